@@ -0,0 +1,52 @@
+#pragma once
+
+namespace montecarlo {
+namespace detail {
+
+/**
+ * @brief Acklam's rational approximation to the standard normal inverse CDF
+ *
+ * Shared by analytics::normal_inverse_cdf and the inverse-CDF normal
+ * generator so the two never use different coefficients. The approximation
+ * has a relative error below 1.15e-9; callers wanting full double precision
+ * refine it with a Halley step.
+ */
+struct AcklamInverseCdf {
+    // Central region p_low <= p <= 1 - p_low
+    static constexpr double a[] = {-3.969683028665376e+01, 2.209460984245205e+02,
+                                   -2.759285104469687e+02, 1.383577518672690e+02,
+                                   -3.066479806614716e+01, 2.506628277459239e+00};
+    static constexpr double b[] = {-5.447609879822406e+01, 1.615858368580409e+02,
+                                   -1.556989798598866e+02, 6.680131188771972e+01,
+                                   -1.328068155288572e+01};
+
+    // Tails
+    static constexpr double c[] = {-7.784894002430293e-03, -3.223964580411365e-01,
+                                   -2.400758277161838e+00, -2.549732539343734e+00,
+                                   4.374664141464968e+00, 2.938163982698783e+00};
+    static constexpr double d[] = {7.784695709041462e-03, 3.224671290700398e-01,
+                                   2.445134137142996e+00, 3.754408661907416e+00};
+
+    static constexpr double p_low = 0.02425;
+    static constexpr double p_high = 1.0 - p_low;
+
+    /**
+     * @brief Central rational at q = p - 0.5
+     */
+    static double central(double q) {
+        const double r = q * q;
+        return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+               (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+    }
+
+    /**
+     * @brief Lower-tail rational at q = sqrt(-2 log p); negate for the upper tail
+     */
+    static double tail(double q) {
+        return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+               ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+};
+
+} // namespace detail
+} // namespace montecarlo
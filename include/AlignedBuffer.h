@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace montecarlo {
+
+/**
+ * @brief Fixed-size, cache-line aligned scratch buffer
+ * 
+ * Storage is allocated once at construction and never resized, so a buffer
+ * can be reused across pricing calls without touching the heap.
+ */
+template <typename T, std::size_t Alignment = 64>
+class AlignedBuffer {
+public:
+    AlignedBuffer() = default;
+
+    explicit AlignedBuffer(std::size_t size)
+        : data_(size > 0 ? static_cast<T*>(::operator new(size * sizeof(T), std::align_val_t{Alignment}))
+                         : nullptr)
+        , size_(size)
+    {}
+
+    ~AlignedBuffer() { release(); }
+
+    AlignedBuffer(const AlignedBuffer&) = delete;
+    AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+    AlignedBuffer(AlignedBuffer&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr))
+        , size_(std::exchange(other.size_, 0))
+    {}
+
+    AlignedBuffer& operator=(AlignedBuffer&& other) noexcept {
+        if (this != &other) {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+    T& operator[](std::size_t i) { return data_[i]; }
+    const T& operator[](std::size_t i) const { return data_[i]; }
+
+private:
+    T* data_ = nullptr;
+    std::size_t size_ = 0;
+
+    void release() {
+        if (data_) {
+            ::operator delete(data_, std::align_val_t{Alignment});
+            data_ = nullptr;
+        }
+    }
+};
+
+} // namespace montecarlo
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "BarrierType.h"
+#include "OptionType.h"
+
+namespace montecarlo {
+namespace analytics {
+
+/**
+ * @brief Standard normal cumulative distribution function
+ * 
+ * @param x Evaluation point
+ * @return double P(Z <= x)
+ */
+double normal_cdf(double x);
+
+/**
+ * @brief Inverse of the standard normal cumulative distribution function
+ * 
+ * Acklam's rational approximation refined by one Halley step, accurate to
+ * close to double precision on (0, 1).
+ * 
+ * @param p Probability in (0, 1)
+ * @return double x with P(Z <= x) = p
+ */
+double normal_inverse_cdf(double p);
+
+/**
+ * @brief Closed-form Black-Scholes price of a European option
+ * 
+ * Degenerates to the discounted intrinsic value of the forward when
+ * sigma or T is zero.
+ * 
+ * @param S Initial asset price
+ * @param K Strike price
+ * @param r Risk-free interest rate
+ * @param sigma Volatility
+ * @param T Time to maturity
+ * @param type Call or put
+ * @return double Option price
+ */
+double black_scholes_price(double S, double K, double r, double sigma, double T, OptionType type);
+
+/**
+ * @brief Closed-form price of a continuously monitored single-barrier option
+ * 
+ * Reiner-Rubinstein formulas without dividends. The rebate is paid at
+ * expiry, as in BarrierPayoff. A spot already at or beyond the barrier
+ * counts as touched.
+ * 
+ * @param S Initial asset price
+ * @param K Strike price
+ * @param H Barrier level
+ * @param r Risk-free interest rate
+ * @param sigma Volatility (positive)
+ * @param T Time to maturity (positive)
+ * @param barrier_type Direction and effect of the barrier
+ * @param type Call or put
+ * @param rebate Amount paid at expiry when the option is not active
+ * @return double Option price
+ */
+double barrier_price(double S, double K, double H, double r, double sigma, double T,
+                     BarrierType barrier_type, OptionType type, double rebate = 0.0);
+
+} // namespace analytics
+} // namespace montecarlo
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "BarrierType.h"
+#include "OptionType.h"
+#include <algorithm>
+
+namespace montecarlo {
+
+/**
+ * @brief Single-barrier European call or put with an optional rebate
+ * 
+ * The payoff of a path depends on whether it touched the barrier, which the
+ * pricer expresses as a survival probability: the probability that the
+ * path never touched the barrier given its monitored points. Rebates are
+ * paid at expiry, to knock-out options that were knocked out and to
+ * knock-in options that were never knocked in.
+ */
+class BarrierPayoff {
+public:
+    /**
+     * @brief Construct a new Barrier Payoff object
+     * 
+     * @param barrier_type Direction and effect of the barrier
+     * @param barrier Barrier level
+     * @param K Strike price
+     * @param option_type Call or put
+     * @param rebate Amount paid at expiry when the option is not active
+     */
+    BarrierPayoff(BarrierType barrier_type, double barrier, double K, OptionType option_type,
+                  double rebate = 0.0)
+        : barrier_type_(barrier_type),
+          barrier_(barrier),
+          K_(K),
+          option_type_(option_type),
+          rebate_(rebate) {}
+
+    /**
+     * @brief Payoff of the underlying vanilla option
+     * 
+     * @param S_T Terminal stock price
+     * @return double max(S_T - K, 0) or max(K - S_T, 0)
+     */
+    double vanilla(double S_T) const {
+        return option_type_ == OptionType::Call ? std::max(S_T - K_, 0.0) : std::max(K_ - S_T, 0.0);
+    }
+
+    /**
+     * @brief Expected payoff of a path given its barrier survival probability
+     * 
+     * @param S_T Terminal stock price
+     * @param survival Probability that the path never touched the barrier
+     * @return double Payoff weighted by the knock-in or knock-out probability
+     */
+    double calculate(double S_T, double survival) const {
+        double active = is_knock_in(barrier_type_) ? 1.0 - survival : survival;
+        return active * vanilla(S_T) + (1.0 - active) * rebate_;
+    }
+
+    BarrierType barrier_type() const { return barrier_type_; }
+    double barrier() const { return barrier_; }
+    double strike() const { return K_; }
+    OptionType option_type() const { return option_type_; }
+    double rebate() const { return rebate_; }
+
+private:
+    BarrierType barrier_type_;
+    double barrier_;
+    double K_;
+    OptionType option_type_;
+    double rebate_;
+};
+
+} // namespace montecarlo
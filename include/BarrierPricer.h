@@ -0,0 +1,82 @@
+#pragma once
+
+#include "BarrierPayoff.h"
+#include "IPricingModel.h"
+#include "OptionPricer.h"
+#include "PricingWorkspace.h"
+
+namespace montecarlo {
+
+/**
+ * @brief Monte Carlo pricer for single-barrier options
+ * 
+ * Paths are generated a block at a time through
+ * IPricingModel::simulate_grid_paths on a uniform grid the model builds once
+ * per run. With continuous monitoring each path carries the
+ * probability that it never touched the barrier. Between consecutive grid
+ * points x0 and x1 in log space, a Brownian bridge crosses the log barrier b
+ * with probability exp(-2 (b - x0) (b - x1) / v), where v is the variance of
+ * the log price over the step, taken from the path grid: sigma^2 dt for a
+ * flat GBM, and the integrated variance of the step for a term structure
+ * model. The path weight
+ * is the product of the complements, rather than a hard knock-out. A coarse
+ * grid therefore prices the continuously monitored option without the
+ * monitoring bias of discrete observation, and with less variance.
+ */
+class BarrierPricer {
+public:
+    /**
+     * @brief Construct a new Barrier Pricer object
+     * 
+     * @param model Reference to the pricing model; continuous monitoring
+     *              needs the step variances of its path grid for the
+     *              bridge
+     * @param num_simulations Number of Monte Carlo simulations
+     * @param num_threads Number of threads for parallel computation
+     * @param num_steps Number of time steps per path
+     */
+    BarrierPricer(const IPricingModel& model,
+                  std::uint64_t num_simulations,
+                  unsigned int num_threads,
+                  unsigned int num_steps);
+
+    /**
+     * @brief Select continuous (Brownian-bridge) or discrete monitoring
+     * 
+     * @param monitoring Monitoring mode (continuous by default)
+     */
+    void set_monitoring(BarrierMonitoring monitoring) { monitoring_ = monitoring; }
+
+    BarrierMonitoring monitoring() const { return monitoring_; }
+
+    /**
+     * @brief Price a barrier option using Monte Carlo simulation
+     * 
+     * @param payoff The barrier payoff to use
+     * @param T Time to maturity
+     * @return PricingResult The pricing result including price, standard error, and computation time
+     */
+    PricingResult price_option(const BarrierPayoff& payoff, double T);
+
+    /**
+     * @brief Price a barrier option reusing a caller-owned workspace
+     * 
+     * @param payoff The barrier payoff to use
+     * @param T Time to maturity
+     * @param workspace Worker threads, RNG states and scratch buffers to use
+     * @return PricingResult The pricing result including price, standard error, and computation time
+     */
+    PricingResult price_option(const BarrierPayoff& payoff, double T, PricingWorkspace& workspace);
+
+private:
+    // Upper bound on the doubles in one step-major block of paths
+    static constexpr std::size_t kMaxBlockValues = 64 * PricingWorkspace::kBlockSize;
+
+    const IPricingModel& model_;
+    std::uint64_t num_simulations_;
+    unsigned int num_threads_;
+    unsigned int num_steps_;
+    BarrierMonitoring monitoring_ = BarrierMonitoring::Continuous;
+};
+
+} // namespace montecarlo
@@ -0,0 +1,62 @@
+#pragma once
+
+namespace montecarlo {
+
+/**
+ * @brief Direction and effect of a single barrier
+ */
+enum class BarrierType {
+    UpAndOut,    ///< Knocked out when the spot rises to the barrier
+    UpAndIn,     ///< Knocked in when the spot rises to the barrier
+    DownAndOut,  ///< Knocked out when the spot falls to the barrier
+    DownAndIn    ///< Knocked in when the spot falls to the barrier
+};
+
+/**
+ * @brief How the barrier is observed between the dates of the time grid
+ */
+enum class BarrierMonitoring {
+    Continuous,  ///< Brownian-bridge crossing probability between grid dates
+    Discrete     ///< Barrier observed on the grid dates only
+};
+
+/**
+ * @brief Whether the barrier lies above the spot
+ */
+inline bool is_up(BarrierType type) {
+    return type == BarrierType::UpAndOut || type == BarrierType::UpAndIn;
+}
+
+/**
+ * @brief Whether touching the barrier activates the option
+ */
+inline bool is_knock_in(BarrierType type) {
+    return type == BarrierType::UpAndIn || type == BarrierType::DownAndIn;
+}
+
+/**
+ * @brief Convert a barrier type to its configuration string
+ * 
+ * @param type Barrier type
+ * @return const char* "up_and_out", "up_and_in", "down_and_out" or "down_and_in"
+ */
+inline const char* to_string(BarrierType type) {
+    switch (type) {
+        case BarrierType::UpAndIn: return "up_and_in";
+        case BarrierType::DownAndOut: return "down_and_out";
+        case BarrierType::DownAndIn: return "down_and_in";
+        default: return "up_and_out";
+    }
+}
+
+/**
+ * @brief Convert a monitoring mode to its configuration string
+ * 
+ * @param monitoring Monitoring mode
+ * @return const char* "continuous" or "discrete"
+ */
+inline const char* to_string(BarrierMonitoring monitoring) {
+    return monitoring == BarrierMonitoring::Discrete ? "discrete" : "continuous";
+}
+
+} // namespace montecarlo
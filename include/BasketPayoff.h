@@ -0,0 +1,78 @@
+#pragma once
+
+#include "MultiAssetPayoff.h"
+#include "OptionType.h"
+#include "Exceptions.h"
+#include <algorithm>
+#include <vector>
+
+namespace montecarlo {
+
+/**
+ * @brief Call or put on a weighted sum of terminal prices
+ */
+class BasketPayoff : public MultiAssetPayoff {
+public:
+    /**
+     * @brief Construct a new Basket Payoff object
+     * 
+     * @param weights Weight of each asset in the basket
+     * @param K Strike price
+     * @param type Call or put on the basket value
+     */
+    BasketPayoff(std::vector<double> weights, double K, OptionType type)
+        : weights_(std::move(weights)), K_(K), type_(type) {}
+
+    /**
+     * @brief Calculate max(sum_i w_i S_i - K, 0) (call) or max(K - sum_i w_i S_i, 0) (put)
+     */
+    void calculate(const double* terminal,
+                   std::size_t num_assets,
+                   std::size_t num_paths,
+                   double* payoffs) const override {
+        if (num_assets != weights_.size()) {
+            throw SimulationError("Basket weights do not match the number of assets");
+        }
+        std::fill(payoffs, payoffs + num_paths, 0.0);
+        for (std::size_t i = 0; i < num_assets; ++i) {
+            const double w = weights_[i];
+            const double* row = terminal + i * num_paths;
+            for (std::size_t p = 0; p < num_paths; ++p) {
+                payoffs[p] += w * row[p];
+            }
+        }
+        const double sign = type_ == OptionType::Call ? 1.0 : -1.0;
+        for (std::size_t p = 0; p < num_paths; ++p) {
+            payoffs[p] = std::max(sign * (payoffs[p] - K_), 0.0);
+        }
+    }
+
+    /**
+     * @brief Payoffs and derivatives: +/- w_i on paths that finish in the money, zero otherwise
+     */
+    void calculate_gradient(const double* terminal,
+                            std::size_t num_assets,
+                            std::size_t num_paths,
+                            double* payoffs,
+                            double* gradients) const override {
+        calculate(terminal, num_assets, num_paths, payoffs);
+        const double sign = type_ == OptionType::Call ? 1.0 : -1.0;
+        for (std::size_t i = 0; i < num_assets; ++i) {
+            double* row = gradients + i * num_paths;
+            for (std::size_t p = 0; p < num_paths; ++p) {
+                row[p] = payoffs[p] > 0.0 ? sign * weights_[i] : 0.0;
+            }
+        }
+    }
+
+    std::unique_ptr<MultiAssetPayoff> clone() const override {
+        return std::make_unique<BasketPayoff>(weights_, K_, type_);
+    }
+
+private:
+    std::vector<double> weights_;
+    double K_;  // Strike price
+    OptionType type_;
+};
+
+} // namespace montecarlo
@@ -0,0 +1,192 @@
+#pragma once
+
+#include "IPricingModel.h"
+#include "Payoff.h"
+#include "PricingWorkspace.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+namespace montecarlo {
+
+/**
+ * @brief Path functional the payoff is applied to
+ */
+enum class PathStatistic {
+    Terminal,          ///< Price at maturity (European)
+    ArithmeticAverage  ///< Mean of the prices at the num_steps monitoring dates (Asian)
+};
+
+/**
+ * @brief One pricing job of a batch
+ *
+ * The model and payoff are not owned and must outlive the run.
+ */
+struct BatchJob {
+    const IPricingModel* model = nullptr;
+    const Payoff* payoff = nullptr;
+    double T = 1.0;                  // Time to maturity
+    std::uint64_t num_paths = 0;
+    std::size_t num_steps = 1;       // Monitoring dates; single-step jobs are sampled exactly at T
+    PathStatistic statistic = PathStatistic::Terminal;
+};
+
+/**
+ * @brief Estimate and latency of one job of a batch
+ *
+ * Times are measured from the start of the batch, so latency_ms is how long
+ * the caller waited for this job's price.
+ */
+struct BatchJobResult {
+    double price = 0.0;
+    double standard_error = 0.0;
+    std::uint64_t num_paths = 0;
+    double estimated_ms = 0.0;  // Cost model estimate of the compute time before the run
+    double compute_ms = 0.0;    // Worker time spent on the job, summed over workers
+    double start_ms = 0.0;      // First piece of the job started
+    double latency_ms = 0.0;    // Last piece of the job finished
+};
+
+/**
+ * @brief Batch-wide scheduling statistics
+ */
+struct BatchStats {
+    double makespan_ms = 0.0;       // Wall time from the first piece started to the last finished
+    double busy_ms = 0.0;           // Compute time summed over workers
+    double utilization = 0.0;       // busy_ms / (makespan_ms * workers)
+    double mean_latency_ms = 0.0;
+    double p50_latency_ms = 0.0;
+    double p95_latency_ms = 0.0;
+    double max_latency_ms = 0.0;
+    std::size_t num_items = 0;      // Work items the batch was scheduled as
+    unsigned int num_workers = 0;
+};
+
+/**
+ * @brief Per-job results in submission order and batch statistics
+ */
+struct BatchResult {
+    std::vector<BatchJobResult> jobs;
+    BatchStats stats;
+    std::chrono::milliseconds computation_time{0};
+};
+
+/**
+ * @brief Work items of a batch, in the order workers claim them
+ *
+ * Each job is cut into pieces whose size depends only on its step count, and
+ * every piece draws from its own RNG stream. Items group whole pieces, so the
+ * partition into items (which depends on the cost estimates and the worker
+ * count) never changes the numbers a seeded batch produces.
+ */
+struct BatchPlan {
+    /**
+     * @brief Pieces [first_piece, last_piece) of one job
+     */
+    struct Segment {
+        std::size_t job;
+        std::uint64_t first_piece;
+        std::uint64_t last_piece;
+    };
+
+    struct Item {
+        std::vector<Segment> segments;
+        double estimated_ns = 0.0;
+    };
+
+    std::vector<Item> items;                   // Largest estimated cost first
+    std::vector<std::uint64_t> piece_offsets;  // Job j owns global pieces [piece_offsets[j], piece_offsets[j + 1])
+    std::vector<double> job_estimates_ns;
+    double target_item_ns = 0.0;               // Cost each item was sized towards
+};
+
+/**
+ * @brief Cost-model scheduler for heterogeneous batches of pricing jobs
+ *
+ * A batch mixing a few long path-dependent jobs with many one-step vanillas
+ * finishes late under one-job-per-thread scheduling: the long jobs start
+ * wherever they land in the queue and leave the other cores idle at the tail.
+ * The scheduler instead
+ * - estimates each job's cost as paths x steps x a per-model factor, the
+ *   measured nanoseconds per path step of that model type, refined after
+ *   every batch from the observed throughput;
+ * - splits jobs costing more than the target item size into several items
+ *   and packs cheaper jobs together into one item, the target being a
+ *   fraction of the batch cost per worker;
+ * - hands items out largest first (the LPT rule), so the tail of the batch is
+ *   made of the smallest items and the workers finish close together.
+ *
+ * Multi-step jobs are simulated on a path grid each model builds once per
+ * job and run, not per block. Pieces are merged into each job's estimate in
+ * piece order, so a seeded batch gives the same prices for any worker count
+ * and any cost estimates.
+ */
+class BatchScheduler {
+public:
+    // Doubles of normals (and as many of prices) per block of paths in a worker's scratch buffer
+    static constexpr std::size_t kBlockValues = 32 * PricingWorkspace::kBlockSize;
+
+    // Path steps per piece, the unit of splitting and seeding
+    static constexpr std::uint64_t kPiecePathSteps = 64 * PricingWorkspace::kBlockSize;
+
+    // Items aimed for per worker; more balance the tail better, fewer cost less to dispatch
+    static constexpr std::size_t kItemsPerWorker = 8;
+
+    // Initial cost factor of a model type not measured yet
+    static constexpr double kDefaultNsPerPathStep = 25.0;
+
+    /**
+     * @brief Construct a new Batch Scheduler object
+     *
+     * @param smoothing Weight of a new throughput measurement in the model
+     *                  factors, in (0, 1]
+     * @throws ValidationError if smoothing is outside (0, 1]
+     */
+    explicit BatchScheduler(double smoothing = 0.5);
+
+    /**
+     * @brief Price every job of a batch
+     *
+     * @param jobs Jobs to price
+     * @param workspace Worker threads and RNG streams to use
+     * @return BatchResult Per-job estimates and latencies, and batch statistics
+     * @throws ValidationError if the batch is empty or a job is invalid
+     */
+    BatchResult run(const std::vector<BatchJob>& jobs, PricingWorkspace& workspace);
+
+    /**
+     * @brief Split, pack and order a batch for the given number of workers
+     */
+    BatchPlan make_plan(const std::vector<BatchJob>& jobs, unsigned int num_workers) const;
+
+    /**
+     * @brief Estimated compute time of a job in nanoseconds
+     */
+    double estimate_ns(const BatchJob& job) const;
+
+    /**
+     * @brief Nanoseconds per path step of a model's type
+     *
+     * kDefaultNsPerPathStep until a batch using the type has run.
+     */
+    double model_factor(const IPricingModel& model) const;
+
+    /**
+     * @brief Paths per block of a job with num_steps steps
+     */
+    static std::uint64_t block_paths(std::size_t num_steps);
+
+    /**
+     * @brief Paths per piece of a job with num_steps steps (a whole number of blocks)
+     */
+    static std::uint64_t piece_paths(std::size_t num_steps);
+
+private:
+    double smoothing_;
+    std::unordered_map<std::type_index, double> ns_per_path_step_;
+};
+
+} // namespace montecarlo
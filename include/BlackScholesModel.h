@@ -1,6 +1,5 @@
 #pragma once
 #include "IPricingModel.h"
-#include <random>
 #include <cmath>
 
 /**
@@ -20,16 +19,22 @@ public:
     ~BlackScholesModel() override = default;
 
     /**
-     * @brief Simulates a price path using geometric Brownian motion
-     * 
-     * @param S Initial asset price
-     * @param K Strike price
-     * @param r Risk-free interest rate
-     * @param sigma Volatility
-     * @param T Time to maturity
-     * @return double Simulated price at maturity
+     * @brief Terminal prices S0 exp((r - sigma^2 / 2) T + sigma sqrt(T) Z)
      */
-    double simulate_price(double S, double K, double r, double sigma, double T) const override;
+    void simulate_terminal(const double* normals, double* terminal,
+                           std::size_t count, double T) const override;
+
+    /**
+     * @brief Exact geometric Brownian motion on a uniform grid of num_steps steps
+     */
+    void simulate_paths(const double* normals, double* paths,
+                        std::size_t count, std::size_t num_steps, double T) const override;
+
+    double discount_factor(double T) const override { return std::exp(-risk_free_rate_ * T); }
+
+    std::optional<GbmTerms> gbm_terms() const override {
+        return GbmTerms{initial_price_, risk_free_rate_, volatility_};
+    }
 
     // Getters
     double get_initial_price() const { return initial_price_; }
@@ -40,11 +45,4 @@ private:
     double initial_price_;
     double risk_free_rate_;
     double volatility_;
-
-    /**
-     * @brief Generates a standard normal random variable
-     * 
-     * @return double Random value from standard normal distribution
-     */
-    double generate_normal_random() const;
 }; 
\ No newline at end of file
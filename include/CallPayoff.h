@@ -35,6 +35,15 @@ public:
         return std::make_unique<CallPayoff>(K_);
     }
 
+    /**
+     * @brief Report the vanilla terms so the pricer can inline this payoff
+     * 
+     * @return std::optional<VanillaTerms> Call with this strike
+     */
+    std::optional<VanillaTerms> vanilla_terms() const override {
+        return VanillaTerms{OptionType::Call, K_};
+    }
+
 private:
     double K_;  // Strike price
 };
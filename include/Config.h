@@ -1,8 +1,16 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <vector>
 #include "nlohmann/json.hpp"
+#include "BarrierType.h"
 #include "OptionType.h"
+#include "PathPrecision.h"
+#include "NormalGenerator.h"
+#include "SamplingMethod.h"
+#include "TermStructure.h"
+#include <optional>
 
 namespace montecarlo {
 
@@ -24,9 +32,67 @@ public:
      */
     static OptionType parse_option_type(const std::string& type_str);
 
+    /**
+     * @brief Parse path precision from string
+     * 
+     * @param precision_str String representation of path precision ("double" or "float")
+     * @return PathPrecision Parsed path precision
+     */
+    static PathPrecision parse_path_precision(const std::string& precision_str);
+
+    /**
+     * @brief Parse sampling method from string
+     * 
+     * @param method_str String representation of sampling method ("mc", "stratified" or "lhs")
+     * @return SamplingMethod Parsed sampling method
+     */
+    static SamplingMethod parse_sampling_method(const std::string& method_str);
+
+    /**
+     * @brief Parse normal generator from string
+     * 
+     * @param method_str String representation of normal generator ("ziggurat" or "inverse_cdf")
+     * @return NormalMethod Parsed normal generator
+     */
+    static NormalMethod parse_normal_method(const std::string& method_str);
+
+    /**
+     * @brief Parse barrier type from string
+     * 
+     * @param type_str String representation of barrier type ("up_and_out", "up_and_in",
+     *                 "down_and_out" or "down_and_in")
+     * @return BarrierType Parsed barrier type
+     */
+    static BarrierType parse_barrier_type(const std::string& type_str);
+
+    /**
+     * @brief Parse barrier monitoring from string
+     * 
+     * @param monitoring_str String representation of monitoring ("continuous" or "discrete")
+     * @return BarrierMonitoring Parsed monitoring mode
+     */
+    static BarrierMonitoring parse_barrier_monitoring(const std::string& monitoring_str);
+
+    /**
+     * @brief Set r and sigma to the averages of their term structures over [0, T]
+     * 
+     * Call again after changing T or a curve. Flat parameters are left alone.
+     */
+    void update_curve_averages();
+
     // Simulation parameters
-    unsigned int num_simulations;
+    std::uint64_t num_simulations;
     unsigned int num_threads;
+    bool auto_threads = false;         // "auto": taken from the machine profile if there is one
+    PathPrecision path_precision = PathPrecision::Double;
+    double drift_shift = 0.0;        // Importance-sampling shift (0 disables)
+    bool auto_drift_shift = false;   // Choose the shift from a pilot run
+    SamplingMethod sampling = SamplingMethod::MonteCarlo;
+    unsigned int num_strata = 1024;
+    NormalMethod normal_method = NormalMethod::Ziggurat;
+    double deadline_ms = 0.0;          // Time budget per pricing call (0 disables)
+    double max_standard_error = 0.0;   // Accuracy floor under a deadline (0 disables)
+    bool auto_normal_method = true;    // Not configured: taken from the machine profile if there is one
 
     // Option parameters
     OptionType option_type;
@@ -36,9 +102,42 @@ public:
     double sigma;  // Volatility
     double T;      // Time to maturity
 
+    // Rate and volatility term structures (unset when r and sigma are flat).
+    // When set, r and sigma hold their averages over [0, T]
+    std::optional<TermStructure> rate_curve;
+    std::optional<TermStructure> vol_curve;
+
+    // Merton jump parameters (jump_intensity of zero disables jumps)
+    double jump_intensity = 0.0;
+    double jump_mean = 0.0;
+    double jump_volatility = 0.0;
+
+    // Local volatility surface (empty when using flat sigma)
+    std::vector<double> local_vol_times;
+    std::vector<double> local_vol_spots;
+    std::vector<double> local_vols;   // Row-major times x spots
+    unsigned int num_steps = 1;
+
+    // Barrier parameters (barrier_level of zero prices a vanilla option)
+    BarrierType barrier_type = BarrierType::DownAndOut;
+    double barrier_level = 0.0;
+    double barrier_rebate = 0.0;
+    BarrierMonitoring barrier_monitoring = BarrierMonitoring::Continuous;
+
+    // Multi-asset parameters (empty when pricing a single underlying)
+    std::vector<double> asset_spots;
+    std::vector<double> asset_volatilities;
+    std::vector<double> basket_weights;
+    std::vector<double> correlation;  // Row-major num_assets x num_assets
+    std::string basket_payoff;        // "basket", "best_of" or "worst_of"
+
     // Output parameters
     int precision;
     bool show_timing;
+    bool report_distribution = false;   // Payoff quantiles, VaR and histogram
+    double var_confidence = 0.99;
+    unsigned int histogram_bins = 20;
+    bool report_memory = false;         // Heap counters and resident set size
 
 private:
     Config() = default;
@@ -17,6 +17,15 @@ public:
         : std::runtime_error("Simulation error: " + message) {}
 };
 
+/**
+ * @brief A pricing call could not reach its required accuracy in its time budget
+ */
+class AccuracyError : public SimulationError {
+public:
+    explicit AccuracyError(const std::string& message)
+        : SimulationError(message) {}
+};
+
 class ValidationError : public std::runtime_error {
 public:
     explicit ValidationError(const std::string& message) 
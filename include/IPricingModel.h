@@ -1,24 +1,141 @@
 #pragma once
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <vector>
+
+/**
+ * @brief Parameters of a geometric Brownian motion model
+ */
+struct GbmTerms {
+    double initial_price;
+    double risk_free_rate;
+    double volatility;
+};
 
 /**
  * @brief Abstract interface for pricing models
- * 
+ *
  * This interface defines the contract for all pricing models that can be used
- * with the Monte Carlo Option Pricing Engine.
+ * with the Monte Carlo Option Pricing Engine. Models evolve whole blocks of
+ * paths per call from standard normals supplied by the caller, so the engine
+ * owns random number generation, threading and accumulation, and a model
+ * only has to implement the map from normals to prices.
  */
 class IPricingModel {
 public:
+    /**
+     * @brief Per-run tables for simulating paths on one uniform time grid
+     *
+     * Built once per (num_steps, T) by make_path_grid and handed to
+     * simulate_grid_paths for every block, so a model looks up its curves,
+     * surface or sampling tables once per run rather than once per block.
+     * Models derive from it to add their own tables.
+     */
+    struct PathGrid {
+        virtual ~PathGrid() = default;
+
+        std::size_t num_steps = 0;
+        double T = 0.0;
+
+        // Spot and log price variance of each step when the log price is
+        // Gaussian with deterministic variance, as Brownian-bridge barrier
+        // monitoring needs; empty otherwise
+        double initial_price = 0.0;
+        std::vector<double> step_variances;
+    };
+
     virtual ~IPricingModel() = default;
 
     /**
-     * @brief Simulates a single price path
-     * 
-     * @param S Initial asset price
-     * @param K Strike price
-     * @param r Risk-free interest rate
-     * @param sigma Volatility
+     * @brief Terminal prices of a block of single-step paths
+     *
+     * normals and terminal may point to the same array.
+     *
+     * @param normals One standard normal per path
+     * @param terminal Receives the price at maturity of each path
+     * @param count Number of paths
+     * @param T Time to maturity
+     */
+    virtual void simulate_terminal(const double* normals, double* terminal,
+                                   std::size_t count, double T) const = 0;
+
+    /**
+     * @brief Prices of a block of paths on a uniform time grid
+     *
+     * Both arrays are step-major: element step * count + path holds the
+     * normal driving, and the price at the end of, step 'step' of 'path'.
+     * normals and paths may point to the same array.
+     *
+     * @param normals num_steps * count standard normals
+     * @param paths Receives num_steps * count prices
+     * @param count Number of paths
+     * @param num_steps Number of equal time steps
+     * @param T Time to maturity
+     */
+    virtual void simulate_paths(const double* normals, double* paths,
+                                std::size_t count, std::size_t num_steps, double T) const = 0;
+
+    /**
+     * @brief Build the path grid of num_steps equal steps to T
+     *
+     * The default holds no tables and takes the step variances from
+     * gbm_terms().
+     *
+     * @param num_steps Number of equal time steps
      * @param T Time to maturity
-     * @return double Simulated price at maturity
+     * @return std::shared_ptr<const PathGrid> Grid for simulate_grid_paths
+     */
+    virtual std::shared_ptr<const PathGrid> make_path_grid(std::size_t num_steps, double T) const {
+        auto grid = std::make_shared<PathGrid>();
+        grid->num_steps = num_steps;
+        grid->T = T;
+        if (auto gbm = gbm_terms()) {
+            grid->initial_price = gbm->initial_price;
+            grid->step_variances.assign(num_steps, gbm->volatility * gbm->volatility * T / num_steps);
+        }
+        return grid;
+    }
+
+    /**
+     * @brief Prices of a block of paths on a grid from this model's make_path_grid
+     *
+     * Same layout as simulate_paths with grid.num_steps steps to grid.T. The
+     * default calls simulate_paths.
+     *
+     * @param grid Grid from make_path_grid
+     * @param normals grid.num_steps * count standard normals
+     * @param paths Receives grid.num_steps * count prices
+     * @param count Number of paths
+     */
+    virtual void simulate_grid_paths(const PathGrid& grid, const double* normals, double* paths,
+                                     std::size_t count) const {
+        simulate_paths(normals, paths, count, grid.num_steps, grid.T);
+    }
+
+    /**
+     * @brief Discount factor from maturity T to today
+     */
+    virtual double discount_factor(double T) const = 0;
+
+    /**
+     * @brief Parameters of the model if it is a geometric Brownian motion
+     *
+     * Pricers use them to select kernels with the dynamics inlined; other
+     * models are driven through simulate_terminal.
+     */
+    virtual std::optional<GbmTerms> gbm_terms() const { return std::nullopt; }
+
+    /**
+     * @brief Flat geometric Brownian motion with the model's terminal distribution at T
+     *
+     * A GBM with deterministic time-dependent rate and volatility ends at T
+     * where a flat GBM with its average rate and root-mean-square volatility
+     * over [0, T] would, so single-step European pricers can use the inlined
+     * GBM kernels for it. Path-dependent pricers must use gbm_terms() instead.
      */
-    virtual double simulate_price(double S, double K, double r, double sigma, double T) const = 0;
-}; 
\ No newline at end of file
+    virtual std::optional<GbmTerms> terminal_gbm_terms(double T) const {
+        (void)T;
+        return gbm_terms();
+    }
+};
@@ -0,0 +1,251 @@
+#pragma once
+
+#include "IPricingModel.h"
+#include "Tape.h"
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace montecarlo {
+
+/**
+ * @brief Dupire local volatility model sigma(t, S)
+ * 
+ * The model is defined by local volatilities on a rectangular (time, spot)
+ * node grid, typically the output of a Dupire calibration to the implied
+ * surface, interpolated bilinearly with flat extrapolation.
+ * 
+ * Before simulation the surface is resampled once onto a Grid matched to the
+ * simulation time steps: each time slice holds linear interpolation
+ * coefficients on a uniform log-spot axis, stored contiguously, so a lookup
+ * is one multiply, one clamp and one fused multiply-add with no search.
+ * 
+ * Through IPricingModel, paths are Euler steps in log space on a grid the
+ * model caches per (T, steps). simulate_terminal gets one normal per path,
+ * so it fixes the terminal Brownian motion with it and fills in the
+ * terminal_steps() steps to maturity by a Brownian bridge whose normals come
+ * from a counter-based stream keyed on that normal: the path is still a full
+ * local volatility path, reproducible from the block of normals, and
+ * stratifying or shifting the normal acts on the dominant driver of S_T.
+ * The cached Grid is also the model's path grid, and pricers that step many
+ * blocks themselves build one and use evolve_step.
+ */
+class LocalVolModel : public IPricingModel {
+public:
+    // Euler steps per terminal price drawn through simulate_terminal
+    static constexpr std::size_t kDefaultTerminalSteps = 100;
+
+    /**
+     * @brief Precomputed simulation grid
+     * 
+     * For step n and log-spot cell k, coefficients[(n * num_cells + k) * 2]
+     * and [... + 1] hold (a, b) such that sigma = a + b * x on that cell.
+     */
+    struct Grid : PathGrid {
+        std::size_t num_cells = 0;
+        double dt = 0.0;
+        double sqrt_dt = 0.0;
+        double x_min = 0.0;        // Lowest log-spot node
+        double x_max = 0.0;        // Highest log-spot node
+        double inv_dx = 0.0;       // Reciprocal log-spot spacing
+        std::vector<double> coefficients;
+
+        /**
+         * @brief Local volatility for step n at log-spot x
+         */
+        double volatility(std::size_t step, double x) const {
+            return volatility(step, x, coefficients.data());
+        }
+
+        /**
+         * @brief Local volatility for step n at log-spot x from the given coefficients
+         * 
+         * @param coefficients Values laid out as the coefficients member, in
+         *                     any scalar type (double or Active)
+         */
+        template <typename Scalar>
+        Scalar volatility(std::size_t step, const Scalar& x, const Scalar* coefficients) const {
+            const double value = value_of(x);
+            const Scalar clamped = value < x_min ? Scalar(x_min) : (value > x_max ? Scalar(x_max) : x);
+            std::size_t cell = static_cast<std::size_t>((value_of(clamped) - x_min) * inv_dx);
+            cell = cell < num_cells ? cell : num_cells - 1;
+            const Scalar* c = coefficients + (step * num_cells + cell) * 2;
+            return c[0] + c[1] * clamped;
+        }
+    };
+
+    /**
+     * @brief Construct a new Local Vol Model object
+     * 
+     * @param initial_price Initial asset price
+     * @param risk_free_rate Risk-free interest rate
+     * @param times Increasing node times
+     * @param spots Increasing node spot levels
+     * @param volatilities Row-major local volatilities (times x spots)
+     */
+    LocalVolModel(double initial_price,
+                  double risk_free_rate,
+                  std::vector<double> times,
+                  std::vector<double> spots,
+                  std::vector<double> volatilities);
+
+    /**
+     * @brief Local volatility by bilinear interpolation on the input nodes
+     * 
+     * This is the reference (search-based) lookup used to build grids.
+     * 
+     * @param t Time
+     * @param S Spot level
+     * @return double Local volatility
+     */
+    double local_volatility(double t, double S) const;
+
+    /**
+     * @brief Resample the surface onto a simulation grid
+     * 
+     * @param T Time to maturity
+     * @param num_steps Number of time steps
+     * @param num_nodes Number of uniform log-spot nodes per slice
+     * @return Grid Precomputed grid
+     */
+    Grid build_grid(double T, std::size_t num_steps, std::size_t num_nodes = 256) const;
+
+    /**
+     * @brief Simulation grid with the default spot nodes, kept by the model
+     * 
+     * The grid of the most recent (T, num_steps) is cached, so repeated calls
+     * for one maturity, from any thread, build it once.
+     * 
+     * @param T Time to maturity
+     * @param num_steps Number of time steps
+     * @return std::shared_ptr<const Grid> Grid as from build_grid()
+     */
+    std::shared_ptr<const Grid> grid(double T, std::size_t num_steps) const;
+
+    /**
+     * @brief Set the number of Euler steps behind each simulate_terminal price
+     * 
+     * @param num_steps Steps to maturity (kDefaultTerminalSteps by default)
+     * @throws ValidationError if num_steps is zero
+     */
+    void set_terminal_steps(std::size_t num_steps);
+
+    std::size_t terminal_steps() const { return terminal_steps_; }
+
+    /**
+     * @brief Map sensitivities to grid coefficients back to the surface nodes
+     * 
+     * The adjoint of build_grid: the resampling is recorded once on a tape
+     * with the node volatilities as inputs and swept in reverse, seeded with
+     * the coefficient sensitivities.
+     * 
+     * @param grid Grid from build_grid()
+     * @param coefficient_adjoints Sensitivity to each entry of grid.coefficients
+     * @return std::vector<double> Sensitivity to each node volatility, row-major (times x spots)
+     */
+    std::vector<double> surface_sensitivities(const Grid& grid,
+                                              const std::vector<double>& coefficient_adjoints) const;
+
+    /**
+     * @brief Advance a block of log-spot paths by one Euler step
+     * 
+     * @param grid Grid from build_grid()
+     * @param step Index of the step being taken
+     * @param normals Standard normals, one per path
+     * @param log_spots Log spot per path, updated in place
+     * @param num_paths Number of paths in the block
+     */
+    void evolve_step(const Grid& grid,
+                     std::size_t step,
+                     const double* normals,
+                     double* log_spots,
+                     std::size_t num_paths) const;
+
+    /**
+     * @brief One Euler step of a single log spot in any scalar type
+     * 
+     * The dynamics of evolve_step with the rate and the grid coefficients
+     * passed in, so LocalVolPricer can run them on Active tape inputs.
+     * 
+     * @param grid Grid from build_grid()
+     * @param step Index of the step being taken
+     * @param x Log spot at the start of the step
+     * @param z Standard normal driving the step
+     * @param r_dt Risk-free rate times grid.dt
+     * @param coefficients Values laid out as grid.coefficients
+     * @return Scalar Log spot at the end of the step
+     */
+    template <typename Scalar>
+    static Scalar advance(const Grid& grid, std::size_t step, const Scalar& x, double z,
+                          const Scalar& r_dt, const Scalar* coefficients) {
+        const double half_dt = 0.5 * grid.dt;
+        const Scalar sigma = grid.volatility(step, x, coefficients);
+        return x + (r_dt - half_dt * sigma * sigma + sigma * grid.sqrt_dt * z);
+    }
+
+    /**
+     * @brief Terminal prices of Euler paths with terminal_steps() steps
+     * 
+     * Each normal fixes the path's terminal Brownian motion; the steps in
+     * between are a Brownian bridge drawn from a stream keyed on the normal.
+     */
+    void simulate_terminal(const double* normals, double* terminal,
+                           std::size_t count, double T) const override;
+
+    /**
+     * @brief Euler paths on the cached grid of num_steps steps
+     */
+    void simulate_paths(const double* normals, double* paths,
+                        std::size_t count, std::size_t num_steps, double T) const override;
+
+    /**
+     * @brief Euler paths on a precomputed grid
+     * 
+     * Same layout as IPricingModel::simulate_paths, with grid.num_steps steps.
+     */
+    void simulate_paths(const Grid& grid, const double* normals, double* paths, std::size_t count) const;
+
+    /**
+     * @brief The cached grid(T, num_steps), as the model's path grid
+     */
+    std::shared_ptr<const PathGrid> make_path_grid(std::size_t num_steps, double T) const override;
+
+    /**
+     * @brief Euler paths on a Grid from make_path_grid
+     */
+    void simulate_grid_paths(const PathGrid& grid, const double* normals, double* paths,
+                             std::size_t count) const override;
+
+    double discount_factor(double T) const override;
+
+    // Getters
+    double get_initial_price() const { return initial_price_; }
+    double get_risk_free_rate() const { return risk_free_rate_; }
+
+private:
+    double initial_price_;
+    double risk_free_rate_;
+    std::vector<double> times_;
+    std::vector<double> spots_;
+    std::vector<double> volatilities_;
+    std::size_t terminal_steps_ = kDefaultTerminalSteps;
+
+    // Grid of the most recently requested (T, num_steps)
+    mutable std::mutex grid_mutex_;
+    mutable std::shared_ptr<const Grid> cached_grid_;
+
+    /**
+     * @brief Bilinear interpolation of the given node volatilities at (t, S)
+     */
+    template <typename Scalar>
+    Scalar interpolate(double t, double S, const Scalar* volatilities) const;
+
+    /**
+     * @brief Fill the coefficients of a grid whose geometry is set
+     */
+    template <typename Scalar>
+    void fill_coefficients(const Grid& grid, const Scalar* volatilities, Scalar* coefficients) const;
+};
+
+} // namespace montecarlo
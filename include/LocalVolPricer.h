@@ -0,0 +1,111 @@
+#pragma once
+
+#include "LocalVolModel.h"
+#include "OptionPricer.h"
+#include "Payoff.h"
+#include "PricingWorkspace.h"
+#include <vector>
+
+namespace montecarlo {
+
+/**
+ * @brief Price and pathwise sensitivities under local volatility
+ */
+struct LocalVolSensitivities {
+    PricingResult pricing;
+    double delta = 0.0;         // dPrice / dS0
+    double rho = 0.0;           // dPrice / dr
+    std::vector<double> vegas;  // dPrice / d(node volatility), row-major (times x spots)
+};
+
+/**
+ * @brief Monte Carlo pricer for European payoffs under local volatility
+ * 
+ * Paths are stepped a block at a time in log space against a precomputed
+ * LocalVolModel::Grid, so the stepping loop performs no searches and no
+ * allocations.
+ */
+class LocalVolPricer {
+public:
+    /**
+     * @brief Construct a new Local Vol Pricer object
+     * 
+     * @param model Reference to the local volatility model
+     * @param num_simulations Number of Monte Carlo simulations
+     * @param num_threads Number of threads for parallel computation
+     * @param num_steps Number of time steps per path
+     */
+    LocalVolPricer(const LocalVolModel& model,
+                   std::uint64_t num_simulations,
+                   unsigned int num_threads,
+                   unsigned int num_steps);
+
+    /**
+     * @brief Price an option using Monte Carlo simulation
+     * 
+     * @param payoff The payoff strategy to use
+     * @param T Time to maturity
+     * @return PricingResult The pricing result including price, standard error, and computation time
+     */
+    PricingResult price_option(const Payoff& payoff, double T);
+
+    /**
+     * @brief Price an option reusing a caller-owned workspace
+     * 
+     * @param payoff The payoff strategy to use
+     * @param T Time to maturity
+     * @param workspace Worker threads, RNG states and scratch buffers to use
+     * @return PricingResult The pricing result including price, standard error, and computation time
+     */
+    PricingResult price_option(const Payoff& payoff, double T, PricingWorkspace& workspace);
+
+    /**
+     * @brief Use Latin hypercube sampling across the time-step dimensions
+     * 
+     * Each block of paths forms one Latin hypercube sample: for every step the
+     * block's normals come from a random permutation of equal-probability
+     * strata. The standard error is estimated from the spread of block means.
+     * 
+     * @param enabled Whether to use Latin hypercube sampling
+     */
+    void set_latin_hypercube(bool enabled) { latin_hypercube_ = enabled; }
+
+    /**
+     * @brief Price an option together with its sensitivity to every surface node
+     * 
+     * Paths are recorded on the workspace's per-worker tapes (see Tape) a few
+     * at a time, stepped by LocalVolModel::advance on Active inputs, and swept
+     * in reverse into per-worker adjoints of S0, r and the grid
+     * coefficients, merged at the end and mapped back to the surface nodes
+     * through LocalVolModel::surface_sensitivities. Every sensitivity comes
+     * out of one run, at a small constant multiple of the cost of
+     * price_option, however many nodes the surface has. The paths and the
+     * price are those of price_option with the same seed.
+     * 
+     * Pathwise derivatives need a payoff that is continuous in S_T, so only
+     * vanilla calls and puts are supported.
+     * 
+     * @param payoff Vanilla call or put
+     * @param T Time to maturity
+     * @param workspace Worker threads, RNG states and scratch buffers to use
+     * @return LocalVolSensitivities Price, delta, rho and node vegas
+     */
+    LocalVolSensitivities price_sensitivities(const Payoff& payoff, double T, PricingWorkspace& workspace);
+
+    /**
+     * @brief Price an option and its sensitivities with a temporary workspace
+     */
+    LocalVolSensitivities price_sensitivities(const Payoff& payoff, double T);
+
+private:
+    const LocalVolModel& model_;
+    std::uint64_t num_simulations_;
+    unsigned int num_threads_;
+    unsigned int num_steps_;
+    bool latin_hypercube_ = false;
+
+    // Paths recorded on a tape between reverse sweeps
+    static constexpr unsigned int kTapePaths = 16;
+};
+
+} // namespace montecarlo
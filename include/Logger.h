@@ -8,6 +8,7 @@
 #include <sstream>
 #include <iostream>
 #include "Exceptions.h"
+#include "MemoryStats.h"
 
 namespace montecarlo {
 
@@ -48,6 +49,7 @@ private:
     static std::mutex log_mutex_;
 
     static void log(const std::string& level, const std::string& message) {
+        MemoryScope memory_scope(MemorySubsystem::Logger);
         std::lock_guard<std::mutex> lock(log_mutex_);
         
         // Get current time
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "NormalGenerator.h"
+#include "PricingWorkspace.h"
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+
+namespace montecarlo {
+
+/**
+ * @brief Tuned execution settings for one kind of machine
+ *
+ * A profile is keyed by the CPU model and the cgroup CPU quota, so a
+ * container limited to two CPUs on a large host gets its own entry. Profile
+ * files hold one entry per key; --tune adds or replaces the entry for the
+ * current machine and later runs pick it up automatically.
+ */
+struct MachineProfile {
+    static constexpr int kVersion = 1;
+
+    std::string cpu_model;
+    double cpu_quota = 0.0;                               // CPUs allowed by the cgroup quota, 0 when unlimited
+    unsigned int num_threads = 1;
+    std::uint64_t chunk_size = PricingWorkspace::kChunkSize;  // Paths per scheduled chunk
+    NormalMethod normal_method = NormalMethod::Ziggurat;
+    std::uint64_t serial_threshold = 0;                   // Jobs below this many paths run on one thread
+    double paths_per_second = 0.0;                        // Throughput of the tuned settings
+
+    /**
+     * @brief CPU model name of this machine, or "unknown"
+     */
+    static std::string current_cpu_model();
+
+    /**
+     * @brief CPUs allowed by this process's cgroup quota, 0 when unlimited or unknown
+     */
+    static double current_cpu_quota();
+
+    /**
+     * @brief Number of CPUs this process can actually use
+     *
+     * The smaller of the CPUs in the affinity mask (or hardware_concurrency)
+     * and the cgroup quota rounded up, and at least 1. Unlike
+     * hardware_concurrency this respects container limits.
+     */
+    static unsigned int available_cpus();
+
+    /**
+     * @brief Default profile file
+     *
+     * $MONTECARLO_PROFILE if set, otherwise ~/.montecarlo/machine_profile.json.
+     */
+    static std::string default_path();
+
+    /**
+     * @brief Load the entry for a machine from a profile file
+     *
+     * @param filename Path to the profile file
+     * @param cpu_model CPU model to look up
+     * @param cpu_quota cgroup CPU quota to look up
+     * @return std::optional<MachineProfile> The entry, or nothing if the file or entry does not exist
+     * @throws ConfigError if the file is malformed or of another version
+     */
+    static std::optional<MachineProfile> find(const std::string& filename,
+                                              const std::string& cpu_model,
+                                              double cpu_quota);
+
+    /**
+     * @brief Load the entry for the current machine from a profile file
+     */
+    static std::optional<MachineProfile> find(const std::string& filename);
+
+    /**
+     * @brief Add this entry to a profile file, replacing any entry with the same key
+     *
+     * Creates the file and its directory if needed; entries for other
+     * machines are kept. A malformed existing file is replaced.
+     *
+     * @param filename Path to the profile file
+     */
+    void save(const std::string& filename) const;
+};
+
+/**
+ * @brief Settings of the tuning benchmarks
+ */
+struct TuneOptions {
+    std::uint64_t benchmark_paths = 1u << 21;  // Paths per timed pricing call
+    unsigned int repeats = 5;                  // Timed calls per setting; the median is kept
+    unsigned int max_threads = 0;              // Largest thread count tried, 0 for available_cpus()
+    double tolerance = 0.05;                   // Fewer threads win when within this share of the fastest
+};
+
+/**
+ * @brief One measurement reported while tuning
+ */
+struct TuneMeasurement {
+    std::string stage;          // "threads", "chunk_size", "normal_generator" or "serial_threshold"
+    std::string setting;        // Value tried
+    double paths_per_second;
+};
+
+/**
+ * @brief Microbenchmark the machine and return the fastest settings
+ *
+ * Prices a Black-Scholes call with OptionPricer and tunes, in order: the
+ * thread count (1, 2, 4, ... and available_cpus(), keeping the smallest
+ * count within the tolerance of the fastest, which skips oversubscribed
+ * hyperthreads), the chunk size, the normal generator, and the job size
+ * below which building a multi-threaded workspace is not worth it. Path
+ * precision is not tuned, as single precision changes the results.
+ *
+ * @param options Benchmark sizes
+ * @param progress Optional callback receiving every measurement
+ * @return MachineProfile Profile keyed by the current machine
+ */
+MachineProfile tune_machine(const TuneOptions& options = TuneOptions(),
+                            const std::function<void(const TuneMeasurement&)>& progress = nullptr);
+
+} // namespace montecarlo
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace montecarlo {
+
+/**
+ * @brief Parts of the program whose heap use is counted separately
+ *
+ * Allocations are charged to the subsystem of the innermost MemoryScope on
+ * the allocating thread, and to Other outside any scope. PricingWorkspace
+ * worker threads run entirely in the Pricer scope.
+ */
+enum class MemorySubsystem : std::uint8_t {
+    Other,
+    Pricer,
+    Exporter,
+    Config,
+    Logger
+};
+
+constexpr std::size_t kNumMemorySubsystems = 5;
+
+/**
+ * @brief Convert a memory subsystem to its report name
+ *
+ * @param subsystem Memory subsystem
+ * @return const char* "other", "pricer", "exporter", "config" or "logger"
+ */
+inline const char* to_string(MemorySubsystem subsystem) {
+    switch (subsystem) {
+        case MemorySubsystem::Pricer: return "pricer";
+        case MemorySubsystem::Exporter: return "exporter";
+        case MemorySubsystem::Config: return "config";
+        case MemorySubsystem::Logger: return "logger";
+        default: return "other";
+    }
+}
+
+/**
+ * @brief Heap counters of the whole process or of one subsystem
+ */
+struct MemoryCounters {
+    std::uint64_t allocations = 0;       // Calls to operator new
+    std::uint64_t deallocations = 0;     // Calls to operator delete
+    std::uint64_t bytes_allocated = 0;   // Bytes requested over the process lifetime
+    std::int64_t live_bytes = 0;         // Bytes allocated and not yet freed
+};
+
+/**
+ * @brief Snapshot of the process's memory use
+ *
+ * The heap counters are only filled in when the counting allocator
+ * (src/CountingAllocator.cpp) is linked into the executable; see
+ * allocations_counted(). Resident set sizes are always sampled.
+ */
+struct MemoryStats {
+    bool counted = false;                                       // Whether the heap counters are live
+    MemoryCounters total;
+    std::array<MemoryCounters, kNumMemorySubsystems> subsystems; // Indexed by MemorySubsystem
+    std::int64_t peak_live_bytes = 0;                           // High-water mark of total.live_bytes
+    std::size_t peak_rss_kb = 0;                                // Process resident set high-water mark
+    std::size_t current_rss_kb = 0;                             // Process resident set now
+
+    /**
+     * @brief Counters of one subsystem
+     */
+    const MemoryCounters& of(MemorySubsystem subsystem) const {
+        return subsystems[static_cast<std::size_t>(subsystem)];
+    }
+};
+
+/**
+ * @brief Whether heap allocations are being counted
+ *
+ * True once the counting allocator has seen its first allocation, which
+ * happens before main in any executable that links it.
+ */
+bool allocations_counted();
+
+/**
+ * @brief Take a snapshot of the heap counters and resident set sizes
+ *
+ * Does not allocate, so it can be called inside a MemoryScope.
+ */
+MemoryStats memory_stats();
+
+/**
+ * @brief Restart the live-heap high-water mark from the bytes live now
+ *
+ * Lets a caller read the heap peak of one section of work from
+ * memory_stats().peak_live_bytes. Other threads allocating meanwhile are
+ * included in that peak.
+ */
+void reset_peak_live_bytes();
+
+/**
+ * @brief Process resident set high-water mark in KiB, 0 if unavailable
+ */
+std::size_t peak_rss_kb();
+
+/**
+ * @brief Current process resident set size in KiB, 0 if unavailable
+ */
+std::size_t current_rss_kb();
+
+/**
+ * @brief Subsystem charged for allocations made on the calling thread
+ */
+MemorySubsystem current_memory_subsystem();
+
+/**
+ * @brief Charges allocations on this thread to a subsystem while in scope
+ *
+ * Scopes nest; the previous subsystem is restored on destruction. Entering
+ * a scope costs one thread-local store whether or not allocations are
+ * counted.
+ */
+class MemoryScope {
+public:
+    explicit MemoryScope(MemorySubsystem subsystem);
+    ~MemoryScope();
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemorySubsystem previous_;
+};
+
+/**
+ * @brief Counts the heap allocations made on all threads since construction
+ *
+ * Meant for tests that pin a code path to a fixed number of allocations,
+ * usually zero. Requires the counting allocator; check allocations_counted().
+ */
+class AllocationCounter {
+public:
+    AllocationCounter() { reset(); }
+
+    /**
+     * @brief Restart counting from now
+     */
+    void reset();
+
+    /**
+     * @brief Allocations made since construction or the last reset
+     */
+    std::uint64_t allocations() const;
+
+    /**
+     * @brief Bytes requested since construction or the last reset
+     */
+    std::uint64_t bytes_allocated() const;
+
+private:
+    std::uint64_t allocations_ = 0;
+    std::uint64_t bytes_allocated_ = 0;
+};
+
+namespace detail {
+
+/**
+ * @brief Count an allocation against the calling thread's subsystem
+ *
+ * Called by the counting allocator only; must not allocate.
+ *
+ * @param bytes Bytes requested
+ * @return MemorySubsystem Subsystem charged, to be passed back on deallocation
+ */
+MemorySubsystem record_allocation(std::size_t bytes) noexcept;
+
+/**
+ * @brief Count a deallocation against the subsystem that made the allocation
+ */
+void record_deallocation(std::size_t bytes, MemorySubsystem subsystem) noexcept;
+
+} // namespace detail
+
+} // namespace montecarlo
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "IPricingModel.h"
+#include "OptionType.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace montecarlo {
+
+/**
+ * @brief Merton jump-diffusion model
+ * 
+ * Geometric Brownian motion with compound Poisson jumps whose log sizes are
+ * normal(jump_mean, jump_volatility^2). The drift is compensated so that the
+ * discounted spot is a martingale.
+ * 
+ * Without monitoring dates the terminal price is sampled exactly in a single
+ * step: conditional on N jumps, log(S_T / S_0) is normal with mean
+ * (r - lambda*k - sigma^2/2) T + N jump_mean and variance
+ * sigma^2 T + N jump_volatility^2.
+ * 
+ * Through IPricingModel, which supplies one normal per path, the terminal
+ * price is instead the quantile of that Poisson mixture of normals at the
+ * normal's probability, so a single draw still samples the exact law and
+ * stratifying or shifting the draw acts on S_T directly. The quantile is
+ * tabulated once per maturity and interpolated, so a draw costs a lookup
+ * rather than a root search. MertonJumpPricer keeps the two-draw sampler
+ * above and never builds that table.
+ */
+class MertonJumpModel : public IPricingModel {
+public:
+    /**
+     * @brief Per-maturity lookup tables for exact terminal sampling
+     * 
+     * Entry n holds the Poisson CDF P(N <= n) and the conditional log-mean and
+     * standard deviation given n jumps. The table is truncated once the
+     * remaining Poisson tail is negligible.
+     */
+    struct TerminalTables {
+        std::vector<double> poisson_cdf;
+        std::vector<double> log_mean;
+        std::vector<double> log_stdev;
+    };
+
+    /**
+     * @brief Per-maturity table of the mixture quantile against the normal
+     * 
+     * The central range of normals is split into equal intervals, and
+     * interval j into divisions[j] equal pieces whose end points, from
+     * offsets[j], hold the log price quantile x(z) and its slope dx/dz for
+     * cubic Hermite interpolation. Pieces are halved until interpolation at
+     * their midpoints agrees with the root search to about 1e-12 in z, and
+     * the checked midpoints are kept as nodes. Normals outside the range, and
+     * intervals too steep to tabulate (gaps between well separated jump
+     * counts), are inverted by root search on mixture.
+     */
+    struct QuantileTable {
+        std::shared_ptr<const TerminalTables> mixture;
+        std::vector<std::size_t> offsets;
+        std::vector<std::size_t> divisions;
+        std::vector<double> quantiles;
+        std::vector<double> slopes;
+    };
+
+    /**
+     * @brief Construct a new Merton Jump Model object
+     * 
+     * @param initial_price Initial asset price
+     * @param risk_free_rate Risk-free interest rate
+     * @param volatility Diffusion volatility
+     * @param jump_intensity Expected number of jumps per year (lambda)
+     * @param jump_mean Mean of the log jump size
+     * @param jump_volatility Standard deviation of the log jump size
+     */
+    MertonJumpModel(double initial_price,
+                    double risk_free_rate,
+                    double volatility,
+                    double jump_intensity,
+                    double jump_mean,
+                    double jump_volatility);
+
+    /**
+     * @brief Build the sampling tables for a maturity
+     * 
+     * @param T Time to maturity
+     * @return TerminalTables Tables for simulate_terminal
+     */
+    TerminalTables prepare(double T) const;
+
+    /**
+     * @brief Sampling tables for a maturity, kept by the model
+     * 
+     * The tables of the most recent maturity are cached, so repeated calls
+     * for one maturity, from any thread, build them once.
+     * 
+     * @param T Time to maturity
+     * @return std::shared_ptr<const TerminalTables> Tables for simulate_terminal
+     */
+    std::shared_ptr<const TerminalTables> tables(double T) const;
+
+    /**
+     * @brief Quantile table for a maturity, kept by the model
+     * 
+     * Built on first use, from tables(T), and cached for the most recent
+     * maturity like the tables themselves.
+     * 
+     * @param T Time to maturity
+     * @return std::shared_ptr<const QuantileTable> Table for quantile()
+     */
+    std::shared_ptr<const QuantileTable> quantile_table(double T) const;
+
+    /**
+     * @brief Log price quantile of a maturity's mixture at a normal's probability
+     * 
+     * @param table Table from quantile_table()
+     * @param z Standard normal
+     * @return double Log price x with P(log S_T <= x) = Phi(z)
+     */
+    static double quantile(const QuantileTable& table, double z);
+
+    /**
+     * @brief Map a block of uniforms to Poisson jump counts by table inversion
+     * 
+     * Each count is the number of CDF entries below the uniform, computed
+     * without data-dependent branches so the loop vectorizes.
+     * 
+     * @param tables Tables from prepare()
+     * @param uniforms Uniforms in [0, 1)
+     * @param counts Output jump counts
+     * @param num_paths Number of paths in the block
+     */
+    static void sample_jump_counts(const TerminalTables& tables,
+                                   const double* uniforms,
+                                   std::uint32_t* counts,
+                                   std::size_t num_paths);
+
+    /**
+     * @brief Exact single-step terminal prices for a block of paths
+     * 
+     * @param tables Tables from prepare()
+     * @param normals Standard normals, one per path
+     * @param counts Jump counts, one per path
+     * @param terminal Output terminal prices (may alias normals)
+     * @param num_paths Number of paths in the block
+     */
+    void simulate_terminal(const TerminalTables& tables,
+                           const double* normals,
+                           const std::uint32_t* counts,
+                           double* terminal,
+                           std::size_t num_paths) const;
+
+    /**
+     * @brief Closed-form Merton series price of a European option
+     * 
+     * Sums Black-Scholes prices conditional on n jumps weighted by Poisson
+     * probabilities with intensity lambda (1 + k).
+     * 
+     * @param K Strike price
+     * @param T Time to maturity
+     * @param type Call or put
+     * @return double Option price
+     */
+    double analytic_price(double K, double T, OptionType type) const;
+
+    /**
+     * @brief Exact terminal prices, one normal per path, by mixture inversion
+     * 
+     * Each price is the quantile of the terminal distribution at the normal's
+     * probability, interpolated from quantile_table(T).
+     */
+    void simulate_terminal(const double* normals, double* terminal,
+                           std::size_t count, double T) const override;
+
+    /**
+     * @brief Paths on a uniform grid, each step sampled exactly by mixture inversion
+     */
+    void simulate_paths(const double* normals, double* paths,
+                        std::size_t count, std::size_t num_steps, double T) const override;
+
+    /**
+     * @brief Path grid holding the quantile table of one step
+     */
+    std::shared_ptr<const PathGrid> make_path_grid(std::size_t num_steps, double T) const override;
+
+    /**
+     * @brief Paths on a grid from make_path_grid, without touching the table cache
+     */
+    void simulate_grid_paths(const PathGrid& grid, const double* normals, double* paths,
+                             std::size_t count) const override;
+
+    double discount_factor(double T) const override;
+
+    // Getters
+    double get_initial_price() const { return initial_price_; }
+    double get_risk_free_rate() const { return risk_free_rate_; }
+    double get_volatility() const { return volatility_; }
+    double get_jump_intensity() const { return jump_intensity_; }
+    double get_jump_mean() const { return jump_mean_; }
+    double get_jump_volatility() const { return jump_volatility_; }
+
+    /**
+     * @brief Expected relative jump size k = E[e^J] - 1
+     */
+    double jump_compensator() const;
+
+private:
+    double initial_price_;
+    double risk_free_rate_;
+    double volatility_;
+    double jump_intensity_;
+    double jump_mean_;
+    double jump_volatility_;
+
+    // Tables of the most recently requested maturity
+    mutable std::mutex tables_mutex_;
+    mutable double cached_maturity_ = -1.0;
+    mutable std::shared_ptr<const TerminalTables> cached_tables_;
+
+    // Quantile table of the most recently requested maturity
+    mutable std::mutex quantile_mutex_;
+    mutable double cached_quantile_maturity_ = -1.0;
+    mutable std::shared_ptr<const QuantileTable> cached_quantile_table_;
+};
+
+} // namespace montecarlo
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "MertonJumpModel.h"
+#include "OptionPricer.h"
+#include "OptionType.h"
+#include "Payoff.h"
+#include "PricingWorkspace.h"
+
+namespace montecarlo {
+
+/**
+ * @brief Monte Carlo pricer for European payoffs under the Merton jump model
+ * 
+ * Jump counts and normals are drawn a block at a time and terminal prices are
+ * sampled exactly in a single step. Optionally a vanilla option with a
+ * closed-form Merton price is used as a control variate.
+ */
+class MertonJumpPricer {
+public:
+    /**
+     * @brief Construct a new Merton Jump Pricer object
+     * 
+     * @param model Reference to the jump-diffusion model
+     * @param num_simulations Number of Monte Carlo simulations
+     * @param num_threads Number of threads for parallel computation
+     */
+    MertonJumpPricer(const MertonJumpModel& model,
+                     std::uint64_t num_simulations,
+                     unsigned int num_threads);
+
+    /**
+     * @brief Use a vanilla option with a closed-form price as control variate
+     * 
+     * @param K Strike of the control option
+     * @param type Call or put
+     */
+    void set_control_variate(double K, OptionType type);
+
+    /**
+     * @brief Price without a control variate
+     */
+    void clear_control_variate() { use_control_variate_ = false; }
+
+    /**
+     * @brief Price an option using Monte Carlo simulation
+     * 
+     * @param payoff The payoff strategy to use
+     * @param T Time to maturity
+     * @return PricingResult The pricing result including price, standard error, and computation time
+     */
+    PricingResult price_option(const Payoff& payoff, double T);
+
+    /**
+     * @brief Price an option reusing a caller-owned workspace
+     * 
+     * @param payoff The payoff strategy to use
+     * @param T Time to maturity
+     * @param workspace Worker threads, RNG states and scratch buffers to use
+     * @return PricingResult The pricing result including price, standard error, and computation time
+     */
+    PricingResult price_option(const Payoff& payoff, double T, PricingWorkspace& workspace);
+
+private:
+    const MertonJumpModel& model_;
+    std::uint64_t num_simulations_;
+    unsigned int num_threads_;
+
+    bool use_control_variate_ = false;
+    double control_strike_ = 0.0;
+    OptionType control_type_ = OptionType::Call;
+};
+
+} // namespace montecarlo
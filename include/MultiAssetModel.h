@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace montecarlo {
+
+/**
+ * @brief Correlated multi-asset geometric Brownian motion
+ * 
+ * The correlation matrix is factorized once at construction: Cholesky when it
+ * is positive definite, otherwise an eigen-decomposition with the (numerically)
+ * zero eigenvalues clipped, which handles positive semi-definite matrices such
+ * as perfectly correlated assets.
+ * 
+ * Paths are processed in blocks stored asset-major: element (i, p) of a block
+ * of num_paths paths lives at index i * num_paths + p, so the correlation step
+ * is a small lower-triangular matrix-matrix product whose inner loop runs over
+ * contiguous paths.
+ */
+class MultiAssetModel {
+public:
+    /**
+     * @brief Model inputs in a scalar type, as arrays laid out like the getters
+     */
+    template <typename Scalar>
+    struct Inputs {
+        const Scalar* spots;
+        const Scalar* volatilities;
+        const Scalar* factor;      // Row-major, as get_factor()
+        Scalar risk_free_rate;
+    };
+
+    /**
+     * @brief Construct a new Multi Asset Model object
+     * 
+     * @param spots Initial asset prices
+     * @param volatilities Asset volatilities
+     * @param correlation Row-major correlation matrix (num_assets x num_assets)
+     * @param risk_free_rate Risk-free interest rate
+     */
+    MultiAssetModel(std::vector<double> spots,
+                    std::vector<double> volatilities,
+                    const std::vector<double>& correlation,
+                    double risk_free_rate);
+
+    /**
+     * @brief Apply the correlation factor to a block of independent normals
+     * 
+     * @param normals Independent standard normals, asset-major
+     * @param correlated Output correlated normals, asset-major (must not alias normals)
+     * @param num_paths Number of paths in the block
+     */
+    void correlate(const double* normals, double* correlated, std::size_t num_paths) const;
+
+    /**
+     * @brief Simulate terminal prices for a block of paths
+     * 
+     * @param normals Independent standard normals, asset-major
+     * @param terminal Output terminal prices, asset-major (must not alias normals)
+     * @param num_paths Number of paths in the block
+     * @param T Time to maturity
+     */
+    void simulate_terminal(const double* normals, double* terminal, std::size_t num_paths, double T) const;
+
+    /**
+     * @brief Simulate terminal prices from model inputs in any scalar type
+     * 
+     * The dynamics of simulate_terminal, instantiated for double and for
+     * Active, so MultiAssetPricer records paths on a tape with the inputs as
+     * tape inputs. Factor entries that are zero in the model are skipped.
+     * 
+     * @param inputs Spots, volatilities, factor and rate to simulate with
+     * @param normals Independent standard normals, asset-major with row stride 'stride'
+     * @param stride Distance between the rows of consecutive assets in normals
+     * @param terminal Output terminal prices, asset-major with row stride num_paths
+     * @param num_paths Number of paths in the block
+     * @param T Time to maturity
+     */
+    template <typename Scalar>
+    void simulate_terminal(const Inputs<Scalar>& inputs, const double* normals, std::size_t stride,
+                           Scalar* terminal, std::size_t num_paths, double T) const;
+
+    // Getters
+    std::size_t num_assets() const { return spots_.size(); }
+    const std::vector<double>& get_spots() const { return spots_; }
+    const std::vector<double>& get_volatilities() const { return volatilities_; }
+    double get_risk_free_rate() const { return risk_free_rate_; }
+
+    /**
+     * @brief Factor L with L * L^T equal to the correlation matrix
+     * 
+     * Lower-triangular unless the eigen-decomposition fallback was used.
+     * 
+     * @return const std::vector<double>& Row-major factor
+     */
+    const std::vector<double>& get_factor() const { return factor_; }
+
+    /**
+     * @brief Whether the eigen-decomposition fallback was used
+     */
+    bool used_eigen_fallback() const { return used_eigen_fallback_; }
+
+    /**
+     * @brief Map sensitivities to the factor back to the correlations
+     * 
+     * The adjoint of the Cholesky factorization, recorded on a tape and swept
+     * in reverse. Entry (i, j) of the result is the sensitivity to moving
+     * rho_ij and rho_ji together; the diagonal is zero. Not available when
+     * the eigen-decomposition fallback was used.
+     * 
+     * @param factor_adjoints Sensitivity to each entry of get_factor(), row-major
+     * @return std::vector<double> Symmetric row-major num_assets x num_assets sensitivities
+     */
+    std::vector<double> correlation_sensitivities(const std::vector<double>& factor_adjoints) const;
+
+private:
+    std::vector<double> spots_;
+    std::vector<double> volatilities_;
+    std::vector<double> correlation_;
+    double risk_free_rate_;
+    std::vector<double> factor_;
+    bool used_eigen_fallback_ = false;
+
+    template <typename Scalar>
+    void correlate(const Scalar* factor, const double* normals, std::size_t stride,
+                   Scalar* correlated, std::size_t num_paths) const;
+
+    template <typename Scalar>
+    static bool cholesky(const Scalar* matrix, std::size_t n, Scalar* factor);
+    static void eigen_factor(const std::vector<double>& matrix, std::size_t n, std::vector<double>& factor);
+};
+
+} // namespace montecarlo
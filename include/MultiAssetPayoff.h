@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Exceptions.h"
+#include <cstddef>
+#include <memory>
+
+namespace montecarlo {
+
+/**
+ * @brief Abstract base class for payoffs on several underlyings
+ * 
+ * Payoffs are evaluated a block of paths at a time on asset-major terminal
+ * prices: the price of asset i on path p is terminal[i * num_paths + p].
+ */
+class MultiAssetPayoff {
+public:
+    virtual ~MultiAssetPayoff() = default;
+
+    /**
+     * @brief Calculate the payoffs for a block of paths
+     * 
+     * @param terminal Asset-major terminal prices
+     * @param num_assets Number of assets
+     * @param num_paths Number of paths in the block
+     * @param payoffs Output payoff per path
+     */
+    virtual void calculate(const double* terminal,
+                           std::size_t num_assets,
+                           std::size_t num_paths,
+                           double* payoffs) const = 0;
+
+    /**
+     * @brief Calculate the payoffs and their derivatives with respect to the terminal prices
+     * 
+     * Used for pathwise sensitivities, which need a payoff that is continuous
+     * in the terminal prices. The default throws ValidationError.
+     * 
+     * @param terminal Asset-major terminal prices
+     * @param num_assets Number of assets
+     * @param num_paths Number of paths in the block
+     * @param payoffs Output payoff per path
+     * @param gradients Output asset-major derivative of each payoff with respect to each terminal price
+     */
+    virtual void calculate_gradient(const double* terminal,
+                                    std::size_t num_assets,
+                                    std::size_t num_paths,
+                                    double* payoffs,
+                                    double* gradients) const {
+        (void)terminal;
+        (void)num_assets;
+        (void)num_paths;
+        (void)payoffs;
+        (void)gradients;
+        throw ValidationError("Payoff does not provide pathwise derivatives");
+    }
+
+    /**
+     * @brief Create a copy of the payoff object
+     * 
+     * @return std::unique_ptr<MultiAssetPayoff> A new copy of the payoff object
+     */
+    virtual std::unique_ptr<MultiAssetPayoff> clone() const = 0;
+};
+
+} // namespace montecarlo
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+
+namespace montecarlo {
+
+/**
+ * @brief Algorithm used to turn uniform bits into standard normals
+ */
+enum class NormalMethod {
+    Ziggurat,    ///< Marsaglia-Tsang ziggurat, one 32-bit draw for ~99% of variates
+    InverseCdf   ///< Acklam rational inverse CDF, evaluated branch-free over a buffer
+};
+
+/**
+ * @brief Convert a normal method to its configuration string
+ * 
+ * @param method Normal method
+ * @return const char* "ziggurat" or "inverse_cdf"
+ */
+inline const char* to_string(NormalMethod method) {
+    return method == NormalMethod::InverseCdf ? "inverse_cdf" : "ziggurat";
+}
+
+/**
+ * @brief Buffer-oriented standard normal generator
+ * 
+ * Replaces std::normal_distribution in the simulation hot loops. Every call
+ * fills a whole buffer. The inverse-CDF method first writes uniforms and then
+ * transforms them in a separate pass; that pass evaluates the central
+ * rational approximation for every element without branches, then patches
+ * the rare tail elements, so it vectorizes. transform() is exposed on its own
+ * so stratified, Latin hypercube or quasi-random uniforms can share it.
+ * 
+ * Uniforms are built from 32 random bits, which truncates the normal at about
+ * 6.3 standard deviations (probability 2e-10). The Acklam approximation has a
+ * relative error below 1.2e-9.
+ */
+class NormalGenerator {
+public:
+    explicit NormalGenerator(NormalMethod method = NormalMethod::Ziggurat) : method_(method) {}
+
+    NormalMethod method() const { return method_; }
+
+    /**
+     * @brief Fill a buffer with independent standard normals
+     * 
+     * @param rng 32-bit uniform random bit generator (e.g. std::mt19937)
+     * @param out Output buffer
+     * @param n Number of variates
+     */
+    template <typename Engine, typename Real>
+    void fill(Engine& rng, Real* out, std::size_t n) const {
+        if (method_ == NormalMethod::InverseCdf) {
+            fill_inverse_cdf(rng, out, n);
+        } else {
+            fill_ziggurat(rng, out, n);
+        }
+    }
+
+    /**
+     * @brief Fill a buffer by the ziggurat method
+     */
+    template <typename Engine, typename Real>
+    static void fill_ziggurat(Engine& rng, Real* out, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = static_cast<Real>(ziggurat(rng));
+        }
+    }
+
+    /**
+     * @brief Fill a buffer by inverse CDF of 32-bit uniforms
+     */
+    template <typename Engine, typename Real>
+    static void fill_inverse_cdf(Engine& rng, Real* out, std::size_t n) {
+        // Uniforms go through a small stack chunk, then transform() in place
+        constexpr std::size_t kChunk = 256;
+        double chunk[kChunk];
+        for (std::size_t i = 0; i < n; i += kChunk) {
+            const std::size_t m = n - i < kChunk ? n - i : kChunk;
+            for (std::size_t j = 0; j < m; ++j) {
+                chunk[j] = uniform(rng);
+            }
+            transform(chunk, chunk, m);
+            for (std::size_t j = 0; j < m; ++j) {
+                out[i + j] = static_cast<Real>(chunk[j]);
+            }
+        }
+    }
+
+    /**
+     * @brief Map uniforms in (0, 1) to standard normals by inverse CDF
+     * 
+     * @param uniforms Input uniforms
+     * @param normals Output normals (may alias uniforms)
+     * @param n Number of variates
+     */
+    static void transform(const double* uniforms, double* normals, std::size_t n);
+
+    /**
+     * @brief Uniform in the open interval (0, 1) from 32 random bits
+     */
+    template <typename Engine>
+    static double uniform(Engine& rng) {
+        return (static_cast<double>(static_cast<std::uint32_t>(rng())) + 0.5) * kTwoPowMinus32;
+    }
+
+    /**
+     * @brief A single standard normal by the ziggurat method
+     */
+    template <typename Engine>
+    static double ziggurat(Engine& rng) {
+        const ZigguratTables& t = tables();
+        const std::int32_t hz = static_cast<std::int32_t>(static_cast<std::uint32_t>(rng()));
+        const std::uint32_t iz = static_cast<std::uint32_t>(hz) & 127u;
+        if (magnitude(hz) < t.kn[iz]) {
+            return hz * t.wn[iz];
+        }
+        return ziggurat_tail(rng, hz, iz);
+    }
+
+private:
+    static constexpr double kTwoPowMinus32 = 1.0 / 4294967296.0;
+
+    struct ZigguratTables {
+        std::uint32_t kn[128];
+        double wn[128];
+        double fn[128];
+    };
+
+    NormalMethod method_;
+
+    static const ZigguratTables& tables();
+
+    static std::uint32_t magnitude(std::int32_t hz) {
+        return static_cast<std::uint32_t>(hz < 0 ? -static_cast<std::int64_t>(hz) : hz);
+    }
+
+    // Rejection step for the ~1% of draws outside the rectangles
+    template <typename Engine>
+    static double ziggurat_tail(Engine& rng, std::int32_t hz, std::uint32_t iz) {
+        constexpr double r = 3.442619855899;
+        const ZigguratTables& t = tables();
+        for (;;) {
+            double x = hz * t.wn[iz];
+            if (iz == 0) {
+                // Sample from the base strip's tail beyond r
+                double y;
+                do {
+                    x = -std::log(uniform(rng)) / r;
+                    y = -std::log(uniform(rng));
+                } while (y + y < x * x);
+                return hz > 0 ? r + x : -r - x;
+            }
+            if (t.fn[iz] + uniform(rng) * (t.fn[iz - 1] - t.fn[iz]) < std::exp(-0.5 * x * x)) {
+                return x;
+            }
+            hz = static_cast<std::int32_t>(static_cast<std::uint32_t>(rng()));
+            iz = static_cast<std::uint32_t>(hz) & 127u;
+            if (magnitude(hz) < t.kn[iz]) {
+                return hz * t.wn[iz];
+            }
+        }
+    }
+};
+
+} // namespace montecarlo
@@ -1,20 +1,172 @@
 #pragma once
-#include "BlackScholesModel.h"
+#include "IPricingModel.h"
 #include "OptionType.h"
+#include "PathPrecision.h"
+#include "PathAccumulator.h"
+#include "PricingWorkspace.h"
+#include "MemoryStats.h"
+#include "NormalGenerator.h"
+#include "PricingKernel.h"
+#include "QuantileSketch.h"
 #include <chrono>
 #include <vector>
 #include <thread>
 #include <mutex>
 #include <atomic>
 #include <memory>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <optional>
 #include "Payoff.h"
 
 namespace montecarlo {
 
+/**
+ * @brief Distribution of the discounted payoff, estimated by streaming quantile sketches
+ * 
+ * value_at_risk and expected_shortfall are losses of the option writer,
+ * whose tail is unbounded: the discounted payoff in excess of the price at
+ * the given confidence, and the mean excess beyond that quantile. The
+ * holder's loss is capped by the premium and can be read off the quantiles.
+ */
+struct PayoffDistribution {
+    std::vector<double> levels;        // Probability levels of the quantiles
+    std::vector<double> quantiles;     // Discounted payoff quantile at each level
+    double confidence = 0.0;           // Confidence of the VaR and expected shortfall
+    double value_at_risk = 0.0;        // Q(confidence) - price
+    double expected_shortfall = 0.0;   // E[payoff | payoff >= Q(confidence)] - price
+    double min = 0.0;                  // Smallest discounted payoff
+    double max = 0.0;                  // Largest discounted payoff
+    std::vector<HistogramBin> histogram;
+};
+
+/**
+ * @brief Estimate returned by every pricer
+ *
+ * standard_error is the standard error of the discounted price, in the same
+ * units as price, whichever pricer produced the result.
+ */
 struct PricingResult {
-    double price;
-    double standard_error;
+    double price;            // Discounted price
+    double standard_error;   // Standard error of the discounted price
     std::chrono::milliseconds computation_time;
+    bool cancelled = false;  // Cancelled before every path completed; estimates cover the completed paths
+    std::optional<PayoffDistribution> distribution = std::nullopt;  // Set when the payoff distribution is enabled
+    std::uint64_t num_paths = 0;     // Paths merged into the estimate (set by OptionPricer)
+    bool deadline_reached = false;   // Stopped at the time budget before every path completed
+    std::optional<MemoryStats> memory = std::nullopt;  // Set by callers reporting memory use (--memory-stats)
+};
+
+/**
+ * @brief Running estimate at one checkpoint of a convergence trace
+ */
+struct ConvergencePoint {
+    std::uint64_t paths;     // Paths merged into this estimate
+    double estimate;         // Discounted price from those paths
+    double standard_error;   // Standard error from those paths
+    double elapsed_ms;       // Time since pricing started
+};
+
+/**
+ * @brief Snapshot of an asynchronous pricing call
+ */
+struct PricingProgress {
+    std::uint64_t paths_completed;  // Paths merged into the estimate so far
+    std::uint64_t total_paths;      // Paths requested
+    double estimate;                // Discounted price from the completed paths (NaN before the first chunk)
+    double standard_error;          // Standard error from the completed paths
+};
+
+/**
+ * @brief Handle to a pricing call running on a background thread
+ * 
+ * Returned by OptionPricer::price_option_async. Progress is published after
+ * every work chunk. Cancellation is cooperative: workers finish the chunk
+ * they are on and claim no more, and get() then returns the estimate from
+ * the completed chunks with PricingResult::cancelled set. At least one chunk
+ * always completes, so even a call cancelled before it started returns a
+ * finite estimate. Destroying a
+ * handle whose result has not been retrieved cancels the call and waits for
+ * it to stop.
+ */
+class PricingHandle {
+public:
+    /**
+     * @brief State shared between the pricing thread and the handle
+     */
+    struct State {
+        std::atomic<bool> cancel_requested{false};
+        std::uint64_t total_paths = 0;
+        double discount = 1.0;
+
+        /**
+         * @brief Merge the sums of a completed chunk into the running estimate
+         */
+        void publish(const PathAccumulator& chunk);
+
+        /**
+         * @brief Current running estimate
+         */
+        PricingProgress snapshot();
+
+    private:
+        std::mutex mutex_;
+        PathAccumulator partial_;
+    };
+
+    PricingHandle() = default;
+    PricingHandle(std::shared_ptr<State> state, std::future<PricingResult> result);
+    ~PricingHandle();
+
+    PricingHandle(PricingHandle&&) noexcept = default;
+    PricingHandle& operator=(PricingHandle&& other) noexcept;
+
+    /**
+     * @brief Whether the handle refers to a call whose result has not been retrieved
+     */
+    bool valid() const { return result_.valid(); }
+
+    /**
+     * @brief Ask the workers to stop at the next chunk boundary
+     */
+    void cancel();
+
+    /**
+     * @brief Whether the call has finished, normally or after cancellation
+     */
+    bool ready() const;
+
+    /**
+     * @brief Wait up to the given time for the call to finish
+     * 
+     * @return bool True if the call has finished
+     */
+    template <typename Rep, typename Period>
+    bool wait_for(const std::chrono::duration<Rep, Period>& timeout) const {
+        return result_.wait_for(timeout) == std::future_status::ready;
+    }
+
+    /**
+     * @brief Wait for the call to finish
+     */
+    void wait() const { result_.wait(); }
+
+    /**
+     * @brief Wait for and retrieve the result, rethrowing any pricing error
+     * 
+     * May be called once; the handle is no longer valid afterwards.
+     */
+    PricingResult get();
+
+    /**
+     * @brief Paths completed so far and the running estimate from them
+     */
+    PricingProgress progress() const;
+
+private:
+    std::shared_ptr<State> state_;
+    std::future<PricingResult> result_;
 };
 
 /**
@@ -28,13 +180,21 @@ public:
     /**
      * @brief Construct a new Option Pricer object
      * 
+     * Geometric Brownian motion models, including those with rate and
+     * volatility term structures (see IPricingModel::terminal_gbm_terms), are
+     * priced by kernels with the dynamics inlined. Any other model is driven
+     * one block at a time through IPricingModel::simulate_terminal, in
+     * double precision whatever the precision setting.
+     * 
      * @param model Reference to the pricing model
      * @param num_simulations Number of Monte Carlo simulations
      * @param num_threads Number of threads for parallel computation
+     * @param precision Precision used for normal draws and path evolution
      */
-    OptionPricer(const BlackScholesModel& model, 
-                unsigned int num_simulations,
-                unsigned int num_threads);
+    OptionPricer(const IPricingModel& model, 
+                std::uint64_t num_simulations,
+                unsigned int num_threads,
+                PathPrecision precision = PathPrecision::Double);
 
     /**
      * @brief Price an option using Monte Carlo simulation
@@ -45,30 +205,344 @@ public:
      */
     PricingResult price_option(const Payoff& payoff, double T);
 
+    /**
+     * @brief Price an option reusing a caller-owned workspace
+     * 
+     * The workspace's worker count determines the degree of parallelism. Once
+     * the workspace is constructed this call performs no heap allocations,
+     * which makes it suitable for tight repricing loops.
+     * 
+     * @param payoff The payoff strategy to use
+     * @param T Time to maturity
+     * @param workspace Worker threads, RNG states and scratch buffers to use
+     * @return PricingResult The pricing result including price, standard error, and computation time
+     */
+    PricingResult price_option(const Payoff& payoff, double T, PricingWorkspace& workspace);
+
+    /**
+     * @brief Start pricing an option on a background thread
+     * 
+     * The returned handle exposes progress and cooperative cancellation, see
+     * PricingHandle. The payoff and this pricer must outlive the call, and
+     * the pricer must not be used for anything else until it finishes. A
+     * seeded run that is not cancelled returns the same price as
+     * price_option. Not available with stratified sampling, whose partial
+     * estimates are biased until every stratum is complete.
+     * 
+     * @param payoff The payoff strategy to use
+     * @param T Time to maturity
+     * @return PricingHandle Handle to the running call, which owns its workspace
+     */
+    PricingHandle price_option_async(const Payoff& payoff, double T);
+
+    /**
+     * @brief Start pricing an option on a background thread with a caller-owned workspace
+     * 
+     * The calling thread of the workspace is the background thread, so the
+     * workspace must outlive the call and not be used by anything else
+     * until it finishes.
+     * 
+     * @param payoff The payoff strategy to use
+     * @param T Time to maturity
+     * @param workspace Worker threads, RNG states and scratch buffers to use
+     * @return PricingHandle Handle to the running call
+     */
+    PricingHandle price_option_async(const Payoff& payoff, double T, PricingWorkspace& workspace);
+
+    /**
+     * @brief Enable importance sampling with a fixed drift shift
+     * 
+     * Each standard normal Z is replaced by Z + shift and the payoff is
+     * weighted by the likelihood ratio exp(-shift * Z - shift^2 / 2), which
+     * keeps the estimator unbiased. A positive shift pushes paths up (useful
+     * for out-of-the-money calls), a negative shift pushes them down.
+     * 
+     * @param shift Shift applied to every normal draw
+     */
+    void set_drift_shift(double shift);
+
+    /**
+     * @brief Enable importance sampling with a shift chosen by a pilot run
+     * 
+     * Before each pricing call a short pilot run evaluates a grid of shifts on
+     * common normals and keeps the one minimizing the relative second moment
+     * of the weighted payoff.
+     * 
+     * @param pilot_paths Number of paths in the pilot run
+     */
+    void enable_automatic_drift_shift(unsigned int pilot_paths = 4096);
+
+    /**
+     * @brief Disable importance sampling
+     */
+    void disable_importance_sampling();
+
+    /**
+     * @brief Drift shift used by the most recent pricing call
+     */
+    double drift_shift() const { return active_drift_shift_; }
+
+    /**
+     * @brief Stratify the terminal normal into equal-probability strata
+     * 
+     * Stratum s covers the probabilities [s / num_strata, (s + 1) / num_strata)
+     * and receives an equal share of the paths, generated by inverse CDF.
+     * Runs of whole strata are scheduled as chunks, so every stratum keeps its
+     * full share of paths, and the standard error is estimated from the
+     * within-stratum variances.
+     * 
+     * @param num_strata Number of strata (0 disables stratification)
+     */
+    void set_stratification(unsigned int num_strata) { num_strata_ = num_strata; }
+
+    /**
+     * @brief Ratio of plain Monte Carlo to stratified variance in the last stratified run
+     * 
+     * Computed as (within + between) / within stratum variance; 1 when
+     * stratification is disabled.
+     */
+    double variance_reduction() const { return variance_reduction_; }
+
+    /**
+     * @brief Select the algorithm used to draw the terminal normals
+     * 
+     * @param method Ziggurat (default) or vectorized inverse CDF
+     */
+    void set_normal_method(NormalMethod method) { normal_generator_ = NormalGenerator(method); }
+
+    /**
+     * @brief Algorithm used to draw the terminal normals
+     */
+    NormalMethod normal_method() const { return normal_generator_.method(); }
+
+    /**
+     * @brief Bound the wall-clock time of every pricing call
+     * 
+     * num_simulations becomes an upper bound: workers claim chunks until the
+     * budget, measured from the start of the call, runs out, and the call
+     * returns the estimate from the chunks completed by then with
+     * PricingResult::num_paths and deadline_reached set. A chunk started
+     * before the deadline runs to completion, so the call can overrun by up
+     * to one chunk (see set_chunk_size); at least one chunk always completes.
+     * Which chunks complete depends on timing, so sums are kept per worker
+     * and a seeded run matches an unbounded one only up to summation order.
+     * Not available with stratified sampling.
+     * 
+     * With an accuracy floor the call throws AccuracyError instead of
+     * returning an estimate whose standard error is above it. Once a tenth of
+     * the budget has passed, the standard error reachable by the deadline is
+     * projected from the throughput so far after every chunk, and the call
+     * fails as soon as the projection misses the floor, without spending the
+     * rest of the budget.
+     * 
+     * @param budget Time budget per call (zero disables the deadline)
+     * @param max_standard_error Largest acceptable standard error (0 disables the floor)
+     */
+    void set_deadline(std::chrono::nanoseconds budget, double max_standard_error = 0.0);
+
+    /**
+     * @brief Price every path again, without a time budget
+     */
+    void clear_deadline() { deadline_ = std::chrono::nanoseconds::zero(); max_standard_error_ = 0.0; }
+
+    /**
+     * @brief Set the number of paths per dynamically scheduled chunk
+     * 
+     * Rounded up to whole blocks of PricingWorkspace::kBlockSize paths; 0
+     * restores the default PricingWorkspace::kChunkSize. Smaller chunks balance
+     * load better across uneven cores, larger ones cost less scheduling.
+     * Chunks draw from their own RNG streams, so seeded results depend on the
+     * chunk size (but still not on the number of threads).
+     * 
+     * @param paths Minimum paths per chunk
+     */
+    void set_chunk_size(std::uint64_t paths);
+
+    /**
+     * @brief Paths per chunk used by pricing calls
+     */
+    std::uint64_t chunk_size() const { return chunk_size_; }
+
+    /**
+     * @brief Run small jobs on the calling thread only
+     * 
+     * price_option and price_option_async without a workspace build one with
+     * num_threads workers per call. Below the given number of paths starting
+     * the extra threads costs more than it saves, so a single worker is used.
+     * Calls with a caller-owned workspace are not affected.
+     * 
+     * @param paths Path count below which pricing is single-threaded (0 disables)
+     */
+    void set_serial_threshold(std::uint64_t paths) { serial_threshold_ = paths; }
+
+    /**
+     * @brief Callback receiving convergence checkpoints as they are produced
+     */
+    using ConvergenceCallback = std::function<void(const ConvergencePoint&)>;
+
+    /**
+     * @brief Record the running estimate at geometric path-count checkpoints
+     * 
+     * Workers publish their partial sums after every chunk of paths and a
+     * reporter thread merges them, so no worker ever waits for another. A
+     * point is emitted the first time the merged path count reaches each of
+     * first_checkpoint, first_checkpoint * growth, ..., and a final point
+     * always covers all paths. The final price is identical to an untraced
+     * run with the same seed. Not available with stratified sampling, whose
+     * partial estimates are biased until every stratum is complete.
+     * 
+     * @param first_checkpoint Path count of the first checkpoint
+     * @param growth Ratio between consecutive checkpoints (> 1)
+     * @param callback Optional callback, invoked on the reporter thread
+     */
+    void enable_convergence_trace(std::uint64_t first_checkpoint = 4096,
+                                  double growth = 2.0,
+                                  ConvergenceCallback callback = nullptr);
+
+    /**
+     * @brief Stop recording convergence traces
+     */
+    void disable_convergence_trace();
+
+    /**
+     * @brief Checkpoints recorded by the most recent traced pricing call
+     */
+    const std::vector<ConvergencePoint>& convergence_trace() const { return trace_; }
+
+    /**
+     * @brief Report quantiles, VaR, expected shortfall and a histogram of the payoff
+     * 
+     * Every worker adds its payoffs to a quantile sketch of a few KB with 1%
+     * relative accuracy, merged when the run ends; PricingResult::distribution
+     * then holds the summary. Under importance sampling each payoff is
+     * weighted by its likelihood ratio, so the distribution is the one under
+     * the pricing measure. Sketches merge by adding bucket counts, so a
+     * seeded run without importance sampling reports the same distribution
+     * whatever the number of workers. Not available with stratified sampling.
+     * 
+     * @param confidence Confidence level of the VaR and expected shortfall, in (0, 1)
+     * @param histogram_bins Number of equal-width histogram bins
+     * @param levels Probability levels of the reported quantiles, in [0, 1]
+     */
+    void enable_payoff_distribution(double confidence = 0.99,
+                                    unsigned int histogram_bins = 20,
+                                    std::vector<double> levels = {0.01, 0.05, 0.25, 0.5, 0.75, 0.95, 0.99});
+
+    /**
+     * @brief Stop reporting the payoff distribution
+     */
+    void disable_payoff_distribution() { distribution_enabled_ = false; }
+
 private:
     // Model reference
-    const BlackScholesModel& model_;
+    const IPricingModel& model_;
     
     // Simulation parameters
-    unsigned int num_simulations_;
+    std::uint64_t num_simulations_;
     unsigned int num_threads_;
+    PathPrecision precision_;
+    NormalGenerator normal_generator_;
+    std::uint64_t chunk_size_ = PricingWorkspace::kChunkSize;
+    std::uint64_t serial_threshold_ = 0;
+
+    // Time budget per call (zero when unbounded) and accuracy floor
+    std::chrono::nanoseconds deadline_{0};
+    double max_standard_error_ = 0.0;
+
+    // Importance sampling parameters
+    double drift_shift_ = 0.0;
+    bool automatic_drift_shift_ = false;
+    unsigned int pilot_paths_ = 0;
+    double active_drift_shift_ = 0.0;
+
+    // Stratified sampling parameters
+    unsigned int num_strata_ = 0;
+    double variance_reduction_ = 1.0;
+
+    // Convergence trace parameters
+    bool trace_enabled_ = false;
+    std::uint64_t trace_first_checkpoint_ = 0;
+    double trace_growth_ = 2.0;
+    ConvergenceCallback trace_callback_;
+    std::vector<ConvergencePoint> trace_;
+
+    // Payoff distribution parameters; sketches are kept between calls
+    bool distribution_enabled_ = false;
+    double distribution_confidence_ = 0.99;
+    unsigned int histogram_bins_ = 20;
+    std::vector<double> distribution_levels_;
+    std::vector<QuantileSketch> sketches_;
+
+    /**
+     * @brief Worker count of a workspace built for one call
+     */
+    unsigned int workers_for_call() const {
+        return num_simulations_ < serial_threshold_ ? 1u : num_threads_;
+    }
+
+    /**
+     * @brief Kernel inputs for one pricing call
+     * 
+     * @param payoff The payoff strategy to use
+     * @param T Time to maturity
+     * @param kind Receives the payoff family used to select the kernel
+     * @return KernelParams Path constants folded in double precision
+     */
+    KernelParams make_kernel_params(const Payoff& payoff, double T, PayoffKind& kind) const;
+
+    /**
+     * @brief Shared body of price_option and price_option_async
+     * 
+     * @param async Progress and cancellation state of an asynchronous call, or nullptr
+     */
+    PricingResult price(const Payoff& payoff, double T, PricingWorkspace& workspace,
+                        PricingHandle::State* async);
+
+    /**
+     * @brief Start an asynchronous call after checking it is supported
+     */
+    PricingHandle launch_async(double T, std::function<PricingResult(PricingHandle::State*)> body);
+
+    /**
+     * @brief Empty per-worker sketches for a call, or nullptr when the distribution is disabled
+     */
+    QuantileSketch* prepare_sketches(std::size_t num_workers);
+
+    /**
+     * @brief Merge the per-worker sketches and summarize the discounted payoff distribution
+     *
+     * Fills the distribution in place, so the result never copies or moves it.
+     */
+    void summarize_distribution(double discount, double price, PayoffDistribution& distribution);
+
+    /**
+     * @brief Stratified pricing path of price_option
+     */
+    PricingResult price_stratified(const KernelEntry& kernel,
+                                   const KernelParams& params,
+                                   double T,
+                                   PricingWorkspace& workspace,
+                                   std::chrono::high_resolution_clock::time_point start_time);
+
+    /**
+     * @brief Traced plain Monte Carlo path of price_option
+     */
+    PricingResult price_traced(const KernelEntry& kernel,
+                               const KernelParams& params,
+                               double T,
+                               PricingWorkspace& workspace,
+                               std::chrono::high_resolution_clock::time_point start_time,
+                               PricingHandle::State* async);
 
     /**
-     * @brief Simulate a range of paths and accumulate results
+     * @brief Choose a drift shift from a pilot run on worker 0's stream
      * 
-     * @param start_idx Starting index of the simulation range
-     * @param end_idx Ending index of the simulation range
-     * @param sum_payoffs Reference to accumulate sum of payoffs
-     * @param sum_squared_payoffs Reference to accumulate sum of squared payoffs
      * @param payoff The payoff strategy to use
      * @param T Time to maturity
+     * @param state Worker state providing the RNG and scratch space
+     * @return double Shift minimizing the estimated relative second moment
      */
-    void simulate_range(unsigned int start_idx,
-                       unsigned int end_idx,
-                       double& sum_payoffs,
-                       double& sum_squared_payoffs,
-                       const Payoff& payoff,
-                       double T);
+    double find_drift_shift(const Payoff& payoff, double T, PricingWorkspace::WorkerState& state) const;
 
     /**
      * @brief Calculate the payoff for a given terminal price
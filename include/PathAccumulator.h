@@ -0,0 +1,256 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+namespace montecarlo {
+
+/**
+ * @brief Neumaier-compensated running sum
+ *
+ * Keeps the rounding error of every addition in a separate term so that long
+ * per-thread sums of payoffs do not drift, regardless of the precision the
+ * payoffs were computed in.
+ */
+struct CompensatedSum {
+    double sum = 0.0;
+    double compensation = 0.0;
+
+    void add(double value) {
+        double t = sum + value;
+        if ((sum >= 0.0 ? sum : -sum) >= (value >= 0.0 ? value : -value)) {
+            compensation += (sum - t) + value;
+        } else {
+            compensation += (value - t) + sum;
+        }
+        sum = t;
+    }
+
+    double value() const { return sum + compensation; }
+};
+
+/**
+ * @brief Per-thread accumulator of payoff moments
+ */
+struct PathAccumulator {
+    CompensatedSum sum;
+    CompensatedSum sum_squared;
+    std::size_t count = 0;
+
+    void add(double payoff_value) {
+        sum.add(payoff_value);
+        sum_squared.add(payoff_value * payoff_value);
+        ++count;
+    }
+
+    void merge(const PathAccumulator& other) {
+        sum.add(other.sum.value());
+        sum_squared.add(other.sum_squared.value());
+        count += other.count;
+    }
+
+    double mean() const {
+        return count > 0 ? sum.value() / count : 0.0;
+    }
+
+    double standard_error() const {
+        if (count == 0) {
+            return 0.0;
+        }
+        double m = mean();
+        double variance = sum_squared.value() / count - m * m;
+        return std::sqrt((variance > 0.0 ? variance : 0.0) / count);
+    }
+};
+
+/**
+ * @brief Accumulator for a stratified estimator with equal-probability strata
+ * 
+ * Each completed stratum contributes its mean and the variance of that mean.
+ * The estimator is the average of the stratum means; its variance is the
+ * within-stratum part only, while the spread of the stratum means is the
+ * between-stratum variance that stratification removes.
+ */
+struct StratifiedAccumulator {
+    CompensatedSum sum_means;
+    CompensatedSum sum_squared_means;
+    CompensatedSum sum_mean_variances;   // Sum over strata of Var(mean_s)
+    CompensatedSum sum_variances;        // Sum over strata of Var(Y | stratum s)
+    std::size_t num_strata = 0;
+
+    void add_stratum(const PathAccumulator& stratum) {
+        double m = stratum.mean();
+        double se = stratum.standard_error();
+        sum_means.add(m);
+        sum_squared_means.add(m * m);
+        sum_mean_variances.add(se * se);
+        sum_variances.add(se * se * stratum.count);
+        ++num_strata;
+    }
+
+    void merge(const StratifiedAccumulator& other) {
+        sum_means.add(other.sum_means.value());
+        sum_squared_means.add(other.sum_squared_means.value());
+        sum_mean_variances.add(other.sum_mean_variances.value());
+        sum_variances.add(other.sum_variances.value());
+        num_strata += other.num_strata;
+    }
+
+    double mean() const {
+        return num_strata > 0 ? sum_means.value() / num_strata : 0.0;
+    }
+
+    double standard_error() const {
+        return num_strata > 0 ? std::sqrt(sum_mean_variances.value()) / num_strata : 0.0;
+    }
+
+    /**
+     * @brief Average variance of a single draw within a stratum
+     */
+    double within_variance() const {
+        return num_strata > 0 ? sum_variances.value() / num_strata : 0.0;
+    }
+
+    /**
+     * @brief Variance of the stratum means across strata
+     */
+    double between_variance() const {
+        if (num_strata == 0) {
+            return 0.0;
+        }
+        double m = mean();
+        double v = sum_squared_means.value() / num_strata - m * m;
+        return v > 0.0 ? v : 0.0;
+    }
+};
+
+/**
+ * @brief Accumulator for batch-means standard errors
+ * 
+ * Used when draws within a batch are not independent (e.g. one Latin
+ * hypercube sample per batch) but batches are. The mean is the path-weighted
+ * mean, and the standard error follows from the spread of the batch means.
+ */
+struct BatchMeansAccumulator {
+    CompensatedSum sum;                 // sum_b n_b m_b
+    CompensatedSum sum_weighted_sq;     // sum_b n_b^2 m_b^2
+    CompensatedSum sum_weighted;        // sum_b n_b^2 m_b
+    CompensatedSum sum_sizes_sq;        // sum_b n_b^2
+    std::size_t count = 0;
+    std::size_t num_batches = 0;
+
+    void add_batch(const PathAccumulator& batch) {
+        double n = static_cast<double>(batch.count);
+        double m = batch.mean();
+        sum.add(n * m);
+        sum_weighted_sq.add(n * n * m * m);
+        sum_weighted.add(n * n * m);
+        sum_sizes_sq.add(n * n);
+        count += batch.count;
+        ++num_batches;
+    }
+
+    void merge(const BatchMeansAccumulator& other) {
+        sum.add(other.sum.value());
+        sum_weighted_sq.add(other.sum_weighted_sq.value());
+        sum_weighted.add(other.sum_weighted.value());
+        sum_sizes_sq.add(other.sum_sizes_sq.value());
+        count += other.count;
+        num_batches += other.num_batches;
+    }
+
+    double mean() const {
+        return count > 0 ? sum.value() / count : 0.0;
+    }
+
+    double standard_error() const {
+        if (num_batches < 2) {
+            return 0.0;
+        }
+        double m = mean();
+        double spread = sum_weighted_sq.value() - 2.0 * m * sum_weighted.value() + m * m * sum_sizes_sq.value();
+        double b = static_cast<double>(num_batches);
+        double variance = spread * b / (b - 1.0) / (static_cast<double>(count) * count);
+        return std::sqrt(variance > 0.0 ? variance : 0.0);
+    }
+};
+
+/**
+ * @brief Per-thread accumulator for a control-variate estimator
+ * 
+ * Tracks the joint moments of a target payoff Y and a control C whose
+ * expectation is known, so the optimal coefficient beta = Cov(Y, C) / Var(C)
+ * can be estimated from the same paths.
+ */
+struct ControlVariateAccumulator {
+    CompensatedSum sum_y;
+    CompensatedSum sum_c;
+    CompensatedSum sum_yy;
+    CompensatedSum sum_cc;
+    CompensatedSum sum_yc;
+    std::size_t count = 0;
+
+    void add(double y, double c) {
+        sum_y.add(y);
+        sum_c.add(c);
+        sum_yy.add(y * y);
+        sum_cc.add(c * c);
+        sum_yc.add(y * c);
+        ++count;
+    }
+
+    void merge(const ControlVariateAccumulator& other) {
+        sum_y.add(other.sum_y.value());
+        sum_c.add(other.sum_c.value());
+        sum_yy.add(other.sum_yy.value());
+        sum_cc.add(other.sum_cc.value());
+        sum_yc.add(other.sum_yc.value());
+        count += other.count;
+    }
+
+    /**
+     * @brief Control-variate adjusted mean of Y
+     * 
+     * @param control_mean Known expectation of the control
+     */
+    double mean(double control_mean) const {
+        if (count == 0) {
+            return 0.0;
+        }
+        double mean_y = sum_y.value() / count;
+        double mean_c = sum_c.value() / count;
+        return mean_y - beta() * (mean_c - control_mean);
+    }
+
+    /**
+     * @brief Standard error of the adjusted mean (residual variance of Y given C)
+     */
+    double standard_error() const {
+        if (count == 0) {
+            return 0.0;
+        }
+        double mean_y = sum_y.value() / count;
+        double mean_c = sum_c.value() / count;
+        double var_y = sum_yy.value() / count - mean_y * mean_y;
+        double var_c = sum_cc.value() / count - mean_c * mean_c;
+        double cov = sum_yc.value() / count - mean_y * mean_c;
+        double residual = var_c > 0.0 ? var_y - cov * cov / var_c : var_y;
+        return std::sqrt((residual > 0.0 ? residual : 0.0) / count);
+    }
+
+    /**
+     * @brief Estimated optimal control coefficient Cov(Y, C) / Var(C)
+     */
+    double beta() const {
+        if (count == 0) {
+            return 0.0;
+        }
+        double mean_y = sum_y.value() / count;
+        double mean_c = sum_c.value() / count;
+        double var_c = sum_cc.value() / count - mean_c * mean_c;
+        double cov = sum_yc.value() / count - mean_y * mean_c;
+        return var_c > 0.0 ? cov / var_c : 0.0;
+    }
+};
+
+} // namespace montecarlo
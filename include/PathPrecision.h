@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+
+namespace montecarlo {
+
+/**
+ * @brief Floating-point precision used to generate and evolve paths
+ *
+ * Payoff statistics are always accumulated in (compensated) double precision;
+ * this only selects the type used for normal draws and path evolution.
+ */
+enum class PathPrecision {
+    Double,   ///< Normals and paths in double precision
+    Single    ///< Normals and paths in float, sums in compensated double
+};
+
+/**
+ * @brief Convert a path precision to its configuration string
+ *
+ * @param precision Path precision
+ * @return const char* "double" or "float"
+ */
+inline const char* to_string(PathPrecision precision) {
+    return precision == PathPrecision::Single ? "float" : "double";
+}
+
+} // namespace montecarlo
@@ -1,9 +1,19 @@
 #pragma once
 
+#include "OptionType.h"
 #include <memory>
+#include <optional>
 
 namespace montecarlo {
 
+/**
+ * @brief Type and strike of a plain vanilla payoff
+ */
+struct VanillaTerms {
+    OptionType type;
+    double strike;
+};
+
 /**
  * @brief Abstract base class for option payoff strategies
  * 
@@ -29,6 +39,16 @@ public:
      * @return std::unique_ptr<Payoff> A new copy of the payoff object
      */
     virtual std::unique_ptr<Payoff> clone() const = 0;
+
+    /**
+     * @brief Type and strike when this is a plain vanilla payoff
+     * 
+     * Lets the pricer select a kernel with the payoff inlined. Other payoffs
+     * return nothing and are evaluated through calculate().
+     * 
+     * @return std::optional<VanillaTerms> Vanilla terms, if any
+     */
+    virtual std::optional<VanillaTerms> vanilla_terms() const { return std::nullopt; }
 };
 
 } // namespace montecarlo 
\ No newline at end of file
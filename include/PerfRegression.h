@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace montecarlo {
+
+/**
+ * @brief One entry of the performance regression matrix
+ */
+struct PerfWorkload {
+    std::string name;
+    std::uint64_t paths;           // Paths priced by one call of run
+    std::function<void()> run;     // Prices the workload once
+};
+
+/**
+ * @brief Measured performance of one workload
+ */
+struct PerfSample {
+    std::string name;
+    std::uint64_t paths = 0;
+    unsigned int repeats = 0;
+    double paths_per_second = 0.0;  // From the median latency
+    double latency_p50_ms = 0.0;
+    double latency_p90_ms = 0.0;
+    double latency_p99_ms = 0.0;
+    double noise = 0.0;             // Relative median absolute deviation of the latencies
+    std::size_t peak_memory_kb = 0; // Peak memory of the workload above what was in use before it
+};
+
+/**
+ * @brief Stored measurements that later runs are compared against
+ */
+struct PerfBaseline {
+    static constexpr int kVersion = 2;  // 2: peak_memory_kb is per workload
+
+    int version = kVersion;
+    unsigned int hardware_threads = 0;
+    std::vector<PerfSample> samples;
+
+    /**
+     * @brief Load a baseline from a JSON file
+     * 
+     * @param filename Path to the baseline file
+     * @return PerfBaseline Loaded baseline
+     * @throws ConfigError if the file is missing, malformed or of another version
+     */
+    static PerfBaseline load(const std::string& filename);
+
+    /**
+     * @brief Write the baseline to a JSON file
+     * 
+     * @param filename Path to the baseline file
+     */
+    void save(const std::string& filename) const;
+
+    /**
+     * @brief Sample with the given workload name, or nullptr
+     */
+    const PerfSample* find(const std::string& name) const;
+};
+
+/**
+ * @brief Tolerances for declaring a regression
+ */
+struct PerfThresholds {
+    double throughput = 0.10;       // Allowed relative drop in paths/sec
+    double memory = 0.20;           // Allowed relative growth of the memory high-water mark
+    double noise_multiplier = 3.0;  // Drops within this many combined noise levels are ignored
+};
+
+/**
+ * @brief Result of comparing a run against a baseline
+ */
+struct PerfComparison {
+    struct Row {
+        std::string name;
+        double baseline_paths_per_second = 0.0;
+        double current_paths_per_second = 0.0;
+        double change = 0.0;          // Relative throughput change (negative is slower)
+        double allowed = 0.0;         // Allowed drop after noise widening
+        double memory_change = 0.0;   // Relative memory high-water mark change
+        bool regressed = false;
+        std::string status;           // "ok", "REGRESSED", "new", "missing" or "resized"
+    };
+
+    std::vector<Row> rows;
+
+    /**
+     * @brief Whether any workload regressed
+     */
+    bool regressed() const;
+
+    /**
+     * @brief Human-readable table of the comparison
+     */
+    std::string format() const;
+};
+
+/**
+ * @brief Linearly interpolated percentile of a set of values
+ * 
+ * @param values Values (need not be sorted)
+ * @param q Quantile in [0, 1]
+ * @return double The q-th percentile, or 0 for an empty set
+ */
+double percentile(std::vector<double> values, double q);
+
+/**
+ * @brief Median absolute deviation relative to the median
+ * 
+ * A robust noise estimate that ignores the occasional preempted run.
+ * 
+ * @param values Values (need not be sorted)
+ * @return double MAD / median, or 0 when the median is 0
+ */
+double relative_mad(const std::vector<double>& values);
+
+/**
+ * @brief Peak resident set size of this process in KiB
+ */
+std::size_t peak_memory_kb();
+
+/**
+ * @brief Time a workload after a warm-up run
+ * 
+ * The memory figure is the workload's own: the heap high-water mark above
+ * the bytes live before the warm-up when the counting allocator is linked,
+ * otherwise the growth of the resident set sampled after each run.
+ * 
+ * @param workload Workload to run
+ * @param repeats Number of timed runs
+ * @return PerfSample Throughput, latency percentiles, noise and memory
+ */
+PerfSample measure(const PerfWorkload& workload, unsigned int repeats);
+
+/**
+ * @brief Compare measured samples against a baseline
+ * 
+ * A workload regresses when its throughput drops by more than
+ * max(thresholds.throughput, noise_multiplier * combined noise), or when its
+ * memory high-water mark grows by more than thresholds.memory.
+ * 
+ * @param baseline Stored baseline
+ * @param current Samples from this run
+ * @param thresholds Tolerances
+ * @return PerfComparison One row per workload in either set
+ */
+PerfComparison compare(const PerfBaseline& baseline,
+                       const std::vector<PerfSample>& current,
+                       const PerfThresholds& thresholds);
+
+/**
+ * @brief The fixed matrix of pricing workloads
+ * 
+ * Covers the plain, single-precision, inverse-CDF, stratified and
+ * importance-sampled Black-Scholes pricer, plus the jump, local volatility
+ * and basket pricers. All workloads share one seeded workspace.
+ * 
+ * @param num_threads Worker count for the shared workspace
+ * @param scale Multiplier on the default path counts
+ * @return std::vector<PerfWorkload> Workloads in a fixed order
+ */
+std::vector<PerfWorkload> standard_workloads(unsigned int num_threads, double scale = 1.0);
+
+} // namespace montecarlo
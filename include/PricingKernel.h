@@ -0,0 +1,318 @@
+#pragma once
+
+#include "IPricingModel.h"
+#include "NormalGenerator.h"
+#include "OptionType.h"
+#include "PathAccumulator.h"
+#include "PathPrecision.h"
+#include "Payoff.h"
+#include "PricingWorkspace.h"
+#include "QuantileSketch.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+namespace montecarlo {
+
+/**
+ * @brief Runtime inputs shared by every single-step pricing kernel
+ * 
+ * Filled once per pricing call; the kernel narrows what it needs to its
+ * path precision before entering the path loop.
+ */
+struct KernelParams {
+    double S0 = 0.0;
+    double drift = 0.0;               // (r - sigma^2 / 2) T, plus the importance-sampling shift
+    double diffusion = 0.0;           // sigma sqrt(T)
+    const IPricingModel* model = nullptr;  // Used by the generic model policy
+    double maturity = 0.0;                 // Used by the generic model policy
+    double shift = 0.0;               // Importance-sampling shift of the normal draw
+    double half_shift_squared = 0.0;
+    double strike = 0.0;              // Used by the vanilla payoff policies
+    const Payoff* payoff = nullptr;   // Used by the generic payoff policy
+    std::uint64_t num_simulations = 0;
+    unsigned int num_strata = 0;
+};
+
+/**
+ * @brief Model policy: exact one-step geometric Brownian motion
+ */
+template <typename Real>
+struct GbmTerminal {
+    Real S0;
+    Real drift;
+    Real diffusion;
+
+    explicit GbmTerminal(const KernelParams& params)
+        : S0(static_cast<Real>(params.S0)),
+          drift(static_cast<Real>(params.drift)),
+          diffusion(static_cast<Real>(params.diffusion)) {}
+
+    /**
+     * @brief Map a block of normals to terminal prices in place
+     */
+    void evolve(Real* block, unsigned int n) const {
+        for (unsigned int j = 0; j < n; ++j) {
+            block[j] = S0 * std::exp(drift + diffusion * block[j]);
+        }
+    }
+};
+
+/**
+ * @brief Model policy: any IPricingModel, one simulate_terminal call per block
+ * 
+ * Runs in double precision only, the precision of the model interface. The
+ * importance-sampling shift is added to the normals before the call.
+ */
+template <typename Real>
+struct ModelTerminal {
+    static_assert(std::is_same_v<Real, double>, "IPricingModel evolves paths in double precision");
+
+    const IPricingModel* model;
+    double maturity;
+    double shift;
+
+    explicit ModelTerminal(const KernelParams& params)
+        : model(params.model),
+          maturity(params.maturity),
+          shift(params.shift) {}
+
+    void evolve(double* block, unsigned int n) const {
+        if (shift != 0.0) {
+            for (unsigned int j = 0; j < n; ++j) {
+                block[j] += shift;
+            }
+        }
+        model->simulate_terminal(block, block, n, maturity);
+    }
+};
+
+/**
+ * @brief Payoff policy: vanilla call or put with the type fixed at compile time
+ */
+template <OptionType Type>
+struct VanillaPolicy {
+    static constexpr OptionType type = Type;
+    double strike;
+
+    explicit VanillaPolicy(const KernelParams& params) : strike(params.strike) {}
+
+    double operator()(double S_T) const {
+        if constexpr (Type == OptionType::Call) {
+            return std::max(S_T - strike, 0.0);
+        } else {
+            return std::max(strike - S_T, 0.0);
+        }
+    }
+};
+
+/**
+ * @brief Payoff policy: any Payoff, called through its virtual interface
+ */
+struct GenericPayoffPolicy {
+    const Payoff* payoff;
+
+    explicit GenericPayoffPolicy(const KernelParams& params) : payoff(params.payoff) {}
+
+    double operator()(double S_T) const { return payoff->calculate(S_T); }
+};
+
+/**
+ * @brief Normal policies selecting the NormalGenerator algorithm at compile time
+ */
+struct ZigguratNormals {
+    static constexpr NormalMethod method = NormalMethod::Ziggurat;
+
+    template <typename Engine, typename Real>
+    static void fill(Engine& rng, Real* out, std::size_t n) {
+        NormalGenerator::fill_ziggurat(rng, out, n);
+    }
+};
+
+struct InverseCdfNormals {
+    static constexpr NormalMethod method = NormalMethod::InverseCdf;
+
+    template <typename Engine, typename Real>
+    static void fill(Engine& rng, Real* out, std::size_t n) {
+        NormalGenerator::fill_inverse_cdf(rng, out, n);
+    }
+};
+
+/**
+ * @brief Block pricing kernel specialized on model, payoff, RNG and precision
+ * 
+ * Every policy call is resolved at compile time, so the only indirect call
+ * in a pricing run is the one through the dispatch table that selected the
+ * kernel. Weighted kernels apply the importance-sampling likelihood ratio.
+ * 
+ * @tparam Model Model policy template (GbmTerminal or ModelTerminal)
+ * @tparam PayoffPolicy Payoff policy (e.g. VanillaPolicy<OptionType::Call>)
+ * @tparam Normals Normal policy (ZigguratNormals or InverseCdfNormals)
+ * @tparam Real Path precision
+ * @tparam Weighted Whether the draws carry an importance-sampling shift
+ */
+template <template <typename> class Model, typename PayoffPolicy, typename Normals,
+          typename Real, bool Weighted>
+struct PathKernel {
+    static constexpr unsigned int kBlockSize = static_cast<unsigned int>(PricingWorkspace::kBlockSize);
+
+    /**
+     * @brief Evolve a block of normals and accumulate its (weighted) payoffs
+     * 
+     * @tparam Track Whether to also add each payoff, with its likelihood ratio
+     *               as weight, to a quantile sketch
+     * @param block Normals on entry, terminal prices on exit
+     * @param weights Scratch for the likelihood ratios (unused when unweighted)
+     */
+    template <bool Track = false>
+    static void evaluate(const KernelParams& params, const Model<Real>& model, const PayoffPolicy& payoff,
+                         Real* block, double* weights, unsigned int n, PathAccumulator& accumulator,
+                         QuantileSketch* sketch = nullptr) {
+        if constexpr (Weighted) {
+            for (unsigned int j = 0; j < n; ++j) {
+                weights[j] = std::exp(-params.shift * static_cast<double>(block[j]) - params.half_shift_squared);
+            }
+        }
+        model.evolve(block, n);
+        for (unsigned int j = 0; j < n; ++j) {
+            double value = payoff(static_cast<double>(block[j]));
+            if constexpr (Track) {
+                sketch->add(value, Weighted ? weights[j] : 1.0);
+            }
+            if constexpr (Weighted) {
+                value *= weights[j];
+            }
+            accumulator.add(value);
+        }
+    }
+
+    /**
+     * @brief Simulate paths [first, last) into an accumulator and, when tracking, a sketch
+     */
+    template <bool Track>
+    static void simulate_range(const KernelParams& params, std::uint64_t first, std::uint64_t last,
+                               PricingWorkspace::WorkerState& state, PathAccumulator& accumulator,
+                               QuantileSketch* sketch) {
+        const Model<Real> model(params);
+        const PayoffPolicy payoff(params);
+        Real* block = state.buffer<Real>();
+        double* weights = Weighted ? state.scratch_buffer(PricingWorkspace::kBlockSize) : nullptr;
+
+        for (std::uint64_t i = first; i < last; i += kBlockSize) {
+            unsigned int n = static_cast<unsigned int>(std::min<std::uint64_t>(kBlockSize, last - i));
+            Normals::fill(state.rng, block, n);
+            evaluate<Track>(params, model, payoff, block, weights, n, accumulator, sketch);
+        }
+    }
+
+    /**
+     * @brief Simulate paths [first, last) into an accumulator
+     */
+    static void simulate(const KernelParams& params, std::uint64_t first, std::uint64_t last,
+                         PricingWorkspace::WorkerState& state, PathAccumulator& accumulator) {
+        simulate_range<false>(params, first, last, state, accumulator, nullptr);
+    }
+
+    /**
+     * @brief Simulate paths [first, last), also adding every payoff to a sketch
+     */
+    static void simulate_tracked(const KernelParams& params, std::uint64_t first, std::uint64_t last,
+                                 PricingWorkspace::WorkerState& state, PathAccumulator& accumulator,
+                                 QuantileSketch& sketch) {
+        simulate_range<true>(params, first, last, state, accumulator, &sketch);
+    }
+
+    /**
+     * @brief Simulate whole strata [first_stratum, last_stratum)
+     * 
+     * Stratum s draws its normals by inverse CDF from [s / S, (s + 1) / S),
+     * whatever the normal policy, and accumulates into strata[s].
+     */
+    static void simulate_strata(const KernelParams& params, std::uint64_t first_stratum, std::uint64_t last_stratum,
+                                PricingWorkspace::WorkerState& state, PathAccumulator* strata) {
+        const Model<Real> model(params);
+        const PayoffPolicy payoff(params);
+        Real* block = state.buffer<Real>();
+        // Scratch layout: weights | uniforms
+        double* weights = state.scratch_buffer(2 * PricingWorkspace::kBlockSize);
+        double* uniforms = weights + PricingWorkspace::kBlockSize;
+
+        const std::uint64_t paths_per_stratum = params.num_simulations / params.num_strata;
+        const std::uint64_t extra_paths = params.num_simulations % params.num_strata;
+        const double stratum_width = 1.0 / params.num_strata;
+
+        for (std::uint64_t s = first_stratum; s < last_stratum; ++s) {
+            std::uint64_t stratum_paths = paths_per_stratum + (s < extra_paths ? 1 : 0);
+            PathAccumulator& stratum = strata[s];
+
+            for (std::uint64_t i = 0; i < stratum_paths; i += kBlockSize) {
+                unsigned int n = static_cast<unsigned int>(std::min<std::uint64_t>(kBlockSize, stratum_paths - i));
+                for (unsigned int j = 0; j < n; ++j) {
+                    uniforms[j] = (static_cast<double>(s) + NormalGenerator::uniform(state.rng)) * stratum_width;
+                }
+                NormalGenerator::transform(uniforms, uniforms, n);
+                for (unsigned int j = 0; j < n; ++j) {
+                    block[j] = static_cast<Real>(uniforms[j]);
+                }
+                evaluate(params, model, payoff, block, weights, n, stratum);
+            }
+        }
+    }
+};
+
+/**
+ * @brief Payoff families with a dedicated kernel
+ */
+enum class PayoffKind {
+    Call,     ///< Inlined vanilla call
+    Put,      ///< Inlined vanilla put
+    Generic   ///< Any other payoff, through its virtual interface
+};
+
+/**
+ * @brief Model families with a dedicated kernel
+ */
+enum class ModelKind {
+    Gbm,      ///< Inlined geometric Brownian motion
+    Generic   ///< Any other model, through IPricingModel::simulate_terminal
+};
+
+/**
+ * @brief One row of the kernel dispatch table
+ */
+struct KernelEntry {
+    void (*simulate)(const KernelParams&, std::uint64_t, std::uint64_t,
+                     PricingWorkspace::WorkerState&, PathAccumulator&);
+    void (*simulate_strata)(const KernelParams&, std::uint64_t, std::uint64_t,
+                            PricingWorkspace::WorkerState&, PathAccumulator*);
+    void (*simulate_tracked)(const KernelParams&, std::uint64_t, std::uint64_t,
+                             PricingWorkspace::WorkerState&, PathAccumulator&, QuantileSketch&);
+};
+
+/**
+ * @brief Classify a payoff for kernel selection
+ * 
+ * @param payoff Payoff to classify
+ * @param strike Receives the strike of a vanilla payoff
+ * @return PayoffKind Call or Put for vanilla payoffs, Generic otherwise
+ */
+PayoffKind classify_payoff(const Payoff& payoff, double& strike);
+
+/**
+ * @brief Look up the pre-instantiated kernel for a configuration
+ * 
+ * Selection happens once per pricing call, never per path. Generic models
+ * always run in double precision.
+ * 
+ * @param model Model family
+ * @param precision Path precision
+ * @param kind Payoff family
+ * @param method Normal generator
+ * @param weighted Whether importance sampling is active
+ * @return const KernelEntry& Kernel entry points
+ */
+const KernelEntry& select_kernel(ModelKind model, PathPrecision precision, PayoffKind kind,
+                                 NormalMethod method, bool weighted);
+
+} // namespace montecarlo
@@ -0,0 +1,243 @@
+#pragma once
+
+#include "AlignedBuffer.h"
+#include "PathAccumulator.h"
+#include "Tape.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace montecarlo {
+
+/**
+ * @brief Reusable per-pricer scratch state
+ * 
+ * Owns a pool of persistent worker threads together with each worker's RNG
+ * state, aligned path buffer and payoff accumulator. Everything is allocated
+ * at construction, so repeated pricing calls through the same workspace
+ * perform no heap allocations once it is built.
+ * 
+ * A workspace must not be used by more than one pricing call at a time.
+ */
+class PricingWorkspace {
+public:
+    // Paths generated per block in each worker's scratch buffer
+    static constexpr std::size_t kBlockSize = 1024;
+
+    // Minimum paths per dynamically scheduled chunk (a whole number of blocks)
+    static constexpr std::uint64_t kChunkSize = 32 * kBlockSize;
+
+    // Default upper bound on the number of chunks in one run
+    static constexpr std::uint64_t kMaxChunks = 4096;
+
+    /**
+     * @brief Partition of [0, num_items) into equal chunks
+     * 
+     * The plan depends only on its arguments, never on the worker count, so
+     * seeded results do not change with the number of threads.
+     */
+    struct ChunkPlan {
+        std::uint64_t num_items = 0;
+        std::uint64_t chunk_size = 1;
+        std::uint64_t num_chunks = 0;
+
+        /**
+         * @brief Chunks of a multiple of min_chunk items, at most max_chunks of them
+         */
+        static ChunkPlan make(std::uint64_t num_items, std::uint64_t min_chunk, std::uint64_t max_chunks = kMaxChunks);
+
+        /**
+         * @brief Chunks of whole blocks of paths
+         */
+        static ChunkPlan for_paths(std::uint64_t num_paths, std::uint64_t max_chunks = kMaxChunks) {
+            return make(num_paths, kChunkSize, max_chunks);
+        }
+
+        std::uint64_t first(std::uint64_t chunk) const { return chunk * chunk_size; }
+        std::uint64_t last(std::uint64_t chunk) const { return std::min(num_items, first(chunk) + chunk_size); }
+    };
+
+    /**
+     * @brief Scratch state owned by a single worker
+     */
+    struct alignas(64) WorkerState {
+        std::mt19937 rng;
+        AlignedBuffer<double> block;
+        AlignedBuffer<double> scratch;
+        PathAccumulator accumulator;
+        Tape tape;                    // Adjoint tape for pathwise sensitivities
+        std::vector<Active> actives;  // Tape-recorded values kept across blocks
+
+        /**
+         * @brief View the block buffer as kBlockSize values of type Real
+         */
+        template <typename Real>
+        Real* buffer() {
+            static_assert(sizeof(Real) <= sizeof(double), "Block buffer holds at most double");
+            return reinterpret_cast<Real*>(block.data());
+        }
+
+        /**
+         * @brief Aligned scratch space of at least the given number of doubles
+         * 
+         * The buffer only grows, so repeated calls with the same size reuse it.
+         */
+        double* scratch_buffer(std::size_t size) {
+            if (scratch.size() < size) {
+                scratch = AlignedBuffer<double>(size);
+            }
+            return scratch.data();
+        }
+
+        /**
+         * @brief Active values of at least the given number, for use with the tape
+         * 
+         * Grows like scratch_buffer, keeping the values already stored.
+         */
+        Active* active_buffer(std::size_t size) {
+            if (actives.size() < size) {
+                actives.resize(size);
+            }
+            return actives.data();
+        }
+    };
+
+    /**
+     * @brief Construct a workspace seeded from std::random_device
+     * 
+     * @param num_workers Number of workers (the calling thread acts as worker 0)
+     */
+    explicit PricingWorkspace(unsigned int num_workers);
+
+    /**
+     * @brief Construct a workspace with deterministic RNG streams
+     * 
+     * @param num_workers Number of workers (the calling thread acts as worker 0)
+     * @param seed Base seed; worker i is seeded from (seed, i) and the chunks
+     *             of run_chunks from (seed, call number, chunk index)
+     */
+    PricingWorkspace(unsigned int num_workers, std::uint64_t seed);
+
+    ~PricingWorkspace();
+
+    PricingWorkspace(const PricingWorkspace&) = delete;
+    PricingWorkspace& operator=(const PricingWorkspace&) = delete;
+
+    unsigned int num_workers() const { return static_cast<unsigned int>(workers_.size()); }
+
+    WorkerState& worker(unsigned int index) { return workers_[index]; }
+
+    /**
+     * @brief Reseed every worker's RNG stream from (seed, worker index)
+     * 
+     * Also restarts the sequence of chunk streams used by run_chunks.
+     */
+    void reseed(std::uint64_t seed);
+
+    /**
+     * @brief Run job(context, worker_index) on every worker and wait for completion
+     * 
+     * Exceptions thrown by a worker are rethrown on the calling thread.
+     */
+    void run(void (*job)(void*, unsigned int), void* context);
+
+    /**
+     * @brief Run a callable taking the worker index on every worker
+     */
+    template <typename Fn>
+    void run(Fn& fn) {
+        run([](void* context, unsigned int index) { (*static_cast<Fn*>(context))(index); }, &fn);
+    }
+
+    /**
+     * @brief Run fn(state, chunk, first, last) once for every chunk of a plan
+     * 
+     * Workers claim chunks from an atomic counter, so a worker on a slow or
+     * shared core simply takes fewer of them. Before each chunk the claiming
+     * worker's RNG is reseeded from (seed, call number, chunk index): every
+     * chunk draws the same numbers whichever worker runs it, and results kept
+     * per chunk and merged in chunk order are reproducible.
+     * 
+     * If stop is given, workers check it before claiming each chunk and stop
+     * claiming once it is set; chunks already started run to completion.
+     */
+    template <typename Fn>
+    void run_chunks(const ChunkPlan& plan, Fn& fn, const std::atomic<bool>* stop = nullptr) {
+        const std::uint64_t call = ++chunk_calls_;
+        std::atomic<std::uint64_t> next{0};
+        auto job = [&](unsigned int index) {
+            WorkerState& state = workers_[index];
+            for (std::uint64_t chunk = next.fetch_add(1, std::memory_order_relaxed);
+                 chunk < plan.num_chunks;
+                 chunk = next.fetch_add(1, std::memory_order_relaxed)) {
+                if (stop && stop->load(std::memory_order_relaxed)) {
+                    break;
+                }
+                seed_chunk(state.rng, call, chunk);
+                fn(state, chunk, plan.first(chunk), plan.last(chunk));
+            }
+        };
+        run(job);
+    }
+
+    /**
+     * @brief Claim a call number for work scheduled outside run_chunks
+     *
+     * Callers that hand out their own work items seed each one with
+     * seed_stream(rng, call, index), from the same (seed, call number, index)
+     * streams run_chunks uses for its chunks.
+     */
+    std::uint64_t claim_call() { return ++chunk_calls_; }
+
+    /**
+     * @brief Seed an engine from (seed, call number, index)
+     */
+    void seed_stream(std::mt19937& rng, std::uint64_t call, std::uint64_t index) const {
+        seed_chunk(rng, call, index);
+    }
+
+    /**
+     * @brief Empty accumulators for per-chunk results, owned by the workspace
+     * 
+     * The storage only grows, so repeated calls with the same count reuse it.
+     */
+    PathAccumulator* chunk_accumulators(std::size_t count);
+
+    /**
+     * @brief Empty per-chunk batch-means accumulators, owned by the workspace
+     * 
+     * Grows like chunk_accumulators; stratified pricers use them for their
+     * standard errors.
+     */
+    BatchMeansAccumulator* batch_accumulators(std::size_t count);
+
+private:
+    std::vector<WorkerState> workers_;
+    std::vector<std::thread> threads_;
+    std::vector<PathAccumulator> chunk_accumulators_;
+    std::vector<BatchMeansAccumulator> batch_accumulators_;
+    std::uint64_t seed_ = 0;
+    std::uint64_t chunk_calls_ = 0;
+
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    void (*job_)(void*, unsigned int) = nullptr;
+    void* context_ = nullptr;
+    std::uint64_t generation_ = 0;
+    unsigned int pending_ = 0;
+    bool stopping_ = false;
+    std::exception_ptr error_;
+
+    void seed_chunk(std::mt19937& rng, std::uint64_t call, std::uint64_t chunk) const;
+    void worker_loop(unsigned int index);
+    void execute(unsigned int index);
+};
+
+} // namespace montecarlo
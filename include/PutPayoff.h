@@ -35,6 +35,15 @@ public:
         return std::make_unique<PutPayoff>(K_);
     }
 
+    /**
+     * @brief Report the vanilla terms so the pricer can inline this payoff
+     * 
+     * @return std::optional<VanillaTerms> Put with this strike
+     */
+    std::optional<VanillaTerms> vanilla_terms() const override {
+        return VanillaTerms{OptionType::Put, K_};
+    }
+
 private:
     double K_;  // Strike price
 };
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace montecarlo {
+
+/**
+ * @brief One bin of an equal-width histogram
+ */
+struct HistogramBin {
+    double lower;        // Inclusive lower edge
+    double upper;        // Exclusive upper edge (inclusive for the last bin)
+    double probability;  // Share of the total weight in the bin
+};
+
+/**
+ * @brief Mergeable streaming quantile sketch with bounded relative error
+ *
+ * Values are counted in logarithmically spaced buckets (DDSketch): bucket i
+ * holds the magnitudes in (gamma^(i-1), gamma^i] with
+ * gamma = (1 + alpha) / (1 - alpha), so any quantile is returned within a
+ * relative error alpha of a value of the sample. Positive and negative
+ * values have a store each and exact zeros a counter of their own.
+ *
+ * Each store is a fixed window of max_buckets counts allocated at
+ * construction, so add() never allocates and a sketch occupies about
+ * 16 * max_buckets bytes. When the magnitudes span more buckets than the
+ * window, the smallest magnitudes are collapsed into the lowest bucket,
+ * which only costs accuracy at the end of the distribution nearest zero.
+ *
+ * Merging adds bucket counts, so the result does not depend on how values
+ * were split between sketches or in which order sketches were merged; with
+ * unit weights the counts are exact integers and merged sketches are
+ * bit-identical whatever the split.
+ */
+class QuantileSketch {
+public:
+    /**
+     * @brief Construct an empty sketch
+     *
+     * @param relative_accuracy Relative error alpha of the quantiles, in (0, 1)
+     * @param max_buckets Buckets per sign
+     */
+    explicit QuantileSketch(double relative_accuracy = 0.01, std::size_t max_buckets = 512);
+
+    /**
+     * @brief Add a value with a weight (e.g. an importance-sampling likelihood ratio)
+     */
+    void add(double value, double weight = 1.0) {
+        if (!(weight > 0.0)) {
+            return;
+        }
+        total_weight_ += weight;
+        min_ = value < min_ ? value : min_;
+        max_ = value > max_ ? value : max_;
+        if (value > kMinMagnitude) {
+            positive_.add(index(value), weight);
+        } else if (value < -kMinMagnitude) {
+            negative_.add(index(-value), weight);
+        } else {
+            zero_weight_ += weight;
+        }
+    }
+
+    /**
+     * @brief Add the contents of another sketch with the same parameters
+     *
+     * @throws ValidationError if the relative accuracy or bucket count differ
+     */
+    void merge(const QuantileSketch& other);
+
+    /**
+     * @brief Remove every value, keeping the allocated stores
+     */
+    void clear();
+
+    /**
+     * @brief Total weight added
+     */
+    double total_weight() const { return total_weight_; }
+
+    /**
+     * @brief Whether no value has been added
+     */
+    bool empty() const { return total_weight_ == 0.0; }
+
+    /**
+     * @brief Smallest value added (exact)
+     */
+    double min() const { return min_; }
+
+    /**
+     * @brief Largest value added (exact)
+     */
+    double max() const { return max_; }
+
+    double relative_accuracy() const { return relative_accuracy_; }
+    std::size_t max_buckets() const { return positive_.counts.size(); }
+
+    /**
+     * @brief Value below which a share q of the weight lies
+     *
+     * @param q Probability level in [0, 1]; 0 and 1 return the exact min and max
+     * @return double The quantile, or NaN for an empty sketch
+     */
+    double quantile(double q) const;
+
+    /**
+     * @brief Mean of the values above the q-quantile, E[X | X >= Q(q)]
+     *
+     * Uses bucket representatives, so it carries the same relative error as
+     * the quantiles.
+     *
+     * @param q Probability level in [0, 1)
+     * @return double The tail mean, or NaN for an empty sketch
+     */
+    double upper_tail_mean(double q) const;
+
+    /**
+     * @brief Equal-width histogram between the smallest and largest values
+     *
+     * Each bucket's weight goes to the bin holding its representative value.
+     *
+     * @param num_bins Number of bins
+     * @return std::vector<HistogramBin> Bins in increasing order, empty for an empty sketch
+     */
+    std::vector<HistogramBin> histogram(std::size_t num_bins) const;
+
+private:
+    // Magnitudes at or below this count as zero
+    static constexpr double kMinMagnitude = std::numeric_limits<double>::min();
+
+    /**
+     * @brief Window of max_buckets consecutive bucket counts
+     *
+     * offset is the bucket index of counts[0]. A bucket below the window is
+     * counted in the lowest bucket still within max_buckets of the highest
+     * bucket seen, which keeps the contents independent of insertion order.
+     */
+    struct Store {
+        std::vector<double> counts;
+        int offset = 0;
+        bool used = false;
+
+        explicit Store(std::size_t max_buckets) : counts(max_buckets, 0.0) {}
+
+        void add(int bucket, double weight) {
+            if (!used || bucket < offset || bucket >= offset + static_cast<int>(counts.size())) {
+                bucket = extend(bucket);
+            }
+            counts[static_cast<std::size_t>(bucket - offset)] += weight;
+        }
+
+        /**
+         * @brief Move the window to cover a bucket and return where to count it
+         */
+        int extend(int bucket);
+        void clear();
+    };
+
+    int index(double magnitude) const {
+        return static_cast<int>(std::ceil(std::log(magnitude) * inverse_log_gamma_));
+    }
+
+    /**
+     * @brief Value reported for a bucket, within alpha of every magnitude in it
+     */
+    double representative(int bucket) const {
+        return 2.0 * std::exp(bucket * log_gamma_) / (gamma_ + 1.0);
+    }
+
+    /**
+     * @brief Visit (value, weight) of every non-empty bucket in increasing value order
+     */
+    template <typename Visitor>
+    void for_each_bucket(Visitor&& visit) const;
+
+    double relative_accuracy_;
+    double gamma_;
+    double log_gamma_;
+    double inverse_log_gamma_;
+
+    Store positive_;
+    Store negative_;   // Indexed by magnitude
+    double zero_weight_ = 0.0;
+    double total_weight_ = 0.0;
+    double min_ = std::numeric_limits<double>::infinity();
+    double max_ = -std::numeric_limits<double>::infinity();
+};
+
+} // namespace montecarlo
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "MultiAssetPayoff.h"
+#include "OptionType.h"
+#include <algorithm>
+
+namespace montecarlo {
+
+/**
+ * @brief Which order statistic of the terminal prices a rainbow option pays on
+ */
+enum class RainbowType {
+    BestOf,   ///< Maximum terminal price
+    WorstOf   ///< Minimum terminal price
+};
+
+/**
+ * @brief Call or put on the best or worst terminal price across assets
+ */
+class RainbowPayoff : public MultiAssetPayoff {
+public:
+    /**
+     * @brief Construct a new Rainbow Payoff object
+     * 
+     * @param rainbow Best-of or worst-of
+     * @param K Strike price
+     * @param type Call or put on the selected price
+     */
+    RainbowPayoff(RainbowType rainbow, double K, OptionType type)
+        : rainbow_(rainbow), K_(K), type_(type) {}
+
+    /**
+     * @brief Calculate the payoff on max_i S_i (best-of) or min_i S_i (worst-of)
+     */
+    void calculate(const double* terminal,
+                   std::size_t num_assets,
+                   std::size_t num_paths,
+                   double* payoffs) const override {
+        std::copy(terminal, terminal + num_paths, payoffs);
+        for (std::size_t i = 1; i < num_assets; ++i) {
+            const double* row = terminal + i * num_paths;
+            if (rainbow_ == RainbowType::BestOf) {
+                for (std::size_t p = 0; p < num_paths; ++p) {
+                    payoffs[p] = std::max(payoffs[p], row[p]);
+                }
+            } else {
+                for (std::size_t p = 0; p < num_paths; ++p) {
+                    payoffs[p] = std::min(payoffs[p], row[p]);
+                }
+            }
+        }
+        const double sign = type_ == OptionType::Call ? 1.0 : -1.0;
+        for (std::size_t p = 0; p < num_paths; ++p) {
+            payoffs[p] = std::max(sign * (payoffs[p] - K_), 0.0);
+        }
+    }
+
+    /**
+     * @brief Payoffs and derivatives: +/- 1 on the selected asset of paths that finish in the money
+     */
+    void calculate_gradient(const double* terminal,
+                            std::size_t num_assets,
+                            std::size_t num_paths,
+                            double* payoffs,
+                            double* gradients) const override {
+        calculate(terminal, num_assets, num_paths, payoffs);
+        std::fill(gradients, gradients + num_assets * num_paths, 0.0);
+        const double sign = type_ == OptionType::Call ? 1.0 : -1.0;
+        for (std::size_t p = 0; p < num_paths; ++p) {
+            if (payoffs[p] <= 0.0) {
+                continue;
+            }
+            // First asset attaining the extreme, as selected by calculate
+            std::size_t selected = 0;
+            for (std::size_t i = 1; i < num_assets; ++i) {
+                const double candidate = terminal[i * num_paths + p];
+                const double current = terminal[selected * num_paths + p];
+                if (rainbow_ == RainbowType::BestOf ? candidate > current : candidate < current) {
+                    selected = i;
+                }
+            }
+            gradients[selected * num_paths + p] = sign;
+        }
+    }
+
+    std::unique_ptr<MultiAssetPayoff> clone() const override {
+        return std::make_unique<RainbowPayoff>(rainbow_, K_, type_);
+    }
+
+private:
+    RainbowType rainbow_;
+    double K_;  // Strike price
+    OptionType type_;
+};
+
+} // namespace montecarlo
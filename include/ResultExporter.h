@@ -1,6 +1,7 @@
 #pragma once
 #include "OptionPricer.h"
 #include "Config.h"
+#include "ScenarioEngine.h"
 #include <string>
 #include <fstream>
 #include <memory>
@@ -44,6 +45,54 @@ public:
     static void export_to_text(const std::string& filename,
                              const PricingResult& result,
                              const Config& config);
+
+    /**
+     * @brief Export a scenario sweep price matrix to a CSV file
+     * 
+     * Writes one row per (scenario, instrument) cell.
+     * 
+     * @param filename Output file path
+     * @param result Scenario sweep result
+     * @param config Configuration used
+     */
+    static void export_scenarios_to_csv(const std::string& filename,
+                                      const ScenarioResult& result,
+                                      const Config& config);
+
+    /**
+     * @brief Export a scenario sweep price matrix to a JSON file
+     * 
+     * @param filename Output file path
+     * @param result Scenario sweep result
+     * @param config Configuration used
+     */
+    static void export_scenarios_to_json(const std::string& filename,
+                                       const ScenarioResult& result,
+                                       const Config& config);
+
+    /**
+     * @brief Export a convergence trace to a CSV file
+     * 
+     * Writes one row per checkpoint: paths, estimate, standard error, elapsed time.
+     * 
+     * @param filename Output file path
+     * @param trace Convergence checkpoints
+     * @param config Configuration used
+     */
+    static void export_convergence_to_csv(const std::string& filename,
+                                        const std::vector<ConvergencePoint>& trace,
+                                        const Config& config);
+
+    /**
+     * @brief Export a convergence trace to a JSON file
+     * 
+     * @param filename Output file path
+     * @param trace Convergence checkpoints
+     * @param config Configuration used
+     */
+    static void export_convergence_to_json(const std::string& filename,
+                                         const std::vector<ConvergencePoint>& trace,
+                                         const Config& config);
 };
 
 } // namespace montecarlo 
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+namespace montecarlo {
+
+/**
+ * @brief How the normal draws driving each path are sampled
+ */
+enum class SamplingMethod {
+    MonteCarlo,      ///< Independent pseudo-random draws
+    Stratified,      ///< Equal-probability strata on the terminal normal
+    LatinHypercube   ///< Latin hypercube across the time-step dimensions
+};
+
+/**
+ * @brief Convert a sampling method to its configuration string
+ * 
+ * @param method Sampling method
+ * @return const char* "mc", "stratified" or "lhs"
+ */
+inline const char* to_string(SamplingMethod method) {
+    switch (method) {
+        case SamplingMethod::Stratified: return "stratified";
+        case SamplingMethod::LatinHypercube: return "lhs";
+        default: return "mc";
+    }
+}
+
+} // namespace montecarlo
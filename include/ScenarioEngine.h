@@ -0,0 +1,110 @@
+#pragma once
+
+#include "BlackScholesModel.h"
+#include "Payoff.h"
+#include "PricingWorkspace.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace montecarlo {
+
+/**
+ * @brief A single shocked market state
+ */
+struct MarketScenario {
+    double S;      // Spot price
+    double sigma;  // Volatility
+    double r;      // Risk-free rate
+};
+
+/**
+ * @brief Cartesian grid of market shocks
+ * 
+ * Spot shocks are relative (0.01 = +1%), volatility and rate shocks are
+ * absolute shifts. An empty axis is treated as a single zero shock.
+ */
+struct ShockGrid {
+    std::vector<double> spot_shocks;
+    std::vector<double> vol_shocks;
+    std::vector<double> rate_shocks;
+
+    /**
+     * @brief Load a shock grid from a JSON file
+     * 
+     * @param filename Path to a JSON file with "spot_shocks", "vol_shocks" and "rate_shocks" arrays
+     * @return ShockGrid Loaded grid
+     */
+    static ShockGrid load(const std::string& filename);
+
+    /**
+     * @brief Expand the grid around a base market
+     * 
+     * Scenarios are ordered with the rate shock varying fastest, then
+     * volatility, then spot.
+     * 
+     * @param base Unshocked market
+     * @return std::vector<MarketScenario> One scenario per grid point
+     */
+    std::vector<MarketScenario> expand(const MarketScenario& base) const;
+};
+
+/**
+ * @brief Dense price matrix produced by a scenario sweep
+ * 
+ * All matrices are row-major with one row per scenario and one column per
+ * instrument in the book.
+ */
+struct ScenarioResult {
+    std::vector<MarketScenario> scenarios;
+    std::size_t num_instruments = 0;
+    std::vector<double> prices;
+    std::vector<double> standard_errors;
+    std::vector<double> pnl;                   // Price minus unshocked price
+    std::vector<double> pnl_standard_errors;   // Standard error of the P&L estimate
+    std::chrono::milliseconds computation_time{0};
+
+    double price(std::size_t scenario, std::size_t instrument) const {
+        return prices[scenario * num_instruments + instrument];
+    }
+};
+
+/**
+ * @brief Revalues a book of payoffs under many market shocks with common random numbers
+ * 
+ * Every scenario is driven by the same standard normals. Each block of normals
+ * is drawn once and applied to all scenarios while it is still in cache, so the
+ * cost per extra scenario is only the path evolution and payoff evaluation,
+ * and scenario-to-scenario P&L differences have far lower variance than
+ * independent runs would give.
+ */
+class ScenarioEngine {
+public:
+    /**
+     * @brief Construct a new Scenario Engine object
+     * 
+     * @param base_model Unshocked market model
+     * @param num_simulations Number of paths shared by all scenarios
+     */
+    ScenarioEngine(const BlackScholesModel& base_model, std::uint64_t num_simulations);
+
+    /**
+     * @brief Price every instrument under every scenario
+     * 
+     * @param scenarios Shocked markets to revalue under
+     * @param book Payoffs to revalue
+     * @param T Time to maturity
+     * @param workspace Worker threads and RNG streams to use
+     * @return ScenarioResult Price and P&L matrices
+     */
+    ScenarioResult run(const std::vector<MarketScenario>& scenarios,
+                       const std::vector<const Payoff*>& book,
+                       double T,
+                       PricingWorkspace& workspace) const;
+
+private:
+    const BlackScholesModel& base_model_;
+    std::uint64_t num_simulations_;
+};
+
+} // namespace montecarlo
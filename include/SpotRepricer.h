@@ -0,0 +1,122 @@
+#pragma once
+
+#include "IPricingModel.h"
+#include "NormalGenerator.h"
+#include "OptionPricer.h"
+#include "Payoff.h"
+#include "PricingWorkspace.h"
+#include <cstdint>
+#include <vector>
+
+namespace montecarlo {
+
+/**
+ * @brief Reprices European options on spot moves without new simulation
+ *
+ * Under geometric Brownian motion S_T = S0 * G with a growth factor G that
+ * does not depend on S0. The first call for a given rate, volatility and
+ * maturity simulates the growth factors once, sorts them and keeps their
+ * prefix sums and prefix sums of squares. Every later call with a new spot
+ * reuses them: a vanilla call or put at spot S and strike K only needs the
+ * samples above or below K / S, so its price and standard error come from a
+ * binary search and a few prefix-sum lookups, in microseconds. Any other
+ * payoff is evaluated once per cached sample, still without drawing normals.
+ *
+ * The cache is keyed on (r, sigma, T) and is rebuilt automatically when any
+ * of them changes. Under rate and volatility term structures r and sigma are
+ * the averages over [0, T] (see IPricingModel::terminal_gbm_terms). With a
+ * seeded workspace the samples are the paths OptionPricer::price_option
+ * draws in double precision, so both return the same price up to summation
+ * order.
+ */
+class SpotRepricer {
+public:
+    /**
+     * @brief Construct a new Spot Repricer object
+     *
+     * @param num_simulations Number of cached paths
+     * @param num_threads Number of threads used to build the cache
+     */
+    SpotRepricer(std::uint64_t num_simulations, unsigned int num_threads);
+
+    /**
+     * @brief Select the algorithm used to draw the normals, invalidating the cache
+     */
+    void set_normal_method(NormalMethod method);
+
+    /**
+     * @brief Price an option, building the cache if the market has moved off it
+     *
+     * Builds a temporary workspace for the call; callers repricing in a loop
+     * pass their own workspace or use reprice().
+     *
+     * @param model Geometric Brownian motion model (see IPricingModel::terminal_gbm_terms)
+     * @param payoff The payoff strategy to use
+     * @param T Time to maturity
+     * @return PricingResult The pricing result including price, standard error, and computation time
+     * @throws ValidationError if the model is not a geometric Brownian motion
+     */
+    PricingResult price_option(const IPricingModel& model, const Payoff& payoff, double T);
+
+    /**
+     * @brief Price an option, building the cache with a caller-owned workspace if needed
+     *
+     * @param model Geometric Brownian motion model (see IPricingModel::terminal_gbm_terms)
+     * @param payoff The payoff strategy to use
+     * @param T Time to maturity
+     * @param workspace Worker threads and RNG streams used to build the cache
+     * @return PricingResult The pricing result including price, standard error, and computation time
+     * @throws ValidationError if the model is not a geometric Brownian motion
+     */
+    PricingResult price_option(const IPricingModel& model, const Payoff& payoff, double T,
+                               PricingWorkspace& workspace);
+
+    /**
+     * @brief Price an option at a new spot from the cache
+     *
+     * @param spot Spot price
+     * @param payoff The payoff strategy to use
+     * @return PricingResult The pricing result including price, standard error, and computation time
+     * @throws ValidationError if the cache is empty or the spot is not positive
+     */
+    PricingResult reprice(double spot, const Payoff& payoff) const;
+
+    /**
+     * @brief Whether the cache holds samples for the given market and maturity
+     */
+    bool is_cached(double r, double sigma, double T) const;
+
+    /**
+     * @brief Drop the cached samples, keeping their storage
+     */
+    void invalidate() { valid_ = false; }
+
+    /**
+     * @brief Number of times the cache has been built
+     */
+    std::uint64_t cache_builds() const { return cache_builds_; }
+
+private:
+    std::uint64_t num_simulations_;
+    unsigned int num_threads_;
+    NormalGenerator normal_generator_;
+
+    // Cache key
+    bool valid_ = false;
+    double rate_ = 0.0;
+    double volatility_ = 0.0;
+    double maturity_ = 0.0;
+    double discount_ = 1.0;
+    std::uint64_t cache_builds_ = 0;
+
+    std::vector<double> growth_;           // Sorted S_T / S0
+    std::vector<double> prefix_;           // prefix_[i] = sum of growth_[0, i)
+    std::vector<double> prefix_squared_;   // prefix_squared_[i] = sum of growth_[0, i)^2
+
+    /**
+     * @brief Simulate, sort and sum the growth factors for a market
+     */
+    void build(double r, double sigma, double T, double discount, PricingWorkspace& workspace);
+};
+
+} // namespace montecarlo
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace montecarlo {
+
+/**
+ * @brief Tape for adjoint algorithmic differentiation (AAD)
+ *
+ * Operations on Active values append a node to the tape recording the
+ * indices of their (at most two) operands and the local partial derivatives.
+ * A reverse sweep then propagates adjoints from the seeded outputs back to
+ * the inputs, so the derivatives of one output with respect to every input
+ * cost a small constant multiple of the forward computation.
+ *
+ * Indices below num_inputs() name the inputs, whose adjoints are kept across
+ * reset() and accumulate over every sweep: pricers record one block of paths
+ * at a time, sweep it, and reset the tape for the next block. Nodes live in
+ * one contiguous arena whose capacity only grows to the largest block
+ * recorded, so after the first block recording allocates nothing.
+ */
+class Tape {
+public:
+    using Index = std::uint32_t;
+
+    /**
+     * @brief Index of a value that does not depend on any input
+     */
+    static constexpr Index kConstant = std::numeric_limits<Index>::max();
+
+    /**
+     * @brief Construct an empty tape
+     *
+     * @param num_inputs Number of input slots
+     */
+    explicit Tape(std::size_t num_inputs = 0);
+
+    /**
+     * @brief Change the number of inputs, clearing the tape and the input adjoints
+     */
+    void set_num_inputs(std::size_t num_inputs);
+
+    std::size_t num_inputs() const { return num_inputs_; }
+
+    /**
+     * @brief Number of nodes recorded since the last reset
+     */
+    std::size_t num_nodes() const { return nodes_.size(); }
+
+    /**
+     * @brief Number of nodes the arena holds without reallocating
+     */
+    std::size_t capacity() const { return nodes_.capacity(); }
+
+    /**
+     * @brief Reserve arena space for a block of the given number of nodes
+     */
+    void reserve(std::size_t num_nodes);
+
+    /**
+     * @brief Append a node depending on one or two operands
+     *
+     * @param a First operand
+     * @param da Partial derivative with respect to a
+     * @param b Second operand, or kConstant
+     * @param db Partial derivative with respect to b
+     * @return Index Index of the new node
+     */
+    Index record(Index a, double da, Index b = kConstant, double db = 0.0) {
+        nodes_.push_back({a, b, da, db});
+        return static_cast<Index>(num_inputs_ + nodes_.size() - 1);
+    }
+
+    /**
+     * @brief Add to the adjoint of a node or input before a sweep
+     */
+    void add_adjoint(Index index, double adjoint);
+
+    /**
+     * @brief Reverse sweep over every recorded node
+     *
+     * Adds the contributions of the seeded adjoints to the input adjoints.
+     * Node adjoints are left in place until the next reset().
+     */
+    void propagate();
+
+    /**
+     * @brief Forget the recorded nodes, keeping the arena and the input adjoints
+     */
+    void reset();
+
+    /**
+     * @brief Adjoints accumulated into the inputs, num_inputs() values
+     */
+    const double* input_adjoints() const { return adjoints_.data(); }
+
+    /**
+     * @brief Zero the accumulated input adjoints
+     */
+    void clear_input_adjoints();
+
+private:
+    struct Node {
+        Index operand[2];
+        double partial[2];
+    };
+
+    std::size_t num_inputs_;
+    std::vector<Node> nodes_;
+    std::vector<double> adjoints_;   // Inputs, then one per node
+};
+
+/**
+ * @brief Scalar whose arithmetic is recorded on a Tape
+ *
+ * Model code templated on its scalar type runs unchanged on double or on
+ * Active. Values built from plain doubles are constants and are never
+ * recorded; the tape of a result is taken from its non-constant operands,
+ * so several tapes can be in use on one thread.
+ */
+class Active {
+public:
+    Active(double value = 0.0) : value_(value) {}  // NOLINT: constants convert implicitly
+
+    /**
+     * @brief Active value bound to an input slot of a tape
+     */
+    static Active input(Tape& tape, Tape::Index input, double value) {
+        return Active(value, input, &tape);
+    }
+
+    double value() const { return value_; }
+    Tape::Index index() const { return index_; }
+    Tape* tape() const { return tape_; }
+    bool is_constant() const { return index_ == Tape::kConstant; }
+
+    /**
+     * @brief Result of a unary operation with local derivative da
+     */
+    static Active unary(double value, const Active& a, double da) {
+        if (a.is_constant()) {
+            return Active(value);
+        }
+        return Active(value, a.tape_->record(a.index_, da), a.tape_);
+    }
+
+    /**
+     * @brief Result of a binary operation with local derivatives da and db
+     */
+    static Active binary(double value, const Active& a, double da, const Active& b, double db) {
+        if (a.is_constant()) {
+            return unary(value, b, db);
+        }
+        if (b.is_constant()) {
+            return unary(value, a, da);
+        }
+        return Active(value, a.tape_->record(a.index_, da, b.index_, db), a.tape_);
+    }
+
+    Active& operator+=(const Active& other) { return *this = binary(value_ + other.value_, *this, 1.0, other, 1.0); }
+    Active& operator-=(const Active& other) { return *this = binary(value_ - other.value_, *this, 1.0, other, -1.0); }
+    Active& operator*=(const Active& other) {
+        return *this = binary(value_ * other.value_, *this, other.value_, other, value_);
+    }
+    Active& operator/=(const Active& other) {
+        const double inverse = 1.0 / other.value_;
+        return *this = binary(value_ * inverse, *this, inverse, other, -value_ * inverse * inverse);
+    }
+
+private:
+    Active(double value, Tape::Index index, Tape* tape) : value_(value), index_(index), tape_(tape) {}
+
+    double value_;
+    Tape::Index index_ = Tape::kConstant;
+    Tape* tape_ = nullptr;
+};
+
+inline Active operator+(Active a, const Active& b) { return a += b; }
+inline Active operator-(Active a, const Active& b) { return a -= b; }
+inline Active operator*(Active a, const Active& b) { return a *= b; }
+inline Active operator/(Active a, const Active& b) { return a /= b; }
+inline Active operator-(const Active& a) { return Active::unary(-a.value(), a, -1.0); }
+
+inline bool operator<(const Active& a, const Active& b) { return a.value() < b.value(); }
+inline bool operator>(const Active& a, const Active& b) { return a.value() > b.value(); }
+inline bool operator<=(const Active& a, const Active& b) { return a.value() <= b.value(); }
+inline bool operator>=(const Active& a, const Active& b) { return a.value() >= b.value(); }
+
+inline Active exp(const Active& a) {
+    const double value = std::exp(a.value());
+    return Active::unary(value, a, value);
+}
+
+inline Active log(const Active& a) {
+    return Active::unary(std::log(a.value()), a, 1.0 / a.value());
+}
+
+inline Active sqrt(const Active& a) {
+    const double value = std::sqrt(a.value());
+    return Active::unary(value, a, 0.5 / value);
+}
+
+/**
+ * @brief Value of a scalar, for code templated on double or Active
+ */
+inline double value_of(double x) { return x; }
+inline double value_of(const Active& x) { return x.value(); }
+
+} // namespace montecarlo
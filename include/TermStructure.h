@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace montecarlo {
+
+/**
+ * @brief How a term structure varies between its nodes
+ */
+enum class Interpolation {
+    PiecewiseConstant,  ///< Each node's value holds back to the previous node
+    PiecewiseLinear     ///< Linear between nodes
+};
+
+/**
+ * @brief Convert an interpolation to its configuration string
+ *
+ * @param interpolation Interpolation
+ * @return const char* "constant" or "linear"
+ */
+inline const char* to_string(Interpolation interpolation) {
+    return interpolation == Interpolation::PiecewiseLinear ? "linear" : "constant";
+}
+
+/**
+ * @brief Deterministic curve f(t) of a rate or a volatility
+ *
+ * Defined by values at increasing node times and extrapolated flat before
+ * the first node and after the last. Piecewise-constant curves take the
+ * value of node i on (t_{i-1}, t_i], the usual convention for forward-rate
+ * and forward-volatility bootstrapping.
+ *
+ * The integrals of f and f^2 from 0 to every node are tabulated once on
+ * construction, so integral() and integral_of_square() at any time cost a
+ * binary search and a closed-form partial segment.
+ */
+class TermStructure {
+public:
+    /**
+     * @brief Construct a term structure
+     *
+     * @param times Increasing positive node times
+     * @param values Curve values at the nodes
+     * @param interpolation Interpolation between nodes
+     * @throws ValidationError if the nodes are empty, mismatched or not increasing
+     */
+    TermStructure(std::vector<double> times,
+                  std::vector<double> values,
+                  Interpolation interpolation = Interpolation::PiecewiseConstant);
+
+    /**
+     * @brief A curve with the same value at all times
+     */
+    static TermStructure flat(double value);
+
+    /**
+     * @brief Parse an interpolation from its configuration string
+     *
+     * @param interpolation_str "constant" or "linear"
+     * @throws ConfigError for any other string
+     */
+    static Interpolation parse_interpolation(const std::string& interpolation_str);
+
+    /**
+     * @brief Curve value at time t
+     */
+    double value(double t) const;
+
+    /**
+     * @brief Integral of the curve from 0 to t
+     */
+    double integral(double t) const;
+
+    /**
+     * @brief Integral of the squared curve from 0 to t
+     */
+    double integral_of_square(double t) const;
+
+    /**
+     * @brief Whether the curve has the same value at all times
+     */
+    bool is_flat() const { return flat_; }
+
+    const std::vector<double>& times() const { return times_; }
+    const std::vector<double>& values() const { return values_; }
+    Interpolation interpolation() const { return interpolation_; }
+
+private:
+    std::vector<double> times_;
+    std::vector<double> values_;
+    Interpolation interpolation_;
+    bool flat_ = true;
+
+    // cumulative_[i] and cumulative_square_[i] integrate f and f^2 over [0, times_[i]]
+    std::vector<double> cumulative_;
+    std::vector<double> cumulative_square_;
+
+    /**
+     * @brief Integral of f (or f^2) over [times_[segment - 1], t] within one segment
+     */
+    double partial(std::size_t segment, double t, bool squared) const;
+
+    /**
+     * @brief Integral of f (or f^2) over [0, t]
+     */
+    double integrate(double t, bool squared) const;
+};
+
+} // namespace montecarlo
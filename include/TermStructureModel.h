@@ -0,0 +1,126 @@
+#pragma once
+
+#include "IPricingModel.h"
+#include "TermStructure.h"
+#include <cstddef>
+#include <vector>
+
+namespace montecarlo {
+
+/**
+ * @brief Geometric Brownian motion with time-dependent rate and volatility
+ *
+ * dS = r(t) S dt + sigma(t) S dW with deterministic curves r and sigma. Over
+ * any interval [s, t] the log return is exactly normal with mean
+ * R(s, t) - V(s, t) / 2 and variance V(s, t), where R and V integrate r and
+ * sigma^2. Both come from the integrals the curves tabulate at their nodes,
+ * so the curves are never interpolated per path:
+ * - European payoffs are sampled in one exact step, and terminal_gbm_terms
+ *   lets OptionPricer run them through the inlined GBM kernels at the cost
+ *   of a flat model.
+ * - Path simulation evolves each step with per-step drift and diffusion
+ *   computed once per block, or once per run from a Grid, which is the
+ *   model's path grid.
+ */
+class TermStructureModel : public IPricingModel {
+public:
+    /**
+     * @brief Integrated rate and variance on a uniform simulation time grid
+     *
+     * Entry n of the cumulative tables integrates over [0, n dt]; entry n of
+     * drift and diffusion evolves the log price over step n.
+     */
+    struct Grid : PathGrid {
+        double dt = 0.0;
+        std::vector<double> integrated_rate;      // num_steps + 1 entries
+        std::vector<double> integrated_variance;  // num_steps + 1 entries
+        std::vector<double> drift;                // num_steps entries
+        std::vector<double> diffusion;            // num_steps entries
+    };
+
+    /**
+     * @brief Construct a new Term Structure Model object
+     *
+     * @param initial_price Initial asset price
+     * @param rates Risk-free short rate curve
+     * @param volatilities Volatility curve
+     * @throws ValidationError if the initial price is not positive or a volatility is negative
+     */
+    TermStructureModel(double initial_price, TermStructure rates, TermStructure volatilities);
+
+    /**
+     * @brief Tabulate the integrals on a uniform grid of num_steps steps to T
+     *
+     * @param num_steps Number of equal time steps
+     * @param T Time to maturity
+     * @return Grid Tables for simulate_paths
+     */
+    Grid make_grid(std::size_t num_steps, double T) const;
+
+    /**
+     * @brief A Grid from make_grid, as the model's path grid
+     */
+    std::shared_ptr<const PathGrid> make_path_grid(std::size_t num_steps, double T) const override;
+
+    /**
+     * @brief Exact path simulation on a Grid from make_path_grid
+     */
+    void simulate_grid_paths(const PathGrid& grid, const double* normals, double* paths,
+                             std::size_t count) const override;
+
+    /**
+     * @brief Exact terminal prices S0 exp(R(T) - V(T) / 2 + sqrt(V(T)) Z)
+     */
+    void simulate_terminal(const double* normals, double* terminal,
+                           std::size_t count, double T) const override;
+
+    /**
+     * @brief Exact path simulation on a uniform grid of num_steps steps
+     */
+    void simulate_paths(const double* normals, double* paths,
+                        std::size_t count, std::size_t num_steps, double T) const override;
+
+    /**
+     * @brief Exact path simulation on a precomputed grid
+     *
+     * Same layout as IPricingModel::simulate_paths.
+     */
+    void simulate_paths(const Grid& grid, const double* normals, double* paths, std::size_t count) const;
+
+    double discount_factor(double T) const override;
+
+    /**
+     * @brief Flat GBM terms when both curves are flat, nothing otherwise
+     */
+    std::optional<GbmTerms> gbm_terms() const override;
+
+    /**
+     * @brief Average rate and root-mean-square volatility over [0, T]
+     */
+    std::optional<GbmTerms> terminal_gbm_terms(double T) const override;
+
+    /**
+     * @brief Integral of the short rate over [0, t]
+     */
+    double integrated_rate(double t) const { return rates_.integral(t); }
+
+    /**
+     * @brief Integral of the squared volatility over [0, t]
+     */
+    double integrated_variance(double t) const { return volatilities_.integral_of_square(t); }
+
+    double get_initial_price() const { return initial_price_; }
+    const TermStructure& get_rates() const { return rates_; }
+    const TermStructure& get_volatilities() const { return volatilities_; }
+
+private:
+    double initial_price_;
+    TermStructure rates_;
+    TermStructure volatilities_;
+
+    template <typename StepTerms>
+    void evolve(const double* normals, double* paths, std::size_t count,
+                std::size_t num_steps, StepTerms step_terms) const;
+};
+
+} // namespace montecarlo
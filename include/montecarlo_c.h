@@ -0,0 +1,146 @@
+#pragma once
+
+/**
+ * @brief C interface to libmontecarlo
+ *
+ * Every function is plain C with fixed-width types, so the interface can be
+ * called from C, from other languages through their C FFI, and across
+ * compiler versions. Pricers are opaque handles that keep their worker
+ * threads and scratch buffers alive between calls. Batches are passed as
+ * flat arrays, one array per field, and results are written into buffers
+ * owned by the caller.
+ *
+ * Functions return MC_OK on success. On failure they return an error code,
+ * leave the output buffers in an unspecified state, and mc_last_error()
+ * describes the failure on the calling thread.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(MONTECARLO_BUILDING_LIBRARY)
+#    define MC_API __declspec(dllexport)
+#  elif defined(MONTECARLO_SHARED)
+#    define MC_API __declspec(dllimport)
+#  else
+#    define MC_API
+#  endif
+#else
+#  define MC_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Version of this interface; bumped only on incompatible changes */
+#define MC_API_VERSION 1
+
+typedef enum mc_status {
+    MC_OK = 0,
+    MC_ERROR_INVALID_ARGUMENT = 1,  /* Null pointer, zero size or out-of-range value */
+    MC_ERROR_VALIDATION = 2,        /* Unsupported combination of settings */
+    MC_ERROR_SIMULATION = 3,        /* Failure inside the simulation */
+    MC_ERROR_INTERNAL = 4           /* Any other failure, including out of memory */
+} mc_status;
+
+typedef enum mc_option_type {
+    MC_CALL = 0,
+    MC_PUT = 1
+} mc_option_type;
+
+typedef enum mc_path_precision {
+    MC_PRECISION_DOUBLE = 0,
+    MC_PRECISION_SINGLE = 1
+} mc_path_precision;
+
+typedef enum mc_normal_method {
+    MC_NORMAL_ZIGGURAT = 0,
+    MC_NORMAL_INVERSE_CDF = 1
+} mc_normal_method;
+
+/**
+ * @brief Settings for mc_pricer_create
+ *
+ * Always fill with mc_pricer_options_init first: struct_size records which
+ * version of the struct the caller was compiled against, so fields can be
+ * appended without breaking existing binaries.
+ */
+typedef struct mc_pricer_options {
+    uint32_t struct_size;
+    uint32_t num_threads;       /* Worker threads, including the calling thread */
+    uint64_t num_simulations;   /* Paths per option */
+    uint32_t path_precision;    /* mc_path_precision */
+    uint32_t normal_method;     /* mc_normal_method */
+    uint64_t seed;              /* RNG seed, used when use_seed is non-zero */
+    uint32_t use_seed;          /* Zero seeds from std::random_device */
+    uint32_t reserved;
+} mc_pricer_options;
+
+/** Opaque pricer with persistent worker threads */
+typedef struct mc_pricer mc_pricer;
+
+/**
+ * @brief Version of the interface the library was built with (MC_API_VERSION)
+ */
+MC_API uint32_t mc_api_version(void);
+
+/**
+ * @brief Description of the last failure on the calling thread
+ *
+ * The string stays valid until the next failing call on the same thread.
+ */
+MC_API const char* mc_last_error(void);
+
+/**
+ * @brief Fill options with the defaults: usable CPUs, 100,000 paths,
+ *        double precision, ziggurat normals, random seed
+ */
+MC_API void mc_pricer_options_init(mc_pricer_options* options);
+
+/**
+ * @brief Create a pricer and start its worker threads
+ *
+ * @param options Settings, or NULL for the defaults
+ * @param out Receives the new pricer
+ */
+MC_API mc_status mc_pricer_create(const mc_pricer_options* options, mc_pricer** out);
+
+/**
+ * @brief Stop the worker threads and release the pricer; NULL is ignored
+ */
+MC_API void mc_pricer_destroy(mc_pricer* pricer);
+
+/**
+ * @brief Price a batch of European options under Black-Scholes dynamics
+ *
+ * Option i is described by element i of each input array. The options are
+ * priced one after another, each across all of the pricer's workers. A
+ * pricer must not be used by two threads at once.
+ *
+ * @param pricer Pricer from mc_pricer_create
+ * @param count Number of options
+ * @param option_type mc_option_type of each option
+ * @param spot Initial asset prices
+ * @param strike Strike prices
+ * @param rate Continuously compounded risk-free rates
+ * @param volatility Volatilities
+ * @param maturity Times to maturity in years
+ * @param price_out Receives count discounted prices
+ * @param standard_error_out Receives count standard errors, or NULL
+ */
+MC_API mc_status mc_price_batch(mc_pricer* pricer,
+                                size_t count,
+                                const int32_t* option_type,
+                                const double* spot,
+                                const double* strike,
+                                const double* rate,
+                                const double* volatility,
+                                const double* maturity,
+                                double* price_out,
+                                double* standard_error_out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,103 @@
+#include "Analytics.h"
+#include "AcklamInverseCdf.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace montecarlo {
+namespace analytics {
+
+double normal_cdf(double x) {
+    return 0.5 * std::erfc(-x / std::sqrt(2.0));
+}
+
+double normal_inverse_cdf(double p) {
+    using detail::AcklamInverseCdf;
+
+    if (p <= 0.0) {
+        return -std::numeric_limits<double>::infinity();
+    }
+    if (p >= 1.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    double x;
+    if (p < AcklamInverseCdf::p_low) {
+        x = AcklamInverseCdf::tail(std::sqrt(-2.0 * std::log(p)));
+    } else if (p <= AcklamInverseCdf::p_high) {
+        x = AcklamInverseCdf::central(p - 0.5);
+    } else {
+        x = -AcklamInverseCdf::tail(std::sqrt(-2.0 * std::log(1.0 - p)));
+    }
+
+    // One Halley step against the exact CDF
+    constexpr double sqrt_2pi = 2.506628274631000502;
+    double e = normal_cdf(x) - p;
+    double u = e * sqrt_2pi * std::exp(0.5 * x * x);
+    return x - u / (1.0 + 0.5 * x * u);
+}
+
+double black_scholes_price(double S, double K, double r, double sigma, double T, OptionType type) {
+    double discount = std::exp(-r * T);
+    double stdev = sigma * std::sqrt(T);
+    if (stdev <= 0.0) {
+        double forward = S / discount;
+        double intrinsic = type == OptionType::Call ? forward - K : K - forward;
+        return discount * std::max(intrinsic, 0.0);
+    }
+
+    double d1 = (std::log(S / K) + (r + 0.5 * sigma * sigma) * T) / stdev;
+    double d2 = d1 - stdev;
+    if (type == OptionType::Call) {
+        return S * normal_cdf(d1) - K * discount * normal_cdf(d2);
+    }
+    return K * discount * normal_cdf(-d2) - S * normal_cdf(-d1);
+}
+
+double barrier_price(double S, double K, double H, double r, double sigma, double T,
+                     BarrierType barrier_type, OptionType type, double rebate) {
+    const double discount = std::exp(-r * T);
+    const double vanilla = black_scholes_price(S, K, r, sigma, T, type);
+    const bool up = is_up(barrier_type);
+
+    // Knock-in value without rebate, and the probability of never touching
+    double knock_in = vanilla;
+    double no_touch = 0.0;
+    if (up ? S < H : S > H) {
+        const double phi = type == OptionType::Call ? 1.0 : -1.0;
+        const double eta = up ? -1.0 : 1.0;
+        const double stdev = sigma * std::sqrt(T);
+        const double mu = (r - 0.5 * sigma * sigma) / (sigma * sigma);
+
+        const double x1 = std::log(S / K) / stdev + (1.0 + mu) * stdev;
+        const double x2 = std::log(S / H) / stdev + (1.0 + mu) * stdev;
+        const double y1 = std::log(H * H / (S * K)) / stdev + (1.0 + mu) * stdev;
+        const double y2 = std::log(H / S) / stdev + (1.0 + mu) * stdev;
+        const double reflect_spot = std::pow(H / S, 2.0 * (mu + 1.0));
+        const double reflect_strike = std::pow(H / S, 2.0 * mu);
+
+        const double A = phi * S * normal_cdf(phi * x1) - phi * K * discount * normal_cdf(phi * (x1 - stdev));
+        const double B = phi * S * normal_cdf(phi * x2) - phi * K * discount * normal_cdf(phi * (x2 - stdev));
+        const double C = phi * S * reflect_spot * normal_cdf(eta * y1) -
+                         phi * K * discount * reflect_strike * normal_cdf(eta * (y1 - stdev));
+        const double D = phi * S * reflect_spot * normal_cdf(eta * y2) -
+                         phi * K * discount * reflect_strike * normal_cdf(eta * (y2 - stdev));
+
+        const bool strike_above = K > H;
+        if (type == OptionType::Call) {
+            knock_in = up ? (strike_above ? A : B - C + D) : (strike_above ? C : A - B + D);
+        } else {
+            knock_in = up ? (strike_above ? A - B + D : C) : (strike_above ? B - C + D : A);
+        }
+        no_touch = normal_cdf(eta * (x2 - stdev)) - reflect_strike * normal_cdf(eta * (y2 - stdev));
+    }
+
+    if (is_knock_in(barrier_type)) {
+        return knock_in + rebate * discount * no_touch;
+    }
+    // In-out parity: out + in = vanilla, and exactly one of them pays the rebate
+    return vanilla - knock_in + rebate * discount * (1.0 - no_touch);
+}
+
+} // namespace analytics
+} // namespace montecarlo
@@ -0,0 +1,130 @@
+#include "BarrierPricer.h"
+#include "Exceptions.h"
+#include "MemoryStats.h"
+#include "NormalGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace montecarlo {
+
+BarrierPricer::BarrierPricer(const IPricingModel& model,
+                             std::uint64_t num_simulations,
+                             unsigned int num_threads,
+                             unsigned int num_steps)
+    : model_(model),
+      num_simulations_(num_simulations),
+      num_threads_(num_threads),
+      num_steps_(num_steps) {
+}
+
+PricingResult BarrierPricer::price_option(const BarrierPayoff& payoff, double T) {
+    PricingWorkspace workspace(num_threads_);
+    return price_option(payoff, T, workspace);
+}
+
+PricingResult BarrierPricer::price_option(const BarrierPayoff& payoff, double T, PricingWorkspace& workspace) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    MemoryScope memory_scope(MemorySubsystem::Pricer);
+
+    if (num_steps_ == 0) {
+        throw ValidationError("Barrier pricing requires at least one time step");
+    }
+    if (payoff.barrier() <= 0.0) {
+        throw ValidationError("Barrier level must be positive");
+    }
+
+    const bool up = is_up(payoff.barrier_type());
+    const bool bridge = monitoring_ == BarrierMonitoring::Continuous;
+    const double barrier = payoff.barrier();
+    const double log_barrier = std::log(barrier);
+
+    // The model builds its per-step tables once per run rather than once per block
+    const std::size_t num_steps = num_steps_;
+    const auto grid = model_.make_path_grid(num_steps, T);
+
+    // Bridge crossing probability over step k is exp(-bridge_scales[k] * d0 * d1),
+    // with d0 and d1 the log distances of its end points from the barrier
+    std::vector<double> bridge_scales;
+    double log_spot = 0.0;
+    if (bridge) {
+        auto bridge_scale = [](double step_variance) {
+            return step_variance > 0.0 ? 2.0 / step_variance : std::numeric_limits<double>::infinity();
+        };
+        if (grid->step_variances.size() != num_steps) {
+            throw ValidationError("Continuous barrier monitoring requires a model with deterministic step variances");
+        }
+        bridge_scales.resize(num_steps);
+        for (std::size_t k = 0; k < num_steps; ++k) {
+            bridge_scales[k] = bridge_scale(grid->step_variances[k]);
+        }
+        log_spot = std::log(grid->initial_price);
+    }
+
+    // Paths per block, so the step-major block stays a bounded size
+    const unsigned int block_size = static_cast<unsigned int>(
+        std::max<std::size_t>(1, std::min(PricingWorkspace::kBlockSize, kMaxBlockValues / num_steps)));
+
+    const auto plan = PricingWorkspace::ChunkPlan::for_paths(num_simulations_);
+    PathAccumulator* chunks = workspace.chunk_accumulators(plan.num_chunks);
+
+    auto job = [&](PricingWorkspace::WorkerState& state, std::uint64_t chunk,
+                   std::uint64_t start_idx, std::uint64_t end_idx) {
+        // Normals on entry, spot prices after simulate_paths, step-major
+        double* paths = state.scratch_buffer(num_steps * block_size);
+        const NormalGenerator generator;
+
+        for (std::uint64_t i = start_idx; i < end_idx; i += block_size) {
+            unsigned int n = static_cast<unsigned int>(std::min<std::uint64_t>(block_size, end_idx - i));
+            generator.fill(state.rng, paths, num_steps * n);
+            model_.simulate_grid_paths(*grid, paths, paths, n);
+
+            PathAccumulator block;
+            for (unsigned int j = 0; j < n; ++j) {
+                double survival = 1.0;
+                if (bridge) {
+                    double previous = up ? log_barrier - log_spot : log_spot - log_barrier;
+                    for (std::size_t k = 0; k < num_steps && survival > 0.0; ++k) {
+                        double x = std::log(paths[k * n + j]);
+                        double distance = up ? log_barrier - x : x - log_barrier;
+                        if (previous <= 0.0 || distance <= 0.0) {
+                            survival = 0.0;
+                        } else {
+                            survival *= 1.0 - std::exp(-bridge_scales[k] * previous * distance);
+                        }
+                        previous = distance;
+                    }
+                } else {
+                    for (std::size_t k = 0; k < num_steps; ++k) {
+                        double S = paths[k * n + j];
+                        if (up ? S >= barrier : S <= barrier) {
+                            survival = 0.0;
+                            break;
+                        }
+                    }
+                }
+                block.add(payoff.calculate(paths[(num_steps - 1) * n + j], survival));
+            }
+            chunks[chunk].merge(block);
+        }
+    };
+    workspace.run_chunks(plan, job);
+
+    // Merge in chunk order so seeded runs are reproducible
+    PathAccumulator total;
+    for (std::uint64_t c = 0; c < plan.num_chunks; ++c) {
+        total.merge(chunks[c]);
+    }
+
+    double discount = model_.discount_factor(T);
+    double discounted_price = total.mean() * discount;
+    double standard_error = total.standard_error() * discount;
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto computation_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+
+    return {discounted_price, standard_error, computation_time};
+}
+
+} // namespace montecarlo
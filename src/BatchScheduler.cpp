@@ -0,0 +1,312 @@
+#include "BatchScheduler.h"
+#include "Exceptions.h"
+#include "MemoryStats.h"
+#include "NormalGenerator.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <typeinfo>
+
+namespace montecarlo {
+
+namespace {
+
+// Start and end of one piece in nanoseconds since the batch started
+struct PieceTiming {
+    double start_ns = 0.0;
+    double end_ns = 0.0;
+};
+
+void validate(const BatchJob& job) {
+    if (!job.model || !job.payoff) {
+        throw ValidationError("Batch job requires a model and a payoff");
+    }
+    if (job.num_paths == 0) {
+        throw ValidationError("Batch job requires at least one path");
+    }
+    if (job.num_steps == 0) {
+        throw ValidationError("Time grid requires at least one step");
+    }
+    if (job.T <= 0.0) {
+        throw ValidationError("Time to maturity must be positive");
+    }
+}
+
+// Paths [first, last) of a job, discounted payoffs added to sum; grid is the
+// job's path grid, null for single-step jobs
+void price_piece(const BatchJob& job, const IPricingModel::PathGrid* grid, double discount,
+                 std::uint64_t first, std::uint64_t last,
+                 PricingWorkspace::WorkerState& state, PathAccumulator& sum) {
+    const NormalGenerator generator;
+    const std::size_t steps = job.num_steps;
+    const std::uint64_t block = BatchScheduler::block_paths(steps);
+    double* values = state.scratch_buffer(block * steps);
+
+    for (std::uint64_t i = first; i < last; i += block) {
+        const std::size_t n = static_cast<std::size_t>(std::min(block, last - i));
+        generator.fill(state.rng, values, n * steps);
+
+        if (steps == 1) {
+            // One exact step to maturity; the average of one date is the terminal price
+            job.model->simulate_terminal(values, values, n, job.T);
+            for (std::size_t j = 0; j < n; ++j) {
+                sum.add(discount * job.payoff->calculate(values[j]));
+            }
+            continue;
+        }
+
+        job.model->simulate_grid_paths(*grid, values, values, n);
+        if (job.statistic == PathStatistic::Terminal) {
+            const double* terminal = values + (steps - 1) * n;
+            for (std::size_t j = 0; j < n; ++j) {
+                sum.add(discount * job.payoff->calculate(terminal[j]));
+            }
+            continue;
+        }
+
+        // Step-major rows: sum the monitoring dates row by row
+        double* averages = state.buffer<double>();
+        std::fill(averages, averages + n, 0.0);
+        for (std::size_t step = 0; step < steps; ++step) {
+            const double* row = values + step * n;
+            for (std::size_t j = 0; j < n; ++j) {
+                averages[j] += row[j];
+            }
+        }
+        const double inverse_steps = 1.0 / static_cast<double>(steps);
+        for (std::size_t j = 0; j < n; ++j) {
+            sum.add(discount * job.payoff->calculate(averages[j] * inverse_steps));
+        }
+    }
+}
+
+// Nearest-rank percentile of sorted values
+double percentile(const std::vector<double>& sorted, double p) {
+    std::size_t rank = static_cast<std::size_t>(std::ceil(p * sorted.size()));
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+double elapsed_ns(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double, std::nano>(to - from).count();
+}
+
+} // namespace
+
+BatchScheduler::BatchScheduler(double smoothing)
+    : smoothing_(smoothing) {
+    if (!(smoothing > 0.0 && smoothing <= 1.0)) {
+        throw ValidationError("Cost model smoothing must be in (0, 1]");
+    }
+}
+
+std::uint64_t BatchScheduler::block_paths(std::size_t num_steps) {
+    // A multiple of 8 paths, so each row of a block stays vector-aligned
+    std::uint64_t paths = kBlockValues / std::max<std::size_t>(num_steps, 1);
+    paths -= paths % 8;
+    return std::clamp<std::uint64_t>(paths, 8, PricingWorkspace::kBlockSize);
+}
+
+std::uint64_t BatchScheduler::piece_paths(std::size_t num_steps) {
+    const std::uint64_t block = block_paths(num_steps);
+    const std::uint64_t blocks = kPiecePathSteps / (block * std::max<std::size_t>(num_steps, 1));
+    return block * std::max<std::uint64_t>(blocks, 1);
+}
+
+double BatchScheduler::model_factor(const IPricingModel& model) const {
+    auto it = ns_per_path_step_.find(std::type_index(typeid(model)));
+    return it != ns_per_path_step_.end() ? it->second : kDefaultNsPerPathStep;
+}
+
+double BatchScheduler::estimate_ns(const BatchJob& job) const {
+    return static_cast<double>(job.num_paths) * static_cast<double>(job.num_steps) * model_factor(*job.model);
+}
+
+BatchPlan BatchScheduler::make_plan(const std::vector<BatchJob>& jobs, unsigned int num_workers) const {
+    if (jobs.empty()) {
+        throw ValidationError("Batch requires at least one job");
+    }
+
+    BatchPlan plan;
+    plan.piece_offsets.reserve(jobs.size() + 1);
+    plan.piece_offsets.push_back(0);
+    plan.job_estimates_ns.reserve(jobs.size());
+    double total_ns = 0.0;
+    for (const auto& job : jobs) {
+        validate(job);
+        const std::uint64_t pp = piece_paths(job.num_steps);
+        plan.piece_offsets.push_back(plan.piece_offsets.back() + (job.num_paths + pp - 1) / pp);
+        plan.job_estimates_ns.push_back(estimate_ns(job));
+        total_ns += plan.job_estimates_ns.back();
+    }
+    plan.target_item_ns = total_ns / (static_cast<double>(std::max(num_workers, 1u)) * kItemsPerWorker);
+
+    BatchPlan::Item pack;
+    for (std::size_t j = 0; j < jobs.size(); ++j) {
+        const double estimate = plan.job_estimates_ns[j];
+        const std::uint64_t num_pieces = plan.piece_offsets[j + 1] - plan.piece_offsets[j];
+
+        if (estimate <= plan.target_item_ns || num_pieces == 1) {
+            // Cheap jobs share an item until it reaches the target
+            if (!pack.segments.empty() && pack.estimated_ns + estimate > plan.target_item_ns) {
+                plan.items.push_back(std::move(pack));
+                pack = BatchPlan::Item{};
+            }
+            pack.segments.push_back({j, 0, num_pieces});
+            pack.estimated_ns += estimate;
+            continue;
+        }
+
+        // Expensive jobs are cut into items of about the target, spreading the pieces evenly
+        const std::uint64_t pp = piece_paths(jobs[j].num_steps);
+        const std::uint64_t num_items = std::min<std::uint64_t>(
+            num_pieces, static_cast<std::uint64_t>(std::ceil(estimate / plan.target_item_ns)));
+        for (std::uint64_t k = 0; k < num_items; ++k) {
+            const std::uint64_t first = k * num_pieces / num_items;
+            const std::uint64_t last = (k + 1) * num_pieces / num_items;
+            const std::uint64_t paths = std::min(jobs[j].num_paths, last * pp) - first * pp;
+            BatchPlan::Item item;
+            item.segments.push_back({j, first, last});
+            item.estimated_ns = estimate * static_cast<double>(paths) / static_cast<double>(jobs[j].num_paths);
+            plan.items.push_back(std::move(item));
+        }
+    }
+    if (!pack.segments.empty()) {
+        plan.items.push_back(std::move(pack));
+    }
+
+    // Largest first: the last items handed out are the ones that fit in the gaps
+    std::stable_sort(plan.items.begin(), plan.items.end(),
+                     [](const BatchPlan::Item& a, const BatchPlan::Item& b) {
+                         return a.estimated_ns > b.estimated_ns;
+                     });
+    return plan;
+}
+
+BatchResult BatchScheduler::run(const std::vector<BatchJob>& jobs, PricingWorkspace& workspace) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    MemoryScope memory_scope(MemorySubsystem::Pricer);
+
+    const BatchPlan plan = make_plan(jobs, workspace.num_workers());
+    const std::uint64_t num_pieces = plan.piece_offsets.back();
+
+    std::vector<double> discounts;
+    std::vector<std::shared_ptr<const IPricingModel::PathGrid>> grids;
+    discounts.reserve(jobs.size());
+    grids.reserve(jobs.size());
+    for (const auto& job : jobs) {
+        discounts.push_back(job.model->discount_factor(job.T));
+        grids.push_back(job.num_steps > 1 ? job.model->make_path_grid(job.num_steps, job.T) : nullptr);
+    }
+
+    std::vector<PathAccumulator> piece_sums(num_pieces);
+    std::vector<PieceTiming> timings(num_pieces);
+    const std::uint64_t call = workspace.claim_call();
+    std::atomic<std::size_t> next{0};
+    const auto batch_start = std::chrono::steady_clock::now();
+
+    auto worker_job = [&](unsigned int index) {
+        PricingWorkspace::WorkerState& state = workspace.worker(index);
+        for (std::size_t item = next.fetch_add(1, std::memory_order_relaxed);
+             item < plan.items.size();
+             item = next.fetch_add(1, std::memory_order_relaxed)) {
+            for (const auto& segment : plan.items[item].segments) {
+                const BatchJob& job = jobs[segment.job];
+                const std::uint64_t pp = piece_paths(job.num_steps);
+                for (std::uint64_t piece = segment.first_piece; piece < segment.last_piece; ++piece) {
+                    // Seeded by the piece's place in the batch, not by the item or worker running it
+                    const std::uint64_t global = plan.piece_offsets[segment.job] + piece;
+                    const auto piece_start = std::chrono::steady_clock::now();
+                    workspace.seed_stream(state.rng, call, global);
+                    price_piece(job, grids[segment.job].get(), discounts[segment.job], piece * pp,
+                                std::min(job.num_paths, (piece + 1) * pp), state, piece_sums[global]);
+                    timings[global] = {elapsed_ns(batch_start, piece_start),
+                                       elapsed_ns(batch_start, std::chrono::steady_clock::now())};
+                }
+            }
+        }
+    };
+    workspace.run(worker_job);
+
+    BatchResult result;
+    result.jobs.resize(jobs.size());
+    double first_start_ns = timings.front().start_ns;
+    double last_end_ns = 0.0;
+    double busy_ns = 0.0;
+
+    // Measured cost per model type, folded into the factors once the batch is in
+    struct Throughput {
+        double ns = 0.0;
+        double path_steps = 0.0;
+    };
+    std::unordered_map<std::type_index, Throughput> throughput;
+
+    for (std::size_t j = 0; j < jobs.size(); ++j) {
+        PathAccumulator sum;
+        double compute_ns = 0.0;
+        double job_start_ns = timings[plan.piece_offsets[j]].start_ns;
+        double job_end_ns = 0.0;
+        for (std::uint64_t g = plan.piece_offsets[j]; g < plan.piece_offsets[j + 1]; ++g) {
+            sum.merge(piece_sums[g]);
+            compute_ns += timings[g].end_ns - timings[g].start_ns;
+            job_start_ns = std::min(job_start_ns, timings[g].start_ns);
+            job_end_ns = std::max(job_end_ns, timings[g].end_ns);
+        }
+
+        BatchJobResult& job_result = result.jobs[j];
+        job_result.price = sum.mean();
+        job_result.standard_error = sum.standard_error();
+        job_result.num_paths = sum.count;
+        job_result.estimated_ms = plan.job_estimates_ns[j] * 1e-6;
+        job_result.compute_ms = compute_ns * 1e-6;
+        job_result.start_ms = job_start_ns * 1e-6;
+        job_result.latency_ms = job_end_ns * 1e-6;
+
+        first_start_ns = std::min(first_start_ns, job_start_ns);
+        last_end_ns = std::max(last_end_ns, job_end_ns);
+        busy_ns += compute_ns;
+
+        Throughput& t = throughput[std::type_index(typeid(*jobs[j].model))];
+        t.ns += compute_ns;
+        t.path_steps += static_cast<double>(jobs[j].num_paths) * static_cast<double>(jobs[j].num_steps);
+    }
+
+    for (const auto& [type, t] : throughput) {
+        if (t.path_steps <= 0.0 || t.ns <= 0.0) {
+            continue;
+        }
+        const double measured = t.ns / t.path_steps;
+        auto it = ns_per_path_step_.find(type);
+        if (it == ns_per_path_step_.end()) {
+            ns_per_path_step_.emplace(type, measured);
+        } else {
+            it->second += smoothing_ * (measured - it->second);
+        }
+    }
+
+    std::vector<double> latencies;
+    latencies.reserve(jobs.size());
+    double latency_sum = 0.0;
+    for (const auto& job_result : result.jobs) {
+        latencies.push_back(job_result.latency_ms);
+        latency_sum += job_result.latency_ms;
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    BatchStats& stats = result.stats;
+    stats.num_workers = workspace.num_workers();
+    stats.num_items = plan.items.size();
+    stats.makespan_ms = (last_end_ns - first_start_ns) * 1e-6;
+    stats.busy_ms = busy_ns * 1e-6;
+    stats.utilization = stats.makespan_ms > 0.0 ? stats.busy_ms / (stats.makespan_ms * stats.num_workers) : 0.0;
+    stats.mean_latency_ms = latency_sum / latencies.size();
+    stats.p50_latency_ms = percentile(latencies, 0.50);
+    stats.p95_latency_ms = percentile(latencies, 0.95);
+    stats.max_latency_ms = latencies.back();
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    result.computation_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    return result;
+}
+
+} // namespace montecarlo
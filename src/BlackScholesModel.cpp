@@ -1,24 +1,36 @@
 #include "BlackScholesModel.h"
-#include <random>
 #include <cmath>
 
-double BlackScholesModel::simulate_price(double S, double K, double r, double sigma, double T) const {
-    // Generate random normal variable
-    double Z = generate_normal_random();
-    
-    // Calculate drift and diffusion terms
-    double drift = (r - 0.5 * sigma * sigma) * T;
-    double diffusion = sigma * std::sqrt(T) * Z;
-    
-    // Calculate final price using geometric Brownian motion
-    return S * std::exp(drift + diffusion);
+void BlackScholesModel::simulate_terminal(const double* normals, double* terminal,
+                                          std::size_t count, double T) const {
+    // Calculate drift and diffusion terms once per block
+    double drift = (risk_free_rate_ - 0.5 * volatility_ * volatility_) * T;
+    double diffusion = volatility_ * std::sqrt(T);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        terminal[i] = initial_price_ * std::exp(drift + diffusion * normals[i]);
+    }
 }
 
-double BlackScholesModel::generate_normal_random() const {
-    // Use thread_local to ensure thread safety
-    thread_local std::random_device rd;
-    thread_local std::mt19937 gen(rd());
-    thread_local std::normal_distribution<> dist(0.0, 1.0);
-    
-    return dist(gen);
-} 
\ No newline at end of file
+void BlackScholesModel::simulate_paths(const double* normals, double* paths,
+                                       std::size_t count, std::size_t num_steps, double T) const {
+    double dt = T / num_steps;
+    double drift = (risk_free_rate_ - 0.5 * volatility_ * volatility_) * dt;
+    double diffusion = volatility_ * std::sqrt(dt);
+
+    // Step-major layout: each step reads the previous row of prices
+    for (std::size_t step = 0; step < num_steps; ++step) {
+        const double* z = normals + step * count;
+        double* current = paths + step * count;
+        if (step == 0) {
+            for (std::size_t i = 0; i < count; ++i) {
+                current[i] = initial_price_ * std::exp(drift + diffusion * z[i]);
+            }
+        } else {
+            const double* previous = current - count;
+            for (std::size_t i = 0; i < count; ++i) {
+                current[i] = previous[i] * std::exp(drift + diffusion * z[i]);
+            }
+        }
+    }
+}
@@ -1,11 +1,25 @@
 #include "Config.h"
+#include "MachineProfile.h"
+#include "MemoryStats.h"
+#include <cmath>
 #include <fstream>
-#include <thread>
 #include <stdexcept>
 
 namespace montecarlo {
 
+namespace {
+
+// {"times": [...], "values": [...], "interpolation": "constant" | "linear"}
+TermStructure parse_curve(const nlohmann::json& curve) {
+    return TermStructure(curve["times"].get<std::vector<double>>(),
+                         curve["values"].get<std::vector<double>>(),
+                         TermStructure::parse_interpolation(curve.value("interpolation", std::string("constant"))));
+}
+
+} // namespace
+
 Config Config::load(const std::string& filename) {
+    MemoryScope memory_scope(MemorySubsystem::Config);
     Config config;
     std::ifstream file(filename);
     if (!file.is_open()) {
@@ -16,32 +30,176 @@ Config Config::load(const std::string& filename) {
     file >> j;
 
     // Load simulation parameters
-    config.num_simulations = j["simulation"]["num_simulations"].get<unsigned int>();
-    if (j["simulation"]["num_threads"].get<std::string>() == "auto") {
-        config.num_threads = std::thread::hardware_concurrency();
+    config.num_simulations = j["simulation"]["num_simulations"].get<std::uint64_t>();
+    const auto& threads = j["simulation"]["num_threads"];
+    if (threads.is_string()) {
+        if (threads.get<std::string>() != "auto") {
+            throw std::runtime_error("Invalid thread count: " + threads.get<std::string>());
+        }
+        // Respects CPU affinity and container quotas; a machine profile may refine it
+        config.num_threads = MachineProfile::available_cpus();
+        config.auto_threads = true;
     } else {
         config.num_threads = j["simulation"]["num_threads"].get<unsigned int>();
     }
+    config.path_precision = parse_path_precision(
+        j["simulation"].value("path_precision", std::string("double")));
+    config.sampling = parse_sampling_method(
+        j["simulation"].value("sampling", std::string("mc")));
+    config.num_strata = j["simulation"].value("num_strata", config.num_strata);
+    std::string normal_generator = j["simulation"].value("normal_generator", std::string("auto"));
+    config.auto_normal_method = normal_generator == "auto";
+    if (!config.auto_normal_method) {
+        config.normal_method = parse_normal_method(normal_generator);
+    }
+    config.deadline_ms = j["simulation"].value("deadline_ms", 0.0);
+    config.max_standard_error = j["simulation"].value("max_standard_error", 0.0);
+    if (config.deadline_ms < 0.0 || config.max_standard_error < 0.0) {
+        throw std::runtime_error("Deadline and accuracy floor cannot be negative");
+    }
+    if (j["simulation"].contains("drift_shift")) {
+        const auto& shift = j["simulation"]["drift_shift"];
+        if (shift.is_string()) {
+            if (shift.get<std::string>() != "auto") {
+                throw std::runtime_error("Invalid drift shift: " + shift.get<std::string>());
+            }
+            config.auto_drift_shift = true;
+        } else {
+            config.drift_shift = shift.get<double>();
+        }
+    }
 
     // Load option parameters
     config.option_type = parse_option_type(j["option"]["type"].get<std::string>());
     config.S = j["option"]["parameters"]["S"].get<double>();
     config.K = j["option"]["parameters"]["K"].get<double>();
-    config.r = j["option"]["parameters"]["r"].get<double>();
-    config.sigma = j["option"]["parameters"]["sigma"].get<double>();
     config.T = j["option"]["parameters"]["T"].get<double>();
 
+    // Load optional term structures; flat r and sigma then become their averages
+    if (j["option"].contains("rate_curve")) {
+        config.rate_curve = parse_curve(j["option"]["rate_curve"]);
+    } else {
+        config.r = j["option"]["parameters"]["r"].get<double>();
+    }
+    if (j["option"].contains("vol_curve")) {
+        config.vol_curve = parse_curve(j["option"]["vol_curve"]);
+    } else {
+        config.sigma = j["option"]["parameters"]["sigma"].get<double>();
+    }
+    config.update_curve_averages();
+
+    // Load optional jump parameters
+    if (j["option"].contains("jumps")) {
+        const auto& jumps = j["option"]["jumps"];
+        config.jump_intensity = jumps["intensity"].get<double>();
+        config.jump_mean = jumps["mean"].get<double>();
+        config.jump_volatility = jumps["volatility"].get<double>();
+    }
+
+    // Load optional local volatility surface
+    if (j["option"].contains("local_vol")) {
+        const auto& surface = j["option"]["local_vol"];
+        config.local_vol_times = surface["times"].get<std::vector<double>>();
+        config.local_vol_spots = surface["spots"].get<std::vector<double>>();
+        for (const auto& row : surface["vols"]) {
+            for (const auto& value : row) {
+                config.local_vols.push_back(value.get<double>());
+            }
+        }
+        config.num_steps = surface.value("steps", 100u);
+    }
+
+    // Load optional barrier
+    if (j["option"].contains("barrier")) {
+        const auto& barrier = j["option"]["barrier"];
+        config.barrier_type = parse_barrier_type(barrier["type"].get<std::string>());
+        config.barrier_level = barrier["level"].get<double>();
+        config.barrier_rebate = barrier.value("rebate", 0.0);
+        config.barrier_monitoring = parse_barrier_monitoring(
+            barrier.value("monitoring", std::string("continuous")));
+        config.num_steps = barrier.value("steps", 10u);
+    }
+
+    // Load optional multi-asset parameters
+    if (j.contains("basket")) {
+        const auto& basket = j["basket"];
+        config.basket_payoff = basket.value("payoff", std::string("basket"));
+        if (config.basket_payoff != "basket" && config.basket_payoff != "best_of" &&
+            config.basket_payoff != "worst_of") {
+            throw std::runtime_error("Invalid basket payoff: " + config.basket_payoff);
+        }
+        for (const auto& asset : basket["assets"]) {
+            config.asset_spots.push_back(asset["S"].get<double>());
+            config.asset_volatilities.push_back(asset["sigma"].get<double>());
+            config.basket_weights.push_back(asset.value("weight", 1.0));
+        }
+        for (const auto& row : basket["correlation"]) {
+            for (const auto& value : row) {
+                config.correlation.push_back(value.get<double>());
+            }
+        }
+    }
+
     // Load output parameters
     config.precision = j["output"]["precision"].get<int>();
     config.show_timing = j["output"]["show_timing"].get<bool>();
+    config.report_memory = j["output"].value("memory_stats", false);
+    if (j["output"].contains("distribution")) {
+        const auto& distribution = j["output"]["distribution"];
+        config.report_distribution = true;
+        config.var_confidence = distribution.value("confidence", 0.99);
+        config.histogram_bins = distribution.value("bins", 20u);
+    }
 
     return config;
 }
 
+void Config::update_curve_averages() {
+    if (rate_curve) {
+        r = T > 0.0 ? rate_curve->integral(T) / T : rate_curve->value(0.0);
+    }
+    if (vol_curve) {
+        sigma = T > 0.0 ? std::sqrt(vol_curve->integral_of_square(T) / T) : vol_curve->value(0.0);
+    }
+}
+
 OptionType Config::parse_option_type(const std::string& type_str) {
     if (type_str == "call") return OptionType::Call;
     if (type_str == "put") return OptionType::Put;
     throw std::runtime_error("Invalid option type: " + type_str);
 }
 
+PathPrecision Config::parse_path_precision(const std::string& precision_str) {
+    if (precision_str == "double") return PathPrecision::Double;
+    if (precision_str == "float") return PathPrecision::Single;
+    throw std::runtime_error("Invalid path precision: " + precision_str);
+}
+
+SamplingMethod Config::parse_sampling_method(const std::string& method_str) {
+    if (method_str == "mc") return SamplingMethod::MonteCarlo;
+    if (method_str == "stratified") return SamplingMethod::Stratified;
+    if (method_str == "lhs") return SamplingMethod::LatinHypercube;
+    throw std::runtime_error("Invalid sampling method: " + method_str);
+}
+
+NormalMethod Config::parse_normal_method(const std::string& method_str) {
+    if (method_str == "ziggurat") return NormalMethod::Ziggurat;
+    if (method_str == "inverse_cdf") return NormalMethod::InverseCdf;
+    throw std::runtime_error("Invalid normal generator: " + method_str);
+}
+
+BarrierType Config::parse_barrier_type(const std::string& type_str) {
+    if (type_str == "up_and_out") return BarrierType::UpAndOut;
+    if (type_str == "up_and_in") return BarrierType::UpAndIn;
+    if (type_str == "down_and_out") return BarrierType::DownAndOut;
+    if (type_str == "down_and_in") return BarrierType::DownAndIn;
+    throw std::runtime_error("Invalid barrier type: " + type_str);
+}
+
+BarrierMonitoring Config::parse_barrier_monitoring(const std::string& monitoring_str) {
+    if (monitoring_str == "continuous") return BarrierMonitoring::Continuous;
+    if (monitoring_str == "discrete") return BarrierMonitoring::Discrete;
+    throw std::runtime_error("Invalid barrier monitoring: " + monitoring_str);
+}
+
 } // namespace montecarlo 
\ No newline at end of file
@@ -0,0 +1,151 @@
+// Counting replacement of the global allocation functions.
+//
+// Not part of libmontecarlo: linking this file into an executable makes every
+// operator new and delete in the process feed the counters in MemoryStats.h.
+// The test binary always links it; the command-line tool does when configured
+// with -DMONTECARLO_COUNT_ALLOCATIONS=ON.
+//
+// Each block carries a header recording its size and the subsystem charged,
+// so frees are credited to the subsystem that allocated the block whichever
+// thread releases it.
+
+#include "MemoryStats.h"
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+using montecarlo::MemorySubsystem;
+
+struct BlockHeader {
+    std::size_t size;
+    MemorySubsystem subsystem;
+};
+
+// Header space in front of unaligned blocks; keeps malloc's alignment
+constexpr std::size_t kHeaderSize = 16;
+static_assert(kHeaderSize >= sizeof(BlockHeader), "Block header does not fit");
+static_assert(kHeaderSize % alignof(std::max_align_t) == 0, "Header breaks malloc alignment");
+
+BlockHeader* header_of(void* p) {
+    return static_cast<BlockHeader*>(p) - 1;
+}
+
+void* finish_block(void* base, std::size_t offset, std::size_t size) {
+    void* p = static_cast<char*>(base) + offset;
+    *header_of(p) = {size, montecarlo::detail::record_allocation(size)};
+    return p;
+}
+
+void* allocate(std::size_t size) noexcept {
+    void* base = std::malloc(kHeaderSize + size);
+    return base ? finish_block(base, kHeaderSize, size) : nullptr;
+}
+
+void* allocate_aligned(std::size_t size, std::size_t align) noexcept {
+    // The header sits in a full alignment unit before the block
+    std::size_t offset = align < kHeaderSize ? kHeaderSize : align;
+    std::size_t rounded = (offset + size + align - 1) / align * align;
+#ifdef _MSC_VER
+    void* base = _aligned_malloc(rounded, align);
+#else
+    void* base = std::aligned_alloc(align, rounded);
+#endif
+    return base ? finish_block(base, offset, size) : nullptr;
+}
+
+void deallocate(void* p) noexcept {
+    if (!p) {
+        return;
+    }
+    BlockHeader* header = header_of(p);
+    montecarlo::detail::record_deallocation(header->size, header->subsystem);
+    std::free(static_cast<char*>(p) - kHeaderSize);
+}
+
+void deallocate_aligned(void* p, std::size_t align) noexcept {
+    if (!p) {
+        return;
+    }
+    BlockHeader* header = header_of(p);
+    montecarlo::detail::record_deallocation(header->size, header->subsystem);
+    std::size_t offset = align < kHeaderSize ? kHeaderSize : align;
+#ifdef _MSC_VER
+    _aligned_free(static_cast<char*>(p) - offset);
+#else
+    std::free(static_cast<char*>(p) - offset);
+#endif
+}
+
+void* allocate_or_throw(std::size_t size) {
+    for (;;) {
+        if (void* p = allocate(size)) {
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* allocate_aligned_or_throw(std::size_t size, std::size_t align) {
+    for (;;) {
+        if (void* p = allocate_aligned(size, align)) {
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return allocate_or_throw(size); }
+void* operator new[](std::size_t size) { return allocate_or_throw(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    return allocate_aligned_or_throw(size, static_cast<std::size_t>(align));
+}
+void* operator new[](std::size_t size, std::align_val_t align) {
+    return allocate_aligned_or_throw(size, static_cast<std::size_t>(align));
+}
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return allocate_aligned(size, static_cast<std::size_t>(align));
+}
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return allocate_aligned(size, static_cast<std::size_t>(align));
+}
+
+void operator delete(void* p) noexcept { deallocate(p); }
+void operator delete[](void* p) noexcept { deallocate(p); }
+void operator delete(void* p, std::size_t) noexcept { deallocate(p); }
+void operator delete[](void* p, std::size_t) noexcept { deallocate(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { deallocate(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { deallocate(p); }
+
+void operator delete(void* p, std::align_val_t align) noexcept {
+    deallocate_aligned(p, static_cast<std::size_t>(align));
+}
+void operator delete[](void* p, std::align_val_t align) noexcept {
+    deallocate_aligned(p, static_cast<std::size_t>(align));
+}
+void operator delete(void* p, std::size_t, std::align_val_t align) noexcept {
+    deallocate_aligned(p, static_cast<std::size_t>(align));
+}
+void operator delete[](void* p, std::size_t, std::align_val_t align) noexcept {
+    deallocate_aligned(p, static_cast<std::size_t>(align));
+}
+void operator delete(void* p, std::align_val_t align, const std::nothrow_t&) noexcept {
+    deallocate_aligned(p, static_cast<std::size_t>(align));
+}
+void operator delete[](void* p, std::align_val_t align, const std::nothrow_t&) noexcept {
+    deallocate_aligned(p, static_cast<std::size_t>(align));
+}
@@ -0,0 +1,281 @@
+#include "LocalVolModel.h"
+#include "Exceptions.h"
+#include "NormalGenerator.h"
+#include "Tape.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace montecarlo {
+
+namespace {
+
+// Locate the bracketing interval of x in nodes and the interpolation weight,
+// with flat extrapolation outside the node range
+void bracket(const std::vector<double>& nodes, double x, std::size_t& lower, double& weight) {
+    if (nodes.size() == 1 || x <= nodes.front()) {
+        lower = 0;
+        weight = 0.0;
+        return;
+    }
+    if (x >= nodes.back()) {
+        lower = nodes.size() - 2;
+        weight = 1.0;
+        return;
+    }
+    lower = static_cast<std::size_t>(std::upper_bound(nodes.begin(), nodes.end(), x) - nodes.begin()) - 1;
+    weight = (x - nodes[lower]) / (nodes[lower + 1] - nodes[lower]);
+}
+
+void require_increasing(const std::vector<double>& nodes, const char* what) {
+    if (nodes.empty()) {
+        throw ValidationError(std::string("Local volatility surface requires at least one ") + what);
+    }
+    for (std::size_t i = 1; i < nodes.size(); ++i) {
+        if (nodes[i] <= nodes[i - 1]) {
+            throw ValidationError(std::string("Local volatility ") + what + " nodes must be increasing");
+        }
+    }
+}
+
+// SplitMix64 stream of 32-bit values, for NormalGenerator. Keyed on a
+// path's normal and its position in the block, since normals made from 32
+// random bits repeat within large runs.
+class BridgeStream {
+public:
+    using result_type = std::uint32_t;
+
+    BridgeStream(double normal, std::size_t position) {
+        std::memcpy(&state_, &normal, sizeof(state_));
+        state_ ^= static_cast<std::uint64_t>(position) * 0xD1B54A32D192ED03ull;
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+    result_type operator()() {
+        std::uint64_t z = (state_ += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return static_cast<result_type>((z ^ (z >> 31)) >> 32);
+    }
+
+private:
+    std::uint64_t state_ = 0;
+};
+
+} // namespace
+
+LocalVolModel::LocalVolModel(double initial_price,
+                             double risk_free_rate,
+                             std::vector<double> times,
+                             std::vector<double> spots,
+                             std::vector<double> volatilities)
+    : initial_price_(initial_price),
+      risk_free_rate_(risk_free_rate),
+      times_(std::move(times)),
+      spots_(std::move(spots)),
+      volatilities_(std::move(volatilities)) {
+    if (initial_price_ <= 0.0) {
+        throw ValidationError("Initial stock price must be positive");
+    }
+    require_increasing(times_, "time");
+    require_increasing(spots_, "spot");
+    if (spots_.front() <= 0.0) {
+        throw ValidationError("Local volatility spot nodes must be positive");
+    }
+    if (volatilities_.size() != times_.size() * spots_.size()) {
+        throw ValidationError("Local volatility surface must have times x spots entries");
+    }
+    for (double sigma : volatilities_) {
+        if (sigma < 0.0) {
+            throw ValidationError("Local volatilities cannot be negative");
+        }
+    }
+}
+
+template <typename Scalar>
+Scalar LocalVolModel::interpolate(double t, double S, const Scalar* volatilities) const {
+    std::size_t i;
+    std::size_t j;
+    double wt;
+    double ws;
+    bracket(times_, t, i, wt);
+    bracket(spots_, S, j, ws);
+
+    const std::size_t n = spots_.size();
+    const std::size_t i1 = std::min(i + 1, times_.size() - 1);
+    const std::size_t j1 = std::min(j + 1, n - 1);
+    Scalar lower = (1.0 - ws) * volatilities[i * n + j] + ws * volatilities[i * n + j1];
+    Scalar upper = (1.0 - ws) * volatilities[i1 * n + j] + ws * volatilities[i1 * n + j1];
+    return (1.0 - wt) * lower + wt * upper;
+}
+
+double LocalVolModel::local_volatility(double t, double S) const {
+    return interpolate(t, S, volatilities_.data());
+}
+
+template <typename Scalar>
+void LocalVolModel::fill_coefficients(const Grid& grid, const Scalar* volatilities, Scalar* coefficients) const {
+    const std::size_t num_nodes = grid.num_cells + 1;
+    const double dx = (grid.x_max - grid.x_min) / static_cast<double>(grid.num_cells);
+    std::vector<Scalar> node_vols(num_nodes);
+    for (std::size_t step = 0; step < grid.num_steps; ++step) {
+        // Each step uses the volatility at its start time
+        const double t = step * grid.dt;
+        for (std::size_t k = 0; k < num_nodes; ++k) {
+            node_vols[k] = interpolate(t, std::exp(grid.x_min + k * dx), volatilities);
+        }
+
+        Scalar* slice = coefficients + step * grid.num_cells * 2;
+        for (std::size_t k = 0; k < grid.num_cells; ++k) {
+            const double x_k = grid.x_min + k * dx;
+            const Scalar b = (node_vols[k + 1] - node_vols[k]) * grid.inv_dx;
+            slice[2 * k] = node_vols[k] - b * x_k;
+            slice[2 * k + 1] = b;
+        }
+    }
+}
+
+LocalVolModel::Grid LocalVolModel::build_grid(double T, std::size_t num_steps, std::size_t num_nodes) const {
+    if (num_steps == 0) {
+        throw ValidationError("Local volatility simulation requires at least one time step");
+    }
+    if (num_nodes < 2) {
+        throw ValidationError("Local volatility grid requires at least two spot nodes");
+    }
+
+    Grid grid;
+    grid.num_steps = num_steps;
+    grid.T = T;
+    grid.num_cells = num_nodes - 1;
+    grid.dt = T / static_cast<double>(num_steps);
+    grid.sqrt_dt = std::sqrt(grid.dt);
+    grid.x_min = std::log(spots_.front());
+    grid.x_max = std::log(spots_.back());
+    if (grid.x_max <= grid.x_min) {
+        // Single spot node: the surface is flat in S, widen the axis around it
+        grid.x_max = grid.x_min + 1.0;
+    }
+    const double dx = (grid.x_max - grid.x_min) / static_cast<double>(grid.num_cells);
+    grid.inv_dx = 1.0 / dx;
+    grid.coefficients.resize(num_steps * grid.num_cells * 2);
+    fill_coefficients(grid, volatilities_.data(), grid.coefficients.data());
+    return grid;
+}
+
+std::vector<double> LocalVolModel::surface_sensitivities(const Grid& grid,
+                                                         const std::vector<double>& coefficient_adjoints) const {
+    if (coefficient_adjoints.size() != grid.coefficients.size()) {
+        throw ValidationError("Expected one sensitivity per grid coefficient");
+    }
+
+    Tape tape(volatilities_.size());
+    std::vector<Active> volatilities(volatilities_.size());
+    for (std::size_t i = 0; i < volatilities_.size(); ++i) {
+        volatilities[i] = Active::input(tape, static_cast<Tape::Index>(i), volatilities_[i]);
+    }
+    std::vector<Active> coefficients(grid.coefficients.size());
+    fill_coefficients(grid, volatilities.data(), coefficients.data());
+
+    for (std::size_t c = 0; c < coefficients.size(); ++c) {
+        tape.add_adjoint(coefficients[c].index(), coefficient_adjoints[c]);
+    }
+    tape.propagate();
+    return std::vector<double>(tape.input_adjoints(), tape.input_adjoints() + volatilities_.size());
+}
+
+void LocalVolModel::evolve_step(const Grid& grid,
+                                std::size_t step,
+                                const double* normals,
+                                double* log_spots,
+                                std::size_t num_paths) const {
+    const double r_dt = risk_free_rate_ * grid.dt;
+    for (std::size_t p = 0; p < num_paths; ++p) {
+        log_spots[p] = advance(grid, step, log_spots[p], normals[p], r_dt, grid.coefficients.data());
+    }
+}
+
+std::shared_ptr<const LocalVolModel::Grid> LocalVolModel::grid(double T, std::size_t num_steps) const {
+    std::lock_guard<std::mutex> lock(grid_mutex_);
+    if (!cached_grid_ || cached_grid_->T != T || cached_grid_->num_steps != num_steps) {
+        cached_grid_ = std::make_shared<const Grid>(build_grid(T, num_steps));
+    }
+    return cached_grid_;
+}
+
+void LocalVolModel::set_terminal_steps(std::size_t num_steps) {
+    if (num_steps == 0) {
+        throw ValidationError("Local volatility simulation requires at least one time step");
+    }
+    terminal_steps_ = num_steps;
+}
+
+void LocalVolModel::simulate_terminal(const double* normals, double* terminal,
+                                      std::size_t count, double T) const {
+    const auto terminal_grid = grid(T, terminal_steps_);
+    const std::size_t num_steps = terminal_grid->num_steps;
+    const double x0 = std::log(initial_price_);
+    const double r_dt = risk_free_rate_ * terminal_grid->dt;
+    const double* coefficients = terminal_grid->coefficients.data();
+
+    for (std::size_t p = 0; p < count; ++p) {
+        // Brownian motion still to come, in units of sqrt(dt); the bridge
+        // step over k of the remaining steps has mean remaining / k and
+        // variance (k - 1) / k, and the last step takes what is left
+        double remaining = normals[p] * std::sqrt(static_cast<double>(num_steps));
+        BridgeStream stream(normals[p], p);
+        double x = x0;
+        for (std::size_t step = 0; step < num_steps; ++step) {
+            const double k = static_cast<double>(num_steps - step);
+            double z = remaining;
+            if (k > 1.0) {
+                z = remaining / k + std::sqrt((k - 1.0) / k) * NormalGenerator::ziggurat(stream);
+            }
+            remaining -= z;
+            x = advance(*terminal_grid, step, x, z, r_dt, coefficients);
+        }
+        terminal[p] = std::exp(x);
+    }
+}
+
+void LocalVolModel::simulate_paths(const double* normals, double* paths,
+                                   std::size_t count, std::size_t num_steps, double T) const {
+    simulate_paths(*grid(T, num_steps), normals, paths, count);
+}
+
+std::shared_ptr<const IPricingModel::PathGrid> LocalVolModel::make_path_grid(std::size_t num_steps,
+                                                                             double T) const {
+    return grid(T, num_steps);
+}
+
+void LocalVolModel::simulate_grid_paths(const PathGrid& grid, const double* normals, double* paths,
+                                        std::size_t count) const {
+    simulate_paths(static_cast<const Grid&>(grid), normals, paths, count);
+}
+
+void LocalVolModel::simulate_paths(const Grid& grid, const double* normals, double* paths,
+                                   std::size_t count) const {
+    // Rows hold log spots while stepping, so each step reads the previous row
+    const double x0 = std::log(initial_price_);
+    const double r_dt = risk_free_rate_ * grid.dt;
+    for (std::size_t step = 0; step < grid.num_steps; ++step) {
+        const double* z = normals + step * count;
+        double* current = paths + step * count;
+        for (std::size_t p = 0; p < count; ++p) {
+            const double x = step == 0 ? x0 : current[p - count];
+            current[p] = advance(grid, step, x, z[p], r_dt, grid.coefficients.data());
+        }
+    }
+    for (std::size_t i = 0; i < grid.num_steps * count; ++i) {
+        paths[i] = std::exp(paths[i]);
+    }
+}
+
+double LocalVolModel::discount_factor(double T) const {
+    return std::exp(-risk_free_rate_ * T);
+}
+
+} // namespace montecarlo
@@ -0,0 +1,226 @@
+#include "LocalVolPricer.h"
+#include "Exceptions.h"
+#include "MemoryStats.h"
+#include "NormalGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+namespace montecarlo {
+
+LocalVolPricer::LocalVolPricer(const LocalVolModel& model,
+                               std::uint64_t num_simulations,
+                               unsigned int num_threads,
+                               unsigned int num_steps)
+    : model_(model),
+      num_simulations_(num_simulations),
+      num_threads_(num_threads),
+      num_steps_(num_steps) {
+}
+
+PricingResult LocalVolPricer::price_option(const Payoff& payoff, double T) {
+    PricingWorkspace workspace(num_threads_);
+    return price_option(payoff, T, workspace);
+}
+
+PricingResult LocalVolPricer::price_option(const Payoff& payoff, double T, PricingWorkspace& workspace) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    MemoryScope memory_scope(MemorySubsystem::Pricer);
+
+    const LocalVolModel::Grid grid = model_.build_grid(T, num_steps_);
+    const double x0 = std::log(model_.get_initial_price());
+
+    const auto plan = PricingWorkspace::ChunkPlan::for_paths(num_simulations_);
+    PathAccumulator* chunks = workspace.chunk_accumulators(plan.num_chunks);
+    BatchMeansAccumulator* batches = latin_hypercube_ ? workspace.batch_accumulators(plan.num_chunks) : nullptr;
+
+    auto job = [&](PricingWorkspace::WorkerState& state, std::uint64_t chunk,
+                   std::uint64_t start_idx, std::uint64_t end_idx) {
+        const unsigned int block_size = static_cast<unsigned int>(PricingWorkspace::kBlockSize);
+
+        // Scratch layout: log spots | stratum permutation
+        double* normals = state.buffer<double>();
+        double* log_spots = state.scratch_buffer(2 * PricingWorkspace::kBlockSize);
+        auto* permutation = reinterpret_cast<std::uint32_t*>(log_spots + PricingWorkspace::kBlockSize);
+        const NormalGenerator generator;
+
+        for (std::uint64_t i = start_idx; i < end_idx; i += block_size) {
+            unsigned int n = static_cast<unsigned int>(std::min<std::uint64_t>(block_size, end_idx - i));
+            std::fill(log_spots, log_spots + n, x0);
+
+            for (std::size_t step = 0; step < grid.num_steps; ++step) {
+                if (latin_hypercube_) {
+                    for (unsigned int j = 0; j < n; ++j) {
+                        permutation[j] = j;
+                    }
+                    std::shuffle(permutation, permutation + n, state.rng);
+                    for (unsigned int j = 0; j < n; ++j) {
+                        normals[j] = (permutation[j] + NormalGenerator::uniform(state.rng)) / n;
+                    }
+                    NormalGenerator::transform(normals, normals, n);
+                } else {
+                    generator.fill(state.rng, normals, n);
+                }
+                model_.evolve_step(grid, step, normals, log_spots, n);
+            }
+
+            PathAccumulator block;
+            for (unsigned int j = 0; j < n; ++j) {
+                block.add(payoff.calculate(std::exp(log_spots[j])));
+            }
+            chunks[chunk].merge(block);
+            if (latin_hypercube_) {
+                batches[chunk].add_batch(block);
+            }
+        }
+    };
+    workspace.run_chunks(plan, job);
+
+    // Merge in chunk order so seeded runs are reproducible
+    PathAccumulator total;
+    BatchMeansAccumulator batch_total;
+    for (std::uint64_t c = 0; c < plan.num_chunks; ++c) {
+        total.merge(chunks[c]);
+        if (latin_hypercube_) {
+            batch_total.merge(batches[c]);
+        }
+    }
+
+    double discount = model_.discount_factor(T);
+    double discounted_price = total.mean() * discount;
+    double standard_error = (latin_hypercube_ ? batch_total.standard_error() : total.standard_error()) * discount;
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto computation_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+
+    return {discounted_price, standard_error, computation_time};
+}
+
+LocalVolSensitivities LocalVolPricer::price_sensitivities(const Payoff& payoff, double T) {
+    PricingWorkspace workspace(num_threads_);
+    return price_sensitivities(payoff, T, workspace);
+}
+
+LocalVolSensitivities LocalVolPricer::price_sensitivities(const Payoff& payoff, double T,
+                                                          PricingWorkspace& workspace) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    MemoryScope memory_scope(MemorySubsystem::Pricer);
+
+    const auto terms = payoff.vanilla_terms();
+    if (!terms) {
+        throw ValidationError("Pathwise sensitivities require a vanilla call or put");
+    }
+    if (latin_hypercube_) {
+        throw ValidationError("Pathwise sensitivities are not available with Latin hypercube sampling");
+    }
+
+    const LocalVolModel::Grid grid = model_.build_grid(T, num_steps_);
+    const double S0 = model_.get_initial_price();
+    const double r = model_.get_risk_free_rate();
+    const double sign = terms->type == OptionType::Call ? 1.0 : -1.0;
+
+    // Tape inputs: S0, r, then the grid coefficients
+    constexpr Tape::Index kSpotInput = 0;
+    constexpr Tape::Index kRateInput = 1;
+    constexpr std::size_t kFirstCoefficient = 2;
+    const std::size_t num_inputs = kFirstCoefficient + grid.coefficients.size();
+    for (unsigned int w = 0; w < workspace.num_workers(); ++w) {
+        PricingWorkspace::WorkerState& state = workspace.worker(w);
+        if (state.tape.num_inputs() != num_inputs) {
+            state.tape.set_num_inputs(num_inputs);
+        } else {
+            state.tape.clear_input_adjoints();
+        }
+        // About ten nodes per path step
+        state.tape.reserve(kTapePaths * (10 * grid.num_steps + 2) + 2);
+
+        // Inputs record nothing and survive tape resets, so they are made once per call
+        Active* coefficients = state.active_buffer(grid.coefficients.size());
+        for (std::size_t c = 0; c < grid.coefficients.size(); ++c) {
+            coefficients[c] = Active::input(state.tape, static_cast<Tape::Index>(kFirstCoefficient + c),
+                                            grid.coefficients[c]);
+        }
+    }
+
+    const auto plan = PricingWorkspace::ChunkPlan::for_paths(num_simulations_);
+    PathAccumulator* chunks = workspace.chunk_accumulators(plan.num_chunks);
+
+    auto job = [&](PricingWorkspace::WorkerState& state, std::uint64_t chunk,
+                   std::uint64_t start_idx, std::uint64_t end_idx) {
+        const unsigned int block_size = static_cast<unsigned int>(PricingWorkspace::kBlockSize);
+        Tape& tape = state.tape;
+        const Active* coefficients = state.actives.data();
+
+        // Normals for every step of a block, step-major, drawn in the order price_option draws them
+        double* normals = state.scratch_buffer(grid.num_steps * PricingWorkspace::kBlockSize);
+        const NormalGenerator generator;
+
+        for (std::uint64_t i = start_idx; i < end_idx; i += block_size) {
+            unsigned int n = static_cast<unsigned int>(std::min<std::uint64_t>(block_size, end_idx - i));
+            for (std::size_t step = 0; step < grid.num_steps; ++step) {
+                generator.fill(state.rng, normals + step * n, n);
+            }
+
+            PathAccumulator block;
+            for (unsigned int first = 0; first < n; first += kTapePaths) {
+                const unsigned int last = std::min(n, first + kTapePaths);
+                tape.reset();
+                const Active x0 = log(Active::input(tape, kSpotInput, S0));
+                const Active r_dt = Active::input(tape, kRateInput, r) * grid.dt;
+
+                for (unsigned int p = first; p < last; ++p) {
+                    Active x = x0;
+                    for (std::size_t step = 0; step < grid.num_steps; ++step) {
+                        x = LocalVolModel::advance(grid, step, x, normals[step * n + p], r_dt, coefficients);
+                    }
+
+                    const Active terminal = exp(x);
+                    const double intrinsic = sign * (terminal.value() - terms->strike);
+                    block.add(std::max(intrinsic, 0.0));
+                    if (intrinsic > 0.0) {
+                        tape.add_adjoint(terminal.index(), sign);
+                    }
+                }
+                tape.propagate();
+            }
+            chunks[chunk].merge(block);
+        }
+    };
+    workspace.run_chunks(plan, job);
+
+    // Merge prices in chunk order and adjoints in worker order
+    PathAccumulator total;
+    for (std::uint64_t c = 0; c < plan.num_chunks; ++c) {
+        total.merge(chunks[c]);
+    }
+    std::vector<double> adjoints(num_inputs, 0.0);
+    for (unsigned int w = 0; w < workspace.num_workers(); ++w) {
+        const double* tape_adjoints = workspace.worker(w).tape.input_adjoints();
+        for (std::size_t k = 0; k < num_inputs; ++k) {
+            adjoints[k] += tape_adjoints[k];
+        }
+    }
+
+    const double discount = model_.discount_factor(T);
+    const double scale = discount / static_cast<double>(total.count);
+
+    LocalVolSensitivities result;
+    result.pricing.price = total.mean() * discount;
+    result.pricing.standard_error = total.standard_error() * discount;
+    result.delta = adjoints[kSpotInput] * scale;
+    // r also discounts the payoff
+    result.rho = adjoints[kRateInput] * scale - T * result.pricing.price;
+
+    std::vector<double> coefficient_adjoints(adjoints.begin() + kFirstCoefficient, adjoints.end());
+    for (double& adjoint : coefficient_adjoints) {
+        adjoint *= scale;
+    }
+    result.vegas = model_.surface_sensitivities(grid, coefficient_adjoints);
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    result.pricing.computation_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    return result;
+}
+
+} // namespace montecarlo
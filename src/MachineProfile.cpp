@@ -0,0 +1,361 @@
+#include "MachineProfile.h"
+#include "BlackScholesModel.h"
+#include "CallPayoff.h"
+#include "Exceptions.h"
+#include "OptionPricer.h"
+#include "nlohmann/json.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace montecarlo {
+
+namespace {
+
+std::string trim(const std::string& text) {
+    const char* whitespace = " \t\r\n";
+    std::size_t first = text.find_first_not_of(whitespace);
+    if (first == std::string::npos) {
+        return "";
+    }
+    std::size_t last = text.find_last_not_of(whitespace);
+    return text.substr(first, last - first + 1);
+}
+
+bool same_key(const MachineProfile& profile, const std::string& cpu_model, double cpu_quota) {
+    return profile.cpu_model == cpu_model && std::abs(profile.cpu_quota - cpu_quota) < 1e-6;
+}
+
+nlohmann::json to_json(const MachineProfile& profile) {
+    return {
+        {"cpu_model", profile.cpu_model},
+        {"cpu_quota", profile.cpu_quota},
+        {"num_threads", profile.num_threads},
+        {"chunk_size", profile.chunk_size},
+        {"normal_generator", to_string(profile.normal_method)},
+        {"serial_threshold", profile.serial_threshold},
+        {"paths_per_second", profile.paths_per_second}
+    };
+}
+
+MachineProfile from_json(const nlohmann::json& j) {
+    MachineProfile profile;
+    profile.cpu_model = j.at("cpu_model").get<std::string>();
+    profile.cpu_quota = j.at("cpu_quota").get<double>();
+    profile.num_threads = std::max(1u, j.at("num_threads").get<unsigned int>());
+    profile.chunk_size = j.at("chunk_size").get<std::uint64_t>();
+    std::string method = j.at("normal_generator").get<std::string>();
+    if (method == "ziggurat") {
+        profile.normal_method = NormalMethod::Ziggurat;
+    } else if (method == "inverse_cdf") {
+        profile.normal_method = NormalMethod::InverseCdf;
+    } else {
+        throw ConfigError("Invalid normal generator in machine profile: " + method);
+    }
+    profile.serial_threshold = j.value("serial_threshold", std::uint64_t{0});
+    profile.paths_per_second = j.value("paths_per_second", 0.0);
+    return profile;
+}
+
+// Entries of a profile file; a missing file has none
+std::vector<MachineProfile> read_profiles(const std::string& filename) {
+    std::vector<MachineProfile> profiles;
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return profiles;
+    }
+
+    try {
+        nlohmann::json j;
+        file >> j;
+        int version = j.value("version", 0);
+        if (version != MachineProfile::kVersion) {
+            throw ConfigError("Machine profile " + filename + " has version " + std::to_string(version) +
+                              ", expected " + std::to_string(MachineProfile::kVersion) + "; re-run --tune");
+        }
+        for (const auto& entry : j.at("profiles")) {
+            profiles.push_back(from_json(entry));
+        }
+    } catch (const nlohmann::json::exception& e) {
+        throw ConfigError("Malformed machine profile " + filename + ": " + e.what());
+    }
+    return profiles;
+}
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    std::size_t middle = values.size() / 2;
+    return values.size() % 2 != 0 ? values[middle] : 0.5 * (values[middle - 1] + values[middle]);
+}
+
+struct TuneSettings {
+    unsigned int num_threads;
+    std::uint64_t chunk_size;
+    NormalMethod normal_method;
+};
+
+// Median seconds per call of a Black-Scholes call priced with the given settings.
+// With a shared workspace the thread pool is reused, as in a pricing service;
+// without one every call builds its own, as price_option(payoff, T) does.
+double time_calls(const TuneSettings& settings, std::uint64_t paths, unsigned int repeats,
+                  bool shared_workspace) {
+    BlackScholesModel model(100.0, 0.05, 0.2);
+    CallPayoff call(100.0);
+    OptionPricer pricer(model, paths, settings.num_threads);
+    pricer.set_chunk_size(settings.chunk_size);
+    pricer.set_normal_method(settings.normal_method);
+    std::optional<PricingWorkspace> workspace;
+    if (shared_workspace) {
+        workspace.emplace(settings.num_threads, 1);
+    }
+
+    auto run = [&] {
+        if (workspace) {
+            pricer.price_option(call, 1.0, *workspace);
+        } else {
+            pricer.price_option(call, 1.0);
+        }
+    };
+
+    // Warm-up: first-touch page faults and thread wake-up
+    run();
+
+    std::vector<double> seconds;
+    seconds.reserve(repeats);
+    for (unsigned int i = 0; i < repeats; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        auto end = std::chrono::steady_clock::now();
+        seconds.push_back(std::chrono::duration<double>(end - start).count());
+    }
+    return std::max(median(seconds), 1e-9);
+}
+
+} // namespace
+
+std::string MachineProfile::current_cpu_model() {
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        std::size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            continue;
+        }
+        std::string key = trim(line.substr(0, colon));
+        if (key == "model name" || key == "Model" || key == "Hardware") {
+            std::string value = trim(line.substr(colon + 1));
+            if (!value.empty()) {
+                return value;
+            }
+        }
+    }
+    return "unknown";
+}
+
+double MachineProfile::current_cpu_quota() {
+    // cgroup v2: "<quota> <period>" or "max <period>"
+    std::ifstream cpu_max("/sys/fs/cgroup/cpu.max");
+    if (cpu_max.is_open()) {
+        std::string quota;
+        double period = 0.0;
+        if (cpu_max >> quota >> period && quota != "max" && period > 0.0) {
+            return std::stod(quota) / period;
+        }
+        return 0.0;
+    }
+
+    // cgroup v1: a negative quota means unlimited
+    std::ifstream quota_file("/sys/fs/cgroup/cpu/cpu.cfs_quota_us");
+    std::ifstream period_file("/sys/fs/cgroup/cpu/cpu.cfs_period_us");
+    double quota = 0.0;
+    double period = 0.0;
+    if (quota_file >> quota && period_file >> period && quota > 0.0 && period > 0.0) {
+        return quota / period;
+    }
+    return 0.0;
+}
+
+unsigned int MachineProfile::available_cpus() {
+    unsigned int cpus = std::thread::hardware_concurrency();
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        cpus = static_cast<unsigned int>(CPU_COUNT(&set));
+    }
+#endif
+    double quota = current_cpu_quota();
+    if (quota > 0.0) {
+        cpus = std::min(cpus, static_cast<unsigned int>(std::ceil(quota)));
+    }
+    return std::max(cpus, 1u);
+}
+
+std::string MachineProfile::default_path() {
+    if (const char* path = std::getenv("MONTECARLO_PROFILE")) {
+        return path;
+    }
+    const char* home = std::getenv("HOME");
+    if (!home) {
+        home = std::getenv("USERPROFILE");
+    }
+    std::filesystem::path directory = home ? std::filesystem::path(home) / ".montecarlo" : ".montecarlo";
+    return (directory / "machine_profile.json").string();
+}
+
+std::optional<MachineProfile> MachineProfile::find(const std::string& filename,
+                                                   const std::string& cpu_model,
+                                                   double cpu_quota) {
+    for (const auto& profile : read_profiles(filename)) {
+        if (same_key(profile, cpu_model, cpu_quota)) {
+            return profile;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<MachineProfile> MachineProfile::find(const std::string& filename) {
+    return find(filename, current_cpu_model(), current_cpu_quota());
+}
+
+void MachineProfile::save(const std::string& filename) const {
+    std::vector<MachineProfile> profiles;
+    try {
+        profiles = read_profiles(filename);
+    } catch (const ConfigError&) {
+        // A stale or corrupt file is replaced by the new profile
+    }
+    profiles.erase(std::remove_if(profiles.begin(), profiles.end(),
+                                  [this](const MachineProfile& p) { return same_key(p, cpu_model, cpu_quota); }),
+                   profiles.end());
+    profiles.push_back(*this);
+
+    std::filesystem::path path(filename);
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
+    }
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file for writing: " + filename);
+    }
+
+    nlohmann::json entries = nlohmann::json::array();
+    for (const auto& profile : profiles) {
+        entries.push_back(to_json(profile));
+    }
+    nlohmann::json j;
+    j["version"] = kVersion;
+    j["profiles"] = entries;
+    file << std::setw(4) << j << std::endl;
+}
+
+MachineProfile tune_machine(const TuneOptions& options,
+                            const std::function<void(const TuneMeasurement&)>& progress) {
+    const std::uint64_t paths = std::max<std::uint64_t>(options.benchmark_paths, PricingWorkspace::kBlockSize);
+    const unsigned int repeats = std::max(options.repeats, 1u);
+    const unsigned int max_threads = options.max_threads > 0 ? options.max_threads : MachineProfile::available_cpus();
+
+    auto report = [&](const char* stage, const std::string& setting, double paths_per_second) {
+        if (progress) {
+            progress({stage, setting, paths_per_second});
+        }
+    };
+
+    TuneSettings best{1, PricingWorkspace::kChunkSize, NormalMethod::Ziggurat};
+
+    // Thread count: hyperthreads and throttled quotas often add nothing, so
+    // the smallest count within the tolerance of the fastest wins
+    std::vector<unsigned int> thread_counts;
+    for (unsigned int t = 1; t < max_threads; t *= 2) {
+        thread_counts.push_back(t);
+    }
+    thread_counts.push_back(max_threads);
+
+    std::vector<double> thread_throughput;
+    for (unsigned int t : thread_counts) {
+        TuneSettings settings = best;
+        settings.num_threads = t;
+        thread_throughput.push_back(paths / time_calls(settings, paths, repeats, true));
+        report("threads", std::to_string(t), thread_throughput.back());
+    }
+    double fastest = *std::max_element(thread_throughput.begin(), thread_throughput.end());
+    for (std::size_t i = 0; i < thread_counts.size(); ++i) {
+        if (thread_throughput[i] >= (1.0 - options.tolerance) * fastest) {
+            best.num_threads = thread_counts[i];
+            break;
+        }
+    }
+
+    // Chunk size at the chosen thread count; the default is kept unless beaten
+    double best_throughput = 0.0;
+    const std::uint64_t default_chunk = PricingWorkspace::kChunkSize;
+    for (std::uint64_t chunk : {default_chunk, default_chunk / 8, default_chunk / 4, default_chunk / 2,
+                                default_chunk * 2, default_chunk * 4}) {
+        TuneSettings settings = best;
+        settings.chunk_size = chunk;
+        double throughput = paths / time_calls(settings, paths, repeats, true);
+        report("chunk_size", std::to_string(chunk), throughput);
+        if (throughput > best_throughput) {
+            best_throughput = throughput;
+            best.chunk_size = chunk;
+        }
+    }
+
+    // Normal generator: both are exact, so only speed matters
+    {
+        TuneSettings settings = best;
+        settings.normal_method = NormalMethod::InverseCdf;
+        double throughput = paths / time_calls(settings, paths, repeats, true);
+        report("normal_generator", to_string(settings.normal_method), throughput);
+        if (throughput > best_throughput) {
+            best_throughput = throughput;
+            best.normal_method = settings.normal_method;
+        }
+    }
+
+    // Small-job cutoff: the smallest job size from which a freshly built
+    // multi-threaded workspace beats one worker at every larger size tried
+    std::uint64_t serial_threshold = 0;
+    if (best.num_threads > 1) {
+        TuneSettings serial = best;
+        serial.num_threads = 1;
+        std::vector<std::uint64_t> sizes;
+        for (std::uint64_t n = PricingWorkspace::kBlockSize; n <= paths; n *= 2) {
+            sizes.push_back(n);
+        }
+        serial_threshold = sizes.back() * 2;
+        for (std::size_t i = sizes.size(); i-- > 0;) {
+            double serial_seconds = time_calls(serial, sizes[i], repeats, false);
+            double parallel_seconds = time_calls(best, sizes[i], repeats, false);
+            report("serial_threshold", "1 thread, " + std::to_string(sizes[i]) + " paths", sizes[i] / serial_seconds);
+            report("serial_threshold", std::to_string(best.num_threads) + " threads, " +
+                   std::to_string(sizes[i]) + " paths", sizes[i] / parallel_seconds);
+            if (parallel_seconds >= serial_seconds) {
+                break;
+            }
+            serial_threshold = sizes[i];
+        }
+    }
+
+    MachineProfile profile;
+    profile.cpu_model = MachineProfile::current_cpu_model();
+    profile.cpu_quota = MachineProfile::current_cpu_quota();
+    profile.num_threads = best.num_threads;
+    profile.chunk_size = best.chunk_size;
+    profile.normal_method = best.normal_method;
+    profile.serial_threshold = serial_threshold;
+    profile.paths_per_second = best_throughput;
+    return profile;
+}
+
+} // namespace montecarlo
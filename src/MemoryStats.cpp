@@ -0,0 +1,170 @@
+#include "MemoryStats.h"
+#include <atomic>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace montecarlo {
+
+namespace {
+
+struct AtomicCounters {
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> deallocations{0};
+    std::atomic<std::uint64_t> bytes_allocated{0};
+    std::atomic<std::int64_t> live_bytes{0};
+
+    MemoryCounters load() const {
+        MemoryCounters counters;
+        counters.allocations = allocations.load(std::memory_order_relaxed);
+        counters.deallocations = deallocations.load(std::memory_order_relaxed);
+        counters.bytes_allocated = bytes_allocated.load(std::memory_order_relaxed);
+        counters.live_bytes = live_bytes.load(std::memory_order_relaxed);
+        return counters;
+    }
+};
+
+// Constant-initialized, so they are usable by allocations made before main
+std::atomic<bool> g_counted{false};
+AtomicCounters g_total;
+AtomicCounters g_subsystems[kNumMemorySubsystems];
+std::atomic<std::int64_t> g_peak_live_bytes{0};
+
+thread_local MemorySubsystem t_subsystem = MemorySubsystem::Other;
+
+} // namespace
+
+namespace detail {
+
+MemorySubsystem record_allocation(std::size_t bytes) noexcept {
+    const MemorySubsystem subsystem = t_subsystem;
+    const auto size = static_cast<std::int64_t>(bytes);
+    AtomicCounters& own = g_subsystems[static_cast<std::size_t>(subsystem)];
+    for (AtomicCounters* counters : {&g_total, &own}) {
+        counters->allocations.fetch_add(1, std::memory_order_relaxed);
+        counters->bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    own.live_bytes.fetch_add(size, std::memory_order_relaxed);
+    const std::int64_t live = g_total.live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+
+    std::int64_t peak = g_peak_live_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !g_peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+    if (!g_counted.load(std::memory_order_relaxed)) {
+        g_counted.store(true, std::memory_order_relaxed);
+    }
+    return subsystem;
+}
+
+void record_deallocation(std::size_t bytes, MemorySubsystem subsystem) noexcept {
+    const auto size = static_cast<std::int64_t>(bytes);
+    AtomicCounters& own = g_subsystems[static_cast<std::size_t>(subsystem)];
+    for (AtomicCounters* counters : {&g_total, &own}) {
+        counters->deallocations.fetch_add(1, std::memory_order_relaxed);
+        counters->live_bytes.fetch_sub(size, std::memory_order_relaxed);
+    }
+}
+
+} // namespace detail
+
+bool allocations_counted() {
+    return g_counted.load(std::memory_order_relaxed);
+}
+
+MemoryStats memory_stats() {
+    MemoryStats stats;
+    stats.counted = allocations_counted();
+    stats.total = g_total.load();
+    for (std::size_t i = 0; i < kNumMemorySubsystems; ++i) {
+        stats.subsystems[i] = g_subsystems[i].load();
+    }
+    stats.peak_live_bytes = g_peak_live_bytes.load(std::memory_order_relaxed);
+    stats.peak_rss_kb = peak_rss_kb();
+    stats.current_rss_kb = current_rss_kb();
+    return stats;
+}
+
+void reset_peak_live_bytes() {
+    g_peak_live_bytes.store(g_total.live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+std::size_t peak_rss_kb() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize / 1024;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+        return static_cast<std::size_t>(usage.ru_maxrss) / 1024;  // Bytes on macOS
+#else
+        return static_cast<std::size_t>(usage.ru_maxrss);         // KiB on Linux
+#endif
+    }
+    return 0;
+#endif
+}
+
+std::size_t current_rss_kb() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.WorkingSetSize / 1024;
+    }
+    return 0;
+#elif defined(__linux__)
+    // Second field of statm: resident pages. Read with stdio, which does not
+    // go through operator new, so sampling leaves the heap counters alone
+    std::FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (!statm) {
+        return 0;
+    }
+    unsigned long size_pages = 0;
+    unsigned long resident_pages = 0;
+    int fields = std::fscanf(statm, "%lu %lu", &size_pages, &resident_pages);
+    std::fclose(statm);
+    if (fields != 2) {
+        return 0;
+    }
+    return static_cast<std::size_t>(resident_pages) * static_cast<std::size_t>(sysconf(_SC_PAGESIZE)) / 1024;
+#else
+    return 0;
+#endif
+}
+
+MemorySubsystem current_memory_subsystem() {
+    return t_subsystem;
+}
+
+MemoryScope::MemoryScope(MemorySubsystem subsystem)
+    : previous_(t_subsystem) {
+    t_subsystem = subsystem;
+}
+
+MemoryScope::~MemoryScope() {
+    t_subsystem = previous_;
+}
+
+void AllocationCounter::reset() {
+    allocations_ = g_total.allocations.load(std::memory_order_relaxed);
+    bytes_allocated_ = g_total.bytes_allocated.load(std::memory_order_relaxed);
+}
+
+std::uint64_t AllocationCounter::allocations() const {
+    return g_total.allocations.load(std::memory_order_relaxed) - allocations_;
+}
+
+std::uint64_t AllocationCounter::bytes_allocated() const {
+    return g_total.bytes_allocated.load(std::memory_order_relaxed) - bytes_allocated_;
+}
+
+} // namespace montecarlo
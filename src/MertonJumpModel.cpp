@@ -0,0 +1,410 @@
+#include "MertonJumpModel.h"
+#include "Analytics.h"
+#include "Exceptions.h"
+#include <algorithm>
+#include <cmath>
+
+namespace montecarlo {
+
+namespace {
+
+// Poisson tail mass below which the sampling table and series are truncated
+constexpr double kTailTolerance = 1e-15;
+
+// Hard cap on tabulated jump counts, reached only for very large lambda * T
+constexpr std::size_t kMaxJumps = 512;
+
+// Newton iterations on the mixture CDF before settling for the bracket midpoint
+constexpr int kMaxQuantileIterations = 60;
+
+// Step, relative to 1 + |x|, at which the Newton iteration stops
+constexpr double kQuantileRootTolerance = 1e-13;
+
+constexpr double kInvSqrtTwoPi = 0.3989422804014327;
+
+// Normals tabulated by the quantile table; beyond them, about two draws in a
+// billion, the quantile is found by root search
+constexpr double kQuantileRange = 6.0;
+constexpr std::size_t kQuantileIntervals = 256;
+
+// Interpolation error allowed at a piece midpoint, in units of z, on top of
+// twice the root search's own tolerance
+constexpr double kQuantileTolerance = 1e-12;
+
+// Halvings of an interval before it is left to root search
+constexpr int kMaxQuantileDepth = 8;
+
+// Lower (z <= 0) or upper (z > 0) tail probability of a standard normal at y,
+// whichever keeps full relative precision on the side of z
+double tail_probability(double y, bool upper) {
+    return 0.5 * std::erfc((upper ? y : -y) / std::sqrt(2.0));
+}
+
+// Log price at which the Poisson mixture of normals in the tables has the
+// probability of the standard normal z, iterated from start. The quantile
+// lies between the smallest and largest component quantiles, so Newton steps
+// that leave that bracket fall back to bisection.
+double mixture_quantile(const MertonJumpModel::TerminalTables& tables, double z, double start) {
+    const bool upper = z > 0.0;
+    const double target = tail_probability(z, upper);
+    const std::size_t terms = tables.poisson_cdf.size();
+
+    double low = tables.log_mean[0] + tables.log_stdev[0] * z;
+    double high = low;
+    for (std::size_t n = 1; n < terms; ++n) {
+        const double x_n = tables.log_mean[n] + tables.log_stdev[n] * z;
+        low = std::min(low, x_n);
+        high = std::max(high, x_n);
+    }
+    if (high - low <= 0.0) {
+        return low;
+    }
+    double x = std::min(std::max(start, low), high);
+
+    const double tolerance = kQuantileRootTolerance * (1.0 + std::abs(x));
+    for (int iteration = 0; iteration < kMaxQuantileIterations; ++iteration) {
+        // Signed so that the residual increases with x on both sides
+        double residual = upper ? target : -target;
+        double density = 0.0;
+        double previous_cdf = 0.0;
+        for (std::size_t n = 0; n < terms; ++n) {
+            const double weight = tables.poisson_cdf[n] - previous_cdf;
+            previous_cdf = tables.poisson_cdf[n];
+            const double stdev = tables.log_stdev[n];
+            const double offset = x - tables.log_mean[n];
+            if (stdev > 0.0) {
+                const double y = offset / stdev;
+                const double tail = tail_probability(y, upper);
+                residual += upper ? -weight * tail : weight * tail;
+                density += weight * kInvSqrtTwoPi * std::exp(-0.5 * y * y) / stdev;
+            } else if (upper ? offset < 0.0 : offset >= 0.0) {
+                // Point mass: counts in the tail on the side of z
+                residual += upper ? -weight : weight;
+            }
+        }
+
+        if (residual > 0.0) {
+            high = x;
+        } else {
+            low = x;
+        }
+        double next = density > 0.0 ? x - residual / density : 0.5 * (low + high);
+        if (!(next > low && next < high)) {
+            next = 0.5 * (low + high);
+        }
+        if (std::abs(next - x) < tolerance || high - low < tolerance) {
+            return next;
+        }
+        x = next;
+    }
+    return 0.5 * (low + high);
+}
+
+// Mixture quantile at z, iterated from the normal with the mixture's mean and variance
+double mixture_quantile(const MertonJumpModel::TerminalTables& tables, double z) {
+    double mean = 0.0;
+    double second_moment = 0.0;
+    double previous_cdf = 0.0;
+    for (std::size_t n = 0; n < tables.poisson_cdf.size(); ++n) {
+        const double weight = tables.poisson_cdf[n] - previous_cdf;
+        previous_cdf = tables.poisson_cdf[n];
+        mean += weight * tables.log_mean[n];
+        second_moment += weight * (tables.log_stdev[n] * tables.log_stdev[n] +
+                                   tables.log_mean[n] * tables.log_mean[n]);
+    }
+    return mixture_quantile(tables, z, mean + std::sqrt(std::max(second_moment - mean * mean, 0.0)) * z);
+}
+
+// Slope dx/dz = phi(z) / f(x) of the mixture quantile x at z, from the
+// mixture density f
+double quantile_slope(const MertonJumpModel::TerminalTables& tables, double z, double x) {
+    double density = 0.0;
+    double previous_cdf = 0.0;
+    for (std::size_t n = 0; n < tables.poisson_cdf.size(); ++n) {
+        const double weight = tables.poisson_cdf[n] - previous_cdf;
+        previous_cdf = tables.poisson_cdf[n];
+        const double y = (x - tables.log_mean[n]) / tables.log_stdev[n];
+        density += weight * std::exp(-0.5 * y * y) / tables.log_stdev[n];
+    }
+    return std::exp(-0.5 * z * z) / density;
+}
+
+// Path grid of a Merton model: every step has the same law
+struct StepGrid : IPricingModel::PathGrid {
+    std::shared_ptr<const MertonJumpModel::QuantileTable> table;
+};
+
+// Cubic Hermite interpolation at fraction t of a piece of width h
+double hermite(double x0, double s0, double x1, double s1, double h, double t) {
+    const double t2 = t * t;
+    const double t3 = t2 * t;
+    return (2.0 * t3 - 3.0 * t2 + 1.0) * x0 + (t3 - 2.0 * t2 + t) * h * s0 +
+           (-2.0 * t3 + 3.0 * t2) * x1 + (t3 - t2) * h * s1;
+}
+
+} // namespace
+
+MertonJumpModel::MertonJumpModel(double initial_price,
+                                 double risk_free_rate,
+                                 double volatility,
+                                 double jump_intensity,
+                                 double jump_mean,
+                                 double jump_volatility)
+    : initial_price_(initial_price),
+      risk_free_rate_(risk_free_rate),
+      volatility_(volatility),
+      jump_intensity_(jump_intensity),
+      jump_mean_(jump_mean),
+      jump_volatility_(jump_volatility) {
+    if (initial_price_ <= 0.0) {
+        throw ValidationError("Initial stock price must be positive");
+    }
+    if (volatility_ < 0.0 || jump_volatility_ < 0.0) {
+        throw ValidationError("Volatilities cannot be negative");
+    }
+    if (jump_intensity_ < 0.0) {
+        throw ValidationError("Jump intensity cannot be negative");
+    }
+}
+
+double MertonJumpModel::jump_compensator() const {
+    return std::exp(jump_mean_ + 0.5 * jump_volatility_ * jump_volatility_) - 1.0;
+}
+
+MertonJumpModel::TerminalTables MertonJumpModel::prepare(double T) const {
+    TerminalTables tables;
+    const double lambda_T = jump_intensity_ * T;
+    const double drift = (risk_free_rate_ - jump_intensity_ * jump_compensator()
+                          - 0.5 * volatility_ * volatility_) * T;
+    const double diffusion_variance = volatility_ * volatility_ * T;
+
+    double probability = std::exp(-lambda_T);
+    double cdf = 0.0;
+    for (std::size_t n = 0; n < kMaxJumps; ++n) {
+        cdf += probability;
+        tables.poisson_cdf.push_back(cdf);
+        tables.log_mean.push_back(std::log(initial_price_) + drift + n * jump_mean_);
+        tables.log_stdev.push_back(std::sqrt(diffusion_variance + n * jump_volatility_ * jump_volatility_));
+
+        if (1.0 - cdf < kTailTolerance || lambda_T == 0.0) {
+            break;
+        }
+        probability *= lambda_T / static_cast<double>(n + 1);
+    }
+
+    // The last entry absorbs the truncated tail
+    tables.poisson_cdf.back() = 1.0;
+    return tables;
+}
+
+std::shared_ptr<const MertonJumpModel::TerminalTables> MertonJumpModel::tables(double T) const {
+    std::lock_guard<std::mutex> lock(tables_mutex_);
+    if (!cached_tables_ || cached_maturity_ != T) {
+        cached_tables_ = std::make_shared<const TerminalTables>(prepare(T));
+        cached_maturity_ = T;
+    }
+    return cached_tables_;
+}
+
+std::shared_ptr<const MertonJumpModel::QuantileTable> MertonJumpModel::quantile_table(double T) const {
+    std::lock_guard<std::mutex> lock(quantile_mutex_);
+    if (cached_quantile_table_ && cached_quantile_maturity_ == T) {
+        return cached_quantile_table_;
+    }
+
+    auto table = std::make_shared<QuantileTable>();
+    table->mixture = tables(T);
+    const TerminalTables& mixture = *table->mixture;
+    table->offsets.assign(kQuantileIntervals, 0);
+    table->divisions.assign(kQuantileIntervals, 0);
+
+    // A point mass leaves the quantile discontinuous; every draw then takes the root search
+    if (mixture.log_stdev.front() > 0.0) {
+        const double width = 2.0 * kQuantileRange / static_cast<double>(kQuantileIntervals);
+        std::vector<double> x;
+        std::vector<double> slope;
+        std::vector<double> refined_x;
+        std::vector<double> refined_slope;
+
+        // Each node's root search starts from the quantile next to it
+        double end_x = mixture_quantile(mixture, -kQuantileRange);
+        double end_slope = quantile_slope(mixture, -kQuantileRange, end_x);
+        for (std::size_t j = 0; j < kQuantileIntervals; ++j) {
+            const double start = -kQuantileRange + static_cast<double>(j) * width;
+            x.assign({end_x, 0.0});
+            slope.assign({end_slope, 0.0});
+            x[1] = mixture_quantile(mixture, start + width, end_x + width * end_slope);
+            slope[1] = quantile_slope(mixture, start + width, x[1]);
+            end_x = x[1];
+            end_slope = slope[1];
+
+            for (int depth = 0; depth <= kMaxQuantileDepth; ++depth) {
+                const std::size_t pieces = x.size() - 1;
+                const double h = width / static_cast<double>(pieces);
+                refined_x.resize(2 * pieces + 1);
+                refined_slope.resize(2 * pieces + 1);
+
+                bool converged = true;
+                for (std::size_t i = 0; i < pieces; ++i) {
+                    const double z = start + (static_cast<double>(i) + 0.5) * h;
+                    const double interpolated = hermite(x[i], slope[i], x[i + 1], slope[i + 1], h, 0.5);
+                    const double mid_x = mixture_quantile(mixture, z, interpolated);
+                    const double mid_slope = quantile_slope(mixture, z, mid_x);
+                    const double error = interpolated - mid_x;
+                    // Also fails on a slope that overflowed in a gap between mixture modes
+                    const double allowed = kQuantileTolerance * mid_slope +
+                                           2.0 * kQuantileRootTolerance * (1.0 + std::abs(mid_x));
+                    converged = converged && std::abs(error) <= allowed;
+
+                    refined_x[2 * i] = x[i];
+                    refined_slope[2 * i] = slope[i];
+                    refined_x[2 * i + 1] = mid_x;
+                    refined_slope[2 * i + 1] = mid_slope;
+                }
+                refined_x[2 * pieces] = x[pieces];
+                refined_slope[2 * pieces] = slope[pieces];
+                x.swap(refined_x);
+                slope.swap(refined_slope);
+
+                if (converged) {
+                    table->offsets[j] = table->quantiles.size();
+                    table->divisions[j] = x.size() - 1;
+                    table->quantiles.insert(table->quantiles.end(), x.begin(), x.end());
+                    table->slopes.insert(table->slopes.end(), slope.begin(), slope.end());
+                    break;
+                }
+            }
+        }
+    }
+
+    cached_quantile_table_ = std::move(table);
+    cached_quantile_maturity_ = T;
+    return cached_quantile_table_;
+}
+
+double MertonJumpModel::quantile(const QuantileTable& table, double z) {
+    const double u = (z + kQuantileRange) * (static_cast<double>(kQuantileIntervals) / (2.0 * kQuantileRange));
+    if (!(u >= 0.0 && u < static_cast<double>(kQuantileIntervals))) {
+        return mixture_quantile(*table.mixture, z);
+    }
+    const std::size_t j = static_cast<std::size_t>(u);
+    const std::size_t pieces = table.divisions[j];
+    if (pieces == 0) {
+        return mixture_quantile(*table.mixture, z);
+    }
+
+    const double position = (u - static_cast<double>(j)) * static_cast<double>(pieces);
+    const std::size_t i = std::min(static_cast<std::size_t>(position), pieces - 1);
+    const std::size_t node = table.offsets[j] + i;
+    const double h = 2.0 * kQuantileRange / static_cast<double>(kQuantileIntervals * pieces);
+    return hermite(table.quantiles[node], table.slopes[node],
+                   table.quantiles[node + 1], table.slopes[node + 1],
+                   h, position - static_cast<double>(i));
+}
+
+void MertonJumpModel::sample_jump_counts(const TerminalTables& tables,
+                                         const double* uniforms,
+                                         std::uint32_t* counts,
+                                         std::size_t num_paths) {
+    const double* cdf = tables.poisson_cdf.data();
+    const std::size_t last = tables.poisson_cdf.size() - 1;
+
+    for (std::size_t p = 0; p < num_paths; ++p) {
+        counts[p] = 0;
+    }
+    for (std::size_t n = 0; n < last; ++n) {
+        const double threshold = cdf[n];
+        for (std::size_t p = 0; p < num_paths; ++p) {
+            counts[p] += static_cast<std::uint32_t>(uniforms[p] >= threshold);
+        }
+    }
+}
+
+void MertonJumpModel::simulate_terminal(const TerminalTables& tables,
+                                        const double* normals,
+                                        const std::uint32_t* counts,
+                                        double* terminal,
+                                        std::size_t num_paths) const {
+    const double* log_mean = tables.log_mean.data();
+    const double* log_stdev = tables.log_stdev.data();
+    for (std::size_t p = 0; p < num_paths; ++p) {
+        const std::uint32_t n = counts[p];
+        terminal[p] = std::exp(log_mean[n] + log_stdev[n] * normals[p]);
+    }
+}
+
+void MertonJumpModel::simulate_terminal(const double* normals, double* terminal,
+                                        std::size_t count, double T) const {
+    const auto table = quantile_table(T);
+    for (std::size_t p = 0; p < count; ++p) {
+        terminal[p] = std::exp(quantile(*table, normals[p]));
+    }
+}
+
+void MertonJumpModel::simulate_paths(const double* normals, double* paths,
+                                     std::size_t count, std::size_t num_steps, double T) const {
+    simulate_grid_paths(*make_path_grid(num_steps, T), normals, paths, count);
+}
+
+std::shared_ptr<const IPricingModel::PathGrid> MertonJumpModel::make_path_grid(std::size_t num_steps,
+                                                                               double T) const {
+    if (num_steps == 0) {
+        throw ValidationError("Path simulation requires at least one time step");
+    }
+    auto grid = std::make_shared<StepGrid>();
+    grid->num_steps = num_steps;
+    grid->T = T;
+    grid->table = quantile_table(T / static_cast<double>(num_steps));
+    return grid;
+}
+
+void MertonJumpModel::simulate_grid_paths(const PathGrid& grid, const double* normals, double* paths,
+                                          std::size_t count) const {
+    // Every step has the law of a terminal draw over dt, rescaled from S0 to the previous price
+    const QuantileTable& step_table = *static_cast<const StepGrid&>(grid).table;
+    const std::size_t num_steps = grid.num_steps;
+    const double log_initial = std::log(initial_price_);
+    for (std::size_t step = 0; step < num_steps; ++step) {
+        const double* z = normals + step * count;
+        double* current = paths + step * count;
+        for (std::size_t p = 0; p < count; ++p) {
+            const double log_return = quantile(step_table, z[p]) - log_initial;
+            const double previous = step == 0 ? initial_price_ : current[p - count];
+            current[p] = previous * std::exp(log_return);
+        }
+    }
+}
+
+double MertonJumpModel::discount_factor(double T) const {
+    return std::exp(-risk_free_rate_ * T);
+}
+
+double MertonJumpModel::analytic_price(double K, double T, OptionType type) const {
+    const double k = jump_compensator();
+    const double lambda_prime_T = jump_intensity_ * (1.0 + k) * T;
+
+    if (T <= 0.0 || lambda_prime_T == 0.0) {
+        return analytics::black_scholes_price(initial_price_, K, risk_free_rate_ - jump_intensity_ * k,
+                                              volatility_, T, type);
+    }
+
+    double price = 0.0;
+    double weight = std::exp(-lambda_prime_T);
+    double cumulative = 0.0;
+    for (std::size_t n = 0; n < kMaxJumps; ++n) {
+        const double sigma_n = std::sqrt(volatility_ * volatility_ +
+                                         n * jump_volatility_ * jump_volatility_ / T);
+        const double r_n = risk_free_rate_ - jump_intensity_ * k + n * std::log(1.0 + k) / T;
+
+        price += weight * analytics::black_scholes_price(initial_price_, K, r_n, sigma_n, T, type);
+
+        cumulative += weight;
+        if (1.0 - cumulative < kTailTolerance) {
+            break;
+        }
+        weight *= lambda_prime_T / static_cast<double>(n + 1);
+    }
+    return price;
+}
+
+} // namespace montecarlo
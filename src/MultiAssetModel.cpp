@@ -0,0 +1,242 @@
+#include "MultiAssetModel.h"
+#include "Exceptions.h"
+#include "Tape.h"
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+namespace montecarlo {
+
+namespace {
+
+// Tolerance for symmetry, unit diagonal and negative eigenvalues
+constexpr double kCorrelationTolerance = 1e-10;
+
+} // namespace
+
+MultiAssetModel::MultiAssetModel(std::vector<double> spots,
+                                 std::vector<double> volatilities,
+                                 const std::vector<double>& correlation,
+                                 double risk_free_rate)
+    : spots_(std::move(spots)),
+      volatilities_(std::move(volatilities)),
+      correlation_(correlation),
+      risk_free_rate_(risk_free_rate) {
+    const std::size_t n = spots_.size();
+    if (n == 0) {
+        throw ValidationError("Multi-asset model requires at least one asset");
+    }
+    if (volatilities_.size() != n) {
+        throw ValidationError("Expected one volatility per asset");
+    }
+    if (correlation.size() != n * n) {
+        throw ValidationError("Correlation matrix must be num_assets x num_assets");
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        if (spots_[i] <= 0.0) {
+            throw ValidationError("Asset spot prices must be positive");
+        }
+        if (volatilities_[i] < 0.0) {
+            throw ValidationError("Asset volatilities cannot be negative");
+        }
+        if (std::abs(correlation[i * n + i] - 1.0) > kCorrelationTolerance) {
+            throw ValidationError("Correlation matrix must have a unit diagonal");
+        }
+        for (std::size_t j = 0; j < i; ++j) {
+            if (std::abs(correlation[i * n + j] - correlation[j * n + i]) > kCorrelationTolerance) {
+                throw ValidationError("Correlation matrix must be symmetric");
+            }
+        }
+    }
+
+    factor_.assign(n * n, 0.0);
+    if (!cholesky(correlation.data(), n, factor_.data())) {
+        eigen_factor(correlation, n, factor_);
+        used_eigen_fallback_ = true;
+    }
+}
+
+void MultiAssetModel::correlate(const double* normals, double* correlated, std::size_t num_paths) const {
+    correlate(factor_.data(), normals, num_paths, correlated, num_paths);
+}
+
+template <typename Scalar>
+void MultiAssetModel::correlate(const Scalar* factor, const double* normals, std::size_t stride,
+                                Scalar* correlated, std::size_t num_paths) const {
+    const std::size_t n = num_assets();
+    for (std::size_t i = 0; i < n; ++i) {
+        Scalar* out = correlated + i * num_paths;
+        std::fill(out, out + num_paths, Scalar(0.0));
+
+        // Cholesky factors are lower-triangular, so the upper part is skipped
+        const std::size_t k_end = used_eigen_fallback_ ? n : i + 1;
+        for (std::size_t k = 0; k < k_end; ++k) {
+            // Zero weights still record on the tape, where they carry correlation adjoints
+            if constexpr (std::is_same_v<Scalar, double>) {
+                if (factor[i * n + k] == 0.0) {
+                    continue;
+                }
+            }
+            const Scalar& weight = factor[i * n + k];
+            const double* z = normals + k * stride;
+            for (std::size_t p = 0; p < num_paths; ++p) {
+                out[p] += weight * z[p];
+            }
+        }
+    }
+}
+
+void MultiAssetModel::simulate_terminal(const double* normals, double* terminal,
+                                        std::size_t num_paths, double T) const {
+    const Inputs<double> inputs{spots_.data(), volatilities_.data(), factor_.data(), risk_free_rate_};
+    simulate_terminal(inputs, normals, num_paths, terminal, num_paths, T);
+}
+
+template <typename Scalar>
+void MultiAssetModel::simulate_terminal(const Inputs<Scalar>& inputs, const double* normals, std::size_t stride,
+                                        Scalar* terminal, std::size_t num_paths, double T) const {
+    using std::exp;
+    correlate(inputs.factor, normals, stride, terminal, num_paths);
+
+    const double sqrt_T = std::sqrt(T);
+    for (std::size_t i = 0; i < num_assets(); ++i) {
+        const Scalar& sigma = inputs.volatilities[i];
+        const Scalar& S0 = inputs.spots[i];
+        const Scalar drift = (inputs.risk_free_rate - 0.5 * sigma * sigma) * T;
+        const Scalar diffusion = sigma * sqrt_T;
+
+        Scalar* row = terminal + i * num_paths;
+        for (std::size_t p = 0; p < num_paths; ++p) {
+            row[p] = S0 * exp(drift + diffusion * row[p]);
+        }
+    }
+}
+
+template void MultiAssetModel::simulate_terminal(const Inputs<double>&, const double*, std::size_t,
+                                                 double*, std::size_t, double) const;
+template void MultiAssetModel::simulate_terminal(const Inputs<Active>&, const double*, std::size_t,
+                                                 Active*, std::size_t, double) const;
+
+std::vector<double> MultiAssetModel::correlation_sensitivities(const std::vector<double>& factor_adjoints) const {
+    const std::size_t n = num_assets();
+    if (used_eigen_fallback_) {
+        throw ValidationError("Correlation sensitivities require a positive definite correlation matrix");
+    }
+    if (factor_adjoints.size() != n * n) {
+        throw ValidationError("Expected one sensitivity per factor entry");
+    }
+
+    Tape tape(n * n);
+    std::vector<Active> correlation(n * n);
+    for (std::size_t k = 0; k < n * n; ++k) {
+        correlation[k] = Active::input(tape, static_cast<Tape::Index>(k), correlation_[k]);
+    }
+    std::vector<Active> factor(n * n);
+    cholesky(correlation.data(), n, factor.data());
+    for (std::size_t k = 0; k < n * n; ++k) {
+        tape.add_adjoint(factor[k].index(), factor_adjoints[k]);
+    }
+    tape.propagate();
+
+    // The factorization reads the lower triangle only
+    const double* adjoints = tape.input_adjoints();
+    std::vector<double> sensitivities(n * n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < i; ++j) {
+            sensitivities[i * n + j] = adjoints[i * n + j];
+            sensitivities[j * n + i] = adjoints[i * n + j];
+        }
+    }
+    return sensitivities;
+}
+
+template <typename Scalar>
+bool MultiAssetModel::cholesky(const Scalar* matrix, std::size_t n, Scalar* factor) {
+    using std::sqrt;
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j <= i; ++j) {
+            Scalar sum = matrix[i * n + j];
+            for (std::size_t k = 0; k < j; ++k) {
+                sum -= factor[i * n + k] * factor[j * n + k];
+            }
+            if (i == j) {
+                if (sum <= kCorrelationTolerance) {
+                    return false;
+                }
+                factor[i * n + i] = sqrt(sum);
+            } else {
+                factor[i * n + j] = sum / factor[j * n + j];
+            }
+        }
+    }
+    return true;
+}
+
+void MultiAssetModel::eigen_factor(const std::vector<double>& matrix, std::size_t n, std::vector<double>& factor) {
+    // Cyclic Jacobi rotations: a holds the diagonalized matrix, v the eigenvectors
+    std::vector<double> a = matrix;
+    std::vector<double> v(n * n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        v[i * n + i] = 1.0;
+    }
+
+    for (int sweep = 0; sweep < 100; ++sweep) {
+        double off_diagonal = 0.0;
+        for (std::size_t p = 0; p < n; ++p) {
+            for (std::size_t q = p + 1; q < n; ++q) {
+                off_diagonal += a[p * n + q] * a[p * n + q];
+            }
+        }
+        if (off_diagonal < 1e-22) {
+            break;
+        }
+
+        for (std::size_t p = 0; p < n; ++p) {
+            for (std::size_t q = p + 1; q < n; ++q) {
+                const double apq = a[p * n + q];
+                if (std::abs(apq) < 1e-300) {
+                    continue;
+                }
+                const double theta = (a[q * n + q] - a[p * n + p]) / (2.0 * apq);
+                const double t = (theta >= 0.0 ? 1.0 : -1.0) /
+                                 (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+                const double c = 1.0 / std::sqrt(t * t + 1.0);
+                const double s = t * c;
+
+                for (std::size_t k = 0; k < n; ++k) {
+                    const double akp = a[k * n + p];
+                    const double akq = a[k * n + q];
+                    a[k * n + p] = c * akp - s * akq;
+                    a[k * n + q] = s * akp + c * akq;
+                }
+                for (std::size_t k = 0; k < n; ++k) {
+                    const double apk = a[p * n + k];
+                    const double aqk = a[q * n + k];
+                    a[p * n + k] = c * apk - s * aqk;
+                    a[q * n + k] = s * apk + c * aqk;
+                }
+                for (std::size_t k = 0; k < n; ++k) {
+                    const double vkp = v[k * n + p];
+                    const double vkq = v[k * n + q];
+                    v[k * n + p] = c * vkp - s * vkq;
+                    v[k * n + q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+
+    // L = V * sqrt(max(lambda, 0)); markedly negative eigenvalues mean not PSD
+    factor.assign(n * n, 0.0);
+    for (std::size_t k = 0; k < n; ++k) {
+        double lambda = a[k * n + k];
+        if (lambda < -1e-8) {
+            throw ValidationError("Correlation matrix is not positive semi-definite");
+        }
+        const double scale = std::sqrt(std::max(lambda, 0.0));
+        for (std::size_t i = 0; i < n; ++i) {
+            factor[i * n + k] = v[i * n + k] * scale;
+        }
+    }
+}
+
+} // namespace montecarlo
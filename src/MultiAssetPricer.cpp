@@ -0,0 +1,200 @@
+#include "MultiAssetPricer.h"
+#include "Exceptions.h"
+#include "MemoryStats.h"
+#include "NormalGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace montecarlo {
+
+MultiAssetPricer::MultiAssetPricer(const MultiAssetModel& model,
+                                   std::uint64_t num_simulations,
+                                   unsigned int num_threads)
+    : model_(model),
+      num_simulations_(num_simulations),
+      num_threads_(num_threads) {
+}
+
+PricingResult MultiAssetPricer::price_option(const MultiAssetPayoff& payoff, double T) {
+    PricingWorkspace workspace(num_threads_);
+    return price_option(payoff, T, workspace);
+}
+
+PricingResult MultiAssetPricer::price_option(const MultiAssetPayoff& payoff, double T,
+                                             PricingWorkspace& workspace) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    MemoryScope memory_scope(MemorySubsystem::Pricer);
+
+    const std::size_t num_assets = model_.num_assets();
+    const auto plan = PricingWorkspace::ChunkPlan::for_paths(num_simulations_);
+    PathAccumulator* chunks = workspace.chunk_accumulators(plan.num_chunks);
+
+    auto job = [&](PricingWorkspace::WorkerState& state, std::uint64_t chunk,
+                   std::uint64_t start_idx, std::uint64_t end_idx) {
+        // Scratch layout: normals | terminal prices | payoffs
+        double* normals = state.scratch_buffer((2 * num_assets + 1) * kPathBlock);
+        double* terminal = normals + num_assets * kPathBlock;
+        double* payoffs = terminal + num_assets * kPathBlock;
+        const NormalGenerator generator;
+
+        for (std::uint64_t i = start_idx; i < end_idx; i += kPathBlock) {
+            unsigned int n = static_cast<unsigned int>(std::min<std::uint64_t>(kPathBlock, end_idx - i));
+
+            generator.fill(state.rng, normals, num_assets * n);
+            model_.simulate_terminal(normals, terminal, n, T);
+            payoff.calculate(terminal, num_assets, n, payoffs);
+
+            for (unsigned int p = 0; p < n; ++p) {
+                chunks[chunk].add(payoffs[p]);
+            }
+        }
+    };
+    workspace.run_chunks(plan, job);
+
+    // Merge in chunk order so seeded runs are reproducible
+    PathAccumulator total;
+    for (std::uint64_t c = 0; c < plan.num_chunks; ++c) {
+        total.merge(chunks[c]);
+    }
+
+    double discount = std::exp(-model_.get_risk_free_rate() * T);
+    double discounted_price = total.mean() * discount;
+    double standard_error = total.standard_error() * discount;
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto computation_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+
+    return {discounted_price, standard_error, computation_time};
+}
+
+MultiAssetSensitivities MultiAssetPricer::price_sensitivities(const MultiAssetPayoff& payoff, double T) {
+    PricingWorkspace workspace(num_threads_);
+    return price_sensitivities(payoff, T, workspace);
+}
+
+MultiAssetSensitivities MultiAssetPricer::price_sensitivities(const MultiAssetPayoff& payoff, double T,
+                                                              PricingWorkspace& workspace) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    MemoryScope memory_scope(MemorySubsystem::Pricer);
+
+    const std::size_t num_assets = model_.num_assets();
+    const std::vector<double>& factor = model_.get_factor();
+    const bool lower_triangular = !model_.used_eigen_fallback();
+
+    // Tape inputs: spots, volatilities, rate, then the row-major factor
+    const std::size_t first_volatility = num_assets;
+    const std::size_t rate_input = 2 * num_assets;
+    const std::size_t first_factor = rate_input + 1;
+    const std::size_t num_inputs = first_factor + num_assets * num_assets;
+    // Per worker Actives: the inputs (spots | volatilities | factor), then the
+    // asset-major terminal prices of the paths on the tape
+    const std::size_t first_terminal = 2 * num_assets + num_assets * num_assets;
+    for (unsigned int w = 0; w < workspace.num_workers(); ++w) {
+        PricingWorkspace::WorkerState& state = workspace.worker(w);
+        if (state.tape.num_inputs() != num_inputs) {
+            state.tape.set_num_inputs(num_inputs);
+        } else {
+            state.tape.clear_input_adjoints();
+        }
+        // Two nodes per factor entry and four per asset on each path
+        state.tape.reserve(kTapePaths * num_assets * (2 * num_assets + 4) + 6 * num_assets + 1);
+
+        // Inputs record nothing and survive tape resets, so they are made once per call
+        Active* inputs = state.active_buffer(first_terminal + num_assets * kTapePaths);
+        for (std::size_t a = 0; a < num_assets; ++a) {
+            inputs[a] = Active::input(state.tape, static_cast<Tape::Index>(a), model_.get_spots()[a]);
+            inputs[num_assets + a] = Active::input(state.tape, static_cast<Tape::Index>(first_volatility + a),
+                                                   model_.get_volatilities()[a]);
+        }
+        for (std::size_t f = 0; f < num_assets * num_assets; ++f) {
+            inputs[2 * num_assets + f] = Active::input(state.tape, static_cast<Tape::Index>(first_factor + f),
+                                                       factor[f]);
+        }
+    }
+
+    const auto plan = PricingWorkspace::ChunkPlan::for_paths(num_simulations_);
+    PathAccumulator* chunks = workspace.chunk_accumulators(plan.num_chunks);
+
+    auto job = [&](PricingWorkspace::WorkerState& state, std::uint64_t chunk,
+                   std::uint64_t start_idx, std::uint64_t end_idx) {
+        Tape& tape = state.tape;
+        const Active* spots = state.actives.data();
+        const Active* volatilities = spots + num_assets;
+        const Active* factor_inputs = volatilities + num_assets;
+        Active* terminal = state.actives.data() + first_terminal;
+
+        // Scratch layout: normals | terminal prices of one path | payoff gradient of one path
+        double* normals = state.scratch_buffer((num_assets + 2) * kPathBlock + 2 * num_assets);
+        double* values = normals + num_assets * kPathBlock;
+        double* gradient = values + num_assets;
+        const NormalGenerator generator;
+
+        for (std::uint64_t i = start_idx; i < end_idx; i += kPathBlock) {
+            unsigned int n = static_cast<unsigned int>(std::min<std::uint64_t>(kPathBlock, end_idx - i));
+            generator.fill(state.rng, normals, num_assets * n);
+
+            for (unsigned int first = 0; first < n; first += kTapePaths) {
+                const unsigned int count = std::min(n - first, kTapePaths);
+                tape.reset();
+                const Active r = Active::input(tape, static_cast<Tape::Index>(rate_input),
+                                               model_.get_risk_free_rate());
+                const MultiAssetModel::Inputs<Active> inputs{spots, volatilities, factor_inputs, r};
+                model_.simulate_terminal(inputs, normals + first, n, terminal, count, T);
+
+                for (unsigned int p = 0; p < count; ++p) {
+                    for (std::size_t a = 0; a < num_assets; ++a) {
+                        values[a] = terminal[a * count + p].value();
+                    }
+                    double value;
+                    payoff.calculate_gradient(values, num_assets, 1, &value, gradient);
+                    chunks[chunk].add(value);
+                    for (std::size_t a = 0; a < num_assets; ++a) {
+                        if (gradient[a] != 0.0) {
+                            tape.add_adjoint(terminal[a * count + p].index(), gradient[a]);
+                        }
+                    }
+                }
+                tape.propagate();
+            }
+        }
+    };
+    workspace.run_chunks(plan, job);
+
+    // Merge prices in chunk order and adjoints in worker order
+    PathAccumulator total;
+    for (std::uint64_t c = 0; c < plan.num_chunks; ++c) {
+        total.merge(chunks[c]);
+    }
+    std::vector<double> adjoints(num_inputs, 0.0);
+    for (unsigned int w = 0; w < workspace.num_workers(); ++w) {
+        const double* tape_adjoints = workspace.worker(w).tape.input_adjoints();
+        for (std::size_t k = 0; k < num_inputs; ++k) {
+            adjoints[k] += tape_adjoints[k];
+        }
+    }
+
+    const double discount = std::exp(-model_.get_risk_free_rate() * T);
+    const double scale = discount / static_cast<double>(total.count);
+    for (double& adjoint : adjoints) {
+        adjoint *= scale;
+    }
+
+    MultiAssetSensitivities result;
+    result.pricing.price = total.mean() * discount;
+    result.pricing.standard_error = total.standard_error() * discount;
+    result.deltas.assign(adjoints.begin(), adjoints.begin() + num_assets);
+    result.vegas.assign(adjoints.begin() + first_volatility, adjoints.begin() + rate_input);
+    // r also discounts the payoff
+    result.rho = adjoints[rate_input] - T * result.pricing.price;
+    if (lower_triangular) {
+        result.correlation_sensitivities = model_.correlation_sensitivities(
+            std::vector<double>(adjoints.begin() + first_factor, adjoints.end()));
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    result.pricing.computation_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    return result;
+}
+
+} // namespace montecarlo
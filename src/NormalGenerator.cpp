@@ -0,0 +1,74 @@
+#include "NormalGenerator.h"
+#include "AcklamInverseCdf.h"
+#include <cmath>
+
+namespace montecarlo {
+
+namespace {
+
+using detail::AcklamInverseCdf;
+
+double tail(double p) {
+    // Lower-tail formula; the upper tail follows by symmetry
+    const bool upper = p > 0.5;
+    const double x = AcklamInverseCdf::tail(std::sqrt(-2.0 * std::log(upper ? 1.0 - p : p)));
+    return upper ? -x : x;
+}
+
+} // namespace
+
+void NormalGenerator::transform(const double* uniforms, double* normals, std::size_t n) {
+    // Work through a stack copy so normals may alias uniforms
+    constexpr std::size_t kChunk = 256;
+    double u[kChunk];
+
+    for (std::size_t base = 0; base < n; base += kChunk) {
+        const std::size_t m = n - base < kChunk ? n - base : kChunk;
+        for (std::size_t i = 0; i < m; ++i) {
+            u[i] = uniforms[base + i];
+        }
+
+        // Pass 1: central rational for every element, no branches
+        double* z = normals + base;
+        for (std::size_t i = 0; i < m; ++i) {
+            z[i] = AcklamInverseCdf::central(u[i] - 0.5);
+        }
+
+        // Pass 2: patch the ~5% of elements that fall in the tails
+        for (std::size_t i = 0; i < m; ++i) {
+            if (u[i] < AcklamInverseCdf::p_low || u[i] > AcklamInverseCdf::p_high) {
+                z[i] = tail(u[i]);
+            }
+        }
+    }
+}
+
+const NormalGenerator::ZigguratTables& NormalGenerator::tables() {
+    static const ZigguratTables t = [] {
+        ZigguratTables z{};
+        const double m1 = 2147483648.0;
+        const double vn = 9.91256303526217e-3;
+        double dn = 3.442619855899;
+        double tn = dn;
+        const double q = vn / std::exp(-0.5 * dn * dn);
+
+        z.kn[0] = static_cast<std::uint32_t>((dn / q) * m1);
+        z.kn[1] = 0;
+        z.wn[0] = q / m1;
+        z.wn[127] = dn / m1;
+        z.fn[0] = 1.0;
+        z.fn[127] = std::exp(-0.5 * dn * dn);
+
+        for (int i = 126; i >= 1; --i) {
+            dn = std::sqrt(-2.0 * std::log(vn / dn + std::exp(-0.5 * dn * dn)));
+            z.kn[i + 1] = static_cast<std::uint32_t>((dn / tn) * m1);
+            tn = dn;
+            z.fn[i] = std::exp(-0.5 * dn * dn);
+            z.wn[i] = dn / m1;
+        }
+        return z;
+    }();
+    return t;
+}
+
+} // namespace montecarlo
@@ -1,97 +1,698 @@
 #include "OptionPricer.h"
+#include "Exceptions.h"
+#include "MemoryStats.h"
 #include <cmath>
 #include <random>
 #include <thread>
 #include <chrono>
+#include <algorithm>
+#include <limits>
 
 namespace montecarlo {
 
-OptionPricer::OptionPricer(const BlackScholesModel& model,
-                          unsigned int num_simulations,
-                          unsigned int num_threads)
+namespace {
+
+// A worker's running partial sums, published after every chunk
+struct alignas(64) TraceSlot {
+    std::mutex mutex;
+    PathAccumulator partial;
+};
+
+// An empty total (no chunk completed) summarizes to zero paths, price and standard error
+ConvergencePoint summarize(const PathAccumulator& total, double discount, double elapsed_ms) {
+    return {total.count, total.mean() * discount, total.standard_error() * discount, elapsed_ms};
+}
+
+// Stops a call once it is cancelled or reaches its deadline, or earlier once its
+// accuracy floor is out of reach. A zero budget means no deadline. Workers call
+// start_chunk before simulating a claimed chunk and finish_chunk after. Payoffs
+// arrive undiscounted and are discounted to the reported standard error.
+class DeadlineMonitor {
+public:
+    using Clock = std::chrono::high_resolution_clock;
+
+    DeadlineMonitor(Clock::time_point start, std::chrono::nanoseconds budget, double max_standard_error,
+                    double discount, std::uint64_t num_paths, const std::atomic<bool>* cancel)
+        : start_(start),
+          bounded_(budget > std::chrono::nanoseconds::zero()),
+          deadline_(start + std::chrono::duration_cast<Clock::duration>(budget)),
+          budget_seconds_(std::chrono::duration<double>(budget).count()),
+          max_standard_error_(max_standard_error),
+          discount_(discount),
+          num_paths_(num_paths),
+          cancel_(cancel) {}
+
+    const std::atomic<bool>* stop_flag() const { return &stop_; }
+
+    /**
+     * @brief Whether to simulate a claimed chunk; false stops the call
+     */
+    bool start_chunk() {
+        // At least one chunk completes, so there is always an estimate
+        if (!completed_.load(std::memory_order_acquire)) {
+            return true;
+        }
+        if (cancel_ && cancel_->load(std::memory_order_relaxed)) {
+            stop_.store(true, std::memory_order_relaxed);
+            return false;
+        }
+        if (bounded_ && Clock::now() >= deadline_) {
+            expired_.store(true, std::memory_order_relaxed);
+            stop_.store(true, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    void finish_chunk(const PathAccumulator& chunk) {
+        completed_.store(true, std::memory_order_release);
+        if (max_standard_error_ <= 0.0) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        partial_.merge(chunk);
+        ++chunks_;
+        double elapsed = std::chrono::duration<double>(Clock::now() - start_).count();
+        if (chunks_ < 2 || elapsed < 0.1 * budget_seconds_) {
+            return;
+        }
+        // The standard error falls like 1 / sqrt(paths) and paths grow with time
+        double paths = static_cast<double>(partial_.count);
+        double reachable = std::min(static_cast<double>(num_paths_), paths * budget_seconds_ / elapsed);
+        double projected = partial_.standard_error() * discount_ * std::sqrt(paths / reachable);
+        if (projected > max_standard_error_) {
+            unreachable_ = true;
+            stop_.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    bool expired() const { return expired_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Throw AccuracyError if the floor was missed or projected to be missed
+     */
+    void check_accuracy(double standard_error, std::uint64_t paths) const {
+        if (max_standard_error_ <= 0.0) {
+            return;
+        }
+        if (unreachable_) {
+            throw AccuracyError("Standard error " + std::to_string(max_standard_error_) +
+                                " cannot be reached within the time budget (" + std::to_string(standard_error) +
+                                " after " + std::to_string(paths) + " paths)");
+        }
+        if (standard_error > max_standard_error_) {
+            throw AccuracyError("Standard error " + std::to_string(standard_error) + " after " +
+                                std::to_string(paths) + " paths is above the floor of " +
+                                std::to_string(max_standard_error_));
+        }
+    }
+
+private:
+    Clock::time_point start_;
+    bool bounded_;
+    Clock::time_point deadline_;
+    double budget_seconds_;
+    double max_standard_error_;
+    double discount_;
+    std::uint64_t num_paths_;
+    const std::atomic<bool>* cancel_;
+
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> expired_{false};
+    std::atomic<bool> completed_{false};
+
+    std::mutex mutex_;
+    PathAccumulator partial_;
+    std::uint64_t chunks_ = 0;
+    bool unreachable_ = false;
+};
+
+} // namespace
+
+void PricingHandle::State::publish(const PathAccumulator& chunk) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    partial_.merge(chunk);
+}
+
+PricingProgress PricingHandle::State::snapshot() {
+    PathAccumulator partial;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        partial = partial_;
+    }
+    if (partial.count == 0) {
+        double nan = std::numeric_limits<double>::quiet_NaN();
+        return {0, total_paths, nan, nan};
+    }
+    ConvergencePoint point = summarize(partial, discount, 0.0);
+    return {point.paths, total_paths, point.estimate, point.standard_error};
+}
+
+PricingHandle::PricingHandle(std::shared_ptr<State> state, std::future<PricingResult> result)
+    : state_(std::move(state)),
+      result_(std::move(result)) {
+}
+
+PricingHandle::~PricingHandle() {
+    if (result_.valid()) {
+        cancel();
+        result_.wait();
+    }
+}
+
+PricingHandle& PricingHandle::operator=(PricingHandle&& other) noexcept {
+    if (this != &other) {
+        if (result_.valid()) {
+            cancel();
+            result_.wait();
+        }
+        state_ = std::move(other.state_);
+        result_ = std::move(other.result_);
+    }
+    return *this;
+}
+
+void PricingHandle::cancel() {
+    if (state_) {
+        state_->cancel_requested.store(true, std::memory_order_relaxed);
+    }
+}
+
+bool PricingHandle::ready() const {
+    return wait_for(std::chrono::seconds(0));
+}
+
+PricingResult PricingHandle::get() {
+    return result_.get();
+}
+
+PricingProgress PricingHandle::progress() const {
+    if (!state_) {
+        throw ValidationError("Pricing handle has no associated call");
+    }
+    return state_->snapshot();
+}
+
+OptionPricer::OptionPricer(const IPricingModel& model,
+                          std::uint64_t num_simulations,
+                          unsigned int num_threads,
+                          PathPrecision precision)
     : model_(model),
       num_simulations_(num_simulations),
-      num_threads_(num_threads) {
+      num_threads_(num_threads),
+      precision_(precision) {
 }
 
 PricingResult OptionPricer::price_option(const Payoff& payoff, double T) {
+    PricingWorkspace workspace(workers_for_call());
+    return price_option(payoff, T, workspace);
+}
+
+void OptionPricer::set_deadline(std::chrono::nanoseconds budget, double max_standard_error) {
+    if (budget < std::chrono::nanoseconds::zero()) {
+        throw ValidationError("Deadline budget cannot be negative");
+    }
+    if (max_standard_error < 0.0) {
+        throw ValidationError("Accuracy floor cannot be negative");
+    }
+    deadline_ = budget;
+    max_standard_error_ = max_standard_error;
+}
+
+void OptionPricer::set_chunk_size(std::uint64_t paths) {
+    if (paths == 0) {
+        chunk_size_ = PricingWorkspace::kChunkSize;
+        return;
+    }
+    const std::uint64_t block = PricingWorkspace::kBlockSize;
+    chunk_size_ = (paths + block - 1) / block * block;
+}
+
+void OptionPricer::set_drift_shift(double shift) {
+    drift_shift_ = shift;
+    automatic_drift_shift_ = false;
+}
+
+void OptionPricer::enable_automatic_drift_shift(unsigned int pilot_paths) {
+    automatic_drift_shift_ = true;
+    pilot_paths_ = std::max(pilot_paths, 1u);
+}
+
+void OptionPricer::disable_importance_sampling() {
+    drift_shift_ = 0.0;
+    automatic_drift_shift_ = false;
+}
+
+void OptionPricer::enable_convergence_trace(std::uint64_t first_checkpoint,
+                                            double growth,
+                                            ConvergenceCallback callback) {
+    if (growth <= 1.0) {
+        throw ValidationError("Convergence trace growth must be greater than 1");
+    }
+    trace_enabled_ = true;
+    trace_first_checkpoint_ = std::max<std::uint64_t>(first_checkpoint, 1);
+    trace_growth_ = growth;
+    trace_callback_ = std::move(callback);
+}
+
+void OptionPricer::disable_convergence_trace() {
+    trace_enabled_ = false;
+    trace_callback_ = nullptr;
+}
+
+void OptionPricer::enable_payoff_distribution(double confidence,
+                                              unsigned int histogram_bins,
+                                              std::vector<double> levels) {
+    if (!(confidence > 0.0 && confidence < 1.0)) {
+        throw ValidationError("Payoff distribution confidence must be in (0, 1)");
+    }
+    if (histogram_bins == 0) {
+        throw ValidationError("Payoff distribution needs at least one histogram bin");
+    }
+    for (double level : levels) {
+        if (!(level >= 0.0 && level <= 1.0)) {
+            throw ValidationError("Quantile levels must be in [0, 1]");
+        }
+    }
+    distribution_enabled_ = true;
+    distribution_confidence_ = confidence;
+    histogram_bins_ = histogram_bins;
+    distribution_levels_ = std::move(levels);
+}
+
+QuantileSketch* OptionPricer::prepare_sketches(std::size_t num_workers) {
+    if (!distribution_enabled_) {
+        return nullptr;
+    }
+    if (sketches_.size() < num_workers) {
+        sketches_.resize(num_workers);
+    }
+    for (auto& sketch : sketches_) {
+        sketch.clear();
+    }
+    return sketches_.data();
+}
+
+void OptionPricer::summarize_distribution(double discount, double price, PayoffDistribution& distribution) {
+    QuantileSketch& total = sketches_[0];
+    for (std::size_t w = 1; w < sketches_.size(); ++w) {
+        total.merge(sketches_[w]);
+    }
+
+    // Sketches hold undiscounted payoffs; discounting is a positive scaling
+    distribution.levels = distribution_levels_;
+    for (double level : distribution_levels_) {
+        distribution.quantiles.push_back(total.quantile(level) * discount);
+    }
+    distribution.confidence = distribution_confidence_;
+    distribution.value_at_risk = total.quantile(distribution_confidence_) * discount - price;
+    distribution.expected_shortfall = total.upper_tail_mean(distribution_confidence_) * discount - price;
+    distribution.min = total.min() * discount;
+    distribution.max = total.max() * discount;
+    distribution.histogram = total.histogram(histogram_bins_);
+    for (auto& bin : distribution.histogram) {
+        bin.lower *= discount;
+        bin.upper *= discount;
+    }
+}
+
+PricingResult OptionPricer::price_option(const Payoff& payoff, double T, PricingWorkspace& workspace) {
+    return price(payoff, T, workspace, nullptr);
+}
+
+PricingHandle OptionPricer::price_option_async(const Payoff& payoff, double T) {
+    // The background thread owns the workspace and tears it down on exit
+    unsigned int num_threads = workers_for_call();
+    return launch_async(T, [this, &payoff, T, num_threads](PricingHandle::State* async) {
+        PricingWorkspace workspace(num_threads);
+        return price(payoff, T, workspace, async);
+    });
+}
+
+PricingHandle OptionPricer::price_option_async(const Payoff& payoff, double T, PricingWorkspace& workspace) {
+    return launch_async(T, [this, &payoff, T, &workspace](PricingHandle::State* async) {
+        return price(payoff, T, workspace, async);
+    });
+}
+
+PricingHandle OptionPricer::launch_async(double T,
+                                         std::function<PricingResult(PricingHandle::State*)> body) {
+    if (num_strata_ > 0) {
+        throw ValidationError("Asynchronous pricing is not available with stratified sampling");
+    }
+
+    auto state = std::make_shared<PricingHandle::State>();
+    state->total_paths = num_simulations_;
+    state->discount = model_.discount_factor(T);
+
+    auto result = std::async(std::launch::async, [state, body = std::move(body)] {
+        return body(state.get());
+    });
+    return PricingHandle(std::move(state), std::move(result));
+}
+
+PricingResult OptionPricer::price(const Payoff& payoff, double T, PricingWorkspace& workspace,
+                                  PricingHandle::State* async) {
     auto start_time = std::chrono::high_resolution_clock::now();
+    MemoryScope memory_scope(MemorySubsystem::Pricer);
 
-    // Calculate number of simulations per thread
-    unsigned int sims_per_thread = num_simulations_ / num_threads_;
-    unsigned int remaining_sims = num_simulations_ % num_threads_;
+    active_drift_shift_ = automatic_drift_shift_
+        ? find_drift_shift(payoff, T, workspace.worker(0))
+        : drift_shift_;
+    variance_reduction_ = 1.0;
 
-    // Initialize results
-    double sum_payoffs = 0.0;
-    double sum_squared_payoffs = 0.0;
-    std::mutex mutex;
+    // Kernel selection happens once here; the path loop has no dispatch
+    PayoffKind kind;
+    const KernelParams params = make_kernel_params(payoff, T, kind);
+    const ModelKind model_kind = params.model ? ModelKind::Generic : ModelKind::Gbm;
+    const KernelEntry& kernel = select_kernel(model_kind, precision_, kind, normal_generator_.method(),
+                                              active_drift_shift_ != 0.0);
+
+    if (num_strata_ > 0) {
+        if (trace_enabled_) {
+            throw ValidationError("Convergence trace is not available with stratified sampling");
+        }
+        if (distribution_enabled_) {
+            throw ValidationError("Payoff distribution is not available with stratified sampling");
+        }
+        if (deadline_ > std::chrono::nanoseconds::zero()) {
+            throw ValidationError("Deadline-bounded pricing is not available with stratified sampling");
+        }
+        return price_stratified(kernel, params, T, workspace, start_time);
+    }
+    if (trace_enabled_) {
+        return price_traced(kernel, params, T, workspace, start_time, async);
+    }
 
-    // Create and launch threads
-    std::vector<std::thread> threads;
-    unsigned int start_idx = 0;
+    // Chunks are claimed dynamically; each keeps its own sums. Under a
+    // deadline, chunks stay small however many paths are allowed, and sums
+    // are kept per worker, since which chunks complete depends on timing.
+    const bool bounded = deadline_ > std::chrono::nanoseconds::zero();
+    const auto plan = bounded
+        ? PricingWorkspace::ChunkPlan::make(num_simulations_, chunk_size_, std::numeric_limits<std::uint64_t>::max())
+        : PricingWorkspace::ChunkPlan::make(num_simulations_, chunk_size_);
+    const std::uint64_t num_sums = bounded ? workspace.num_workers() : plan.num_chunks;
+    PathAccumulator* sums = workspace.chunk_accumulators(num_sums);
+    QuantileSketch* sketches = prepare_sketches(workspace.num_workers());
+    const double discount = model_.discount_factor(T);
+    const std::atomic<bool>* cancel = async ? &async->cancel_requested : nullptr;
+    std::optional<DeadlineMonitor> monitor;
+    if (bounded || cancel) {
+        monitor.emplace(start_time, deadline_, max_standard_error_, discount, num_simulations_, cancel);
+    }
 
-    for (unsigned int i = 0; i < num_threads_; ++i) {
-        unsigned int thread_sims = sims_per_thread + (i < remaining_sims ? 1 : 0);
-        unsigned int end_idx = start_idx + thread_sims;
+    auto job = [&](PricingWorkspace::WorkerState& state, std::uint64_t chunk,
+                   std::uint64_t first, std::uint64_t last) {
+        // Sketches and bounded sums are per worker, indexed by the state's position
+        const auto worker = &state - &workspace.worker(0);
+        if (monitor && !monitor->start_chunk()) {
+            return;
+        }
+        PathAccumulator bounded_chunk;
+        PathAccumulator& sum = bounded ? bounded_chunk : sums[chunk];
+        if (sketches) {
+            kernel.simulate_tracked(params, first, last, state, sum, sketches[worker]);
+        } else {
+            kernel.simulate(params, first, last, state, sum);
+        }
+        if (async) {
+            async->publish(sum);
+        }
+        if (bounded) {
+            sums[worker].merge(sum);
+        }
+        if (monitor) {
+            monitor->finish_chunk(sum);
+        }
+    };
+    workspace.run_chunks(plan, job, monitor ? monitor->stop_flag() : nullptr);
 
-        threads.emplace_back([this, start_idx, end_idx, &sum_payoffs, &sum_squared_payoffs, &mutex, &payoff, T]() {
-            double local_sum = 0.0;
-            double local_sum_squared = 0.0;
-            
-            simulate_range(start_idx, end_idx, local_sum, local_sum_squared, payoff, T);
+    // Merge per-chunk sums in chunk order so seeded runs are reproducible;
+    // chunks skipped after a cancellation are empty
+    PathAccumulator total;
+    for (std::uint64_t c = 0; c < num_sums; ++c) {
+        total.merge(sums[c]);
+    }
 
-            // Update global sums with thread safety
-            std::lock_guard<std::mutex> lock(mutex);
-            sum_payoffs += local_sum;
-            sum_squared_payoffs += local_sum_squared;
-        });
+    // Calculate final results; an empty run (no paths requested) prices to zero
+    double discounted_price = total.mean() * discount;
+    double standard_error = total.standard_error() * discount;
 
-        start_idx = end_idx;
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto computation_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+
+    if (monitor) {
+        monitor->check_accuracy(standard_error, total.count);
+    }
+
+    // Summarized before the result exists, so the result never copies it
+    std::optional<PayoffDistribution> distribution;
+    if (sketches) {
+        summarize_distribution(discount, discounted_price, distribution.emplace());
+    }
+
+    PricingResult result;
+    result.price = discounted_price;
+    result.standard_error = standard_error;
+    result.computation_time = computation_time;
+    result.num_paths = total.count;
+    result.deadline_reached = monitor && monitor->expired() && total.count < num_simulations_;
+    result.cancelled = total.count < num_simulations_ && !result.deadline_reached;
+    result.distribution = std::move(distribution);
+    return result;
+}
+
+double OptionPricer::find_drift_shift(const Payoff& payoff, double T,
+                                     PricingWorkspace::WorkerState& state) const {
+    // Candidate shifts, in standard deviations of the terminal normal
+    constexpr double kMaxShift = 8.0;
+    constexpr double kShiftStep = 0.25;
+
+    // Scratch layout: normals | shifted normals, then terminal prices in place
+    double* z = state.scratch_buffer(2 * static_cast<std::size_t>(pilot_paths_));
+    double* terminal = z + pilot_paths_;
+    normal_generator_.fill(state.rng, z, pilot_paths_);
+
+    // Minimize E[(w y)^2] / E[w y]^2; shifts that never pay are skipped
+    double best_shift = 0.0;
+    double best_ratio = std::numeric_limits<double>::infinity();
+    for (double shift = -kMaxShift; shift <= kMaxShift + 1e-12; shift += kShiftStep) {
+        double half_shift_squared = 0.5 * shift * shift;
+        for (unsigned int i = 0; i < pilot_paths_; ++i) {
+            terminal[i] = z[i] + shift;
+        }
+        model_.simulate_terminal(terminal, terminal, pilot_paths_, T);
+
+        double sum = 0.0;
+        double sum_squared = 0.0;
+        for (unsigned int i = 0; i < pilot_paths_; ++i) {
+            double value = payoff.calculate(terminal[i]);
+            if (value != 0.0) {
+                value *= std::exp(-shift * z[i] - half_shift_squared);
+                sum += value;
+                sum_squared += value * value;
+            }
+        }
+        if (sum > 0.0) {
+            double ratio = sum_squared * pilot_paths_ / (sum * sum);
+            if (ratio < best_ratio) {
+                best_ratio = ratio;
+                best_shift = shift;
+            }
+        }
     }
+    return best_shift;
+}
+
+PricingResult OptionPricer::price_traced(const KernelEntry& kernel,
+                                         const KernelParams& params,
+                                         double T,
+                                         PricingWorkspace& workspace,
+                                         std::chrono::high_resolution_clock::time_point start_time,
+                                         PricingHandle::State* async) {
+    // Bounded calls keep small chunks and per-worker sums, as in price()
+    const bool bounded = deadline_ > std::chrono::nanoseconds::zero();
+    const auto plan = bounded
+        ? PricingWorkspace::ChunkPlan::make(num_simulations_, chunk_size_, std::numeric_limits<std::uint64_t>::max())
+        : PricingWorkspace::ChunkPlan::make(num_simulations_, chunk_size_);
+    const std::uint64_t num_sums = bounded ? workspace.num_workers() : plan.num_chunks;
+    PathAccumulator* sums = workspace.chunk_accumulators(num_sums);
+    const double discount = model_.discount_factor(T);
 
-    // Wait for all threads to complete
-    for (auto& thread : threads) {
-        thread.join();
+    auto elapsed_ms = [start_time] {
+        auto now = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(now - start_time).count();
+    };
+    auto emit = [&](const PathAccumulator& total) {
+        trace_.push_back(summarize(total, discount, elapsed_ms()));
+        if (trace_callback_) {
+            trace_callback_(trace_.back());
+        }
+    };
+
+    trace_.clear();
+    std::vector<TraceSlot> slots(workspace.num_workers());
+    QuantileSketch* sketches = prepare_sketches(workspace.num_workers());
+    std::atomic<bool> done{false};
+    const std::atomic<bool>* cancel = async ? &async->cancel_requested : nullptr;
+    std::optional<DeadlineMonitor> monitor;
+    if (bounded || cancel) {
+        monitor.emplace(start_time, deadline_, max_standard_error_, discount, num_simulations_, cancel);
     }
 
-    // Calculate final results
-    double mean_payoff = sum_payoffs / num_simulations_;
-    double mean_squared_payoff = sum_squared_payoffs / num_simulations_;
-    double variance = mean_squared_payoff - mean_payoff * mean_payoff;
-    double standard_error = std::sqrt(variance / num_simulations_);
+    // The reporter polls the published partials; workers never wait on it
+    std::thread reporter([&] {
+        double next_checkpoint = static_cast<double>(trace_first_checkpoint_);
+        while (!done.load(std::memory_order_acquire)) {
+            PathAccumulator total;
+            for (auto& slot : slots) {
+                std::lock_guard<std::mutex> lock(slot.mutex);
+                total.merge(slot.partial);
+            }
+            if (total.count > 0 && total.count < num_simulations_ && total.count >= next_checkpoint) {
+                emit(total);
+                while (next_checkpoint <= total.count) {
+                    next_checkpoint *= trace_growth_;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+
+    auto job = [&](PricingWorkspace::WorkerState& state, std::uint64_t chunk,
+                   std::uint64_t first, std::uint64_t last) {
+        if (monitor && !monitor->start_chunk()) {
+            return;
+        }
+        // Slots and sketches are indexed by worker, recovered from the state's position
+        const auto worker = &state - &workspace.worker(0);
+        PathAccumulator bounded_chunk;
+        PathAccumulator& sum = bounded ? bounded_chunk : sums[chunk];
+        if (sketches) {
+            kernel.simulate_tracked(params, first, last, state, sum, sketches[worker]);
+        } else {
+            kernel.simulate(params, first, last, state, sum);
+        }
+        auto& slot = slots[worker];
+        {
+            std::lock_guard<std::mutex> lock(slot.mutex);
+            slot.partial.merge(sum);
+        }
+        if (async) {
+            async->publish(sum);
+        }
+        if (bounded) {
+            sums[worker].merge(sum);
+        }
+        if (monitor) {
+            monitor->finish_chunk(sum);
+        }
+    };
+
+    try {
+        workspace.run_chunks(plan, job, monitor ? monitor->stop_flag() : nullptr);
+    } catch (...) {
+        done.store(true, std::memory_order_release);
+        reporter.join();
+        throw;
+    }
+    done.store(true, std::memory_order_release);
+    reporter.join();
 
-    // Apply discounting
-    double discounted_price = mean_payoff * std::exp(-model_.get_risk_free_rate() * T);
+    // Merge per-chunk sums in chunk order so seeded runs are reproducible
+    PathAccumulator total;
+    for (std::uint64_t c = 0; c < num_sums; ++c) {
+        total.merge(sums[c]);
+    }
+    emit(total);
+    if (monitor) {
+        monitor->check_accuracy(trace_.back().standard_error, total.count);
+    }
 
     auto end_time = std::chrono::high_resolution_clock::now();
     auto computation_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
-    return {discounted_price, standard_error, computation_time};
+    std::optional<PayoffDistribution> distribution;
+    if (sketches) {
+        summarize_distribution(discount, trace_.back().estimate, distribution.emplace());
+    }
+
+    PricingResult result;
+    result.price = trace_.back().estimate;
+    result.standard_error = trace_.back().standard_error;
+    result.computation_time = computation_time;
+    result.num_paths = total.count;
+    result.deadline_reached = monitor && monitor->expired() && total.count < num_simulations_;
+    result.cancelled = total.count < num_simulations_ && !result.deadline_reached;
+    result.distribution = std::move(distribution);
+    return result;
+}
+
+KernelParams OptionPricer::make_kernel_params(const Payoff& payoff, double T, PayoffKind& kind) const {
+    double shift = active_drift_shift_;
+
+    KernelParams params;
+    if (auto gbm = model_.terminal_gbm_terms(T)) {
+        // The importance-sampling shift is folded into the drift: Z + shift
+        double r = gbm->risk_free_rate;
+        double sigma = gbm->volatility;
+        params.S0 = gbm->initial_price;
+        params.drift = (r - 0.5 * sigma * sigma) * T + sigma * std::sqrt(T) * shift;
+        params.diffusion = sigma * std::sqrt(T);
+    } else {
+        // Any other model evolves its blocks through simulate_terminal
+        params.model = &model_;
+        params.maturity = T;
+    }
+    params.shift = shift;
+    params.half_shift_squared = 0.5 * shift * shift;
+    params.payoff = &payoff;
+    params.num_simulations = num_simulations_;
+    params.num_strata = num_strata_;
+    kind = classify_payoff(payoff, params.strike);
+    return params;
 }
 
-void OptionPricer::simulate_range(unsigned int start_idx,
-                                unsigned int end_idx,
-                                double& sum_payoffs,
-                                double& sum_squared_payoffs,
-                                const Payoff& payoff,
-                                double T) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::normal_distribution<double> dist(0.0, 1.0);
+PricingResult OptionPricer::price_stratified(const KernelEntry& kernel,
+                                             const KernelParams& params,
+                                             double T,
+                                             PricingWorkspace& workspace,
+                                             std::chrono::high_resolution_clock::time_point start_time) {
+    if (num_simulations_ < 2 * num_strata_) {
+        throw ValidationError("Stratified sampling requires at least two paths per stratum");
+    }
+
+    // Chunks of whole strata, about chunk_size_ paths each, are claimed dynamically
+    std::uint64_t paths_per_stratum = num_simulations_ / num_strata_;
+    const auto plan = PricingWorkspace::ChunkPlan::make(
+        num_strata_, std::max<std::uint64_t>(1, chunk_size_ / paths_per_stratum));
+    PathAccumulator* strata = workspace.chunk_accumulators(num_strata_);
 
-    double S0 = model_.get_initial_price();
-    double r = model_.get_risk_free_rate();
-    double sigma = model_.get_volatility();
-    double dt = T;
+    auto job = [&](PricingWorkspace::WorkerState& state, std::uint64_t,
+                   std::uint64_t first, std::uint64_t last) {
+        kernel.simulate_strata(params, first, last, state, strata);
+    };
+    workspace.run_chunks(plan, job);
 
-    for (unsigned int i = start_idx; i < end_idx; ++i) {
-        double z = dist(gen);
-        double S_T = S0 * std::exp((r - 0.5 * sigma * sigma) * dt + sigma * std::sqrt(dt) * z);
-        
-        double payoff_value = payoff.calculate(S_T);
-        sum_payoffs += payoff_value;
-        sum_squared_payoffs += payoff_value * payoff_value;
+    StratifiedAccumulator total;
+    for (unsigned int s = 0; s < num_strata_; ++s) {
+        total.add_stratum(strata[s]);
     }
+
+    double within = total.within_variance();
+    variance_reduction_ = within > 0.0 ? (within + total.between_variance()) / within : 1.0;
+
+    const double discount = model_.discount_factor(T);
+    double discounted_price = total.mean() * discount;
+    double standard_error = total.standard_error() * discount;
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto computation_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+
+    PricingResult result{discounted_price, standard_error, computation_time};
+    result.num_paths = num_simulations_;
+    return result;
 }
 
-} // namespace montecarlo 
\ No newline at end of file
+} // namespace montecarlo
\ No newline at end of file
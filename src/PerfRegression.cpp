@@ -0,0 +1,333 @@
+#include "PerfRegression.h"
+#include "BasketPayoff.h"
+#include "BlackScholesModel.h"
+#include "CallPayoff.h"
+#include "Exceptions.h"
+#include "LocalVolPricer.h"
+#include "MemoryStats.h"
+#include "MertonJumpPricer.h"
+#include "MultiAssetPricer.h"
+#include "OptionPricer.h"
+#include "PutPayoff.h"
+#include "nlohmann/json.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+namespace montecarlo {
+
+PerfBaseline PerfBaseline::load(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw ConfigError("Failed to open performance baseline: " + filename);
+    }
+
+    nlohmann::json j;
+    try {
+        file >> j;
+    } catch (const nlohmann::json::exception& e) {
+        throw ConfigError("Malformed performance baseline " + filename + ": " + e.what());
+    }
+
+    PerfBaseline baseline;
+    baseline.version = j.value("version", 0);
+    if (baseline.version != kVersion) {
+        throw ConfigError("Performance baseline " + filename + " has version " +
+                          std::to_string(baseline.version) + ", expected " +
+                          std::to_string(kVersion) + "; re-record it with --update");
+    }
+    baseline.hardware_threads = j.value("hardware_threads", 0u);
+
+    for (const auto& w : j.at("workloads")) {
+        PerfSample sample;
+        sample.name = w.at("name").get<std::string>();
+        sample.paths = w.at("paths").get<std::uint64_t>();
+        sample.repeats = w.value("repeats", 0u);
+        sample.paths_per_second = w.at("paths_per_second").get<double>();
+        sample.latency_p50_ms = w.at("latency_ms").at("p50").get<double>();
+        sample.latency_p90_ms = w.at("latency_ms").at("p90").get<double>();
+        sample.latency_p99_ms = w.at("latency_ms").at("p99").get<double>();
+        sample.noise = w.value("noise", 0.0);
+        sample.peak_memory_kb = w.value("peak_memory_kb", std::size_t{0});
+        baseline.samples.push_back(sample);
+    }
+    return baseline;
+}
+
+void PerfBaseline::save(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file for writing: " + filename);
+    }
+
+    nlohmann::json workloads = nlohmann::json::array();
+    for (const auto& sample : samples) {
+        workloads.push_back({
+            {"name", sample.name},
+            {"paths", sample.paths},
+            {"repeats", sample.repeats},
+            {"paths_per_second", sample.paths_per_second},
+            {"latency_ms", {
+                {"p50", sample.latency_p50_ms},
+                {"p90", sample.latency_p90_ms},
+                {"p99", sample.latency_p99_ms}
+            }},
+            {"noise", sample.noise},
+            {"peak_memory_kb", sample.peak_memory_kb}
+        });
+    }
+
+    nlohmann::json j;
+    j["version"] = version;
+    j["hardware_threads"] = hardware_threads;
+    j["workloads"] = workloads;
+    file << std::setw(4) << j << std::endl;
+}
+
+const PerfSample* PerfBaseline::find(const std::string& name) const {
+    for (const auto& sample : samples) {
+        if (sample.name == name) {
+            return &sample;
+        }
+    }
+    return nullptr;
+}
+
+bool PerfComparison::regressed() const {
+    return std::any_of(rows.begin(), rows.end(), [](const Row& row) { return row.regressed; });
+}
+
+std::string PerfComparison::format() const {
+    std::ostringstream out;
+    out << std::left << std::setw(24) << "workload"
+        << std::right << std::setw(14) << "baseline/s"
+        << std::setw(14) << "current/s"
+        << std::setw(10) << "change"
+        << std::setw(10) << "allowed"
+        << std::setw(10) << "memory"
+        << "  status\n";
+
+    out << std::fixed;
+    for (const auto& row : rows) {
+        out << std::left << std::setw(24) << row.name << std::right
+            << std::setprecision(0)
+            << std::setw(14) << row.baseline_paths_per_second
+            << std::setw(14) << row.current_paths_per_second
+            << std::setprecision(1)
+            << std::setw(9) << 100.0 * row.change << "%"
+            << std::setw(8) << "-" << 100.0 * row.allowed << "%"
+            << std::setw(9) << 100.0 * row.memory_change << "%"
+            << "  " << row.status << "\n";
+    }
+    return out.str();
+}
+
+double percentile(std::vector<double> values, double q) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    double position = std::clamp(q, 0.0, 1.0) * (values.size() - 1);
+    std::size_t lower = static_cast<std::size_t>(position);
+    std::size_t upper = std::min(lower + 1, values.size() - 1);
+    double fraction = position - lower;
+    return values[lower] + fraction * (values[upper] - values[lower]);
+}
+
+double relative_mad(const std::vector<double>& values) {
+    double median = percentile(values, 0.5);
+    if (median == 0.0) {
+        return 0.0;
+    }
+    std::vector<double> deviations;
+    deviations.reserve(values.size());
+    for (double v : values) {
+        deviations.push_back(std::abs(v - median));
+    }
+    return percentile(deviations, 0.5) / median;
+}
+
+std::size_t peak_memory_kb() {
+    return peak_rss_kb();
+}
+
+PerfSample measure(const PerfWorkload& workload, unsigned int repeats) {
+    repeats = std::max(repeats, 1u);
+
+    // The process high-water mark never comes down, so each workload is
+    // measured against the memory in use when it starts
+    const bool heap_counted = allocations_counted();
+    const std::int64_t live_before = memory_stats().total.live_bytes;
+    const std::size_t rss_before = current_rss_kb();
+    std::size_t rss_peak = rss_before;
+    if (heap_counted) {
+        reset_peak_live_bytes();
+    }
+
+    // Warm-up: first-touch page faults, lazily built tables, thread wake-up
+    workload.run();
+
+    std::vector<double> latencies;
+    latencies.reserve(repeats);
+    for (unsigned int i = 0; i < repeats; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        workload.run();
+        auto end = std::chrono::steady_clock::now();
+        latencies.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        rss_peak = std::max(rss_peak, current_rss_kb());
+    }
+
+    PerfSample sample;
+    sample.name = workload.name;
+    sample.paths = workload.paths;
+    sample.repeats = repeats;
+    sample.latency_p50_ms = percentile(latencies, 0.50);
+    sample.latency_p90_ms = percentile(latencies, 0.90);
+    sample.latency_p99_ms = percentile(latencies, 0.99);
+    sample.paths_per_second = sample.latency_p50_ms > 0.0
+        ? workload.paths / (sample.latency_p50_ms * 1e-3)
+        : 0.0;
+    sample.noise = relative_mad(latencies);
+    if (heap_counted) {
+        const std::int64_t growth = memory_stats().peak_live_bytes - live_before;
+        sample.peak_memory_kb = growth > 0 ? static_cast<std::size_t>(growth + 1023) / 1024 : 0;
+    } else {
+        // Without the counting allocator, resident-set growth sampled after each run
+        sample.peak_memory_kb = rss_peak - rss_before;
+    }
+    return sample;
+}
+
+PerfComparison compare(const PerfBaseline& baseline,
+                       const std::vector<PerfSample>& current,
+                       const PerfThresholds& thresholds) {
+    PerfComparison comparison;
+
+    for (const auto& sample : current) {
+        PerfComparison::Row row;
+        row.name = sample.name;
+        row.current_paths_per_second = sample.paths_per_second;
+
+        const PerfSample* reference = baseline.find(sample.name);
+        if (reference == nullptr || reference->paths_per_second <= 0.0) {
+            row.status = "new";
+            comparison.rows.push_back(row);
+            continue;
+        }
+
+        row.baseline_paths_per_second = reference->paths_per_second;
+        if (reference->paths != sample.paths) {
+            // Different problem sizes (e.g. --scale) are not comparable
+            row.status = "resized";
+            comparison.rows.push_back(row);
+            continue;
+        }
+        row.change = sample.paths_per_second / reference->paths_per_second - 1.0;
+        double noise = std::sqrt(reference->noise * reference->noise + sample.noise * sample.noise);
+        row.allowed = std::max(thresholds.throughput, thresholds.noise_multiplier * noise);
+        if (reference->peak_memory_kb > 0) {
+            row.memory_change = static_cast<double>(sample.peak_memory_kb) / reference->peak_memory_kb - 1.0;
+        }
+
+        row.regressed = row.change < -row.allowed || row.memory_change > thresholds.memory;
+        row.status = row.regressed ? "REGRESSED" : "ok";
+        comparison.rows.push_back(row);
+    }
+
+    for (const auto& reference : baseline.samples) {
+        bool measured = std::any_of(current.begin(), current.end(),
+            [&](const PerfSample& sample) { return sample.name == reference.name; });
+        if (!measured) {
+            PerfComparison::Row row;
+            row.name = reference.name;
+            row.baseline_paths_per_second = reference.paths_per_second;
+            row.status = "missing";
+            comparison.rows.push_back(row);
+        }
+    }
+    return comparison;
+}
+
+std::vector<PerfWorkload> standard_workloads(unsigned int num_threads, double scale) {
+    auto paths = [scale](unsigned int base) {
+        return std::max(1u, static_cast<unsigned int>(base * scale));
+    };
+    constexpr double T = 1.0;
+
+    // Shared, seeded state; each workload captures the objects its pricer references
+    auto workspace = std::make_shared<PricingWorkspace>(std::max(num_threads, 1u), 20240601);
+    auto model = std::make_shared<BlackScholesModel>(100.0, 0.05, 0.2);
+    auto call = std::make_shared<CallPayoff>(100.0);
+    auto put = std::make_shared<PutPayoff>(100.0);
+
+    std::vector<PerfWorkload> workloads;
+
+    auto add_vanilla = [&](const std::string& name, const Payoff& payoff, PathPrecision precision,
+                           const std::function<void(OptionPricer&)>& setup) {
+        unsigned int n = paths(1u << 21);
+        auto pricer = std::make_shared<OptionPricer>(*model, n, workspace->num_workers(), precision);
+        setup(*pricer);
+        const Payoff* priced = &payoff;
+        workloads.push_back({name, n, [pricer, priced, workspace, model, call, put] {
+            pricer->price_option(*priced, T, *workspace);
+        }});
+    };
+    auto plain = [](OptionPricer&) {};
+
+    add_vanilla("bs_call_double", *call, PathPrecision::Double, plain);
+    add_vanilla("bs_call_float", *call, PathPrecision::Single, plain);
+    add_vanilla("bs_put_double", *put, PathPrecision::Double, plain);
+    add_vanilla("bs_call_inverse_cdf", *call, PathPrecision::Double, [](OptionPricer& p) {
+        p.set_normal_method(NormalMethod::InverseCdf);
+    });
+    add_vanilla("bs_call_stratified", *call, PathPrecision::Double, [](OptionPricer& p) {
+        p.set_stratification(1024);
+    });
+    add_vanilla("bs_call_importance", *call, PathPrecision::Double, [](OptionPricer& p) {
+        p.set_drift_shift(1.0);
+    });
+
+    {
+        auto jumps = std::make_shared<MertonJumpModel>(100.0, 0.05, 0.2, 0.5, -0.1, 0.15);
+        auto pricer = std::make_shared<MertonJumpPricer>(*jumps, paths(1u << 20), workspace->num_workers());
+        workloads.push_back({"merton_call", paths(1u << 20),
+                             [pricer, jumps, call, workspace] { pricer->price_option(*call, T, *workspace); }});
+    }
+
+    {
+        auto local_vol = std::make_shared<LocalVolModel>(
+            100.0, 0.05,
+            std::vector<double>{0.0, 0.5, 1.0},
+            std::vector<double>{50.0, 100.0, 150.0, 200.0},
+            std::vector<double>{0.35, 0.25, 0.20, 0.18,
+                                0.37, 0.27, 0.22, 0.20,
+                                0.40, 0.30, 0.25, 0.22});
+        auto pricer = std::make_shared<LocalVolPricer>(*local_vol, paths(1u << 16), workspace->num_workers(), 50);
+        workloads.push_back({"local_vol_call_50_steps", paths(1u << 16),
+                             [pricer, local_vol, call, workspace] { pricer->price_option(*call, T, *workspace); }});
+    }
+
+    {
+        auto assets = std::make_shared<MultiAssetModel>(
+            std::vector<double>{100.0, 95.0, 105.0},
+            std::vector<double>{0.2, 0.25, 0.3},
+            std::vector<double>{1.0, 0.5, 0.3,
+                                0.5, 1.0, 0.4,
+                                0.3, 0.4, 1.0},
+            0.05);
+        auto basket = std::make_shared<BasketPayoff>(std::vector<double>{1.0 / 3, 1.0 / 3, 1.0 / 3},
+                                                     100.0, OptionType::Call);
+        auto pricer = std::make_shared<MultiAssetPricer>(*assets, paths(1u << 19), workspace->num_workers());
+        workloads.push_back({"basket_call_3_assets", paths(1u << 19),
+                             [pricer, assets, basket, workspace] { pricer->price_option(*basket, T, *workspace); }});
+    }
+
+    return workloads;
+}
+
+} // namespace montecarlo
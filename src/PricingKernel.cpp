@@ -0,0 +1,65 @@
+#include "PricingKernel.h"
+#include <array>
+
+namespace montecarlo {
+
+namespace {
+
+// Table index: (((model precision) * 3 + payoff kind) * 2 + normal method) * 2 + weighted,
+// where model precision is 0 for double GBM, 1 for float GBM and 2 for a generic model
+constexpr std::size_t kNumKernels = 3 * 3 * 2 * 2;
+constexpr std::size_t kKernelsPerModel = 3 * 2 * 2;
+
+template <template <typename> class Model, typename Real, typename PayoffPolicy, typename Normals>
+void add_weightings(KernelEntry* out) {
+    using Plain = PathKernel<Model, PayoffPolicy, Normals, Real, false>;
+    using Weighted = PathKernel<Model, PayoffPolicy, Normals, Real, true>;
+    out[0] = {&Plain::simulate, &Plain::simulate_strata, &Plain::simulate_tracked};
+    out[1] = {&Weighted::simulate, &Weighted::simulate_strata, &Weighted::simulate_tracked};
+}
+
+template <template <typename> class Model, typename Real, typename PayoffPolicy>
+void add_normal_methods(KernelEntry* out) {
+    add_weightings<Model, Real, PayoffPolicy, ZigguratNormals>(out);
+    add_weightings<Model, Real, PayoffPolicy, InverseCdfNormals>(out + 2);
+}
+
+template <template <typename> class Model, typename Real>
+void add_payoffs(KernelEntry* out) {
+    add_normal_methods<Model, Real, VanillaPolicy<OptionType::Call>>(out);
+    add_normal_methods<Model, Real, VanillaPolicy<OptionType::Put>>(out + 4);
+    add_normal_methods<Model, Real, GenericPayoffPolicy>(out + 8);
+}
+
+const std::array<KernelEntry, kNumKernels>& kernel_table() {
+    static const std::array<KernelEntry, kNumKernels> table = [] {
+        std::array<KernelEntry, kNumKernels> t{};
+        add_payoffs<GbmTerminal, double>(t.data());
+        add_payoffs<GbmTerminal, float>(t.data() + kKernelsPerModel);
+        add_payoffs<ModelTerminal, double>(t.data() + 2 * kKernelsPerModel);
+        return t;
+    }();
+    return table;
+}
+
+} // namespace
+
+PayoffKind classify_payoff(const Payoff& payoff, double& strike) {
+    auto terms = payoff.vanilla_terms();
+    if (!terms) {
+        return PayoffKind::Generic;
+    }
+    strike = terms->strike;
+    return terms->type == OptionType::Call ? PayoffKind::Call : PayoffKind::Put;
+}
+
+const KernelEntry& select_kernel(ModelKind model, PathPrecision precision, PayoffKind kind,
+                                 NormalMethod method, bool weighted) {
+    std::size_t index = model == ModelKind::Generic ? 2 : (precision == PathPrecision::Single ? 1 : 0);
+    index = index * 3 + static_cast<std::size_t>(kind);
+    index = index * 2 + (method == NormalMethod::InverseCdf ? 1 : 0);
+    index = index * 2 + (weighted ? 1 : 0);
+    return kernel_table()[index];
+}
+
+} // namespace montecarlo
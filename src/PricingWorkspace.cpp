@@ -0,0 +1,172 @@
+#include "PricingWorkspace.h"
+#include "Exceptions.h"
+#include "MemoryStats.h"
+
+namespace montecarlo {
+
+namespace {
+
+std::uint64_t mix64(std::uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Seed sequence filling the engine state from a SplitMix64 stream. Much
+// cheaper than std::seed_seq, and keyed on a full 64-bit value.
+struct SplitMixSequence {
+    using result_type = std::uint32_t;
+    std::uint64_t state;
+
+    template <typename It>
+    void generate(It begin, It end) {
+        for (; begin != end; ++begin) {
+            state += 0x9E3779B97F4A7C15ull;
+            *begin = static_cast<std::uint32_t>(mix64(state) >> 32);
+        }
+    }
+};
+
+} // namespace
+
+PricingWorkspace::ChunkPlan PricingWorkspace::ChunkPlan::make(std::uint64_t num_items,
+                                                              std::uint64_t min_chunk,
+                                                              std::uint64_t max_chunks) {
+    min_chunk = std::max<std::uint64_t>(min_chunk, 1);
+    max_chunks = std::max<std::uint64_t>(max_chunks, 1);
+
+    ChunkPlan plan;
+    plan.num_items = num_items;
+    plan.chunk_size = min_chunk;
+
+    // Grow the chunk in whole multiples of the minimum to respect the cap
+    std::uint64_t needed = num_items / max_chunks + (num_items % max_chunks != 0 ? 1 : 0);
+    if (needed > min_chunk) {
+        plan.chunk_size = (needed / min_chunk + (needed % min_chunk != 0 ? 1 : 0)) * min_chunk;
+    }
+    plan.num_chunks = (num_items + plan.chunk_size - 1) / plan.chunk_size;
+    return plan;
+}
+
+PricingWorkspace::PricingWorkspace(unsigned int num_workers)
+    : PricingWorkspace(num_workers, std::random_device{}()) {
+}
+
+PricingWorkspace::PricingWorkspace(unsigned int num_workers, std::uint64_t seed) {
+    MemoryScope memory_scope(MemorySubsystem::Pricer);
+    if (num_workers == 0) {
+        throw SimulationError("Workspace requires at least one worker");
+    }
+
+    workers_.resize(num_workers);
+    for (auto& state : workers_) {
+        state.block = AlignedBuffer<double>(kBlockSize);
+    }
+    reseed(seed);
+
+    // Worker 0 runs on the calling thread
+    threads_.reserve(num_workers - 1);
+    for (unsigned int i = 1; i < num_workers; ++i) {
+        threads_.emplace_back(&PricingWorkspace::worker_loop, this, i);
+    }
+}
+
+PricingWorkspace::~PricingWorkspace() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void PricingWorkspace::reseed(std::uint64_t seed) {
+    seed_ = seed;
+    chunk_calls_ = 0;
+    for (unsigned int i = 0; i < workers_.size(); ++i) {
+        std::seed_seq seq{static_cast<std::uint32_t>(seed),
+                          static_cast<std::uint32_t>(seed >> 32),
+                          static_cast<std::uint32_t>(i)};
+        workers_[i].rng.seed(seq);
+    }
+}
+
+void PricingWorkspace::seed_chunk(std::mt19937& rng, std::uint64_t call, std::uint64_t chunk) const {
+    SplitMixSequence sequence{mix64(mix64(seed_ ^ mix64(call)) ^ chunk)};
+    rng.seed(sequence);
+}
+
+PathAccumulator* PricingWorkspace::chunk_accumulators(std::size_t count) {
+    if (chunk_accumulators_.size() < count) {
+        chunk_accumulators_.resize(count);
+    }
+    std::fill(chunk_accumulators_.begin(), chunk_accumulators_.begin() + count, PathAccumulator{});
+    return chunk_accumulators_.data();
+}
+
+BatchMeansAccumulator* PricingWorkspace::batch_accumulators(std::size_t count) {
+    if (batch_accumulators_.size() < count) {
+        batch_accumulators_.resize(count);
+    }
+    std::fill(batch_accumulators_.begin(), batch_accumulators_.begin() + count, BatchMeansAccumulator{});
+    return batch_accumulators_.data();
+}
+
+void PricingWorkspace::run(void (*job)(void*, unsigned int), void* context) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = job;
+        context_ = context;
+        pending_ = static_cast<unsigned int>(threads_.size());
+        error_ = nullptr;
+        ++generation_;
+    }
+    start_cv_.notify_all();
+
+    execute(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return pending_ == 0; });
+    job_ = nullptr;
+    context_ = nullptr;
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+void PricingWorkspace::worker_loop(unsigned int index) {
+    MemoryScope memory_scope(MemorySubsystem::Pricer);
+    std::uint64_t seen_generation = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_cv_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+            if (stopping_) {
+                return;
+            }
+            seen_generation = generation_;
+        }
+
+        execute(index);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--pending_ == 0) {
+            done_cv_.notify_one();
+        }
+    }
+}
+
+void PricingWorkspace::execute(unsigned int index) {
+    try {
+        job_(context_, index);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error_) {
+            error_ = std::current_exception();
+        }
+    }
+}
+
+} // namespace montecarlo
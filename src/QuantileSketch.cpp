@@ -0,0 +1,195 @@
+#include "QuantileSketch.h"
+#include "Exceptions.h"
+#include <algorithm>
+
+namespace montecarlo {
+
+QuantileSketch::QuantileSketch(double relative_accuracy, std::size_t max_buckets)
+    : relative_accuracy_(relative_accuracy),
+      gamma_((1.0 + relative_accuracy) / (1.0 - relative_accuracy)),
+      log_gamma_(std::log(gamma_)),
+      inverse_log_gamma_(1.0 / log_gamma_),
+      positive_(max_buckets),
+      negative_(max_buckets) {
+    if (!(relative_accuracy > 0.0 && relative_accuracy < 1.0)) {
+        throw ValidationError("Quantile sketch relative accuracy must be in (0, 1)");
+    }
+    if (max_buckets < 2) {
+        throw ValidationError("Quantile sketch needs at least two buckets");
+    }
+}
+
+int QuantileSketch::Store::extend(int bucket) {
+    const int size = static_cast<int>(counts.size());
+    if (!used) {
+        // Start with the bucket at the top of the window, leaving room below
+        used = true;
+        offset = bucket - size + 1;
+        return bucket;
+    }
+
+    if (bucket >= offset + size) {
+        // Slide the window up; buckets falling off the bottom collapse into the new lowest
+        int shift = bucket - size + 1 - offset;
+        double collapsed = 0.0;
+        int kept = std::max(size - shift, 0);
+        for (int i = 0; i < size - kept; ++i) {
+            collapsed += counts[i];
+        }
+        if (kept > 0) {
+            collapsed += counts[shift];
+            std::copy(counts.begin() + shift + 1, counts.end(), counts.begin() + 1);
+        }
+        std::fill(counts.begin() + std::max(kept, 1), counts.end(), 0.0);
+        counts[0] = collapsed;
+        offset += shift;
+        return bucket;
+    }
+
+    // Below the window: slide it down as far as the highest bucket allows,
+    // and count anything still out of reach in the lowest bucket
+    int highest = offset + size - 1;
+    while (counts[static_cast<std::size_t>(highest - offset)] == 0.0) {
+        --highest;
+    }
+    int lowest_allowed = highest - size + 1;
+    if (lowest_allowed < offset) {
+        int shift = offset - lowest_allowed;
+        std::copy_backward(counts.begin(), counts.end() - shift, counts.end());
+        std::fill(counts.begin(), counts.begin() + shift, 0.0);
+        offset = lowest_allowed;
+    }
+    return std::max(bucket, lowest_allowed);
+}
+
+void QuantileSketch::Store::clear() {
+    std::fill(counts.begin(), counts.end(), 0.0);
+    offset = 0;
+    used = false;
+}
+
+void QuantileSketch::merge(const QuantileSketch& other) {
+    if (other.relative_accuracy_ != relative_accuracy_ || other.max_buckets() != max_buckets()) {
+        throw ValidationError("Quantile sketches with different parameters cannot be merged");
+    }
+    if (other.empty()) {
+        return;
+    }
+    auto merge_store = [](Store& into, const Store& from) {
+        for (std::size_t i = 0; i < from.counts.size(); ++i) {
+            if (from.counts[i] != 0.0) {
+                into.add(from.offset + static_cast<int>(i), from.counts[i]);
+            }
+        }
+    };
+    merge_store(positive_, other.positive_);
+    merge_store(negative_, other.negative_);
+    zero_weight_ += other.zero_weight_;
+    total_weight_ += other.total_weight_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+void QuantileSketch::clear() {
+    positive_.clear();
+    negative_.clear();
+    zero_weight_ = 0.0;
+    total_weight_ = 0.0;
+    min_ = std::numeric_limits<double>::infinity();
+    max_ = -std::numeric_limits<double>::infinity();
+}
+
+template <typename Visitor>
+void QuantileSketch::for_each_bucket(Visitor&& visit) const {
+    // Representatives are clamped to the exact range, which also places the
+    // collapsed lowest buckets no further out than the true extremes
+    auto clamp = [this](double value) { return std::min(std::max(value, min_), max_); };
+    if (negative_.used) {
+        for (std::size_t i = negative_.counts.size(); i-- > 0;) {
+            if (negative_.counts[i] != 0.0) {
+                visit(clamp(-representative(negative_.offset + static_cast<int>(i))), negative_.counts[i]);
+            }
+        }
+    }
+    if (zero_weight_ > 0.0) {
+        visit(clamp(0.0), zero_weight_);
+    }
+    if (positive_.used) {
+        for (std::size_t i = 0; i < positive_.counts.size(); ++i) {
+            if (positive_.counts[i] != 0.0) {
+                visit(clamp(representative(positive_.offset + static_cast<int>(i))), positive_.counts[i]);
+            }
+        }
+    }
+}
+
+double QuantileSketch::quantile(double q) const {
+    if (empty()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (q <= 0.0) {
+        return min_;
+    }
+    if (q >= 1.0) {
+        return max_;
+    }
+
+    const double target = q * total_weight_;
+    double cumulative = 0.0;
+    double result = max_;
+    bool found = false;
+    for_each_bucket([&](double value, double weight) {
+        cumulative += weight;
+        if (!found && cumulative > target) {
+            result = value;
+            found = true;
+        }
+    });
+    return result;
+}
+
+double QuantileSketch::upper_tail_mean(double q) const {
+    if (empty()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (q >= 1.0) {
+        return max_;
+    }
+
+    // Skip the lowest share q of the weight, splitting the bucket it ends in
+    const double skip = std::max(q, 0.0) * total_weight_;
+    double cumulative = 0.0;
+    double tail_sum = 0.0;
+    double tail_weight = 0.0;
+    for_each_bucket([&](double value, double weight) {
+        double below = std::min(weight, std::max(skip - cumulative, 0.0));
+        cumulative += weight;
+        tail_sum += (weight - below) * value;
+        tail_weight += weight - below;
+    });
+    return tail_weight > 0.0 ? tail_sum / tail_weight : max_;
+}
+
+std::vector<HistogramBin> QuantileSketch::histogram(std::size_t num_bins) const {
+    std::vector<HistogramBin> bins;
+    if (empty() || num_bins == 0) {
+        return bins;
+    }
+    if (max_ == min_) {
+        bins.push_back({min_, max_, 1.0});
+        return bins;
+    }
+
+    const double width = (max_ - min_) / num_bins;
+    bins.reserve(num_bins);
+    for (std::size_t b = 0; b < num_bins; ++b) {
+        bins.push_back({min_ + b * width, b + 1 == num_bins ? max_ : min_ + (b + 1) * width, 0.0});
+    }
+    for_each_bucket([&](double value, double weight) {
+        auto b = static_cast<std::size_t>((value - min_) / width);
+        bins[std::min(b, num_bins - 1)].probability += weight / total_weight_;
+    });
+    return bins;
+}
+
+} // namespace montecarlo
@@ -1,13 +1,26 @@
 #include "ResultExporter.h"
+#include "MemoryStats.h"
 #include <fstream>
 #include <iomanip>
 #include <ctime>
 
 namespace montecarlo {
 
+namespace {
+
+// The memory snapshot in a result is taken before the result is written, so
+// the exporter's own allocations can never be in it; its row is left out
+// rather than reported as zero
+bool exported_subsystem(std::size_t index) {
+    return static_cast<MemorySubsystem>(index) != MemorySubsystem::Exporter;
+}
+
+} // namespace
+
 void ResultExporter::export_to_csv(const std::string& filename,
                                  const PricingResult& result,
                                  const Config& config) {
+    MemoryScope memory_scope(MemorySubsystem::Exporter);
     std::ofstream file(filename);
     if (!file.is_open()) {
         throw std::runtime_error("Failed to open file for writing: " + filename);
@@ -19,6 +32,9 @@ void ResultExporter::export_to_csv(const std::string& filename,
     // Write simulation parameters
     file << "num_simulations," << config.num_simulations << "\n";
     file << "num_threads," << config.num_threads << "\n";
+    file << "path_precision," << to_string(config.path_precision) << "\n";
+    file << "sampling," << to_string(config.sampling) << "\n";
+    file << "normal_generator," << to_string(config.normal_method) << "\n";
     
     // Write option parameters
     file << "option_type," << (config.option_type == OptionType::Call ? "call" : "put") << "\n";
@@ -32,11 +48,56 @@ void ResultExporter::export_to_csv(const std::string& filename,
     file << "price," << std::setprecision(config.precision) << result.price << "\n";
     file << "standard_error," << std::setprecision(config.precision) << result.standard_error << "\n";
     file << "computation_time_ms," << result.computation_time.count() << "\n";
+    if (result.deadline_reached) {
+        file << "deadline_reached,true\n";
+        file << "paths," << result.num_paths << "\n";
+    }
+
+    // Write payoff distribution
+    if (result.distribution) {
+        const auto& distribution = *result.distribution;
+        file << std::setprecision(config.precision);
+        for (std::size_t i = 0; i < distribution.levels.size(); ++i) {
+            file << "quantile_" << distribution.levels[i] << "," << distribution.quantiles[i] << "\n";
+        }
+        file << "var_confidence," << distribution.confidence << "\n";
+        file << "value_at_risk," << distribution.value_at_risk << "\n";
+        file << "expected_shortfall," << distribution.expected_shortfall << "\n";
+        file << "payoff_min," << distribution.min << "\n";
+        file << "payoff_max," << distribution.max << "\n";
+        for (std::size_t b = 0; b < distribution.histogram.size(); ++b) {
+            file << "histogram_" << b << "_lower," << distribution.histogram[b].lower << "\n";
+            file << "histogram_" << b << "_probability," << distribution.histogram[b].probability << "\n";
+        }
+    }
+
+    // Write memory use
+    if (result.memory) {
+        const auto& memory = *result.memory;
+        file << "peak_rss_kb," << memory.peak_rss_kb << "\n";
+        file << "current_rss_kb," << memory.current_rss_kb << "\n";
+        if (memory.counted) {
+            file << "heap_allocations," << memory.total.allocations << "\n";
+            file << "heap_bytes_allocated," << memory.total.bytes_allocated << "\n";
+            file << "heap_live_bytes," << memory.total.live_bytes << "\n";
+            file << "heap_peak_live_bytes," << memory.peak_live_bytes << "\n";
+            for (std::size_t i = 0; i < kNumMemorySubsystems; ++i) {
+                if (!exported_subsystem(i)) {
+                    continue;
+                }
+                const char* name = to_string(static_cast<MemorySubsystem>(i));
+                file << name << "_allocations," << memory.subsystems[i].allocations << "\n";
+                file << name << "_bytes_allocated," << memory.subsystems[i].bytes_allocated << "\n";
+                file << name << "_live_bytes," << memory.subsystems[i].live_bytes << "\n";
+            }
+        }
+    }
 }
 
 void ResultExporter::export_to_json(const std::string& filename,
                                   const PricingResult& result,
                                   const Config& config) {
+    MemoryScope memory_scope(MemorySubsystem::Exporter);
     std::ofstream file(filename);
     if (!file.is_open()) {
         throw std::runtime_error("Failed to open file for writing: " + filename);
@@ -47,7 +108,10 @@ void ResultExporter::export_to_json(const std::string& filename,
     // Add simulation parameters
     j["simulation"] = {
         {"num_simulations", config.num_simulations},
-        {"num_threads", config.num_threads}
+        {"num_threads", config.num_threads},
+        {"path_precision", to_string(config.path_precision)},
+        {"sampling", to_string(config.sampling)},
+        {"normal_generator", to_string(config.normal_method)}
     };
     
     // Add option parameters
@@ -68,6 +132,61 @@ void ResultExporter::export_to_json(const std::string& filename,
         {"standard_error", result.standard_error},
         {"computation_time_ms", result.computation_time.count()}
     };
+    if (result.deadline_reached) {
+        j["results"]["deadline_reached"] = true;
+        j["results"]["paths"] = result.num_paths;
+    }
+
+    // Add payoff distribution
+    if (result.distribution) {
+        const auto& distribution = *result.distribution;
+        nlohmann::json quantiles = nlohmann::json::array();
+        for (std::size_t i = 0; i < distribution.levels.size(); ++i) {
+            quantiles.push_back({{"level", distribution.levels[i]}, {"value", distribution.quantiles[i]}});
+        }
+        nlohmann::json histogram = nlohmann::json::array();
+        for (const auto& bin : distribution.histogram) {
+            histogram.push_back({{"lower", bin.lower}, {"upper", bin.upper}, {"probability", bin.probability}});
+        }
+        j["distribution"] = {
+            {"quantiles", quantiles},
+            {"confidence", distribution.confidence},
+            {"value_at_risk", distribution.value_at_risk},
+            {"expected_shortfall", distribution.expected_shortfall},
+            {"min", distribution.min},
+            {"max", distribution.max},
+            {"histogram", histogram}
+        };
+    }
+
+    // Add memory use
+    if (result.memory) {
+        const auto& memory = *result.memory;
+        j["memory"] = {
+            {"peak_rss_kb", memory.peak_rss_kb},
+            {"current_rss_kb", memory.current_rss_kb}
+        };
+        if (memory.counted) {
+            auto counters_to_json = [](const MemoryCounters& counters) {
+                return nlohmann::json{
+                    {"allocations", counters.allocations},
+                    {"deallocations", counters.deallocations},
+                    {"bytes_allocated", counters.bytes_allocated},
+                    {"live_bytes", counters.live_bytes}
+                };
+            };
+            nlohmann::json heap = counters_to_json(memory.total);
+            heap["peak_live_bytes"] = memory.peak_live_bytes;
+            for (std::size_t i = 0; i < kNumMemorySubsystems; ++i) {
+                if (!exported_subsystem(i)) {
+                    continue;
+                }
+                heap["subsystems"][to_string(static_cast<MemorySubsystem>(i))] =
+                    counters_to_json(memory.subsystems[i]);
+            }
+            j["memory"]["heap"] = heap;
+        }
+    }
     
     // Add metadata
     auto now = std::chrono::system_clock::now();
@@ -85,6 +204,7 @@ void ResultExporter::export_to_json(const std::string& filename,
 void ResultExporter::export_to_text(const std::string& filename,
                                   const PricingResult& result,
                                   const Config& config) {
+    MemoryScope memory_scope(MemorySubsystem::Exporter);
     std::ofstream file(filename);
     if (!file.is_open()) {
         throw std::runtime_error("Failed to open file for writing: " + filename);
@@ -104,7 +224,10 @@ void ResultExporter::export_to_text(const std::string& filename,
     file << "Simulation Parameters:\n";
     file << "---------------------\n";
     file << "Number of simulations: " << config.num_simulations << "\n";
-    file << "Number of threads: " << config.num_threads << "\n\n";
+    file << "Number of threads: " << config.num_threads << "\n";
+    file << "Path precision: " << to_string(config.path_precision) << "\n";
+    file << "Sampling: " << to_string(config.sampling) << "\n";
+    file << "Normal generator: " << to_string(config.normal_method) << "\n\n";
     
     file << "Option Parameters:\n";
     file << "-----------------\n";
@@ -120,6 +243,166 @@ void ResultExporter::export_to_text(const std::string& filename,
     file << "Option Price: " << std::setprecision(config.precision) << result.price << "\n";
     file << "Standard Error: " << std::setprecision(config.precision) << result.standard_error << "\n";
     file << "Computation Time: " << result.computation_time.count() << " ms\n";
+    if (result.deadline_reached) {
+        file << "Deadline reached after " << result.num_paths << " paths\n";
+    }
+
+    if (result.distribution) {
+        const auto& distribution = *result.distribution;
+        file << "\nPayoff Distribution:\n";
+        file << "--------------------\n";
+        file << std::setprecision(config.precision);
+        for (std::size_t i = 0; i < distribution.levels.size(); ++i) {
+            file << "Quantile " << distribution.levels[i] << ": " << distribution.quantiles[i] << "\n";
+        }
+        file << "VaR (" << distribution.confidence << "): " << distribution.value_at_risk << "\n";
+        file << "Expected Shortfall (" << distribution.confidence << "): "
+             << distribution.expected_shortfall << "\n";
+        file << "Range: [" << distribution.min << ", " << distribution.max << "]\n";
+        file << "Histogram:\n";
+        for (const auto& bin : distribution.histogram) {
+            file << "  [" << bin.lower << ", " << bin.upper << "): " << bin.probability << "\n";
+        }
+    }
+
+    if (result.memory) {
+        const auto& memory = *result.memory;
+        file << "\nMemory:\n";
+        file << "-------\n";
+        file << "Peak RSS: " << memory.peak_rss_kb << " KiB\n";
+        file << "Current RSS: " << memory.current_rss_kb << " KiB\n";
+        if (memory.counted) {
+            file << "Heap allocations: " << memory.total.allocations
+                 << " (" << memory.total.bytes_allocated << " bytes)\n";
+            file << "Peak live heap: " << memory.peak_live_bytes << " bytes\n";
+            for (std::size_t i = 0; i < kNumMemorySubsystems; ++i) {
+                if (!exported_subsystem(i)) {
+                    continue;
+                }
+                file << "  " << to_string(static_cast<MemorySubsystem>(i)) << ": "
+                     << memory.subsystems[i].allocations << " allocations, "
+                     << memory.subsystems[i].bytes_allocated << " bytes, "
+                     << memory.subsystems[i].live_bytes << " live\n";
+            }
+        } else {
+            file << "Heap allocations: not counted (build with MONTECARLO_COUNT_ALLOCATIONS)\n";
+        }
+    }
+}
+
+void ResultExporter::export_scenarios_to_csv(const std::string& filename,
+                                            const ScenarioResult& result,
+                                            const Config& config) {
+    MemoryScope memory_scope(MemorySubsystem::Exporter);
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file for writing: " + filename);
+    }
+
+    file << "scenario,instrument,S,sigma,r,price,standard_error,pnl,pnl_standard_error\n";
+    file << std::setprecision(config.precision);
+    for (std::size_t s = 0; s < result.scenarios.size(); ++s) {
+        const auto& scenario = result.scenarios[s];
+        for (std::size_t i = 0; i < result.num_instruments; ++i) {
+            std::size_t c = s * result.num_instruments + i;
+            file << s << "," << i << ","
+                 << scenario.S << "," << scenario.sigma << "," << scenario.r << ","
+                 << result.prices[c] << "," << result.standard_errors[c] << ","
+                 << result.pnl[c] << "," << result.pnl_standard_errors[c] << "\n";
+        }
+    }
+}
+
+void ResultExporter::export_scenarios_to_json(const std::string& filename,
+                                             const ScenarioResult& result,
+                                             const Config& config) {
+    MemoryScope memory_scope(MemorySubsystem::Exporter);
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file for writing: " + filename);
+    }
+
+    nlohmann::json j;
+    j["simulation"] = {
+        {"num_simulations", config.num_simulations},
+        {"num_threads", config.num_threads},
+        {"path_precision", to_string(config.path_precision)}
+    };
+
+    nlohmann::json scenarios = nlohmann::json::array();
+    for (std::size_t s = 0; s < result.scenarios.size(); ++s) {
+        const auto& scenario = result.scenarios[s];
+        auto begin = static_cast<std::ptrdiff_t>(s * result.num_instruments);
+        auto end = begin + static_cast<std::ptrdiff_t>(result.num_instruments);
+        scenarios.push_back({
+            {"S", scenario.S},
+            {"sigma", scenario.sigma},
+            {"r", scenario.r},
+            {"prices", std::vector<double>(result.prices.begin() + begin, result.prices.begin() + end)},
+            {"standard_errors", std::vector<double>(result.standard_errors.begin() + begin,
+                                                    result.standard_errors.begin() + end)},
+            {"pnl", std::vector<double>(result.pnl.begin() + begin, result.pnl.begin() + end)},
+            {"pnl_standard_errors", std::vector<double>(result.pnl_standard_errors.begin() + begin,
+                                                        result.pnl_standard_errors.begin() + end)}
+        });
+    }
+    j["scenarios"] = scenarios;
+    j["results"] = {
+        {"num_scenarios", result.scenarios.size()},
+        {"num_instruments", result.num_instruments},
+        {"computation_time_ms", result.computation_time.count()}
+    };
+
+    file << std::setw(4) << j << std::endl;
+}
+
+void ResultExporter::export_convergence_to_csv(const std::string& filename,
+                                              const std::vector<ConvergencePoint>& trace,
+                                              const Config& config) {
+    MemoryScope memory_scope(MemorySubsystem::Exporter);
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file for writing: " + filename);
+    }
+
+    file << "paths,estimate,standard_error,elapsed_ms\n";
+    for (const auto& point : trace) {
+        file << point.paths << ","
+             << std::setprecision(config.precision) << point.estimate << ","
+             << std::setprecision(config.precision) << point.standard_error << ","
+             << point.elapsed_ms << "\n";
+    }
+}
+
+void ResultExporter::export_convergence_to_json(const std::string& filename,
+                                               const std::vector<ConvergencePoint>& trace,
+                                               const Config& config) {
+    MemoryScope memory_scope(MemorySubsystem::Exporter);
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file for writing: " + filename);
+    }
+
+    nlohmann::json j;
+    j["simulation"] = {
+        {"num_simulations", config.num_simulations},
+        {"num_threads", config.num_threads},
+        {"path_precision", to_string(config.path_precision)},
+        {"normal_generator", to_string(config.normal_method)}
+    };
+
+    nlohmann::json points = nlohmann::json::array();
+    for (const auto& point : trace) {
+        points.push_back({
+            {"paths", point.paths},
+            {"estimate", point.estimate},
+            {"standard_error", point.standard_error},
+            {"elapsed_ms", point.elapsed_ms}
+        });
+    }
+    j["convergence"] = points;
+
+    file << std::setw(4) << j << std::endl;
 }
 
-} // namespace montecarlo 
\ No newline at end of file
+} // namespace montecarlo
@@ -0,0 +1,214 @@
+#include "ScenarioEngine.h"
+#include "Exceptions.h"
+#include "MemoryStats.h"
+#include "NormalGenerator.h"
+#include "nlohmann/json.hpp"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <random>
+
+namespace montecarlo {
+
+namespace {
+
+// Per-scenario constants folded once before the path loop
+struct ScenarioTerms {
+    double S0;
+    double drift;
+    double diffusion;
+    double discount;
+};
+
+ScenarioTerms make_terms(const MarketScenario& scenario, double T) {
+    if (scenario.S <= 0.0) {
+        throw ValidationError("Shocked spot price must be positive");
+    }
+    if (scenario.sigma < 0.0) {
+        throw ValidationError("Shocked volatility cannot be negative");
+    }
+    return {scenario.S,
+            (scenario.r - 0.5 * scenario.sigma * scenario.sigma) * T,
+            scenario.sigma * std::sqrt(T),
+            std::exp(-scenario.r * T)};
+}
+
+std::vector<double> read_axis(const nlohmann::json& j, const char* key) {
+    if (!j.contains(key)) {
+        return {};
+    }
+    return j.at(key).get<std::vector<double>>();
+}
+
+} // namespace
+
+ShockGrid ShockGrid::load(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw ConfigError("Failed to open shock grid file: " + filename);
+    }
+
+    try {
+        nlohmann::json j;
+        file >> j;
+
+        ShockGrid grid;
+        grid.spot_shocks = read_axis(j, "spot_shocks");
+        grid.vol_shocks = read_axis(j, "vol_shocks");
+        grid.rate_shocks = read_axis(j, "rate_shocks");
+        return grid;
+    } catch (const nlohmann::json::exception& e) {
+        throw ConfigError("Invalid shock grid: " + std::string(e.what()));
+    }
+}
+
+std::vector<MarketScenario> ShockGrid::expand(const MarketScenario& base) const {
+    const std::vector<double> zero{0.0};
+    const auto& spots = spot_shocks.empty() ? zero : spot_shocks;
+    const auto& vols = vol_shocks.empty() ? zero : vol_shocks;
+    const auto& rates = rate_shocks.empty() ? zero : rate_shocks;
+
+    std::vector<MarketScenario> scenarios;
+    scenarios.reserve(spots.size() * vols.size() * rates.size());
+    for (double ds : spots) {
+        for (double dv : vols) {
+            for (double dr : rates) {
+                scenarios.push_back({base.S * (1.0 + ds), base.sigma + dv, base.r + dr});
+            }
+        }
+    }
+    return scenarios;
+}
+
+ScenarioEngine::ScenarioEngine(const BlackScholesModel& base_model, std::uint64_t num_simulations)
+    : base_model_(base_model),
+      num_simulations_(num_simulations) {
+}
+
+ScenarioResult ScenarioEngine::run(const std::vector<MarketScenario>& scenarios,
+                                   const std::vector<const Payoff*>& book,
+                                   double T,
+                                   PricingWorkspace& workspace) const {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    MemoryScope memory_scope(MemorySubsystem::Pricer);
+
+    if (scenarios.empty() || book.empty()) {
+        throw ValidationError("Scenario sweep requires at least one scenario and one instrument");
+    }
+
+    const std::size_t num_scenarios = scenarios.size();
+    const std::size_t num_instruments = book.size();
+    const std::size_t cells = num_scenarios * num_instruments;
+
+    const ScenarioTerms base = make_terms({base_model_.get_initial_price(),
+                                           base_model_.get_volatility(),
+                                           base_model_.get_risk_free_rate()}, T);
+    std::vector<ScenarioTerms> terms;
+    terms.reserve(num_scenarios);
+    for (const auto& scenario : scenarios) {
+        terms.push_back(make_terms(scenario, T));
+    }
+
+    // Each worker sums its current chunk into its own set of cells and then folds
+    // it into the totals in chunk order: memory is O(workers x cells), and the
+    // totals do not depend on which worker ran which chunk
+    const auto plan = PricingWorkspace::ChunkPlan::for_paths(num_simulations_);
+    std::vector<PathAccumulator> price_totals(cells);
+    std::vector<PathAccumulator> pnl_totals(cells);
+    std::vector<PathAccumulator> worker_sums(std::size_t{2} * workspace.num_workers() * cells);
+
+    std::mutex fold_mutex;
+    std::condition_variable fold_cv;
+    std::uint64_t next_fold = 0;
+    bool failed = false;
+
+    auto job = [&](PricingWorkspace::WorkerState& state, std::uint64_t chunk,
+                   std::uint64_t start_idx, std::uint64_t end_idx) {
+        double* z = state.buffer<double>();
+        const unsigned int block_size = static_cast<unsigned int>(PricingWorkspace::kBlockSize);
+        const NormalGenerator generator;
+
+        const std::size_t worker = static_cast<std::size_t>(&state - &workspace.worker(0));
+        PathAccumulator* prices = &worker_sums[2 * worker * cells];
+        PathAccumulator* pnls = prices + cells;
+        std::fill(prices, prices + 2 * cells, PathAccumulator{});
+        double* base_values = state.scratch_buffer(PricingWorkspace::kBlockSize * num_instruments);
+
+        try {
+            for (std::uint64_t i = start_idx; i < end_idx; i += block_size) {
+                unsigned int n = static_cast<unsigned int>(std::min<std::uint64_t>(block_size, end_idx - i));
+
+                // Draw the block once; every scenario below reuses it from cache
+                generator.fill(state.rng, z, n);
+
+                for (unsigned int j = 0; j < n; ++j) {
+                    double S_T = base.S0 * std::exp(base.drift + base.diffusion * z[j]);
+                    for (std::size_t p = 0; p < num_instruments; ++p) {
+                        base_values[j * num_instruments + p] = base.discount * book[p]->calculate(S_T);
+                    }
+                }
+
+                for (std::size_t s = 0; s < num_scenarios; ++s) {
+                    const ScenarioTerms& t = terms[s];
+                    PathAccumulator* row_prices = prices + s * num_instruments;
+                    PathAccumulator* row_pnls = pnls + s * num_instruments;
+
+                    for (unsigned int j = 0; j < n; ++j) {
+                        double S_T = t.S0 * std::exp(t.drift + t.diffusion * z[j]);
+                        for (std::size_t p = 0; p < num_instruments; ++p) {
+                            double value = t.discount * book[p]->calculate(S_T);
+                            row_prices[p].add(value);
+                            row_pnls[p].add(value - base_values[j * num_instruments + p]);
+                        }
+                    }
+                }
+            }
+        } catch (...) {
+            // Release workers waiting for this chunk's turn to fold
+            {
+                std::lock_guard<std::mutex> lock(fold_mutex);
+                failed = true;
+            }
+            fold_cv.notify_all();
+            throw;
+        }
+
+        // Chunks are claimed in order, so the chunks before this one are all running or done
+        std::unique_lock<std::mutex> lock(fold_mutex);
+        fold_cv.wait(lock, [&] { return next_fold == chunk || failed; });
+        if (failed) {
+            return;
+        }
+        for (std::size_t c = 0; c < cells; ++c) {
+            price_totals[c].merge(prices[c]);
+            pnl_totals[c].merge(pnls[c]);
+        }
+        ++next_fold;
+        lock.unlock();
+        fold_cv.notify_all();
+    };
+    workspace.run_chunks(plan, job);
+
+    ScenarioResult result;
+    result.scenarios = scenarios;
+    result.num_instruments = num_instruments;
+    result.prices.resize(cells);
+    result.standard_errors.resize(cells);
+    result.pnl.resize(cells);
+    result.pnl_standard_errors.resize(cells);
+
+    for (std::size_t c = 0; c < cells; ++c) {
+        result.prices[c] = price_totals[c].mean();
+        result.standard_errors[c] = price_totals[c].standard_error();
+        result.pnl[c] = pnl_totals[c].mean();
+        result.pnl_standard_errors[c] = pnl_totals[c].standard_error();
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    result.computation_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    return result;
+}
+
+} // namespace montecarlo
@@ -0,0 +1,159 @@
+#include "SpotRepricer.h"
+#include "Exceptions.h"
+#include "MemoryStats.h"
+#include "PathAccumulator.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace montecarlo {
+
+SpotRepricer::SpotRepricer(std::uint64_t num_simulations, unsigned int num_threads)
+    : num_simulations_(num_simulations),
+      num_threads_(num_threads) {
+    if (num_simulations == 0) {
+        throw ValidationError("Spot repricer needs at least one path");
+    }
+}
+
+void SpotRepricer::set_normal_method(NormalMethod method) {
+    if (method != normal_generator_.method()) {
+        normal_generator_ = NormalGenerator(method);
+        invalidate();
+    }
+}
+
+bool SpotRepricer::is_cached(double r, double sigma, double T) const {
+    return valid_ && r == rate_ && sigma == volatility_ && T == maturity_;
+}
+
+PricingResult SpotRepricer::price_option(const IPricingModel& model, const Payoff& payoff, double T) {
+    PricingWorkspace workspace(num_threads_);
+    return price_option(model, payoff, T, workspace);
+}
+
+PricingResult SpotRepricer::price_option(const IPricingModel& model, const Payoff& payoff, double T,
+                                         PricingWorkspace& workspace) {
+    MemoryScope memory_scope(MemorySubsystem::Pricer);
+
+    auto gbm = model.terminal_gbm_terms(T);
+    if (!gbm) {
+        throw ValidationError("Spot repricing requires a geometric Brownian motion model");
+    }
+    if (!is_cached(gbm->risk_free_rate, gbm->volatility, T)) {
+        build(gbm->risk_free_rate, gbm->volatility, T, model.discount_factor(T), workspace);
+    }
+    return reprice(gbm->initial_price, payoff);
+}
+
+void SpotRepricer::build(double r, double sigma, double T, double discount, PricingWorkspace& workspace) {
+    if (T <= 0.0) {
+        throw ValidationError("Time to maturity must be positive");
+    }
+    if (sigma < 0.0) {
+        throw ValidationError("Volatility cannot be negative");
+    }
+    valid_ = false;
+
+    const double drift = (r - 0.5 * sigma * sigma) * T;
+    const double diffusion = sigma * std::sqrt(T);
+
+    // Blocks are drawn exactly as the pricing kernels draw them, straight into the cache
+    growth_.resize(num_simulations_);
+    const auto plan = PricingWorkspace::ChunkPlan::for_paths(num_simulations_);
+    auto job = [&](PricingWorkspace::WorkerState& state, std::uint64_t,
+                   std::uint64_t start_idx, std::uint64_t end_idx) {
+        for (std::uint64_t i = start_idx; i < end_idx; i += PricingWorkspace::kBlockSize) {
+            std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(PricingWorkspace::kBlockSize, end_idx - i));
+            double* block = growth_.data() + i;
+            normal_generator_.fill(state.rng, block, n);
+            for (std::size_t j = 0; j < n; ++j) {
+                block[j] = std::exp(drift + diffusion * block[j]);
+            }
+        }
+    };
+    workspace.run_chunks(plan, job);
+
+    std::sort(growth_.begin(), growth_.end());
+
+    // Compensated running sums keep the differences of prefix sums accurate
+    // for strikes deep in either tail
+    prefix_.resize(num_simulations_ + 1);
+    prefix_squared_.resize(num_simulations_ + 1);
+    CompensatedSum sum;
+    CompensatedSum sum_squared;
+    prefix_[0] = 0.0;
+    prefix_squared_[0] = 0.0;
+    for (std::size_t i = 0; i < growth_.size(); ++i) {
+        sum.add(growth_[i]);
+        sum_squared.add(growth_[i] * growth_[i]);
+        prefix_[i + 1] = sum.value();
+        prefix_squared_[i + 1] = sum_squared.value();
+    }
+
+    rate_ = r;
+    volatility_ = sigma;
+    maturity_ = T;
+    discount_ = discount;
+    valid_ = true;
+    ++cache_builds_;
+}
+
+PricingResult SpotRepricer::reprice(double spot, const Payoff& payoff) const {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    MemoryScope memory_scope(MemorySubsystem::Pricer);
+
+    if (!valid_) {
+        throw ValidationError("Spot repricer has no cached samples");
+    }
+    if (spot <= 0.0) {
+        throw ValidationError("Spot price must be positive");
+    }
+
+    const std::size_t n = growth_.size();
+    double sum = 0.0;
+    double sum_squared = 0.0;
+
+    if (auto vanilla = payoff.vanilla_terms()) {
+        // The payoff is S G - K above the threshold K / S (calls) or K - S G below it (puts)
+        const double K = vanilla->strike;
+        const double threshold = K / spot;
+        std::size_t m;
+        double g;
+        double g2;
+        if (vanilla->type == OptionType::Call) {
+            std::size_t first = static_cast<std::size_t>(
+                std::upper_bound(growth_.begin(), growth_.end(), threshold) - growth_.begin());
+            m = n - first;
+            g = prefix_[n] - prefix_[first];
+            g2 = prefix_squared_[n] - prefix_squared_[first];
+            sum = spot * g - K * m;
+        } else {
+            m = static_cast<std::size_t>(
+                std::lower_bound(growth_.begin(), growth_.end(), threshold) - growth_.begin());
+            g = prefix_[m];
+            g2 = prefix_squared_[m];
+            sum = K * m - spot * g;
+        }
+        sum_squared = spot * spot * g2 - 2.0 * spot * K * g + K * K * m;
+    } else {
+        PathAccumulator total;
+        for (double growth : growth_) {
+            total.add(payoff.calculate(spot * growth));
+        }
+        sum = total.sum.value();
+        sum_squared = total.sum_squared.value();
+    }
+
+    double mean = sum / n;
+    double variance = sum_squared / n - mean * mean;
+    double price = discount_ * mean;
+    double standard_error = discount_ * std::sqrt((variance > 0.0 ? variance : 0.0) / n);
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto computation_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+
+    return {price, standard_error, computation_time};
+}
+
+} // namespace montecarlo
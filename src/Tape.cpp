@@ -0,0 +1,64 @@
+#include "Tape.h"
+#include "Exceptions.h"
+#include <algorithm>
+
+namespace montecarlo {
+
+Tape::Tape(std::size_t num_inputs)
+    : num_inputs_(0) {
+    set_num_inputs(num_inputs);
+}
+
+void Tape::set_num_inputs(std::size_t num_inputs) {
+    if (num_inputs >= kConstant) {
+        throw ValidationError("Too many tape inputs");
+    }
+    num_inputs_ = num_inputs;
+    nodes_.clear();
+    adjoints_.assign(num_inputs_, 0.0);
+}
+
+void Tape::reserve(std::size_t num_nodes) {
+    nodes_.reserve(num_nodes);
+    adjoints_.reserve(num_inputs_ + num_nodes);
+}
+
+void Tape::add_adjoint(Index index, double adjoint) {
+    if (index == kConstant) {
+        return;
+    }
+    if (adjoints_.size() < num_inputs_ + nodes_.size()) {
+        adjoints_.resize(num_inputs_ + nodes_.size(), 0.0);
+    }
+    adjoints_[index] += adjoint;
+}
+
+void Tape::propagate() {
+    if (adjoints_.size() < num_inputs_ + nodes_.size()) {
+        adjoints_.resize(num_inputs_ + nodes_.size(), 0.0);
+    }
+    double* adjoints = adjoints_.data();
+    for (std::size_t i = nodes_.size(); i-- > 0;) {
+        const double adjoint = adjoints[num_inputs_ + i];
+        if (adjoint == 0.0) {
+            continue;
+        }
+        const Node& node = nodes_[i];
+        adjoints[node.operand[0]] += adjoint * node.partial[0];
+        if (node.operand[1] != kConstant) {
+            adjoints[node.operand[1]] += adjoint * node.partial[1];
+        }
+    }
+}
+
+void Tape::reset() {
+    // Shrinking keeps the capacity, and regrowing zero-fills the node adjoints
+    nodes_.clear();
+    adjoints_.resize(num_inputs_);
+}
+
+void Tape::clear_input_adjoints() {
+    std::fill(adjoints_.begin(), adjoints_.begin() + static_cast<std::ptrdiff_t>(num_inputs_), 0.0);
+}
+
+} // namespace montecarlo
@@ -0,0 +1,109 @@
+#include "TermStructure.h"
+#include "Exceptions.h"
+#include <algorithm>
+
+namespace montecarlo {
+
+TermStructure::TermStructure(std::vector<double> times,
+                             std::vector<double> values,
+                             Interpolation interpolation)
+    : times_(std::move(times)),
+      values_(std::move(values)),
+      interpolation_(interpolation) {
+    if (times_.empty()) {
+        throw ValidationError("Term structure requires at least one node");
+    }
+    if (times_.size() != values_.size()) {
+        throw ValidationError("Term structure needs one value per node time");
+    }
+    if (times_.front() < 0.0) {
+        throw ValidationError("Term structure node times cannot be negative");
+    }
+    for (std::size_t i = 1; i < times_.size(); ++i) {
+        if (times_[i] <= times_[i - 1]) {
+            throw ValidationError("Term structure node times must be increasing");
+        }
+    }
+    for (double value : values_) {
+        flat_ = flat_ && value == values_.front();
+    }
+
+    // Tabulate the integrals to every node once; lookups only add one partial segment
+    cumulative_.resize(times_.size());
+    cumulative_square_.resize(times_.size());
+    for (std::size_t i = 0; i < times_.size(); ++i) {
+        double previous = i == 0 ? 0.0 : cumulative_[i - 1];
+        double previous_square = i == 0 ? 0.0 : cumulative_square_[i - 1];
+        cumulative_[i] = previous + partial(i, times_[i], false);
+        cumulative_square_[i] = previous_square + partial(i, times_[i], true);
+    }
+}
+
+TermStructure TermStructure::flat(double value) {
+    return TermStructure({0.0}, {value});
+}
+
+Interpolation TermStructure::parse_interpolation(const std::string& interpolation_str) {
+    if (interpolation_str == "constant") return Interpolation::PiecewiseConstant;
+    if (interpolation_str == "linear") return Interpolation::PiecewiseLinear;
+    throw ConfigError("Invalid interpolation: " + interpolation_str);
+}
+
+double TermStructure::value(double t) const {
+    // Segment i covers (times_[i - 1], times_[i]]; segment 0 and the last extrapolate flat
+    std::size_t segment = static_cast<std::size_t>(
+        std::lower_bound(times_.begin(), times_.end(), t) - times_.begin());
+    if (segment == 0) {
+        return values_.front();
+    }
+    if (segment == times_.size()) {
+        return values_.back();
+    }
+    if (interpolation_ == Interpolation::PiecewiseConstant) {
+        return values_[segment];
+    }
+    double weight = (t - times_[segment - 1]) / (times_[segment] - times_[segment - 1]);
+    return values_[segment - 1] + weight * (values_[segment] - values_[segment - 1]);
+}
+
+double TermStructure::partial(std::size_t segment, double t, bool squared) const {
+    if (segment == 0 || segment == times_.size()) {
+        // Flat extrapolation before the first node and after the last
+        double start = segment == 0 ? 0.0 : times_.back();
+        double v = segment == 0 ? values_.front() : values_.back();
+        return (t - start) * (squared ? v * v : v);
+    }
+    double start = times_[segment - 1];
+    if (interpolation_ == Interpolation::PiecewiseConstant) {
+        double v = values_[segment];
+        return (t - start) * (squared ? v * v : v);
+    }
+    // Trapezoid for f, and the exact integral of a linear function squared
+    double a = values_[segment - 1];
+    double b = value(t);
+    return squared ? (t - start) * (a * a + a * b + b * b) / 3.0
+                   : (t - start) * (a + b) / 2.0;
+}
+
+double TermStructure::integrate(double t, bool squared) const {
+    if (t <= 0.0) {
+        return 0.0;
+    }
+    std::size_t segment = static_cast<std::size_t>(
+        std::lower_bound(times_.begin(), times_.end(), t) - times_.begin());
+    double base = 0.0;
+    if (segment > 0) {
+        base = squared ? cumulative_square_[segment - 1] : cumulative_[segment - 1];
+    }
+    return base + partial(segment, t, squared);
+}
+
+double TermStructure::integral(double t) const {
+    return integrate(t, false);
+}
+
+double TermStructure::integral_of_square(double t) const {
+    return integrate(t, true);
+}
+
+} // namespace montecarlo
@@ -0,0 +1,139 @@
+#include "TermStructureModel.h"
+#include "Exceptions.h"
+#include <cmath>
+
+namespace montecarlo {
+
+TermStructureModel::TermStructureModel(double initial_price, TermStructure rates, TermStructure volatilities)
+    : initial_price_(initial_price),
+      rates_(std::move(rates)),
+      volatilities_(std::move(volatilities)) {
+    if (initial_price <= 0.0) {
+        throw ValidationError("Initial price must be positive");
+    }
+    for (double sigma : volatilities_.values()) {
+        if (sigma < 0.0) {
+            throw ValidationError("Volatility cannot be negative");
+        }
+    }
+}
+
+TermStructureModel::Grid TermStructureModel::make_grid(std::size_t num_steps, double T) const {
+    if (num_steps == 0) {
+        throw ValidationError("Time grid requires at least one step");
+    }
+    Grid grid;
+    grid.num_steps = num_steps;
+    grid.T = T;
+    grid.initial_price = initial_price_;
+    grid.dt = T / num_steps;
+    grid.integrated_rate.resize(num_steps + 1);
+    grid.integrated_variance.resize(num_steps + 1);
+    grid.drift.resize(num_steps);
+    grid.diffusion.resize(num_steps);
+    grid.step_variances.resize(num_steps);
+    for (std::size_t n = 0; n <= num_steps; ++n) {
+        double t = n == num_steps ? T : n * grid.dt;
+        grid.integrated_rate[n] = integrated_rate(t);
+        grid.integrated_variance[n] = integrated_variance(t);
+    }
+    for (std::size_t n = 0; n < num_steps; ++n) {
+        double rate = grid.integrated_rate[n + 1] - grid.integrated_rate[n];
+        double variance = grid.integrated_variance[n + 1] - grid.integrated_variance[n];
+        grid.drift[n] = rate - 0.5 * variance;
+        grid.step_variances[n] = variance > 0.0 ? variance : 0.0;
+        grid.diffusion[n] = std::sqrt(grid.step_variances[n]);
+    }
+    return grid;
+}
+
+std::shared_ptr<const IPricingModel::PathGrid> TermStructureModel::make_path_grid(std::size_t num_steps,
+                                                                                  double T) const {
+    return std::make_shared<const Grid>(make_grid(num_steps, T));
+}
+
+void TermStructureModel::simulate_grid_paths(const PathGrid& grid, const double* normals, double* paths,
+                                             std::size_t count) const {
+    simulate_paths(static_cast<const Grid&>(grid), normals, paths, count);
+}
+
+void TermStructureModel::simulate_terminal(const double* normals, double* terminal,
+                                           std::size_t count, double T) const {
+    // Two table lookups per block; the path loop is the flat-model loop
+    double variance = integrated_variance(T);
+    double drift = integrated_rate(T) - 0.5 * variance;
+    double diffusion = std::sqrt(variance);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        terminal[i] = initial_price_ * std::exp(drift + diffusion * normals[i]);
+    }
+}
+
+template <typename StepTerms>
+void TermStructureModel::evolve(const double* normals, double* paths, std::size_t count,
+                                std::size_t num_steps, StepTerms step_terms) const {
+    // Step-major layout: each step reads the previous row of prices
+    for (std::size_t step = 0; step < num_steps; ++step) {
+        double drift;
+        double diffusion;
+        step_terms(step, drift, diffusion);
+        const double* z = normals + step * count;
+        double* current = paths + step * count;
+        if (step == 0) {
+            for (std::size_t i = 0; i < count; ++i) {
+                current[i] = initial_price_ * std::exp(drift + diffusion * z[i]);
+            }
+        } else {
+            const double* previous = current - count;
+            for (std::size_t i = 0; i < count; ++i) {
+                current[i] = previous[i] * std::exp(drift + diffusion * z[i]);
+            }
+        }
+    }
+}
+
+void TermStructureModel::simulate_paths(const double* normals, double* paths,
+                                        std::size_t count, std::size_t num_steps, double T) const {
+    // Per-step terms from the curves' node tables, once per step of the block
+    const double dt = T / num_steps;
+    double rate_start = 0.0;
+    double variance_start = 0.0;
+    evolve(normals, paths, count, num_steps, [&](std::size_t step, double& drift, double& diffusion) {
+        double t = step + 1 == num_steps ? T : (step + 1) * dt;
+        double rate_end = integrated_rate(t);
+        double variance_end = integrated_variance(t);
+        double variance = variance_end - variance_start;
+        drift = rate_end - rate_start - 0.5 * variance;
+        diffusion = std::sqrt(variance > 0.0 ? variance : 0.0);
+        rate_start = rate_end;
+        variance_start = variance_end;
+    });
+}
+
+void TermStructureModel::simulate_paths(const Grid& grid, const double* normals, double* paths,
+                                        std::size_t count) const {
+    evolve(normals, paths, count, grid.num_steps, [&](std::size_t step, double& drift, double& diffusion) {
+        drift = grid.drift[step];
+        diffusion = grid.diffusion[step];
+    });
+}
+
+double TermStructureModel::discount_factor(double T) const {
+    return std::exp(-integrated_rate(T));
+}
+
+std::optional<GbmTerms> TermStructureModel::gbm_terms() const {
+    if (!rates_.is_flat() || !volatilities_.is_flat()) {
+        return std::nullopt;
+    }
+    return GbmTerms{initial_price_, rates_.values().front(), volatilities_.values().front()};
+}
+
+std::optional<GbmTerms> TermStructureModel::terminal_gbm_terms(double T) const {
+    if (T <= 0.0) {
+        return GbmTerms{initial_price_, rates_.value(0.0), volatilities_.value(0.0)};
+    }
+    return GbmTerms{initial_price_, integrated_rate(T) / T, std::sqrt(integrated_variance(T) / T)};
+}
+
+} // namespace montecarlo
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <string>
 #include <memory>
+#include <chrono>
 #include "Config.h"
 #include "BlackScholesModel.h"
 #include "OptionPricer.h"
@@ -9,6 +10,18 @@
 #include "CallPayoff.h"
 #include "PutPayoff.h"
 #include "ResultExporter.h"
+#include "ScenarioEngine.h"
+#include "MultiAssetPricer.h"
+#include "BasketPayoff.h"
+#include "RainbowPayoff.h"
+#include "MertonJumpPricer.h"
+#include "LocalVolPricer.h"
+#include "BarrierPricer.h"
+#include "SpotRepricer.h"
+#include "MachineProfile.h"
+#include "MemoryStats.h"
+#include "TermStructureModel.h"
+#include <optional>
 
 int main(int argc, char* argv[]) {
     try {
@@ -24,7 +37,7 @@ int main(int argc, char* argv[]) {
             ->check(CLI::ExistingFile);
 
         // Simulation parameters
-        unsigned int num_simulations = 0;
+        std::uint64_t num_simulations = 0;
         unsigned int num_threads = 0;
         app.add_option("--simulations,-n", num_simulations, 
             "Number of Monte Carlo simulations (overrides config)")
@@ -32,6 +45,28 @@ int main(int argc, char* argv[]) {
         app.add_option("--threads,-t", num_threads, 
             "Number of threads for parallel computation (overrides config)")
             ->check(CLI::PositiveNumber);
+        std::string path_precision_str;
+        app.add_option("--path-precision", path_precision_str, 
+            "Precision for path generation (double/float) (overrides config)")
+            ->check(CLI::IsMember({"double", "float"}));
+        double drift_shift = 0.0;
+        app.add_option("--drift-shift", drift_shift, 
+            "Importance-sampling shift of the normal draws (overrides config)");
+        std::string sampling_str;
+        app.add_option("--sampling", sampling_str, 
+            "Sampling method (mc/stratified/lhs) (overrides config)")
+            ->check(CLI::IsMember({"mc", "stratified", "lhs"}));
+        unsigned int num_strata = 0;
+        app.add_option("--strata", num_strata, 
+            "Number of strata for stratified sampling (overrides config)")
+            ->check(CLI::PositiveNumber);
+        std::string normal_method_str;
+        app.add_option("--normal-generator", normal_method_str, 
+            "Normal variate generator (ziggurat/inverse_cdf) (overrides config)")
+            ->check(CLI::IsMember({"ziggurat", "inverse_cdf"}));
+        bool auto_drift_shift = false;
+        app.add_flag("--auto-drift-shift", auto_drift_shift, 
+            "Choose the importance-sampling shift from a pilot run");
 
         // Option parameters
         std::string option_type_str;
@@ -55,6 +90,24 @@ int main(int argc, char* argv[]) {
             "Time to maturity in years (overrides config)")
             ->check(CLI::PositiveNumber);
 
+        // Barrier parameters
+        double barrier_level = 0.0;
+        double barrier_rebate = -1.0;
+        std::string barrier_type_str;
+        std::string barrier_monitoring_str;
+        app.add_option("--barrier", barrier_level, 
+            "Barrier level; prices a barrier option instead of the vanilla (overrides config)")
+            ->check(CLI::PositiveNumber);
+        app.add_option("--barrier-type", barrier_type_str, 
+            "Barrier type (up_and_out/up_and_in/down_and_out/down_and_in) (overrides config)")
+            ->check(CLI::IsMember({"up_and_out", "up_and_in", "down_and_out", "down_and_in"}));
+        app.add_option("--rebate", barrier_rebate, 
+            "Rebate paid at expiry when the barrier option is inactive (overrides config)")
+            ->check(CLI::NonNegativeNumber);
+        app.add_option("--barrier-monitoring", barrier_monitoring_str, 
+            "Barrier monitoring (continuous/discrete) (overrides config)")
+            ->check(CLI::IsMember({"continuous", "discrete"}));
+
         // Output parameters
         int precision = -1;
         bool show_timing = true;
@@ -71,6 +124,54 @@ int main(int argc, char* argv[]) {
             "Output format (text/csv/json)")
             ->check(CLI::IsMember({"text", "csv", "json"}));
 
+        // Time budget
+        double deadline_ms = 0.0;
+        double max_standard_error = 0.0;
+        app.add_option("--deadline-ms", deadline_ms, 
+            "Stop simulating after this many milliseconds and return the estimate so far")
+            ->check(CLI::NonNegativeNumber);
+        app.add_option("--max-standard-error", max_standard_error, 
+            "With --deadline-ms, fail instead of returning a standard error above this")
+            ->check(CLI::NonNegativeNumber);
+
+        // Payoff distribution
+        bool report_distribution = false;
+        double var_confidence = 0.0;
+        app.add_flag("--distribution", report_distribution, 
+            "Report payoff quantiles, VaR, expected shortfall and a histogram");
+        app.add_option("--var-confidence", var_confidence, 
+            "Confidence level of the VaR and expected shortfall (overrides config)")
+            ->check(CLI::Range(0.0, 1.0));
+
+        // Memory instrumentation
+        bool report_memory = false;
+        app.add_flag("--memory-stats", report_memory, 
+            "Report peak RSS and, in builds counting allocations, heap use per subsystem");
+
+        // Convergence trace
+        std::string trace_file;
+        app.add_option("--convergence-trace", trace_file, 
+            "Write the running estimate at doubling path counts to this file (csv, or json with --format json)");
+
+        // Scenario sweep
+        std::string scenario_file;
+        app.add_option("--scenarios", scenario_file, 
+            "Shock grid JSON file; revalues the option under every scenario")
+            ->check(CLI::ExistingFile);
+
+        // Live repricing
+        bool live = false;
+        app.add_flag("--live", live, 
+            "Read spot prices from stdin, one per line, and reprice each from cached paths");
+
+        // Machine tuning
+        bool tune = false;
+        std::string profile_file = montecarlo::MachineProfile::default_path();
+        app.add_flag("--tune", tune, 
+            "Benchmark this machine and save the fastest settings to the machine profile");
+        app.add_option("--profile", profile_file, 
+            "Machine profile file written by --tune and loaded on startup");
+
         // Additional options
         bool validate_config = false;
         app.add_flag("--validate-config", validate_config, 
@@ -82,6 +183,25 @@ int main(int argc, char* argv[]) {
         // Parse command line
         CLI11_PARSE(app, argc, argv);
 
+        // Tuning needs no configuration
+        if (tune) {
+            montecarlo::Logger::info("Tuning for " + montecarlo::MachineProfile::current_cpu_model() + " with " +
+                std::to_string(montecarlo::MachineProfile::available_cpus()) + " usable CPUs...");
+            auto profile = montecarlo::tune_machine(montecarlo::TuneOptions(),
+                [](const montecarlo::TuneMeasurement& m) {
+                    montecarlo::Logger::info(m.stage + " " + m.setting + ": " +
+                        std::to_string(static_cast<std::uint64_t>(m.paths_per_second)) + " paths/s");
+                });
+            profile.save(profile_file);
+            montecarlo::Logger::info("Tuned: threads=" + std::to_string(profile.num_threads) +
+                " chunk_size=" + std::to_string(profile.chunk_size) +
+                " normal_generator=" + montecarlo::to_string(profile.normal_method) +
+                " serial_threshold=" + std::to_string(profile.serial_threshold));
+            montecarlo::Logger::info("Machine profile saved to " + profile_file);
+            montecarlo::Logger::shutdown();
+            return 0;
+        }
+
         // Load configuration
         montecarlo::Logger::info("Loading configuration from " + config_file);
         auto config = montecarlo::Config::load(config_file);
@@ -89,17 +209,69 @@ int main(int argc, char* argv[]) {
 
         // Override config values if provided via command line
         if (num_simulations > 0) config.num_simulations = num_simulations;
-        if (num_threads > 0) config.num_threads = num_threads;
+        if (num_threads > 0) {
+            config.num_threads = num_threads;
+            config.auto_threads = false;
+        }
+        if (!path_precision_str.empty()) {
+            config.path_precision = montecarlo::Config::parse_path_precision(path_precision_str);
+        }
         if (!option_type_str.empty()) {
             config.option_type = montecarlo::Config::parse_option_type(option_type_str);
         }
+        if (drift_shift != 0.0) {
+            config.drift_shift = drift_shift;
+            config.auto_drift_shift = false;
+        }
+        if (auto_drift_shift) config.auto_drift_shift = true;
+        if (!sampling_str.empty()) {
+            config.sampling = montecarlo::Config::parse_sampling_method(sampling_str);
+        }
+        if (num_strata > 0) config.num_strata = num_strata;
+        if (!normal_method_str.empty()) {
+            config.normal_method = montecarlo::Config::parse_normal_method(normal_method_str);
+            config.auto_normal_method = false;
+        }
         if (S > 0.0) config.S = S;
         if (K > 0.0) config.K = K;
-        if (r > 0.0) config.r = r;
-        if (sigma > 0.0) config.sigma = sigma;
+        if (r > 0.0) {
+            config.r = r;
+            config.rate_curve.reset();
+        }
+        if (sigma > 0.0) {
+            config.sigma = sigma;
+            config.vol_curve.reset();
+        }
         if (T > 0.0) config.T = T;
+        config.update_curve_averages();
+        if (barrier_level > 0.0) config.barrier_level = barrier_level;
+        if (!barrier_type_str.empty()) {
+            config.barrier_type = montecarlo::Config::parse_barrier_type(barrier_type_str);
+        }
+        if (barrier_rebate >= 0.0) config.barrier_rebate = barrier_rebate;
+        if (!barrier_monitoring_str.empty()) {
+            config.barrier_monitoring = montecarlo::Config::parse_barrier_monitoring(barrier_monitoring_str);
+        }
         if (precision >= 0) config.precision = precision;
         config.show_timing = show_timing;
+        if (report_distribution) config.report_distribution = true;
+        if (report_memory) config.report_memory = true;
+        if (deadline_ms > 0.0) config.deadline_ms = deadline_ms;
+        if (max_standard_error > 0.0) config.max_standard_error = max_standard_error;
+        if (var_confidence > 0.0) config.var_confidence = var_confidence;
+
+        // Settings left to the machine come from its tuned profile, if any
+        std::optional<montecarlo::MachineProfile> profile;
+        try {
+            profile = montecarlo::MachineProfile::find(profile_file);
+        } catch (const montecarlo::ConfigError& e) {
+            montecarlo::Logger::error("Ignoring machine profile: " + std::string(e.what()));
+        }
+        if (profile) {
+            montecarlo::Logger::info("Using machine profile from " + profile_file);
+            if (config.auto_threads) config.num_threads = profile->num_threads;
+            if (config.auto_normal_method) config.normal_method = profile->normal_method;
+        }
 
         // Validate config if requested
         if (validate_config) {
@@ -122,15 +294,50 @@ int main(int argc, char* argv[]) {
             config.r,
             config.sigma
         );
+        // Rate and volatility curves drive their own model; engines that only
+        // take flat parameters see the curves' averages over [0, T]
+        std::unique_ptr<montecarlo::TermStructureModel> term_model;
+        if (config.rate_curve || config.vol_curve) {
+            montecarlo::Logger::info("Using rate and volatility term structures");
+            term_model = std::make_unique<montecarlo::TermStructureModel>(
+                config.S,
+                config.rate_curve ? *config.rate_curve : montecarlo::TermStructure::flat(config.r),
+                config.vol_curve ? *config.vol_curve : montecarlo::TermStructure::flat(config.sigma)
+            );
+        }
+        const IPricingModel& pricing_model = term_model ? static_cast<const IPricingModel&>(*term_model) : *model;
         montecarlo::Logger::info("Model created successfully");
 
         // Create pricer
         montecarlo::Logger::info("Creating option pricer...");
         montecarlo::OptionPricer pricer(
-            *model,
+            pricing_model,
             config.num_simulations,
-            config.num_threads
+            config.num_threads,
+            config.path_precision
         );
+        pricer.set_normal_method(config.normal_method);
+        if (profile) {
+            pricer.set_chunk_size(profile->chunk_size);
+            pricer.set_serial_threshold(profile->serial_threshold);
+        }
+        if (config.report_distribution) {
+            pricer.enable_payoff_distribution(config.var_confidence, config.histogram_bins);
+        }
+        if (config.auto_drift_shift) {
+            pricer.enable_automatic_drift_shift();
+        } else if (config.drift_shift != 0.0) {
+            pricer.set_drift_shift(config.drift_shift);
+        }
+        if (config.deadline_ms > 0.0) {
+            pricer.set_deadline(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::duration<double, std::milli>(config.deadline_ms)),
+                                config.max_standard_error);
+        }
+        if (config.sampling != montecarlo::SamplingMethod::MonteCarlo) {
+            // A single-step path has one dimension, where LHS is stratification
+            pricer.set_stratification(config.num_strata);
+        }
         montecarlo::Logger::info("Pricer created successfully");
 
         // Create appropriate payoff strategy
@@ -141,9 +348,185 @@ int main(int argc, char* argv[]) {
             payoff = std::make_unique<montecarlo::PutPayoff>(config.K);
         }
 
+        // Scenario sweep replaces the single pricing run
+        if (!scenario_file.empty()) {
+            montecarlo::Logger::info("Loading shock grid from " + scenario_file);
+            auto grid = montecarlo::ShockGrid::load(scenario_file);
+            auto scenarios = grid.expand({config.S, config.sigma, config.r});
+
+            montecarlo::Logger::info("Revaluing under " + std::to_string(scenarios.size()) + " scenarios...");
+            montecarlo::PricingWorkspace workspace(config.num_threads);
+            montecarlo::ScenarioEngine engine(*model, config.num_simulations);
+            auto sweep = engine.run(scenarios, {payoff.get()}, config.T, workspace);
+
+            if (!output_file.empty()) {
+                montecarlo::Logger::info("Exporting scenario results to " + output_file);
+                if (output_format == "json") {
+                    montecarlo::ResultExporter::export_scenarios_to_json(output_file, sweep, config);
+                } else {
+                    montecarlo::ResultExporter::export_scenarios_to_csv(output_file, sweep, config);
+                }
+                montecarlo::Logger::info("Results exported successfully");
+            } else {
+                for (std::size_t s = 0; s < sweep.scenarios.size(); ++s) {
+                    const auto& scenario = sweep.scenarios[s];
+                    montecarlo::Logger::info("S=" + std::to_string(scenario.S) +
+                        " sigma=" + std::to_string(scenario.sigma) +
+                        " r=" + std::to_string(scenario.r) +
+                        " price=" + std::to_string(sweep.prices[s]) +
+                        " pnl=" + std::to_string(sweep.pnl[s]));
+                }
+            }
+            if (config.show_timing) {
+                montecarlo::Logger::info("Computation Time: " + 
+                    std::to_string(sweep.computation_time.count()) + " ms");
+            }
+
+            montecarlo::Logger::shutdown();
+            return 0;
+        }
+
+        // Live repricing answers every spot tick from one cached simulation
+        if (live) {
+            montecarlo::Logger::info("Caching " + std::to_string(config.num_simulations) + " paths for live repricing...");
+            montecarlo::SpotRepricer repricer(config.num_simulations, config.num_threads);
+            repricer.set_normal_method(config.normal_method);
+            auto base = repricer.price_option(pricing_model, *payoff, config.T);
+            montecarlo::Logger::info("S=" + std::to_string(config.S) +
+                " price=" + std::to_string(base.price) +
+                " se=" + std::to_string(base.standard_error));
+
+            double spot = 0.0;
+            while (std::cin >> spot) {
+                auto tick = std::chrono::high_resolution_clock::now();
+                auto repriced = repricer.reprice(spot, *payoff);
+                auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::high_resolution_clock::now() - tick);
+                std::string line = "S=" + std::to_string(spot) +
+                    " price=" + std::to_string(repriced.price) +
+                    " se=" + std::to_string(repriced.standard_error);
+                if (config.show_timing) {
+                    line += " time=" + std::to_string(elapsed.count()) + "us";
+                }
+                montecarlo::Logger::info(line);
+            }
+
+            montecarlo::Logger::shutdown();
+            return 0;
+        }
+
         // Price the option
         montecarlo::Logger::info("Calculating option price...");
-        auto result = pricer.price_option(*payoff, config.T);
+        montecarlo::PricingResult result;
+        if (!config.asset_spots.empty()) {
+            montecarlo::Logger::info("Pricing " + config.basket_payoff + " option on " +
+                std::to_string(config.asset_spots.size()) + " assets...");
+            montecarlo::MultiAssetModel basket_model(
+                config.asset_spots,
+                config.asset_volatilities,
+                config.correlation,
+                config.r
+            );
+
+            std::unique_ptr<montecarlo::MultiAssetPayoff> basket_payoff;
+            if (config.basket_payoff == "best_of") {
+                basket_payoff = std::make_unique<montecarlo::RainbowPayoff>(
+                    montecarlo::RainbowType::BestOf, config.K, config.option_type);
+            } else if (config.basket_payoff == "worst_of") {
+                basket_payoff = std::make_unique<montecarlo::RainbowPayoff>(
+                    montecarlo::RainbowType::WorstOf, config.K, config.option_type);
+            } else {
+                basket_payoff = std::make_unique<montecarlo::BasketPayoff>(
+                    config.basket_weights, config.K, config.option_type);
+            }
+
+            montecarlo::MultiAssetPricer basket_pricer(
+                basket_model,
+                config.num_simulations,
+                config.num_threads
+            );
+            result = basket_pricer.price_option(*basket_payoff, config.T);
+        } else if (config.jump_intensity > 0.0) {
+            montecarlo::Logger::info("Pricing under Merton jump-diffusion...");
+            montecarlo::MertonJumpModel jump_model(
+                config.S,
+                config.r,
+                config.sigma,
+                config.jump_intensity,
+                config.jump_mean,
+                config.jump_volatility
+            );
+            montecarlo::MertonJumpPricer jump_pricer(
+                jump_model,
+                config.num_simulations,
+                config.num_threads
+            );
+            result = jump_pricer.price_option(*payoff, config.T);
+        } else if (config.barrier_level > 0.0) {
+            montecarlo::Logger::info(std::string("Pricing ") + montecarlo::to_string(config.barrier_type) +
+                " barrier option with " + std::to_string(config.num_steps) + " " +
+                montecarlo::to_string(config.barrier_monitoring) + " monitoring steps...");
+            montecarlo::BarrierPayoff barrier_payoff(
+                config.barrier_type,
+                config.barrier_level,
+                config.K,
+                config.option_type,
+                config.barrier_rebate
+            );
+            montecarlo::BarrierPricer barrier_pricer(
+                pricing_model,
+                config.num_simulations,
+                config.num_threads,
+                config.num_steps
+            );
+            barrier_pricer.set_monitoring(config.barrier_monitoring);
+            result = barrier_pricer.price_option(barrier_payoff, config.T);
+        } else if (!config.local_vols.empty()) {
+            montecarlo::Logger::info("Pricing under local volatility with " +
+                std::to_string(config.num_steps) + " steps...");
+            montecarlo::LocalVolModel local_vol_model(
+                config.S,
+                config.r,
+                config.local_vol_times,
+                config.local_vol_spots,
+                config.local_vols
+            );
+            montecarlo::LocalVolPricer local_vol_pricer(
+                local_vol_model,
+                config.num_simulations,
+                config.num_threads,
+                config.num_steps
+            );
+            local_vol_pricer.set_latin_hypercube(
+                config.sampling == montecarlo::SamplingMethod::LatinHypercube);
+            result = local_vol_pricer.price_option(*payoff, config.T);
+        } else {
+            if (!trace_file.empty()) {
+                pricer.enable_convergence_trace(4096, 2.0, [](const montecarlo::ConvergencePoint& point) {
+                    montecarlo::Logger::info("Convergence: paths=" + std::to_string(point.paths) +
+                        " estimate=" + std::to_string(point.estimate) +
+                        " se=" + std::to_string(point.standard_error));
+                });
+            }
+            result = pricer.price_option(*payoff, config.T);
+            if (!trace_file.empty()) {
+                montecarlo::Logger::info("Exporting convergence trace to " + trace_file);
+                if (output_format == "json") {
+                    montecarlo::ResultExporter::export_convergence_to_json(
+                        trace_file, pricer.convergence_trace(), config);
+                } else {
+                    montecarlo::ResultExporter::export_convergence_to_csv(
+                        trace_file, pricer.convergence_trace(), config);
+                }
+            }
+        }
+
+        // Memory is sampled once pricing and any trace export are done. A results
+        // file cannot count its own writing, so files leave out the exporter row;
+        // the console report below includes it.
+        if (config.report_memory) {
+            result.memory = montecarlo::memory_stats();
+        }
 
         // Output results
         if (!output_file.empty()) {
@@ -160,6 +543,34 @@ int main(int argc, char* argv[]) {
             // Print to console
             montecarlo::Logger::info("Option Price: " + std::to_string(result.price));
             montecarlo::Logger::info("Standard Error: " + std::to_string(result.standard_error));
+            if (result.deadline_reached) {
+                montecarlo::Logger::info("Deadline reached after " + std::to_string(result.num_paths) + " paths");
+            }
+            if (result.distribution) {
+                const auto& distribution = *result.distribution;
+                for (std::size_t i = 0; i < distribution.levels.size(); ++i) {
+                    montecarlo::Logger::info("Quantile " + std::to_string(distribution.levels[i]) + ": " +
+                        std::to_string(distribution.quantiles[i]));
+                }
+                montecarlo::Logger::info("VaR (" + std::to_string(distribution.confidence) + "): " +
+                    std::to_string(distribution.value_at_risk));
+                montecarlo::Logger::info("Expected Shortfall: " + std::to_string(distribution.expected_shortfall));
+            }
+            if (result.memory) {
+                const auto& memory = *result.memory;
+                montecarlo::Logger::info("Peak RSS: " + std::to_string(memory.peak_rss_kb) + " KiB");
+                if (memory.counted) {
+                    montecarlo::Logger::info("Heap allocations: " + std::to_string(memory.total.allocations) +
+                        ", peak live heap: " + std::to_string(memory.peak_live_bytes) + " bytes");
+                    for (std::size_t i = 0; i < montecarlo::kNumMemorySubsystems; ++i) {
+                        const auto& counters = memory.subsystems[i];
+                        montecarlo::Logger::info(std::string("  ") +
+                            montecarlo::to_string(static_cast<montecarlo::MemorySubsystem>(i)) + ": " +
+                            std::to_string(counters.allocations) + " allocations, " +
+                            std::to_string(counters.bytes_allocated) + " bytes");
+                    }
+                }
+            }
             if (config.show_timing) {
                 montecarlo::Logger::info("Computation Time: " + 
                     std::to_string(result.computation_time.count()) + " ms");
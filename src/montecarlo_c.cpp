@@ -0,0 +1,196 @@
+#include "montecarlo_c.h"
+#include "BlackScholesModel.h"
+#include "CallPayoff.h"
+#include "Exceptions.h"
+#include "MachineProfile.h"
+#include "OptionPricer.h"
+#include "PricingWorkspace.h"
+#include "PutPayoff.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <new>
+#include <string>
+
+struct mc_pricer {
+    mc_pricer_options options;
+    std::unique_ptr<montecarlo::PricingWorkspace> workspace;
+};
+
+namespace {
+
+// Size of mc_pricer_options in version 1 of the interface. Frozen at the end
+// of its last field: later versions only append fields, and binaries built
+// against version 1 keep passing this size
+constexpr std::size_t kOptionsV1Size = offsetof(mc_pricer_options, reserved) + sizeof(std::uint32_t);
+static_assert(kOptionsV1Size == 40, "The version 1 layout of mc_pricer_options must not change");
+
+thread_local std::string g_last_error;
+
+mc_status fail(mc_status status, const std::string& message) {
+    g_last_error = message;
+    return status;
+}
+
+// Exceptions never cross the C boundary; each maps to a status code
+template <typename Fn>
+mc_status guarded(Fn&& fn) {
+    try {
+        return fn();
+    } catch (const montecarlo::ValidationError& e) {
+        return fail(MC_ERROR_VALIDATION, e.what());
+    } catch (const montecarlo::SimulationError& e) {
+        return fail(MC_ERROR_SIMULATION, e.what());
+    } catch (const std::bad_alloc&) {
+        return fail(MC_ERROR_INTERNAL, "Out of memory");
+    } catch (const std::exception& e) {
+        return fail(MC_ERROR_INTERNAL, e.what());
+    } catch (...) {
+        return fail(MC_ERROR_INTERNAL, "Unknown error");
+    }
+}
+
+bool positive(double value) {
+    return std::isfinite(value) && value > 0.0;
+}
+
+} // namespace
+
+extern "C" {
+
+uint32_t mc_api_version(void) {
+    return MC_API_VERSION;
+}
+
+const char* mc_last_error(void) {
+    return g_last_error.c_str();
+}
+
+void mc_pricer_options_init(mc_pricer_options* options) {
+    if (!options) {
+        return;
+    }
+    *options = mc_pricer_options{};
+    options->struct_size = sizeof(mc_pricer_options);
+    options->num_threads = montecarlo::MachineProfile::available_cpus();
+    options->num_simulations = 100000;
+    options->path_precision = MC_PRECISION_DOUBLE;
+    options->normal_method = MC_NORMAL_ZIGGURAT;
+}
+
+mc_status mc_pricer_create(const mc_pricer_options* options, mc_pricer** out) {
+    if (!out) {
+        return fail(MC_ERROR_INVALID_ARGUMENT, "Output pointer is null");
+    }
+    *out = nullptr;
+
+    mc_pricer_options settings;
+    mc_pricer_options_init(&settings);
+    if (options) {
+        // Fields beyond the caller's struct_size keep their defaults
+        if (options->struct_size < kOptionsV1Size) {
+            return fail(MC_ERROR_INVALID_ARGUMENT, "Options were not initialized with mc_pricer_options_init");
+        }
+        std::memcpy(&settings, options, std::min<std::size_t>(options->struct_size, sizeof(settings)));
+        settings.struct_size = sizeof(settings);
+    }
+
+    if (settings.num_threads == 0) {
+        return fail(MC_ERROR_INVALID_ARGUMENT, "Number of threads must be positive");
+    }
+    if (settings.num_simulations == 0) {
+        return fail(MC_ERROR_INVALID_ARGUMENT, "Number of simulations must be positive");
+    }
+    if (settings.path_precision > MC_PRECISION_SINGLE) {
+        return fail(MC_ERROR_INVALID_ARGUMENT, "Invalid path precision");
+    }
+    if (settings.normal_method > MC_NORMAL_INVERSE_CDF) {
+        return fail(MC_ERROR_INVALID_ARGUMENT, "Invalid normal method");
+    }
+
+    return guarded([&] {
+        auto pricer = std::make_unique<mc_pricer>();
+        pricer->options = settings;
+        pricer->workspace = settings.use_seed
+            ? std::make_unique<montecarlo::PricingWorkspace>(settings.num_threads, settings.seed)
+            : std::make_unique<montecarlo::PricingWorkspace>(settings.num_threads);
+        *out = pricer.release();
+        return MC_OK;
+    });
+}
+
+void mc_pricer_destroy(mc_pricer* pricer) {
+    delete pricer;
+}
+
+mc_status mc_price_batch(mc_pricer* pricer,
+                         size_t count,
+                         const int32_t* option_type,
+                         const double* spot,
+                         const double* strike,
+                         const double* rate,
+                         const double* volatility,
+                         const double* maturity,
+                         double* price_out,
+                         double* standard_error_out) {
+    if (!pricer) {
+        return fail(MC_ERROR_INVALID_ARGUMENT, "Pricer is null");
+    }
+    if (count == 0) {
+        return MC_OK;
+    }
+    if (!option_type || !spot || !strike || !rate || !volatility || !maturity || !price_out) {
+        return fail(MC_ERROR_INVALID_ARGUMENT, "Input or output array is null");
+    }
+
+    // Validate the whole batch first so a bad entry fails before any work is done
+    for (size_t i = 0; i < count; ++i) {
+        if (option_type[i] != MC_CALL && option_type[i] != MC_PUT) {
+            return fail(MC_ERROR_INVALID_ARGUMENT, "Invalid option type at index " + std::to_string(i));
+        }
+        if (!positive(spot[i]) || !positive(strike[i]) || !positive(maturity[i])) {
+            return fail(MC_ERROR_INVALID_ARGUMENT,
+                        "Spot, strike and maturity must be positive at index " + std::to_string(i));
+        }
+        if (!std::isfinite(rate[i]) || !std::isfinite(volatility[i]) || volatility[i] < 0.0) {
+            return fail(MC_ERROR_INVALID_ARGUMENT,
+                        "Invalid rate or volatility at index " + std::to_string(i));
+        }
+    }
+
+    const mc_pricer_options& options = pricer->options;
+    const auto precision = options.path_precision == MC_PRECISION_SINGLE
+        ? montecarlo::PathPrecision::Single : montecarlo::PathPrecision::Double;
+    const auto method = options.normal_method == MC_NORMAL_INVERSE_CDF
+        ? montecarlo::NormalMethod::InverseCdf : montecarlo::NormalMethod::Ziggurat;
+
+    return guarded([&] {
+        for (size_t i = 0; i < count; ++i) {
+            BlackScholesModel model(spot[i], rate[i], volatility[i]);
+            montecarlo::OptionPricer option_pricer(model, options.num_simulations,
+                                                   options.num_threads, precision);
+            option_pricer.set_normal_method(method);
+
+            montecarlo::PricingResult result;
+            if (option_type[i] == MC_CALL) {
+                montecarlo::CallPayoff payoff(strike[i]);
+                result = option_pricer.price_option(payoff, maturity[i], *pricer->workspace);
+            } else {
+                montecarlo::PutPayoff payoff(strike[i]);
+                result = option_pricer.price_option(payoff, maturity[i], *pricer->workspace);
+            }
+
+            price_out[i] = result.price;
+            if (standard_error_out) {
+                standard_error_out[i] = result.standard_error;
+            }
+        }
+        return MC_OK;
+    });
+}
+
+} // extern "C"
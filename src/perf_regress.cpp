@@ -0,0 +1,99 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CLI/CLI.hpp"
+#include "Exceptions.h"
+#include "PerfRegression.h"
+
+// Exit codes: 0 = within thresholds, 1 = regression, 2 = error
+int main(int argc, char* argv[]) {
+    try {
+        CLI::App app{"Monte Carlo pricing performance regression harness"};
+
+        std::string baseline_file = "perf_baseline.json";
+        app.add_option("-b,--baseline", baseline_file, "Baseline JSON file to compare against");
+        std::string output_file;
+        app.add_option("-o,--output", output_file, "Also write this run's measurements to a JSON file");
+        bool update = false;
+        app.add_flag("--update", update, "Record this run as the new baseline instead of comparing");
+
+        unsigned int repeats = 9;
+        app.add_option("--repeats", repeats, "Timed runs per workload")
+            ->check(CLI::PositiveNumber);
+        unsigned int num_threads = std::thread::hardware_concurrency();
+        app.add_option("--threads,-t", num_threads, "Worker threads for the pricers")
+            ->check(CLI::PositiveNumber);
+        double scale = 1.0;
+        app.add_option("--scale", scale, "Multiplier on the default path counts")
+            ->check(CLI::PositiveNumber);
+
+        montecarlo::PerfThresholds thresholds;
+        app.add_option("--threshold", thresholds.throughput, "Allowed relative throughput drop");
+        app.add_option("--memory-threshold", thresholds.memory, "Allowed relative memory growth");
+        app.add_option("--noise-multiplier", thresholds.noise_multiplier,
+            "Ignore throughput drops within this many combined noise levels");
+
+        CLI11_PARSE(app, argc, argv);
+
+        // Fail on a missing or stale baseline before spending time measuring
+        montecarlo::PerfBaseline baseline;
+        if (!update) {
+            baseline = montecarlo::PerfBaseline::load(baseline_file);
+        }
+
+        auto workloads = montecarlo::standard_workloads(num_threads, scale);
+
+        montecarlo::PerfBaseline run;
+        run.hardware_threads = std::thread::hardware_concurrency();
+        for (const auto& workload : workloads) {
+            std::cout << "Measuring " << workload.name << "..." << std::endl;
+            run.samples.push_back(montecarlo::measure(workload, repeats));
+        }
+
+        if (!output_file.empty()) {
+            run.save(output_file);
+        }
+        if (update) {
+            run.save(baseline_file);
+            std::cout << "Baseline written to " << baseline_file << std::endl;
+            return 0;
+        }
+
+        auto comparison = montecarlo::compare(baseline, run.samples, thresholds);
+
+        // Re-measure suspected regressions once and keep the faster run, so a
+        // single burst of load from a neighbour does not fail the check
+        if (comparison.regressed()) {
+            for (std::size_t i = 0; i < workloads.size(); ++i) {
+                bool suspect = false;
+                for (const auto& row : comparison.rows) {
+                    suspect = suspect || (row.regressed && row.name == workloads[i].name);
+                }
+                if (suspect) {
+                    std::cout << "Re-measuring " << workloads[i].name << "..." << std::endl;
+                    auto retry = montecarlo::measure(workloads[i], repeats);
+                    if (retry.paths_per_second > run.samples[i].paths_per_second) {
+                        run.samples[i] = retry;
+                    }
+                }
+            }
+            comparison = montecarlo::compare(baseline, run.samples, thresholds);
+        }
+
+        std::cout << "\n" << comparison.format();
+        if (baseline.hardware_threads != run.hardware_threads) {
+            std::cout << "Note: baseline was recorded with " << baseline.hardware_threads
+                      << " hardware threads, this machine has " << run.hardware_threads << "\n";
+        }
+        if (comparison.regressed()) {
+            std::cout << "\nPerformance regression detected\n";
+            return 1;
+        }
+        std::cout << "\nAll workloads within thresholds\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 2;
+    }
+}
@@ -0,0 +1,204 @@
+#include "BarrierPricer.h"
+#include "Analytics.h"
+#include "BlackScholesModel.h"
+#include "Exceptions.h"
+#include "TermStructureModel.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+
+namespace montecarlo {
+
+namespace {
+
+// Black-Scholes dynamics that hide their GBM terms
+class OpaqueModel : public IPricingModel {
+public:
+    OpaqueModel() : model_(100.0, 0.05, 0.25) {}
+    void simulate_terminal(const double* normals, double* terminal, std::size_t count, double T) const override {
+        model_.simulate_terminal(normals, terminal, count, T);
+    }
+    void simulate_paths(const double* normals, double* paths, std::size_t count, std::size_t num_steps,
+                        double T) const override {
+        model_.simulate_paths(normals, paths, count, num_steps, T);
+    }
+    double discount_factor(double T) const override { return model_.discount_factor(T); }
+
+private:
+    BlackScholesModel model_;
+};
+
+// Any model's dynamics through the generic per-block path interface only
+class ForwardingModel : public IPricingModel {
+public:
+    explicit ForwardingModel(const IPricingModel& model) : model_(model) {}
+    void simulate_terminal(const double* normals, double* terminal, std::size_t count, double T) const override {
+        model_.simulate_terminal(normals, terminal, count, T);
+    }
+    void simulate_paths(const double* normals, double* paths, std::size_t count, std::size_t num_steps,
+                        double T) const override {
+        model_.simulate_paths(normals, paths, count, num_steps, T);
+    }
+    double discount_factor(double T) const override { return model_.discount_factor(T); }
+
+private:
+    const IPricingModel& model_;
+};
+
+} // namespace
+
+TEST_CASE("Barrier analytic prices satisfy in-out parity", "[BarrierPricer]") {
+    const double S = 100.0, r = 0.05, sigma = 0.25, T = 1.0, rebate = 2.0;
+    for (OptionType type : {OptionType::Call, OptionType::Put}) {
+        for (double K : {90.0, 110.0}) {
+            double vanilla = analytics::black_scholes_price(S, K, r, sigma, T, type);
+            for (double H : {80.0, 95.0}) {
+                double in = analytics::barrier_price(S, K, H, r, sigma, T, BarrierType::DownAndIn, type, rebate);
+                double out = analytics::barrier_price(S, K, H, r, sigma, T, BarrierType::DownAndOut, type, rebate);
+                REQUIRE(in >= 0.0);
+                REQUIRE(out >= 0.0);
+                REQUIRE(std::abs(in + out - vanilla - rebate * std::exp(-r * T)) < 1e-10);
+            }
+            for (double H : {105.0, 130.0}) {
+                double in = analytics::barrier_price(S, K, H, r, sigma, T, BarrierType::UpAndIn, type, rebate);
+                double out = analytics::barrier_price(S, K, H, r, sigma, T, BarrierType::UpAndOut, type, rebate);
+                REQUIRE(in >= 0.0);
+                REQUIRE(out >= 0.0);
+                REQUIRE(std::abs(in + out - vanilla - rebate * std::exp(-r * T)) < 1e-10);
+            }
+        }
+    }
+
+    // A far barrier leaves the vanilla price
+    REQUIRE(std::abs(analytics::barrier_price(S, 100.0, 1e-3, r, sigma, T, BarrierType::DownAndOut, OptionType::Call)
+                     - analytics::black_scholes_price(S, 100.0, r, sigma, T, OptionType::Call)) < 1e-10);
+}
+
+TEST_CASE("BarrierPricer Brownian bridge matches continuous monitoring", "[BarrierPricer]") {
+    const double S = 100.0, r = 0.05, sigma = 0.25, T = 1.0;
+    BlackScholesModel model(S, r, sigma);
+    BarrierPricer pricer(model, 400000, 4, 10);
+
+    struct Case {
+        BarrierType barrier_type;
+        double H;
+        double K;
+        OptionType type;
+        double rebate;
+    };
+    const Case cases[] = {
+        {BarrierType::DownAndOut, 90.0, 100.0, OptionType::Call, 0.0},
+        {BarrierType::DownAndIn, 90.0, 100.0, OptionType::Put, 0.0},
+        {BarrierType::UpAndOut, 120.0, 100.0, OptionType::Call, 3.0},
+        {BarrierType::UpAndIn, 115.0, 95.0, OptionType::Put, 1.0},
+    };
+
+    for (const Case& c : cases) {
+        BarrierPayoff payoff(c.barrier_type, c.H, c.K, c.type, c.rebate);
+        double expected = analytics::barrier_price(S, c.K, c.H, r, sigma, T, c.barrier_type, c.type, c.rebate);
+
+        PricingWorkspace workspace(4, 31);
+        PricingResult result = pricer.price_option(payoff, T, workspace);
+        REQUIRE(result.standard_error > 0.0);
+        REQUIRE(std::abs(result.price - expected) < 4.0 * result.standard_error);
+    }
+}
+
+TEST_CASE("BarrierPricer discrete monitoring is biased on a coarse grid", "[BarrierPricer]") {
+    const double S = 100.0, r = 0.05, sigma = 0.25, T = 1.0;
+    BlackScholesModel model(S, r, sigma);
+    BarrierPayoff payoff(BarrierType::DownAndOut, 90.0, 100.0, OptionType::Call);
+    double expected = analytics::barrier_price(S, 100.0, 90.0, r, sigma, T, BarrierType::DownAndOut, OptionType::Call);
+
+    BarrierPricer pricer(model, 400000, 4, 10);
+    pricer.set_monitoring(BarrierMonitoring::Discrete);
+    PricingWorkspace discrete_workspace(4, 31);
+    PricingResult discrete = pricer.price_option(payoff, T, discrete_workspace);
+
+    pricer.set_monitoring(BarrierMonitoring::Continuous);
+    PricingWorkspace bridge_workspace(4, 31);
+    PricingResult bridge = pricer.price_option(payoff, T, bridge_workspace);
+
+    // Missed crossings between dates overprice the knock-out
+    REQUIRE(discrete.price - expected > 8.0 * discrete.standard_error);
+    REQUIRE(std::abs(bridge.price - expected) < 4.0 * bridge.standard_error);
+    REQUIRE(bridge.standard_error < discrete.standard_error);
+}
+
+TEST_CASE("BarrierPricer handles term structure models", "[BarrierPricer]") {
+    // With r(t) = sigma(t)^2 the log price is a flat GBM run on the clock
+    // V(t), so barrier prices are those of the flat model with the averages
+    TermStructure vols({0.5, 1.0}, {0.2, 0.3});
+    TermStructure rates({0.5, 1.0}, {0.04, 0.09});
+    TermStructureModel model(100.0, rates, vols);
+    const double T = 1.0;
+    auto average = *model.terminal_gbm_terms(T);
+    REQUIRE_FALSE(model.gbm_terms());
+
+    SECTION("Continuous monitoring uses the variance of each step") {
+        BarrierPricer pricer(model, 400000, 4, 10);
+        for (BarrierType barrier_type : {BarrierType::DownAndOut, BarrierType::UpAndOut}) {
+            double H = barrier_type == BarrierType::DownAndOut ? 85.0 : 130.0;
+            BarrierPayoff payoff(barrier_type, H, 100.0, OptionType::Call);
+            double expected = analytics::barrier_price(100.0, 100.0, H, average.risk_free_rate, average.volatility,
+                                                       T, barrier_type, OptionType::Call);
+
+            PricingWorkspace workspace(4, 17);
+            PricingResult result = pricer.price_option(payoff, T, workspace);
+            REQUIRE(std::abs(result.price - expected) < 4.0 * result.standard_error);
+        }
+    }
+
+    SECTION("Paths from the grid match the per-block curve lookups") {
+        ForwardingModel forwarded(model);
+        BarrierPricer pricer(model, 20000, 2, 12);
+        BarrierPricer reference(forwarded, 20000, 2, 12);
+        pricer.set_monitoring(BarrierMonitoring::Discrete);
+        reference.set_monitoring(BarrierMonitoring::Discrete);
+        BarrierPayoff payoff(BarrierType::DownAndOut, 90.0, 100.0, OptionType::Call);
+
+        PricingWorkspace workspace(2, 5);
+        PricingWorkspace reference_workspace(2, 5);
+        PricingResult result = pricer.price_option(payoff, T, workspace);
+        PricingResult expected = reference.price_option(payoff, T, reference_workspace);
+        REQUIRE(std::abs(result.price - expected.price) < 1e-10);
+    }
+}
+
+TEST_CASE("BarrierPricer edge cases", "[BarrierPricer]") {
+    BlackScholesModel model(100.0, 0.05, 0.25);
+
+    SECTION("In and out prices sum to the vanilla on common paths") {
+        BarrierPricer pricer(model, 50000, 2, 8);
+        PricingWorkspace in_workspace(2, 3);
+        PricingWorkspace out_workspace(2, 3);
+        PricingResult in = pricer.price_option(
+            BarrierPayoff(BarrierType::UpAndIn, 115.0, 100.0, OptionType::Call, 2.0), 1.0, in_workspace);
+        PricingResult out = pricer.price_option(
+            BarrierPayoff(BarrierType::UpAndOut, 115.0, 100.0, OptionType::Call, 2.0), 1.0, out_workspace);
+
+        double expected = analytics::black_scholes_price(100.0, 100.0, 0.05, 0.25, 1.0, OptionType::Call)
+                          + 2.0 * std::exp(-0.05);
+        REQUIRE(std::abs(in.price + out.price - expected) < 4.0 * (in.standard_error + out.standard_error));
+    }
+
+    SECTION("Spot beyond the barrier is already knocked out") {
+        BarrierPricer pricer(model, 10000, 2, 4);
+        PricingResult result = pricer.price_option(
+            BarrierPayoff(BarrierType::DownAndOut, 110.0, 100.0, OptionType::Call, 5.0), 1.0);
+        REQUIRE(std::abs(result.price - 5.0 * std::exp(-0.05)) < 1e-12);
+        REQUIRE(result.standard_error < 1e-6);
+    }
+
+    SECTION("Invalid settings are rejected") {
+        BarrierPayoff payoff(BarrierType::DownAndOut, 90.0, 100.0, OptionType::Call);
+        REQUIRE_THROWS_AS(BarrierPricer(model, 1000, 1, 0).price_option(payoff, 1.0), ValidationError);
+
+        OpaqueModel opaque;
+        BarrierPricer bridge(opaque, 1000, 1, 4);
+        REQUIRE_THROWS_AS(bridge.price_option(payoff, 1.0), ValidationError);
+        bridge.set_monitoring(BarrierMonitoring::Discrete);
+        REQUIRE(bridge.price_option(payoff, 1.0).price > 0.0);
+    }
+}
+
+} // namespace montecarlo
@@ -0,0 +1,220 @@
+#include "BatchScheduler.h"
+#include "Analytics.h"
+#include "BlackScholesModel.h"
+#include "CallPayoff.h"
+#include "Exceptions.h"
+#include "PutPayoff.h"
+#include "TermStructureModel.h"
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <vector>
+
+namespace montecarlo {
+
+namespace {
+
+// A model's dynamics, counting the path grids built and the blocks simulated
+// without one; with forward_grids false it keeps the default path grid
+class CountingModel : public IPricingModel {
+public:
+    CountingModel(const IPricingModel& model, bool forward_grids)
+        : model_(model), forward_grids_(forward_grids) {}
+    void simulate_terminal(const double* normals, double* terminal, std::size_t count, double T) const override {
+        model_.simulate_terminal(normals, terminal, count, T);
+    }
+    void simulate_paths(const double* normals, double* paths, std::size_t count, std::size_t num_steps,
+                        double T) const override {
+        ++ungridded_blocks;
+        model_.simulate_paths(normals, paths, count, num_steps, T);
+    }
+    std::shared_ptr<const PathGrid> make_path_grid(std::size_t num_steps, double T) const override {
+        ++grids;
+        return forward_grids_ ? model_.make_path_grid(num_steps, T) : IPricingModel::make_path_grid(num_steps, T);
+    }
+    void simulate_grid_paths(const PathGrid& grid, const double* normals, double* paths,
+                             std::size_t count) const override {
+        if (forward_grids_) {
+            model_.simulate_grid_paths(grid, normals, paths, count);
+        } else {
+            IPricingModel::simulate_grid_paths(grid, normals, paths, count);
+        }
+    }
+    double discount_factor(double T) const override { return model_.discount_factor(T); }
+
+    mutable std::atomic<int> grids{0};
+    mutable std::atomic<int> ungridded_blocks{0};
+
+private:
+    const IPricingModel& model_;
+    bool forward_grids_;
+};
+
+} // namespace
+
+TEST_CASE("BatchScheduler plans", "[BatchScheduler]") {
+    BlackScholesModel model(100.0, 0.05, 0.2);
+    CallPayoff call(100.0);
+    BatchScheduler scheduler;
+
+    // One long path-dependent job and many one-step vanillas
+    std::vector<BatchJob> jobs;
+    jobs.push_back({&model, &call, 1.0, 20000, 252, PathStatistic::ArithmeticAverage});
+    for (int i = 0; i < 100; ++i) {
+        jobs.push_back({&model, &call, 1.0, 2000});
+    }
+
+    SECTION("Costs are paths x steps x the model factor") {
+        REQUIRE(scheduler.model_factor(model) == BatchScheduler::kDefaultNsPerPathStep);
+        REQUIRE(scheduler.estimate_ns(jobs[0]) == 20000.0 * 252 * BatchScheduler::kDefaultNsPerPathStep);
+        REQUIRE(scheduler.estimate_ns(jobs[1]) == 2000.0 * BatchScheduler::kDefaultNsPerPathStep);
+    }
+
+    SECTION("Large jobs are split, small jobs packed, largest first") {
+        auto plan = scheduler.make_plan(jobs, 4);
+        REQUIRE(plan.piece_offsets.size() == jobs.size() + 1);
+
+        std::size_t long_items = 0;
+        std::size_t packed_items = 0;
+        std::vector<int> covered(plan.piece_offsets.back(), 0);
+        for (std::size_t k = 0; k < plan.items.size(); ++k) {
+            const auto& item = plan.items[k];
+            if (k > 0) {
+                REQUIRE(item.estimated_ns <= plan.items[k - 1].estimated_ns);
+            }
+            if (item.segments.size() > 1) {
+                ++packed_items;
+            }
+            for (const auto& segment : item.segments) {
+                long_items += segment.job == 0 ? 1 : 0;
+                for (std::uint64_t p = segment.first_piece; p < segment.last_piece; ++p) {
+                    ++covered[plan.piece_offsets[segment.job] + p];
+                }
+            }
+        }
+        // Every piece of every job is scheduled exactly once
+        for (int c : covered) {
+            REQUIRE(c == 1);
+        }
+        REQUIRE(long_items > 1);
+        REQUIRE(packed_items > 0);
+        REQUIRE(plan.items.size() < jobs.size());
+        REQUIRE(plan.items.front().segments.front().job == 0);
+    }
+
+    SECTION("Pieces are whole blocks sized by the step count") {
+        REQUIRE(BatchScheduler::block_paths(1) == PricingWorkspace::kBlockSize);
+        REQUIRE(BatchScheduler::block_paths(252) % 8 == 0);
+        REQUIRE(BatchScheduler::block_paths(252) * 252 <= BatchScheduler::kBlockValues);
+        REQUIRE(BatchScheduler::piece_paths(252) % BatchScheduler::block_paths(252) == 0);
+        REQUIRE(BatchScheduler::piece_paths(1) * 1 == BatchScheduler::kPiecePathSteps);
+    }
+
+    SECTION("Invalid batches are rejected") {
+        REQUIRE_THROWS_AS(BatchScheduler(0.0), ValidationError);
+        REQUIRE_THROWS_AS(scheduler.make_plan({}, 4), ValidationError);
+        REQUIRE_THROWS_AS(scheduler.make_plan({{nullptr, &call, 1.0, 100}}, 4), ValidationError);
+        REQUIRE_THROWS_AS(scheduler.make_plan({{&model, &call, 1.0, 0}}, 4), ValidationError);
+        REQUIRE_THROWS_AS(scheduler.make_plan({{&model, &call, 1.0, 100, 0}}, 4), ValidationError);
+        REQUIRE_THROWS_AS(scheduler.make_plan({{&model, &call, 0.0, 100}}, 4), ValidationError);
+    }
+}
+
+TEST_CASE("BatchScheduler prices a mixed batch", "[BatchScheduler]") {
+    BlackScholesModel model(100.0, 0.05, 0.2);
+    CallPayoff call(100.0);
+    PutPayoff put(95.0);
+    const double call_price = analytics::black_scholes_price(100.0, 100.0, 0.05, 0.2, 1.0, OptionType::Call);
+    const double put_price = analytics::black_scholes_price(100.0, 95.0, 0.05, 0.2, 1.0, OptionType::Put);
+
+    std::vector<BatchJob> jobs = {
+        {&model, &call, 1.0, 40000, 52, PathStatistic::ArithmeticAverage},
+        {&model, &call, 1.0, 40000, 52, PathStatistic::Terminal},
+    };
+    for (int i = 0; i < 20; ++i) {
+        jobs.push_back({&model, i % 2 == 0 ? static_cast<const Payoff*>(&call) : &put, 1.0, 20000});
+    }
+
+    BatchScheduler scheduler;
+    PricingWorkspace workspace(3, 17);
+    auto result = scheduler.run(jobs, workspace);
+    REQUIRE(result.jobs.size() == jobs.size());
+
+    SECTION("Estimates match the closed forms") {
+        for (std::size_t j = 1; j < jobs.size(); ++j) {
+            const auto& job = result.jobs[j];
+            double expected = jobs[j].payoff == &call ? call_price : put_price;
+            REQUIRE(job.num_paths == jobs[j].num_paths);
+            REQUIRE(std::abs(job.price - expected) < 4.0 * job.standard_error);
+        }
+        // Averaging lowers the volatility the call sees
+        REQUIRE(result.jobs[0].price > 0.0);
+        REQUIRE(result.jobs[0].price < result.jobs[1].price - 4.0 * result.jobs[1].standard_error);
+    }
+
+    SECTION("Seeded prices do not depend on the workers or the cost estimates") {
+        // The scheduler has refined its factors, so this run is planned differently
+        PricingWorkspace single(1, 17);
+        auto again = scheduler.run(jobs, single);
+        for (std::size_t j = 0; j < jobs.size(); ++j) {
+            REQUIRE(again.jobs[j].price == result.jobs[j].price);
+            REQUIRE(again.jobs[j].standard_error == result.jobs[j].standard_error);
+        }
+    }
+
+    SECTION("The cost model is refined from measured throughput") {
+        double factor = scheduler.model_factor(model);
+        REQUIRE(factor > 0.0);
+        REQUIRE(factor != BatchScheduler::kDefaultNsPerPathStep);
+        REQUIRE(scheduler.estimate_ns(jobs[2]) == 20000.0 * factor);
+    }
+
+    SECTION("Latency statistics are consistent") {
+        const auto& stats = result.stats;
+        REQUIRE(stats.num_workers == 3);
+        REQUIRE(stats.num_items > 0);
+        REQUIRE(stats.makespan_ms > 0.0);
+        REQUIRE(stats.utilization > 0.0);
+        REQUIRE(stats.utilization <= 1.0 + 1e-9);
+        REQUIRE(stats.p50_latency_ms <= stats.p95_latency_ms);
+        REQUIRE(stats.p95_latency_ms <= stats.max_latency_ms);
+        REQUIRE(stats.mean_latency_ms <= stats.max_latency_ms);
+
+        double busy_ms = 0.0;
+        for (const auto& job : result.jobs) {
+            REQUIRE(job.start_ms <= job.latency_ms);
+            REQUIRE(job.compute_ms > 0.0);
+            REQUIRE(job.estimated_ms > 0.0);
+            busy_ms += job.compute_ms;
+        }
+        REQUIRE(std::abs(busy_ms - stats.busy_ms) < 1e-6 * stats.busy_ms);
+    }
+}
+
+TEST_CASE("BatchScheduler simulates path jobs on one grid per run", "[BatchScheduler]") {
+    TermStructure vols({0.5, 1.0}, {0.2, 0.3});
+    TermStructure rates({0.5, 1.0}, {0.04, 0.06});
+    TermStructureModel model(100.0, rates, vols);
+    CountingModel counting(model, true);
+    CallPayoff call(100.0);
+
+    std::vector<BatchJob> jobs = {
+        {&counting, &call, 1.0, 60000, 24, PathStatistic::ArithmeticAverage},
+        {&counting, &call, 1.0, 5000},
+    };
+    BatchScheduler scheduler;
+    PricingWorkspace workspace(3, 11);
+    auto result = scheduler.run(jobs, workspace);
+    REQUIRE(counting.grids == 1);
+    REQUIRE(counting.ungridded_blocks == 0);
+
+    // The grid holds the curve integrals the per-block lookups would compute
+    CountingModel ungridded(model, false);
+    std::vector<BatchJob> per_block = {{&ungridded, &call, 1.0, 60000, 24, PathStatistic::ArithmeticAverage}};
+    PricingWorkspace per_block_workspace(2, 11);
+    auto expected = scheduler.run(per_block, per_block_workspace);
+    REQUIRE(ungridded.ungridded_blocks > 0);
+    REQUIRE(std::abs(result.jobs[0].price - expected.jobs[0].price) < 1e-10);
+}
+
+} // namespace montecarlo
@@ -2,6 +2,7 @@
 #include <catch2/catch_test_macros.hpp>
 #include <cmath>
 #include <random>
+#include <vector>
 
 namespace montecarlo {
 
@@ -25,13 +26,19 @@ TEST_CASE("BlackScholesModel price simulation", "[BlackScholesModel]") {
     
     BlackScholesModel model(S, r, sigma);
     
-    // Test multiple simulations
+    // Test multiple simulations as one block
     const int num_simulations = 10000;
+    std::mt19937 rng(42);
+    std::normal_distribution<double> normal;
+    std::vector<double> prices(num_simulations);
+    for (double& z : prices) {
+        z = normal(rng);
+    }
+    model.simulate_terminal(prices.data(), prices.data(), prices.size(), T);
+
     double sum = 0.0;
     double sum_squared = 0.0;
-    
-    for (int i = 0; i < num_simulations; ++i) {
-        double ST = model.simulate_price(S, 0.0, r, sigma, T);
+    for (double ST : prices) {
         sum += ST;
         sum_squared += ST * ST;
     }
@@ -45,27 +52,63 @@ TEST_CASE("BlackScholesModel price simulation", "[BlackScholesModel]") {
     // Check if mean and variance are within reasonable bounds
     REQUIRE(std::abs(mean - expected_mean) < 0.1 * expected_mean);
     REQUIRE(std::abs(variance - expected_variance) < 0.1 * expected_variance);
+    REQUIRE(model.discount_factor(T) == std::exp(-r * T));
+}
+
+TEST_CASE("BlackScholesModel path simulation", "[BlackScholesModel]") {
+    BlackScholesModel model(100.0, 0.05, 0.2);
+    const std::size_t count = 4;
+    const std::size_t num_steps = 3;
+    std::vector<double> normals = {0.1, -0.5, 1.2, 0.0,
+                                   0.3, 0.7, -1.1, 0.0,
+                                   -0.2, 0.4, 0.9, 0.0};
+    std::vector<double> paths(count * num_steps);
+    model.simulate_paths(normals.data(), paths.data(), count, num_steps, 1.5);
+
+    // The sum of the step normals drives the terminal price exactly
+    std::vector<double> total(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        total[i] = (normals[i] + normals[count + i] + normals[2 * count + i]) / std::sqrt(3.0);
+    }
+    std::vector<double> terminal(count);
+    model.simulate_terminal(total.data(), terminal.data(), count, 1.5);
+    for (std::size_t i = 0; i < count; ++i) {
+        double last = paths[(num_steps - 1) * count + i];
+        REQUIRE(std::abs(last - terminal[i]) < 1e-12 * terminal[i]);
+    }
 }
 
 TEST_CASE("BlackScholesModel edge cases", "[BlackScholesModel]") {
+    const double z = 0.7;
+    double ST = 0.0;
+
     SECTION("Zero volatility") {
         BlackScholesModel model(100.0, 0.05, 0.0);
-        double ST = model.simulate_price(100.0, 0.0, 0.05, 0.0, 1.0);
+        model.simulate_terminal(&z, &ST, 1, 1.0);
         double expected = 100.0 * std::exp(0.05 * 1.0);
         REQUIRE(ST == expected);
     }
     
     SECTION("Zero interest rate") {
         BlackScholesModel model(100.0, 0.0, 0.2);
-        double ST = model.simulate_price(100.0, 0.0, 0.0, 0.2, 1.0);
+        model.simulate_terminal(&z, &ST, 1, 1.0);
         REQUIRE(ST > 0.0);
     }
     
     SECTION("Zero time to maturity") {
         BlackScholesModel model(100.0, 0.05, 0.2);
-        double ST = model.simulate_price(100.0, 0.0, 0.05, 0.2, 0.0);
+        model.simulate_terminal(&z, &ST, 1, 0.0);
         REQUIRE(ST == 100.0);
     }
+
+    SECTION("GBM terms are exposed") {
+        BlackScholesModel model(100.0, 0.05, 0.2);
+        auto terms = model.gbm_terms();
+        REQUIRE(terms.has_value());
+        REQUIRE(terms->initial_price == 100.0);
+        REQUIRE(terms->risk_free_rate == 0.05);
+        REQUIRE(terms->volatility == 0.2);
+    }
 }
 
 } // namespace montecarlo 
\ No newline at end of file
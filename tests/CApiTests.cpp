@@ -0,0 +1,116 @@
+#include "montecarlo_c.h"
+#include "Analytics.h"
+#include "BlackScholesModel.h"
+#include "CallPayoff.h"
+#include "OptionPricer.h"
+#include "PricingWorkspace.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace montecarlo {
+
+TEST_CASE("C API pricer lifecycle", "[CApi]") {
+    REQUIRE(mc_api_version() == MC_API_VERSION);
+
+    mc_pricer_options options;
+    mc_pricer_options_init(&options);
+    REQUIRE(options.struct_size == sizeof(mc_pricer_options));
+    REQUIRE(options.num_threads >= 1);
+
+    mc_pricer* pricer = nullptr;
+    REQUIRE(mc_pricer_create(&options, &pricer) == MC_OK);
+    REQUIRE(pricer != nullptr);
+    mc_pricer_destroy(pricer);
+    mc_pricer_destroy(nullptr);
+
+    SECTION("Invalid options are rejected") {
+        options.num_simulations = 0;
+        REQUIRE(mc_pricer_create(&options, &pricer) == MC_ERROR_INVALID_ARGUMENT);
+        REQUIRE(pricer == nullptr);
+        REQUIRE(std::string(mc_last_error()).find("simulations") != std::string::npos);
+
+        mc_pricer_options uninitialized{};
+        REQUIRE(mc_pricer_create(&uninitialized, &pricer) == MC_ERROR_INVALID_ARGUMENT);
+        REQUIRE(mc_pricer_create(&options, nullptr) == MC_ERROR_INVALID_ARGUMENT);
+    }
+
+    SECTION("Version 1 callers are accepted whatever the current struct size") {
+        // A version 1 binary passes the size of the struct up to and including 'reserved'
+        options.struct_size = 40;
+        REQUIRE(mc_pricer_create(&options, &pricer) == MC_OK);
+        mc_pricer_destroy(pricer);
+
+        options.struct_size = 36;
+        pricer = nullptr;
+        REQUIRE(mc_pricer_create(&options, &pricer) == MC_ERROR_INVALID_ARGUMENT);
+        REQUIRE(pricer == nullptr);
+    }
+}
+
+TEST_CASE("C API batch pricing", "[CApi]") {
+    mc_pricer_options options;
+    mc_pricer_options_init(&options);
+    options.num_threads = 2;
+    options.num_simulations = 200000;
+    options.seed = 21;
+    options.use_seed = 1;
+
+    mc_pricer* pricer = nullptr;
+    REQUIRE(mc_pricer_create(&options, &pricer) == MC_OK);
+
+    const std::vector<std::int32_t> types = {MC_CALL, MC_PUT, MC_CALL};
+    const std::vector<double> spot = {100.0, 100.0, 120.0};
+    const std::vector<double> strike = {100.0, 110.0, 100.0};
+    const std::vector<double> rate = {0.05, 0.03, 0.01};
+    const std::vector<double> volatility = {0.2, 0.25, 0.3};
+    const std::vector<double> maturity = {1.0, 0.5, 2.0};
+    std::vector<double> prices(3);
+    std::vector<double> errors(3);
+
+    REQUIRE(mc_price_batch(pricer, 3, types.data(), spot.data(), strike.data(), rate.data(),
+                           volatility.data(), maturity.data(), prices.data(), errors.data()) == MC_OK);
+
+    for (std::size_t i = 0; i < 3; ++i) {
+        double call = analytics::black_scholes_price(spot[i], strike[i], rate[i], volatility[i], maturity[i], OptionType::Call);
+        double expected = types[i] == MC_CALL
+            ? call
+            : call - spot[i] + strike[i] * std::exp(-rate[i] * maturity[i]);
+        REQUIRE(errors[i] > 0.0);
+        REQUIRE(std::abs(prices[i] - expected) < 5.0 * errors[i]);
+    }
+
+    SECTION("Results match the C++ pricer on the same seed") {
+        BlackScholesModel model(spot[0], rate[0], volatility[0]);
+        OptionPricer reference(model, options.num_simulations, options.num_threads);
+        PricingWorkspace workspace(options.num_threads, options.seed);
+        CallPayoff payoff(strike[0]);
+        REQUIRE(reference.price_option(payoff, maturity[0], workspace).price == prices[0]);
+    }
+
+    SECTION("Standard errors are optional") {
+        REQUIRE(mc_price_batch(pricer, 3, types.data(), spot.data(), strike.data(), rate.data(),
+                               volatility.data(), maturity.data(), prices.data(), nullptr) == MC_OK);
+    }
+
+    SECTION("Invalid entries fail before any pricing") {
+        std::vector<double> bad_strike = strike;
+        bad_strike[2] = -1.0;
+        prices.assign(3, -7.0);
+        REQUIRE(mc_price_batch(pricer, 3, types.data(), spot.data(), bad_strike.data(), rate.data(),
+                               volatility.data(), maturity.data(), prices.data(), nullptr)
+                == MC_ERROR_INVALID_ARGUMENT);
+        REQUIRE(std::string(mc_last_error()).find("index 2") != std::string::npos);
+        REQUIRE(prices[0] == -7.0);
+
+        REQUIRE(mc_price_batch(pricer, 3, types.data(), nullptr, strike.data(), rate.data(),
+                               volatility.data(), maturity.data(), prices.data(), nullptr)
+                == MC_ERROR_INVALID_ARGUMENT);
+    }
+
+    mc_pricer_destroy(pricer);
+}
+
+} // namespace montecarlo
@@ -0,0 +1,246 @@
+#include "LocalVolModel.h"
+#include "LocalVolPricer.h"
+#include "OptionPricer.h"
+#include "Analytics.h"
+#include "CallPayoff.h"
+#include "PutPayoff.h"
+#include "PricingWorkspace.h"
+#include "Exceptions.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <vector>
+
+namespace montecarlo {
+
+namespace {
+
+// Skewed surface: volatility falls with spot and rises with time
+LocalVolModel make_skew_model() {
+    std::vector<double> times = {0.0, 0.5, 1.0};
+    std::vector<double> spots = {50.0, 100.0, 150.0, 200.0};
+    std::vector<double> vols = {0.35, 0.25, 0.20, 0.18,
+                                0.37, 0.27, 0.22, 0.20,
+                                0.40, 0.30, 0.25, 0.22};
+    return LocalVolModel(100.0, 0.03, times, spots, vols);
+}
+
+} // namespace
+
+TEST_CASE("LocalVolModel surface interpolation", "[LocalVolModel]") {
+    auto model = make_skew_model();
+
+    REQUIRE(std::abs(model.local_volatility(0.5, 100.0) - 0.27) < 1e-12);
+    REQUIRE(std::abs(model.local_volatility(0.25, 125.0) - 0.5 * (0.225 + 0.245)) < 1e-12);
+
+    // Flat extrapolation in both directions
+    REQUIRE(std::abs(model.local_volatility(2.0, 10.0) - 0.40) < 1e-12);
+    REQUIRE(std::abs(model.local_volatility(-1.0, 500.0) - 0.18) < 1e-12);
+}
+
+TEST_CASE("LocalVolModel grid lookup matches the surface", "[LocalVolModel]") {
+    auto model = make_skew_model();
+    auto grid = model.build_grid(1.0, 50, 512);
+
+    for (std::size_t step = 0; step < grid.num_steps; step += 7) {
+        double t = step * grid.dt;
+        for (double S = 40.0; S < 220.0; S += 3.7) {
+            double expected = model.local_volatility(t, S);
+            REQUIRE(std::abs(grid.volatility(step, std::log(S)) - expected) < 1e-3);
+        }
+    }
+}
+
+TEST_CASE("LocalVolModel validation", "[LocalVolModel]") {
+    REQUIRE_THROWS_AS(LocalVolModel(100.0, 0.03, {0.0, 1.0}, {100.0}, {0.2}), ValidationError);
+    REQUIRE_THROWS_AS(LocalVolModel(100.0, 0.03, {1.0, 0.5}, {100.0}, {0.2, 0.2}), ValidationError);
+    REQUIRE_THROWS_AS(make_skew_model().build_grid(1.0, 0), ValidationError);
+}
+
+TEST_CASE("LocalVolModel through IPricingModel", "[LocalVolModel]") {
+    auto model = make_skew_model();
+    const IPricingModel& generic = model;
+    const std::size_t count = 3;
+    const std::size_t num_steps = 4;
+    std::vector<double> normals = {0.5, -1.0, 2.0, 0.1, 0.2, -0.3, -1.5, 0.0, 1.0, 0.7, -0.2, 0.4};
+
+    SECTION("Paths follow evolve_step on the same grid") {
+        std::vector<double> paths(normals.size());
+        generic.simulate_paths(normals.data(), paths.data(), count, num_steps, 1.0);
+
+        auto grid = model.build_grid(1.0, num_steps);
+        std::vector<double> log_spots(count, std::log(model.get_initial_price()));
+        for (std::size_t step = 0; step < num_steps; ++step) {
+            model.evolve_step(grid, step, normals.data() + step * count, log_spots.data(), count);
+            for (std::size_t p = 0; p < count; ++p) {
+                REQUIRE(paths[step * count + p] == std::exp(log_spots[p]));
+            }
+        }
+
+        // The path grid is the cached grid and gives the same paths
+        auto path_grid = generic.make_path_grid(num_steps, 1.0);
+        REQUIRE(path_grid == model.grid(1.0, num_steps));
+        REQUIRE(path_grid->step_variances.empty());
+        std::vector<double> gridded(normals.size());
+        generic.simulate_grid_paths(*path_grid, normals.data(), gridded.data(), count);
+        REQUIRE(gridded == paths);
+
+        // Prices may overwrite the normals
+        generic.simulate_paths(normals.data(), normals.data(), count, num_steps, 1.0);
+        REQUIRE(normals == paths);
+    }
+
+    SECTION("Terminal prices are bridged local volatility paths") {
+        model.set_terminal_steps(num_steps);
+        std::vector<double> terminal(count);
+        generic.simulate_terminal(normals.data(), terminal.data(), count, 1.0);
+        std::vector<double> again(normals.begin(), normals.begin() + count);
+        generic.simulate_terminal(again.data(), again.data(), count, 1.0);
+        REQUIRE(again == terminal);
+
+        // With one step the normal drives the only Euler step
+        model.set_terminal_steps(1);
+        generic.simulate_terminal(normals.data(), terminal.data(), count, 1.0);
+        std::vector<double> paths(count);
+        generic.simulate_paths(normals.data(), paths.data(), count, 1, 1.0);
+        REQUIRE(terminal == paths);
+        REQUIRE_THROWS_AS(model.set_terminal_steps(0), ValidationError);
+    }
+
+    SECTION("A skewed surface prices through OptionPricer as through LocalVolPricer") {
+        PutPayoff payoff(80.0);
+        OptionPricer generic_pricer(model, 200000, 4);
+        PricingWorkspace generic_workspace(4, 3);
+        auto result = generic_pricer.price_option(payoff, 1.0, generic_workspace);
+
+        LocalVolPricer pricer(model, 200000, 4, LocalVolModel::kDefaultTerminalSteps);
+        PricingWorkspace workspace(4, 5);
+        auto expected = pricer.price_option(payoff, 1.0, workspace);
+
+        double combined = std::sqrt(result.standard_error * result.standard_error +
+                                    expected.standard_error * expected.standard_error);
+        REQUIRE(std::abs(result.price - expected.price) < 4 * combined);
+    }
+
+    SECTION("A flat surface prices exactly through OptionPricer") {
+        LocalVolModel flat(100.0, 0.05, {0.0}, {100.0}, {0.2});
+        OptionPricer pricer(flat, 200000, 4);
+        CallPayoff payoff(100.0);
+
+        auto result = pricer.price_option(payoff, 1.0);
+        double expected = analytics::black_scholes_price(100.0, 100.0, 0.05, 0.2, 1.0, OptionType::Call);
+        REQUIRE(std::abs(result.price - expected) < 4 * result.standard_error);
+    }
+}
+
+TEST_CASE("LocalVolPricer prices", "[LocalVolModel]") {
+    SECTION("Flat surface reproduces Black-Scholes") {
+        LocalVolModel model(100.0, 0.05, {0.0}, {100.0}, {0.2});
+        LocalVolPricer pricer(model, 200000, 4, 10);
+        CallPayoff payoff(100.0);
+
+        auto result = pricer.price_option(payoff, 1.0);
+        double expected = analytics::black_scholes_price(100.0, 100.0, 0.05, 0.2, 1.0, OptionType::Call);
+        REQUIRE(std::abs(result.price - expected) < 4 * result.standard_error);
+    }
+
+    SECTION("Latin hypercube sampling stays unbiased and tightens the estimate") {
+        LocalVolModel model(100.0, 0.05, {0.0}, {100.0}, {0.2});
+        CallPayoff payoff(100.0);
+        double expected = analytics::black_scholes_price(100.0, 100.0, 0.05, 0.2, 1.0, OptionType::Call);
+
+        LocalVolPricer plain(model, 200000, 4, 4);
+        LocalVolPricer lhs(model, 200000, 4, 4);
+        lhs.set_latin_hypercube(true);
+        auto plain_result = plain.price_option(payoff, 1.0);
+        auto lhs_result = lhs.price_option(payoff, 1.0);
+
+        REQUIRE(std::abs(lhs_result.price - expected) < 4 * lhs_result.standard_error);
+        REQUIRE(lhs_result.standard_error < plain_result.standard_error);
+    }
+
+    SECTION("Skew raises low-strike call values relative to at-the-money vol") {
+        auto model = make_skew_model();
+        LocalVolPricer pricer(model, 100000, 4, 50);
+        CallPayoff payoff(80.0);
+
+        auto result = pricer.price_option(payoff, 1.0);
+        double atm_vol_price = analytics::black_scholes_price(100.0, 80.0, 0.03, 0.25, 1.0, OptionType::Call);
+        REQUIRE(result.price > atm_vol_price);
+    }
+}
+
+TEST_CASE("LocalVolPricer pathwise sensitivities", "[LocalVolModel]") {
+    const std::vector<double> times = {0.0, 0.5, 1.0};
+    const std::vector<double> spots = {50.0, 100.0, 150.0, 200.0};
+    const std::vector<double> vols = {0.35, 0.25, 0.20, 0.18,
+                                      0.37, 0.27, 0.22, 0.20,
+                                      0.40, 0.30, 0.25, 0.22};
+    const double S0 = 100.0;
+    const double r = 0.03;
+    const double T = 1.0;
+    const std::uint64_t num_simulations = 100000;
+    const unsigned int num_steps = 20;
+    CallPayoff call(105.0);
+
+    // Same seed for every run, so bumped prices share their paths
+    auto price = [&](double spot, double rate, const std::vector<double>& surface) {
+        LocalVolModel model(spot, rate, times, spots, surface);
+        LocalVolPricer pricer(model, num_simulations, 2, num_steps);
+        PricingWorkspace workspace(2, 23);
+        return pricer.price_option(call, T, workspace).price;
+    };
+
+    LocalVolModel model(S0, r, times, spots, vols);
+    LocalVolPricer pricer(model, num_simulations, 2, num_steps);
+    PricingWorkspace workspace(2, 23);
+    LocalVolSensitivities result = pricer.price_sensitivities(call, T, workspace);
+
+    REQUIRE(std::abs(result.pricing.price - price(S0, r, vols)) < 1e-10);
+    REQUIRE(result.vegas.size() == vols.size());
+
+    const double h = 1e-3;
+    double delta = (price(S0 + h, r, vols) - price(S0 - h, r, vols)) / (2.0 * h);
+    double rho = (price(S0, r + h, vols) - price(S0, r - h, vols)) / (2.0 * h);
+    REQUIRE(std::abs(result.delta - delta) < 1e-3 * std::abs(delta));
+    REQUIRE(std::abs(result.rho - rho) < 1e-3 * std::abs(rho));
+
+    // Every node, against bump-and-reprice on the same paths
+    for (std::size_t k = 0; k < vols.size(); ++k) {
+        std::vector<double> up = vols;
+        std::vector<double> down = vols;
+        up[k] += h;
+        down[k] -= h;
+        double vega = (price(S0, r, up) - price(S0, r, down)) / (2.0 * h);
+        REQUIRE(std::abs(result.vegas[k] - vega) < 1e-3 * std::abs(vega) + 1e-3);
+    }
+
+    SECTION("A flat surface reproduces the Black-Scholes delta and vega") {
+        std::vector<double> flat(vols.size(), 0.2);
+        LocalVolModel flat_model(S0, r, times, spots, flat);
+        LocalVolPricer flat_pricer(flat_model, 400000, 2, num_steps);
+        PricingWorkspace flat_workspace(2, 5);
+        LocalVolSensitivities flat_result = flat_pricer.price_sensitivities(call, T, flat_workspace);
+
+        double d1 = (std::log(S0 / 105.0) + (r + 0.02) * T) / (0.2 * std::sqrt(T));
+        double bs_delta = 0.5 * std::erfc(-d1 / std::sqrt(2.0));
+        double bs_vega = S0 * std::sqrt(T) * std::exp(-0.5 * d1 * d1) / std::sqrt(2.0 * 3.14159265358979323846);
+        double vega_sum = 0.0;
+        for (double vega : flat_result.vegas) {
+            vega_sum += vega;
+        }
+        REQUIRE(std::abs(flat_result.delta - bs_delta) < 0.01);
+        REQUIRE(std::abs(vega_sum - bs_vega) < 0.02 * bs_vega);
+    }
+
+    SECTION("Unsupported settings are rejected") {
+        struct DigitalPayoff : Payoff {
+            double calculate(double S_T) const override { return S_T > 100.0 ? 1.0 : 0.0; }
+            std::unique_ptr<Payoff> clone() const override { return std::make_unique<DigitalPayoff>(); }
+        };
+        REQUIRE_THROWS_AS(pricer.price_sensitivities(DigitalPayoff(), T, workspace), ValidationError);
+        pricer.set_latin_hypercube(true);
+        REQUIRE_THROWS_AS(pricer.price_sensitivities(call, T, workspace), ValidationError);
+    }
+}
+
+} // namespace montecarlo
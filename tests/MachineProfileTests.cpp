@@ -0,0 +1,109 @@
+#include "MachineProfile.h"
+#include "Exceptions.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+namespace montecarlo {
+
+namespace {
+
+MachineProfile make_profile(const std::string& cpu_model, double cpu_quota, unsigned int num_threads) {
+    MachineProfile profile;
+    profile.cpu_model = cpu_model;
+    profile.cpu_quota = cpu_quota;
+    profile.num_threads = num_threads;
+    profile.chunk_size = 16 * PricingWorkspace::kBlockSize;
+    profile.normal_method = NormalMethod::InverseCdf;
+    profile.serial_threshold = 65536;
+    profile.paths_per_second = 1.5e8;
+    return profile;
+}
+
+} // namespace
+
+TEST_CASE("MachineProfile available CPUs", "[MachineProfile]") {
+    unsigned int cpus = MachineProfile::available_cpus();
+    REQUIRE(cpus >= 1);
+    if (std::thread::hardware_concurrency() > 0) {
+        REQUIRE(cpus <= std::thread::hardware_concurrency());
+    }
+    REQUIRE(MachineProfile::current_cpu_quota() >= 0.0);
+    REQUIRE_FALSE(MachineProfile::current_cpu_model().empty());
+}
+
+TEST_CASE("MachineProfile files are keyed by CPU model and quota", "[MachineProfile]") {
+    const std::string filename = "test_machine_profile.json";
+    std::remove(filename.c_str());
+
+    REQUIRE_FALSE(MachineProfile::find(filename, "Test CPU", 0.0));
+
+    make_profile("Test CPU", 0.0, 8).save(filename);
+    make_profile("Test CPU", 2.0, 2).save(filename);
+    make_profile("Other CPU", 0.0, 16).save(filename);
+
+    auto unlimited = MachineProfile::find(filename, "Test CPU", 0.0);
+    REQUIRE(unlimited);
+    REQUIRE(unlimited->num_threads == 8);
+    REQUIRE(unlimited->chunk_size == 16 * PricingWorkspace::kBlockSize);
+    REQUIRE(unlimited->normal_method == NormalMethod::InverseCdf);
+    REQUIRE(unlimited->serial_threshold == 65536);
+    REQUIRE(unlimited->paths_per_second == 1.5e8);
+
+    auto limited = MachineProfile::find(filename, "Test CPU", 2.0);
+    REQUIRE(limited);
+    REQUIRE(limited->num_threads == 2);
+    REQUIRE_FALSE(MachineProfile::find(filename, "Test CPU", 4.0));
+
+    SECTION("Saving replaces the entry with the same key only") {
+        make_profile("Test CPU", 2.0, 3).save(filename);
+        REQUIRE(MachineProfile::find(filename, "Test CPU", 2.0)->num_threads == 3);
+        REQUIRE(MachineProfile::find(filename, "Test CPU", 0.0)->num_threads == 8);
+        REQUIRE(MachineProfile::find(filename, "Other CPU", 0.0)->num_threads == 16);
+    }
+
+    SECTION("Malformed or outdated files are rejected and replaced on save") {
+        {
+            std::ofstream file(filename);
+            file << "{\"version\": 0, \"profiles\": []}";
+        }
+        REQUIRE_THROWS_AS(MachineProfile::find(filename, "Test CPU", 0.0), ConfigError);
+        {
+            std::ofstream file(filename);
+            file << "{ not json";
+        }
+        REQUIRE_THROWS_AS(MachineProfile::find(filename, "Test CPU", 0.0), ConfigError);
+
+        make_profile("Test CPU", 0.0, 4).save(filename);
+        REQUIRE(MachineProfile::find(filename, "Test CPU", 0.0)->num_threads == 4);
+    }
+
+    std::remove(filename.c_str());
+}
+
+TEST_CASE("MachineProfile tuning", "[MachineProfile]") {
+    TuneOptions options;
+    options.benchmark_paths = 64 * PricingWorkspace::kBlockSize;
+    options.repeats = 1;
+    options.max_threads = 2;
+
+    std::size_t measurements = 0;
+    MachineProfile profile = tune_machine(options, [&](const TuneMeasurement& m) {
+        REQUIRE(m.paths_per_second > 0.0);
+        ++measurements;
+    });
+
+    // Two thread counts, six chunk sizes and the other normal generator at least
+    REQUIRE(measurements >= 9);
+    REQUIRE(profile.num_threads >= 1);
+    REQUIRE(profile.num_threads <= 2);
+    REQUIRE(profile.chunk_size % PricingWorkspace::kBlockSize == 0);
+    REQUIRE(profile.paths_per_second > 0.0);
+    REQUIRE(profile.cpu_model == MachineProfile::current_cpu_model());
+    if (profile.num_threads == 1) {
+        REQUIRE(profile.serial_threshold == 0);
+    }
+}
+
+} // namespace montecarlo
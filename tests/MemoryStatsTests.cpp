@@ -0,0 +1,177 @@
+#include "MemoryStats.h"
+#include "BlackScholesModel.h"
+#include "CallPayoff.h"
+#include "Config.h"
+#include "LocalVolPricer.h"
+#include "OptionPricer.h"
+#include "PutPayoff.h"
+#include "ResultExporter.h"
+#include "ScenarioEngine.h"
+#include "nlohmann/json.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace montecarlo {
+
+TEST_CASE("MemoryStats counts allocations per subsystem", "[MemoryStats]") {
+    REQUIRE(allocations_counted());
+
+    SECTION("Allocations are charged to the innermost scope") {
+        // Assertions stay outside the scopes, since Catch may allocate
+        MemoryStats before = memory_stats();
+        MemoryStats inner_stats;
+        MemoryStats outer_stats;
+        MemorySubsystem inner_subsystem;
+        MemorySubsystem outer_subsystem;
+        {
+            MemoryScope scope(MemorySubsystem::Exporter);
+            auto buffer = std::make_unique<char[]>(1000);
+            {
+                MemoryScope inner(MemorySubsystem::Logger);
+                inner_subsystem = current_memory_subsystem();
+                auto line = std::make_unique<char[]>(300);
+                inner_stats = memory_stats();
+            }
+            outer_subsystem = current_memory_subsystem();
+            outer_stats = memory_stats();
+        }
+        REQUIRE(inner_subsystem == MemorySubsystem::Logger);
+        REQUIRE(outer_subsystem == MemorySubsystem::Exporter);
+        REQUIRE(current_memory_subsystem() == MemorySubsystem::Other);
+        REQUIRE(inner_stats.of(MemorySubsystem::Logger).live_bytes -
+                before.of(MemorySubsystem::Logger).live_bytes == 300);
+        REQUIRE(outer_stats.of(MemorySubsystem::Exporter).live_bytes -
+                before.of(MemorySubsystem::Exporter).live_bytes == 1000);
+        REQUIRE(outer_stats.peak_live_bytes >= outer_stats.total.live_bytes);
+
+        MemoryStats after = memory_stats();
+        for (auto subsystem : {MemorySubsystem::Exporter, MemorySubsystem::Logger}) {
+            const auto& now = after.of(subsystem);
+            const auto& then = before.of(subsystem);
+            REQUIRE(now.allocations - then.allocations == 1);
+            REQUIRE(now.deallocations - then.deallocations == 1);
+            REQUIRE(now.live_bytes == then.live_bytes);
+        }
+        REQUIRE(after.of(MemorySubsystem::Exporter).bytes_allocated -
+                before.of(MemorySubsystem::Exporter).bytes_allocated == 1000);
+    }
+
+    SECTION("Frees on another thread credit the allocating subsystem") {
+        MemoryStats before = memory_stats();
+        std::vector<double>* values;
+        {
+            MemoryScope scope(MemorySubsystem::Config);
+            values = new std::vector<double>(64);
+        }
+        std::thread([values] { delete values; }).join();
+
+        MemoryStats after = memory_stats();
+        const auto& now = after.of(MemorySubsystem::Config);
+        const auto& then = before.of(MemorySubsystem::Config);
+        REQUIRE(now.allocations - then.allocations == 2);
+        REQUIRE(now.deallocations - then.deallocations == 2);
+        REQUIRE(now.live_bytes == then.live_bytes);
+    }
+
+    SECTION("Aligned allocations keep their alignment and are counted") {
+        AllocationCounter counter;
+        void* p = ::operator new(256, std::align_val_t{128});
+        REQUIRE(reinterpret_cast<std::uintptr_t>(p) % 128 == 0);
+        REQUIRE(counter.allocations() == 1);
+        REQUIRE(counter.bytes_allocated() == 256);
+        ::operator delete(p, std::align_val_t{128});
+    }
+
+    SECTION("Pricing is charged to the pricer") {
+        BlackScholesModel model(100.0, 0.05, 0.2);
+        CallPayoff payoff(100.0);
+        OptionPricer pricer(model, 20000, 2);
+
+        MemoryStats before = memory_stats();
+        pricer.price_option(payoff, 1.0);
+        MemoryStats after = memory_stats();
+
+        // Building the call's workspace allocates; all of it is released
+        const auto& now = after.of(MemorySubsystem::Pricer);
+        const auto& then = before.of(MemorySubsystem::Pricer);
+        REQUIRE(now.allocations > then.allocations);
+        REQUIRE(now.live_bytes == then.live_bytes);
+    }
+
+    SECTION("Pricers other than OptionPricer are charged to the pricer too") {
+        BlackScholesModel model(100.0, 0.05, 0.2);
+        CallPayoff call(100.0);
+        PutPayoff put(100.0);
+        ScenarioEngine engine(model, 20000);
+        LocalVolModel local_vol(100.0, 0.05, {0.0}, {100.0}, {0.2});
+        LocalVolPricer local_vol_pricer(local_vol, 20000, 2, 4);
+        PricingWorkspace workspace(2, 7);
+        const std::vector<MarketScenario> scenarios = {{100.0, 0.2, 0.05}, {105.0, 0.2, 0.05}};
+        const std::vector<const Payoff*> book = {&call, &put};
+
+        // Both allocate on the calling thread, which is worker 0
+        MemoryStats before = memory_stats();
+        engine.run(scenarios, book, 1.0, workspace);
+        local_vol_pricer.price_option(call, 1.0, workspace);
+        MemoryStats after = memory_stats();
+
+        REQUIRE(after.of(MemorySubsystem::Pricer).allocations > before.of(MemorySubsystem::Pricer).allocations);
+        REQUIRE(after.of(MemorySubsystem::Other).allocations == before.of(MemorySubsystem::Other).allocations);
+    }
+}
+
+TEST_CASE("MemoryStats samples the resident set", "[MemoryStats]") {
+    MemoryStats stats = memory_stats();
+    REQUIRE(stats.counted);
+    REQUIRE(stats.peak_rss_kb > 0);
+#if defined(__linux__) || defined(_WIN32)
+    REQUIRE(stats.current_rss_kb > 0);
+#endif
+}
+
+TEST_CASE("MemoryStats are exported with the results", "[MemoryStats]") {
+    const std::string config_file = "memory_stats_test_config.json";
+    const std::string output_file = "memory_stats_test_result.json";
+    {
+        std::ofstream file(config_file);
+        file << R"({
+            "simulation": {"num_simulations": 1000, "num_threads": 1},
+            "option": {"type": "call", "parameters": {"S": 100, "K": 100, "r": 0.05, "sigma": 0.2, "T": 1}},
+            "output": {"precision": 6, "show_timing": false, "memory_stats": true}
+        })";
+    }
+
+    MemoryStats before = memory_stats();
+    Config config = Config::load(config_file);
+    REQUIRE(config.report_memory);
+    REQUIRE(memory_stats().of(MemorySubsystem::Config).allocations >
+            before.of(MemorySubsystem::Config).allocations);
+
+    PricingResult result{10.0, 0.1, std::chrono::milliseconds(1)};
+    result.memory = memory_stats();
+    ResultExporter::export_to_json(output_file, result, config);
+    REQUIRE(memory_stats().of(MemorySubsystem::Exporter).allocations >
+            result.memory->of(MemorySubsystem::Exporter).allocations);
+
+    nlohmann::json j;
+    std::ifstream(output_file) >> j;
+    REQUIRE(j["memory"]["peak_rss_kb"].get<std::size_t>() == result.memory->peak_rss_kb);
+    REQUIRE(j["memory"]["heap"]["allocations"].get<std::uint64_t>() == result.memory->total.allocations);
+    REQUIRE(j["memory"]["heap"]["subsystems"]["config"]["allocations"].get<std::uint64_t>() ==
+            result.memory->of(MemorySubsystem::Config).allocations);
+    // The snapshot predates the export, so the file has no exporter row
+    REQUIRE_FALSE(j["memory"]["heap"]["subsystems"].contains("exporter"));
+
+    std::remove(config_file.c_str());
+    std::remove(output_file.c_str());
+}
+
+} // namespace montecarlo
@@ -0,0 +1,162 @@
+#include "MertonJumpModel.h"
+#include "MertonJumpPricer.h"
+#include "OptionPricer.h"
+#include "Analytics.h"
+#include "CallPayoff.h"
+#include "PutPayoff.h"
+#include "Exceptions.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace montecarlo {
+
+TEST_CASE("MertonJumpModel analytic price", "[MertonJumpModel]") {
+    SECTION("No jumps reduces to Black-Scholes") {
+        MertonJumpModel model(100.0, 0.05, 0.2, 0.0, -0.1, 0.15);
+        double expected = analytics::black_scholes_price(100.0, 100.0, 0.05, 0.2, 1.0, OptionType::Call);
+        REQUIRE(std::abs(model.analytic_price(100.0, 1.0, OptionType::Call) - expected) < 1e-12);
+    }
+
+    SECTION("Put-call parity holds") {
+        MertonJumpModel model(100.0, 0.05, 0.2, 1.5, -0.1, 0.15);
+        double call = model.analytic_price(95.0, 0.5, OptionType::Call);
+        double put = model.analytic_price(95.0, 0.5, OptionType::Put);
+        REQUIRE(std::abs(call - put - (100.0 - 95.0 * std::exp(-0.05 * 0.5))) < 1e-10);
+    }
+
+    SECTION("Jumps fatten the tails") {
+        MertonJumpModel model(100.0, 0.05, 0.2, 1.0, -0.2, 0.2);
+        double diffusion_only = analytics::black_scholes_price(100.0, 70.0, 0.05, 0.2, 0.25, OptionType::Put);
+        REQUIRE(model.analytic_price(70.0, 0.25, OptionType::Put) > diffusion_only);
+    }
+}
+
+TEST_CASE("MertonJumpModel jump count sampling", "[MertonJumpModel]") {
+    MertonJumpModel model(100.0, 0.05, 0.2, 3.0, -0.1, 0.15);
+    auto tables = model.prepare(1.0);
+    REQUIRE(tables.poisson_cdf.back() == 1.0);
+
+    const std::size_t num_paths = 100000;
+    std::vector<double> uniforms(num_paths);
+    for (std::size_t p = 0; p < num_paths; ++p) {
+        uniforms[p] = (p + 0.5) / num_paths;
+    }
+    std::vector<std::uint32_t> counts(num_paths);
+    MertonJumpModel::sample_jump_counts(tables, uniforms.data(), counts.data(), num_paths);
+
+    double mean = 0.0;
+    double mean_squared = 0.0;
+    for (auto n : counts) {
+        mean += n;
+        mean_squared += static_cast<double>(n) * n;
+    }
+    mean /= num_paths;
+    mean_squared /= num_paths;
+
+    // Poisson(3): mean and variance both equal lambda * T
+    REQUIRE(std::abs(mean - 3.0) < 0.01);
+    REQUIRE(std::abs(mean_squared - mean * mean - 3.0) < 0.05);
+}
+
+TEST_CASE("MertonJumpPricer matches the series price", "[MertonJumpModel]") {
+    MertonJumpModel model(100.0, 0.05, 0.2, 1.0, -0.1, 0.2);
+    MertonJumpPricer pricer(model, 400000, 4);
+
+    SECTION("Plain Monte Carlo") {
+        PutPayoff payoff(90.0);
+        auto result = pricer.price_option(payoff, 0.5);
+        double expected = model.analytic_price(90.0, 0.5, OptionType::Put);
+        REQUIRE(std::abs(result.price - expected) < 4 * result.standard_error);
+    }
+
+    SECTION("Control variate reduces the standard error") {
+        CallPayoff payoff(105.0);
+        auto plain = pricer.price_option(payoff, 0.5);
+
+        pricer.set_control_variate(100.0, OptionType::Call);
+        auto controlled = pricer.price_option(payoff, 0.5);
+
+        double expected = model.analytic_price(105.0, 0.5, OptionType::Call);
+        REQUIRE(std::abs(controlled.price - expected) < 4 * controlled.standard_error);
+        REQUIRE(controlled.standard_error < 0.5 * plain.standard_error);
+    }
+}
+
+TEST_CASE("MertonJumpModel through IPricingModel", "[MertonJumpModel]") {
+    MertonJumpModel model(100.0, 0.05, 0.2, 1.0, -0.1, 0.2);
+    const double T = 0.5;
+
+    SECTION("One normal per path samples the mixture at its probability") {
+        auto tables = model.tables(T);
+        REQUIRE(model.tables(T) == tables);
+
+        std::vector<double> z = {-6.0, -2.0, -0.5, 0.0, 0.7, 2.5, 6.0};
+        std::vector<double> terminal(z.size());
+        model.simulate_terminal(z.data(), terminal.data(), z.size(), T);
+        for (std::size_t i = 0; i < z.size(); ++i) {
+            if (i > 0) {
+                REQUIRE(terminal[i] > terminal[i - 1]);
+            }
+            double x = std::log(terminal[i]);
+            double cdf = 0.0;
+            double previous = 0.0;
+            for (std::size_t n = 0; n < tables->poisson_cdf.size(); ++n) {
+                cdf += (tables->poisson_cdf[n] - previous) *
+                       analytics::normal_cdf((x - tables->log_mean[n]) / tables->log_stdev[n]);
+                previous = tables->poisson_cdf[n];
+            }
+            REQUIRE(std::abs(cdf - analytics::normal_cdf(z[i])) < 1e-12);
+        }
+    }
+
+    SECTION("The quantile table interpolates the mixture inversion") {
+        auto table = model.quantile_table(T);
+        REQUIRE(model.quantile_table(T) == table);
+        for (std::size_t divisions : table->divisions) {
+            REQUIRE(divisions > 0);
+        }
+
+        const auto& mixture = *table->mixture;
+        for (double z = -5.9; z < 5.9; z += 0.0137) {
+            double x = MertonJumpModel::quantile(*table, z);
+            double cdf = 0.0;
+            double previous = 0.0;
+            for (std::size_t n = 0; n < mixture.poisson_cdf.size(); ++n) {
+                cdf += (mixture.poisson_cdf[n] - previous) *
+                       analytics::normal_cdf((x - mixture.log_mean[n]) / mixture.log_stdev[n]);
+                previous = mixture.poisson_cdf[n];
+            }
+            REQUIRE(std::abs(cdf - analytics::normal_cdf(z)) < 1e-11);
+        }
+    }
+
+    SECTION("OptionPricer prices with the generic kernel") {
+        OptionPricer pricer(model, 200000, 4);
+        PutPayoff payoff(90.0);
+        double expected = model.analytic_price(90.0, T, OptionType::Put);
+
+        auto plain = pricer.price_option(payoff, T);
+        REQUIRE(std::abs(plain.price - expected) < 4 * plain.standard_error);
+
+        pricer.set_stratification(1000);
+        auto stratified = pricer.price_option(payoff, T);
+        REQUIRE(std::abs(stratified.price - expected) < 4 * stratified.standard_error);
+        REQUIRE(stratified.standard_error < 0.2 * plain.standard_error);
+    }
+
+    SECTION("Paths chain exact steps") {
+        std::vector<double> normals = {0.3, -1.2, 0.8, 0.1};
+        std::vector<double> paths(normals.size());
+        model.simulate_paths(normals.data(), paths.data(), 2, 2, T);
+
+        std::vector<double> step(normals.size());
+        model.simulate_terminal(normals.data(), step.data(), normals.size(), 0.5 * T);
+        REQUIRE(std::abs(paths[0] - step[0]) < 1e-12 * step[0]);
+        REQUIRE(std::abs(paths[2] - step[0] * step[2] / 100.0) < 1e-12 * paths[2]);
+        REQUIRE(std::abs(paths[3] - step[1] * step[3] / 100.0) < 1e-12 * paths[3]);
+    }
+}
+
+} // namespace montecarlo
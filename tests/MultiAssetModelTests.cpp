@@ -0,0 +1,262 @@
+#include "MultiAssetModel.h"
+#include "MultiAssetPricer.h"
+#include "BasketPayoff.h"
+#include "RainbowPayoff.h"
+#include "Exceptions.h"
+#include "PricingWorkspace.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace montecarlo {
+
+namespace {
+
+double normal_cdf(double x) {
+    return 0.5 * (1.0 + std::erf(x / std::sqrt(2.0)));
+}
+
+double black_scholes_call(double S, double K, double r, double sigma, double T) {
+    double d1 = (std::log(S / K) + (r + 0.5 * sigma * sigma) * T) / (sigma * std::sqrt(T));
+    double d2 = d1 - sigma * std::sqrt(T);
+    return S * normal_cdf(d1) - K * std::exp(-r * T) * normal_cdf(d2);
+}
+
+// Max |L L^T - C| over all entries
+double reconstruction_error(const MultiAssetModel& model, const std::vector<double>& correlation) {
+    const std::size_t n = model.num_assets();
+    const auto& L = model.get_factor();
+    double max_error = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            double sum = 0.0;
+            for (std::size_t k = 0; k < n; ++k) {
+                sum += L[i * n + k] * L[j * n + k];
+            }
+            max_error = std::max(max_error, std::abs(sum - correlation[i * n + j]));
+        }
+    }
+    return max_error;
+}
+
+} // namespace
+
+TEST_CASE("MultiAssetModel factorization", "[MultiAssetModel]") {
+    SECTION("Positive definite matrix uses Cholesky") {
+        std::vector<double> correlation = {1.0, 0.5, 0.2,
+                                           0.5, 1.0, 0.3,
+                                           0.2, 0.3, 1.0};
+        MultiAssetModel model({100.0, 100.0, 100.0}, {0.2, 0.25, 0.3}, correlation, 0.05);
+        REQUIRE_FALSE(model.used_eigen_fallback());
+        REQUIRE(reconstruction_error(model, correlation) < 1e-12);
+    }
+
+    SECTION("Singular PSD matrix falls back to eigen-decomposition") {
+        std::vector<double> correlation = {1.0, 1.0, 0.0,
+                                           1.0, 1.0, 0.0,
+                                           0.0, 0.0, 1.0};
+        MultiAssetModel model({100.0, 100.0, 100.0}, {0.2, 0.2, 0.2}, correlation, 0.05);
+        REQUIRE(model.used_eigen_fallback());
+        REQUIRE(reconstruction_error(model, correlation) < 1e-10);
+    }
+
+    SECTION("Invalid matrices are rejected") {
+        REQUIRE_THROWS_AS(MultiAssetModel({100.0, 100.0}, {0.2, 0.2}, {1.0, 0.5, 0.4, 1.0}, 0.05),
+                          ValidationError);
+        REQUIRE_THROWS_AS(MultiAssetModel({100.0, 100.0}, {0.2, 0.2}, {1.0, 1.5, 1.5, 1.0}, 0.05),
+                          ValidationError);
+    }
+}
+
+TEST_CASE("MultiAssetModel correlated normals", "[MultiAssetModel]") {
+    std::vector<double> correlation = {1.0, 0.7, 0.7, 1.0};
+    MultiAssetModel model({100.0, 100.0}, {0.2, 0.2}, correlation, 0.05);
+
+    const std::size_t num_paths = 200000;
+    std::vector<double> normals(2 * num_paths);
+    std::vector<double> correlated(2 * num_paths);
+    std::mt19937 gen(3);
+    std::normal_distribution<double> dist(0.0, 1.0);
+    for (auto& z : normals) {
+        z = dist(gen);
+    }
+    model.correlate(normals.data(), correlated.data(), num_paths);
+
+    double sum_xy = 0.0;
+    double sum_xx = 0.0;
+    double sum_yy = 0.0;
+    for (std::size_t p = 0; p < num_paths; ++p) {
+        double x = correlated[p];
+        double y = correlated[num_paths + p];
+        sum_xy += x * y;
+        sum_xx += x * x;
+        sum_yy += y * y;
+    }
+    REQUIRE(std::abs(sum_xy / std::sqrt(sum_xx * sum_yy) - 0.7) < 0.01);
+}
+
+TEST_CASE("MultiAssetPricer basket and rainbow prices", "[MultiAssetModel]") {
+    const double r = 0.05;
+    const double T = 1.0;
+
+    SECTION("Single-asset basket matches Black-Scholes") {
+        MultiAssetModel model({100.0}, {0.2}, {1.0}, r);
+        MultiAssetPricer pricer(model, 400000, 4);
+        BasketPayoff payoff({1.0}, 100.0, OptionType::Call);
+
+        auto result = pricer.price_option(payoff, T);
+        REQUIRE(std::abs(result.price - black_scholes_call(100.0, 100.0, r, 0.2, T)) <
+                4 * result.standard_error);
+    }
+
+    SECTION("Perfectly correlated identical assets collapse to one") {
+        MultiAssetModel model({100.0, 100.0}, {0.2, 0.2}, {1.0, 1.0, 1.0, 1.0}, r);
+        MultiAssetPricer pricer(model, 400000, 4);
+        RainbowPayoff best_of(RainbowType::BestOf, 100.0, OptionType::Call);
+
+        auto result = pricer.price_option(best_of, T);
+        REQUIRE(std::abs(result.price - black_scholes_call(100.0, 100.0, r, 0.2, T)) <
+                4 * result.standard_error);
+    }
+
+    SECTION("Best-of dominates basket dominates worst-of") {
+        const std::size_t n = 20;
+        std::vector<double> correlation(n * n, 0.4);
+        for (std::size_t i = 0; i < n; ++i) {
+            correlation[i * n + i] = 1.0;
+        }
+        MultiAssetModel model(std::vector<double>(n, 100.0), std::vector<double>(n, 0.25), correlation, r);
+        MultiAssetPricer pricer(model, 50000, 4);
+
+        auto best = pricer.price_option(RainbowPayoff(RainbowType::BestOf, 100.0, OptionType::Call), T);
+        auto basket = pricer.price_option(BasketPayoff(std::vector<double>(n, 1.0 / n), 100.0,
+                                                       OptionType::Call), T);
+        auto worst = pricer.price_option(RainbowPayoff(RainbowType::WorstOf, 100.0, OptionType::Call), T);
+
+        REQUIRE(best.price > basket.price);
+        REQUIRE(basket.price > worst.price);
+        REQUIRE(worst.price >= 0.0);
+    }
+}
+
+TEST_CASE("MultiAssetPricer pathwise sensitivities", "[MultiAssetModel]") {
+    const std::vector<double> spots = {100.0, 95.0, 110.0};
+    const std::vector<double> vols = {0.2, 0.3, 0.25};
+    std::vector<double> correlation = {1.0, 0.5, 0.3,
+                                       0.5, 1.0, 0.4,
+                                       0.3, 0.4, 1.0};
+    const double r = 0.02;
+    const double T = 1.0;
+    const std::uint64_t num_simulations = 100000;
+
+    auto check = [&](const MultiAssetPayoff& payoff) {
+        auto price = [&](const std::vector<double>& s, const std::vector<double>& v,
+                         const std::vector<double>& c, double rate) {
+            MultiAssetModel model(s, v, c, rate);
+            MultiAssetPricer pricer(model, num_simulations, 2);
+            PricingWorkspace workspace(2, 31);
+            return pricer.price_option(payoff, T, workspace).price;
+        };
+
+        MultiAssetModel model(spots, vols, correlation, r);
+        MultiAssetPricer pricer(model, num_simulations, 2);
+        PricingWorkspace workspace(2, 31);
+        MultiAssetSensitivities result = pricer.price_sensitivities(payoff, T, workspace);
+        REQUIRE(std::abs(result.pricing.price - price(spots, vols, correlation, r)) < 1e-10);
+
+        // Against bump-and-reprice on the same paths
+        const double h = 1e-4;
+        for (std::size_t i = 0; i < spots.size(); ++i) {
+            auto up = spots;
+            auto down = spots;
+            up[i] += h;
+            down[i] -= h;
+            double delta = (price(up, vols, correlation, r) - price(down, vols, correlation, r)) / (2.0 * h);
+            REQUIRE(std::abs(result.deltas[i] - delta) < 1e-3 * std::abs(delta) + 1e-4);
+
+            up = vols;
+            down = vols;
+            up[i] += h;
+            down[i] -= h;
+            double vega = (price(spots, up, correlation, r) - price(spots, down, correlation, r)) / (2.0 * h);
+            REQUIRE(std::abs(result.vegas[i] - vega) < 1e-3 * std::abs(vega) + 1e-3);
+        }
+        double rho = (price(spots, vols, correlation, r + h) - price(spots, vols, correlation, r - h)) / (2.0 * h);
+        REQUIRE(std::abs(result.rho - rho) < 1e-3 * std::abs(rho) + 1e-3);
+
+        REQUIRE(result.correlation_sensitivities.size() == 9);
+        for (std::size_t i = 0; i < 3; ++i) {
+            REQUIRE(result.correlation_sensitivities[i * 3 + i] == 0.0);
+            for (std::size_t j = 0; j < i; ++j) {
+                auto up = correlation;
+                auto down = correlation;
+                up[i * 3 + j] += h;
+                up[j * 3 + i] += h;
+                down[i * 3 + j] -= h;
+                down[j * 3 + i] -= h;
+                double sensitivity = (price(spots, vols, up, r) - price(spots, vols, down, r)) / (2.0 * h);
+                REQUIRE(result.correlation_sensitivities[i * 3 + j] == result.correlation_sensitivities[j * 3 + i]);
+                REQUIRE(std::abs(result.correlation_sensitivities[i * 3 + j] - sensitivity) <
+                        1e-3 * std::abs(sensitivity) + 1e-3);
+            }
+        }
+    };
+
+    SECTION("Basket call") {
+        check(BasketPayoff({0.4, 0.3, 0.3}, 100.0, OptionType::Call));
+    }
+
+    SECTION("Worst-of put") {
+        check(RainbowPayoff(RainbowType::WorstOf, 95.0, OptionType::Put));
+    }
+
+    SECTION("Basket call with an uncorrelated pair") {
+        // A zero correlation leaves a zero Cholesky entry whose sensitivity is not zero
+        correlation[1] = 0.0;
+        correlation[3] = 0.0;
+        check(BasketPayoff({0.4, 0.3, 0.3}, 100.0, OptionType::Call));
+    }
+
+    SECTION("The eigen-decomposition fallback has no correlation sensitivities") {
+        std::vector<double> singular = {1.0, 1.0, 0.0,
+                                        1.0, 1.0, 0.0,
+                                        0.0, 0.0, 1.0};
+        MultiAssetModel model(spots, vols, singular, r);
+        REQUIRE(model.used_eigen_fallback());
+        MultiAssetPricer pricer(model, 20000, 2);
+        BasketPayoff basket({0.4, 0.3, 0.3}, 100.0, OptionType::Call);
+        MultiAssetSensitivities result = pricer.price_sensitivities(basket, T);
+        REQUIRE(result.deltas.size() == 3);
+        REQUIRE(result.correlation_sensitivities.empty());
+        REQUIRE_THROWS_AS(model.correlation_sensitivities(std::vector<double>(9, 0.0)), ValidationError);
+    }
+
+    SECTION("Concurrent calls on one pricer keep their tapes apart") {
+        MultiAssetModel model(spots, vols, correlation, r);
+        MultiAssetPricer pricer(model, 20000, 2);
+        BasketPayoff basket({0.4, 0.3, 0.3}, 100.0, OptionType::Call);
+        PricingWorkspace workspace(2, 31);
+        MultiAssetSensitivities expected = pricer.price_sensitivities(basket, T, workspace);
+
+        std::vector<MultiAssetSensitivities> results(2);
+        std::vector<std::thread> threads;
+        for (auto& result : results) {
+            threads.emplace_back([&] {
+                PricingWorkspace own(2, 31);
+                result = pricer.price_sensitivities(basket, T, own);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (const auto& result : results) {
+            REQUIRE(result.deltas == expected.deltas);
+            REQUIRE(result.vegas == expected.vegas);
+            REQUIRE(result.correlation_sensitivities == expected.correlation_sensitivities);
+        }
+    }
+}
+
+} // namespace montecarlo
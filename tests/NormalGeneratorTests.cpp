@@ -0,0 +1,142 @@
+#include "NormalGenerator.h"
+#include "Analytics.h"
+#include "BlackScholesModel.h"
+#include "CallPayoff.h"
+#include "OptionPricer.h"
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace montecarlo {
+
+namespace {
+
+struct Moments {
+    double mean;
+    double variance;
+    double skewness;
+    double kurtosis;
+};
+
+Moments sample_moments(const std::vector<double>& x) {
+    double n = static_cast<double>(x.size());
+    double mean = 0.0;
+    for (double v : x) mean += v;
+    mean /= n;
+
+    double m2 = 0.0, m3 = 0.0, m4 = 0.0;
+    for (double v : x) {
+        double d = v - mean;
+        m2 += d * d;
+        m3 += d * d * d;
+        m4 += d * d * d * d;
+    }
+    m2 /= n;
+    m3 /= n;
+    m4 /= n;
+    return {mean, m2, m3 / std::pow(m2, 1.5), m4 / (m2 * m2)};
+}
+
+// Kolmogorov-Smirnov distance to the standard normal CDF
+double ks_statistic(std::vector<double> x) {
+    std::sort(x.begin(), x.end());
+    double n = static_cast<double>(x.size());
+    double d = 0.0;
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        double f = analytics::normal_cdf(x[i]);
+        d = std::max(d, std::max(f - i / n, (i + 1) / n - f));
+    }
+    return d;
+}
+
+std::vector<double> draw(NormalMethod method, std::size_t n, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::vector<double> x(n);
+    NormalGenerator(method).fill(rng, x.data(), n);
+    return x;
+}
+
+} // namespace
+
+TEST_CASE("NormalGenerator statistical quality", "[NormalGenerator]") {
+    const std::size_t n = 1000000;
+
+    for (NormalMethod method : {NormalMethod::Ziggurat, NormalMethod::InverseCdf}) {
+        auto x = draw(method, n, 2024);
+
+        // Moment standard errors: 1/sqrt(n), sqrt(2/n), sqrt(6/n), sqrt(24/n)
+        Moments m = sample_moments(x);
+        REQUIRE(std::abs(m.mean) < 4.0 / std::sqrt(n));
+        REQUIRE(std::abs(m.variance - 1.0) < 4.0 * std::sqrt(2.0 / n));
+        REQUIRE(std::abs(m.skewness) < 4.0 * std::sqrt(6.0 / n));
+        REQUIRE(std::abs(m.kurtosis - 3.0) < 4.0 * std::sqrt(24.0 / n));
+
+        // KS critical value at the 0.1% level
+        REQUIRE(ks_statistic(x) < 1.95 / std::sqrt(n));
+
+        // Tail frequencies beyond 2 and 3 standard deviations
+        for (double k : {2.0, 3.0}) {
+            double p = 2.0 * analytics::normal_cdf(-k);
+            double count = static_cast<double>(
+                std::count_if(x.begin(), x.end(), [k](double v) { return std::abs(v) > k; }));
+            REQUIRE(std::abs(count / n - p) < 5.0 * std::sqrt(p * (1.0 - p) / n));
+        }
+    }
+}
+
+TEST_CASE("NormalGenerator inverse CDF accuracy", "[NormalGenerator]") {
+    std::vector<double> p;
+    for (double e = -9.0; e < -1.0; e += 0.5) {
+        p.push_back(std::pow(10.0, e));
+        p.push_back(1.0 - std::pow(10.0, e));
+    }
+    for (int i = 1; i < 100; ++i) {
+        p.push_back(i / 100.0);
+    }
+
+    std::vector<double> z(p.size());
+    NormalGenerator::transform(p.data(), z.data(), p.size());
+    for (std::size_t i = 0; i < p.size(); ++i) {
+        double exact = analytics::normal_inverse_cdf(p[i]);
+        REQUIRE(std::abs(z[i] - exact) <= 1.2e-9 * std::max(1.0, std::abs(exact)));
+    }
+
+    SECTION("In-place transform matches out-of-place") {
+        std::vector<double> inplace = p;
+        NormalGenerator::transform(inplace.data(), inplace.data(), inplace.size());
+        REQUIRE(inplace == z);
+    }
+}
+
+TEST_CASE("NormalGenerator single precision and reproducibility", "[NormalGenerator]") {
+    for (NormalMethod method : {NormalMethod::Ziggurat, NormalMethod::InverseCdf}) {
+        std::mt19937 a(7), b(7);
+        std::vector<double> wide(1000);
+        std::vector<float> narrow(1000);
+        NormalGenerator(method).fill(a, wide.data(), wide.size());
+        NormalGenerator(method).fill(b, narrow.data(), narrow.size());
+        for (std::size_t i = 0; i < wide.size(); ++i) {
+            REQUIRE(narrow[i] == static_cast<float>(wide[i]));
+        }
+    }
+}
+
+TEST_CASE("NormalGenerator methods price consistently", "[NormalGenerator]") {
+    BlackScholesModel model(100.0, 0.05, 0.2);
+    CallPayoff call(100.0);
+    double bs = analytics::black_scholes_price(100.0, 100.0, 0.05, 0.2, 1.0, OptionType::Call);
+
+    for (NormalMethod method : {NormalMethod::Ziggurat, NormalMethod::InverseCdf}) {
+        OptionPricer pricer(model, 200000, 2);
+        pricer.set_normal_method(method);
+        REQUIRE(pricer.normal_method() == method);
+
+        PricingWorkspace workspace(2, 99);
+        PricingResult result = pricer.price_option(call, 1.0, workspace);
+        REQUIRE(std::abs(result.price - bs) * std::exp(0.05) < 4.0 * result.standard_error);
+    }
+}
+
+} // namespace montecarlo
@@ -2,8 +2,10 @@
 #include "BlackScholesModel.h"
 #include "CallPayoff.h"
 #include "PutPayoff.h"
+#include "Exceptions.h"
 #include <catch2/catch_test_macros.hpp>
 #include <cmath>
+#include <thread>
 
 namespace montecarlo {
 
@@ -93,6 +95,459 @@ TEST_CASE("OptionPricer edge cases", "[OptionPricer]") {
         auto result = pricer.price_option(payoff, 0.0);
         REQUIRE(std::abs(result.price - std::max(100.0 - 100.0, 0.0)) < 0.01);
     }
+
+    SECTION("No paths gives a defined empty result") {
+        BlackScholesModel model(100.0, 0.05, 0.2);
+        CallPayoff payoff(100.0);
+        OptionPricer pricer(model, 0, 2);
+        auto result = pricer.price_option(payoff, 1.0);
+        REQUIRE(result.num_paths == 0);
+        REQUIRE(result.price == 0.0);
+        REQUIRE(result.standard_error == 0.0);
+
+        pricer.enable_convergence_trace();
+        auto traced = pricer.price_option(payoff, 1.0);
+        REQUIRE(traced.num_paths == 0);
+        REQUIRE(traced.price == 0.0);
+        REQUIRE(traced.standard_error == 0.0);
+    }
+}
+
+TEST_CASE("OptionPricer single precision bias check", "[OptionPricer]") {
+    BlackScholesModel model(100.0, 0.05, 0.2);
+    double T = 1.0;
+    double bs_price = black_scholes_price(100.0, 100.0, 0.05, 0.2, T, true);
+    CallPayoff payoff(100.0);
+
+    OptionPricer double_pricer(model, 2000000, 4, PathPrecision::Double);
+    OptionPricer single_pricer(model, 2000000, 4, PathPrecision::Single);
+    auto double_result = double_pricer.price_option(payoff, T);
+    auto single_result = single_pricer.price_option(payoff, T);
+
+    // Float path evolution must not introduce a bias visible at this sample size
+    REQUIRE(std::abs(single_result.price - bs_price) < 4 * single_result.standard_error);
+    double combined_error = std::sqrt(double_result.standard_error * double_result.standard_error +
+                                      single_result.standard_error * single_result.standard_error);
+    REQUIRE(std::abs(single_result.price - double_result.price) < 4 * combined_error);
+    REQUIRE(std::abs(single_result.standard_error - double_result.standard_error) <
+            0.05 * double_result.standard_error);
+}
+
+TEST_CASE("OptionPricer importance sampling", "[OptionPricer]") {
+    BlackScholesModel model(100.0, 0.05, 0.2);
+    double T = 1.0;
+    unsigned int n = 200000;
+
+    SECTION("Deep out-of-the-money call") {
+        CallPayoff payoff(200.0);
+        double bs_price = black_scholes_price(100.0, 200.0, 0.05, 0.2, T, true);
+
+        OptionPricer plain(model, n, 4);
+        auto plain_result = plain.price_option(payoff, T);
+
+        OptionPricer shifted(model, n, 4);
+        shifted.enable_automatic_drift_shift();
+        auto shifted_result = shifted.price_option(payoff, T);
+
+        REQUIRE(shifted.drift_shift() > 2.0);
+        REQUIRE(std::abs(shifted_result.price - bs_price) * std::exp(0.05 * T) <
+                4 * shifted_result.standard_error);
+
+        // Relative error must improve by well over an order of magnitude
+        REQUIRE(shifted_result.standard_error / shifted_result.price <
+                0.05 * plain_result.standard_error / bs_price);
+    }
+
+    SECTION("Deep out-of-the-money put with a manual shift") {
+        PutPayoff payoff(50.0);
+        double bs_price = black_scholes_price(100.0, 50.0, 0.05, 0.2, T, false);
+
+        OptionPricer pricer(model, n, 4);
+        pricer.set_drift_shift(-3.5);
+        auto result = pricer.price_option(payoff, T);
+
+        REQUIRE(pricer.drift_shift() == -3.5);
+        REQUIRE(std::abs(result.price - bs_price) * std::exp(0.05 * T) < 4 * result.standard_error);
+    }
+
+    SECTION("At-the-money options keep an unbiased estimate") {
+        CallPayoff payoff(100.0);
+        double bs_price = black_scholes_price(100.0, 100.0, 0.05, 0.2, T, true);
+
+        OptionPricer pricer(model, n, 4);
+        pricer.enable_automatic_drift_shift();
+        auto result = pricer.price_option(payoff, T);
+        REQUIRE(std::abs(result.price - bs_price) * std::exp(0.05 * T) < 4 * result.standard_error);
+    }
+}
+
+TEST_CASE("OptionPricer stratified sampling", "[OptionPricer]") {
+    BlackScholesModel model(100.0, 0.05, 0.2);
+    double T = 1.0;
+    double bs_price = black_scholes_price(100.0, 100.0, 0.05, 0.2, T, true);
+    CallPayoff payoff(100.0);
+
+    OptionPricer plain(model, 200000, 4);
+    auto plain_result = plain.price_option(payoff, T);
+
+    for (auto precision : {PathPrecision::Double, PathPrecision::Single}) {
+        OptionPricer stratified(model, 200000, 4, precision);
+        stratified.set_stratification(1000);
+        auto result = stratified.price_option(payoff, T);
+
+        REQUIRE(std::abs(result.price - bs_price) * std::exp(0.05 * T) < 4 * result.standard_error);
+        REQUIRE(result.standard_error < 0.1 * plain_result.standard_error);
+        REQUIRE(stratified.variance_reduction() > 50.0);
+    }
+
+    SECTION("Too few paths per stratum") {
+        OptionPricer pricer(model, 1000, 4);
+        pricer.set_stratification(1000);
+        REQUIRE_THROWS_AS(pricer.price_option(payoff, T), ValidationError);
+    }
+}
+
+TEST_CASE("OptionPricer convergence trace", "[OptionPricer]") {
+    BlackScholesModel model(100.0, 0.05, 0.2);
+    CallPayoff call(100.0);
+    const unsigned int num_simulations = 4000000;
+
+    OptionPricer plain(model, num_simulations, 2);
+    PricingWorkspace plain_workspace(2, 11);
+    PricingResult expected = plain.price_option(call, 1.0, plain_workspace);
+
+    OptionPricer traced(model, num_simulations, 2);
+    std::size_t streamed = 0;
+    traced.enable_convergence_trace(4096, 2.0, [&streamed](const ConvergencePoint&) { ++streamed; });
+    PricingWorkspace traced_workspace(2, 11);
+    PricingResult result = traced.price_option(call, 1.0, traced_workspace);
+
+    // Tracing does not change the estimate
+    REQUIRE(result.price == expected.price);
+    REQUIRE(result.standard_error == expected.standard_error);
+
+    const auto& trace = traced.convergence_trace();
+    REQUIRE(trace.size() >= 2);
+    REQUIRE(streamed == trace.size());
+    REQUIRE(trace.back().paths == num_simulations);
+    REQUIRE(trace.back().estimate == result.price);
+    for (std::size_t i = 1; i < trace.size(); ++i) {
+        REQUIRE(trace[i].paths > trace[i - 1].paths);
+        REQUIRE(trace[i].elapsed_ms >= trace[i - 1].elapsed_ms);
+    }
+    REQUIRE(trace.front().standard_error > trace.back().standard_error);
+
+    SECTION("Invalid settings are rejected") {
+        REQUIRE_THROWS_AS(traced.enable_convergence_trace(1024, 1.0), ValidationError);
+        traced.set_stratification(64);
+        REQUIRE_THROWS_AS(traced.price_option(call, 1.0, traced_workspace), ValidationError);
+    }
+
+    SECTION("Disabling the trace leaves the last trace untouched") {
+        traced.disable_convergence_trace();
+        PricingWorkspace again(2, 11);
+        REQUIRE(traced.price_option(call, 1.0, again).price == expected.price);
+        REQUIRE(traced.convergence_trace().size() == trace.size());
+    }
+}
+
+TEST_CASE("OptionPricer asynchronous pricing", "[OptionPricer]") {
+    BlackScholesModel model(100.0, 0.05, 0.2);
+    CallPayoff call(100.0);
+    double expected_price = black_scholes_price(100.0, 100.0, 0.05, 0.2, 1.0, true);
+
+    SECTION("Completed calls match synchronous pricing") {
+        OptionPricer pricer(model, 1000000, 2);
+        PricingWorkspace sync_workspace(2, 5);
+        PricingResult expected = pricer.price_option(call, 1.0, sync_workspace);
+
+        PricingWorkspace async_workspace(2, 5);
+        PricingHandle handle = pricer.price_option_async(call, 1.0, async_workspace);
+        PricingResult result = handle.get();
+
+        REQUIRE_FALSE(result.cancelled);
+        REQUIRE(result.price == expected.price);
+        REQUIRE(result.standard_error == expected.standard_error);
+        REQUIRE_FALSE(handle.valid());
+
+        PricingProgress progress = handle.progress();
+        REQUIRE(progress.paths_completed == 1000000);
+        REQUIRE(progress.total_paths == 1000000);
+        REQUIRE(std::abs(progress.estimate - result.price) < 1e-9);
+    }
+
+    SECTION("Cancellation returns a valid partial result") {
+        const std::uint64_t num_simulations = 10000000000ULL;
+        OptionPricer pricer(model, num_simulations, 2);
+        PricingHandle handle = pricer.price_option_async(call, 1.0);
+
+        while (handle.progress().paths_completed == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        handle.cancel();
+        REQUIRE(handle.wait_for(std::chrono::seconds(30)));
+
+        PricingResult result = handle.get();
+        PricingProgress progress = handle.progress();
+        REQUIRE(result.cancelled);
+        REQUIRE(progress.paths_completed > 0);
+        REQUIRE(progress.paths_completed < num_simulations);
+        REQUIRE(std::isfinite(result.price));
+        REQUIRE(result.standard_error > 0.0);
+        REQUIRE(std::abs(result.price - expected_price) < 5 * result.standard_error + 1e-3);
+    }
+
+    SECTION("Cancelling before the first chunk still returns an estimate") {
+        OptionPricer pricer(model, 10000000000ULL, 2);
+        PricingHandle handle = pricer.price_option_async(call, 1.0);
+        handle.cancel();
+
+        PricingResult result = handle.get();
+        REQUIRE(result.cancelled);
+        REQUIRE(result.num_paths > 0);
+        REQUIRE(std::isfinite(result.price));
+        REQUIRE(std::isfinite(result.standard_error));
+        REQUIRE(result.standard_error > 0.0);
+    }
+
+    SECTION("Cancelling a traced call before the first chunk still returns an estimate") {
+        OptionPricer pricer(model, 10000000000ULL, 2);
+        pricer.enable_convergence_trace(1000, 2.0);
+        PricingHandle handle = pricer.price_option_async(call, 1.0);
+        handle.cancel();
+
+        PricingResult result = handle.get();
+        REQUIRE(result.cancelled);
+        REQUIRE(result.num_paths > 0);
+        REQUIRE(std::isfinite(result.price));
+        REQUIRE(std::isfinite(pricer.convergence_trace().back().standard_error));
+    }
+
+    SECTION("Destroying a handle cancels the call") {
+        OptionPricer pricer(model, 10000000000ULL, 2);
+        auto start = std::chrono::steady_clock::now();
+        {
+            PricingHandle handle = pricer.price_option_async(call, 1.0);
+        }
+        REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(30));
+    }
+
+    SECTION("Stratified sampling is rejected") {
+        OptionPricer pricer(model, 100000, 2);
+        pricer.set_stratification(64);
+        REQUIRE_THROWS_AS(pricer.price_option_async(call, 1.0), ValidationError);
+    }
+}
+
+TEST_CASE("OptionPricer payoff distribution", "[OptionPricer]") {
+    const double S = 100.0, K = 100.0, r = 0.05, sigma = 0.2, T = 1.0;
+    BlackScholesModel model(S, r, sigma);
+    CallPayoff call(K);
+    const double discount = std::exp(-r * T);
+
+    // The call payoff is increasing in the terminal normal, so its quantiles
+    // are the payoffs at the normal quantiles
+    auto payoff_quantile = [&](double z) {
+        double terminal = S * std::exp((r - 0.5 * sigma * sigma) * T + sigma * std::sqrt(T) * z);
+        return std::max(terminal - K, 0.0) * discount;
+    };
+
+    OptionPricer pricer(model, 1000000, 2);
+    pricer.enable_payoff_distribution(0.99, 10, {0.25, 0.5, 0.95, 0.99});
+    PricingWorkspace workspace(2, 17);
+    PricingResult result = pricer.price_option(call, T, workspace);
+
+    REQUIRE(result.distribution.has_value());
+    const auto& distribution = *result.distribution;
+    REQUIRE(distribution.levels.size() == 4);
+    REQUIRE(distribution.quantiles[0] == 0.0);
+    REQUIRE(std::abs(distribution.quantiles[1] - payoff_quantile(0.0)) < 0.02 * payoff_quantile(0.0) + 0.05);
+    REQUIRE(std::abs(distribution.quantiles[2] - payoff_quantile(1.6449)) < 0.02 * payoff_quantile(1.6449));
+    REQUIRE(std::abs(distribution.quantiles[3] - payoff_quantile(2.3263)) < 0.02 * payoff_quantile(2.3263));
+    REQUIRE(std::abs(distribution.value_at_risk - (distribution.quantiles[3] - result.price)) < 1e-12);
+    REQUIRE(distribution.expected_shortfall > distribution.value_at_risk);
+    REQUIRE(distribution.min == 0.0);
+    REQUIRE(distribution.histogram.size() == 10);
+    REQUIRE(distribution.histogram.back().upper == distribution.max);
+
+    SECTION("Tracking does not change the estimate") {
+        OptionPricer plain(model, 1000000, 2);
+        PricingWorkspace plain_workspace(2, 17);
+        PricingResult expected = plain.price_option(call, T, plain_workspace);
+        REQUIRE(result.price == expected.price);
+        REQUIRE(result.standard_error == expected.standard_error);
+        REQUIRE_FALSE(expected.distribution.has_value());
+    }
+
+    SECTION("The distribution does not depend on the number of workers") {
+        OptionPricer serial(model, 1000000, 1);
+        serial.enable_payoff_distribution(0.99, 10, {0.25, 0.5, 0.95, 0.99});
+        PricingWorkspace serial_workspace(1, 17);
+        PricingResult serial_result = serial.price_option(call, T, serial_workspace);
+        REQUIRE(serial_result.distribution->quantiles == distribution.quantiles);
+        REQUIRE(serial_result.distribution->expected_shortfall == distribution.expected_shortfall);
+    }
+
+    SECTION("Importance-sampled paths are weighted back to the pricing measure") {
+        pricer.set_drift_shift(1.0);
+        PricingWorkspace shifted_workspace(2, 17);
+        PricingResult shifted = pricer.price_option(call, T, shifted_workspace);
+        REQUIRE(std::abs(shifted.distribution->quantiles[2] - distribution.quantiles[2]) <
+                0.03 * distribution.quantiles[2]);
+        REQUIRE(std::abs(shifted.distribution->quantiles[3] - distribution.quantiles[3]) <
+                0.03 * distribution.quantiles[3]);
+    }
+
+    SECTION("Traced runs report the distribution too") {
+        pricer.enable_convergence_trace();
+        PricingWorkspace traced_workspace(2, 17);
+        PricingResult traced = pricer.price_option(call, T, traced_workspace);
+        REQUIRE(traced.distribution->quantiles == distribution.quantiles);
+    }
+
+    SECTION("Invalid settings are rejected") {
+        REQUIRE_THROWS_AS(pricer.enable_payoff_distribution(1.0), ValidationError);
+        REQUIRE_THROWS_AS(pricer.enable_payoff_distribution(0.99, 0), ValidationError);
+        REQUIRE_THROWS_AS(pricer.enable_payoff_distribution(0.99, 10, {1.5}), ValidationError);
+        pricer.set_stratification(64);
+        REQUIRE_THROWS_AS(pricer.price_option(call, T, workspace), ValidationError);
+    }
+}
+
+TEST_CASE("OptionPricer chunk size and serial threshold", "[OptionPricer]") {
+    BlackScholesModel model(100.0, 0.05, 0.2);
+    CallPayoff payoff(100.0);
+
+    OptionPricer pricer(model, 200000, 3);
+    REQUIRE(pricer.chunk_size() == PricingWorkspace::kChunkSize);
+    pricer.set_chunk_size(5000);
+    REQUIRE(pricer.chunk_size() == 5 * PricingWorkspace::kBlockSize);
+    pricer.set_chunk_size(0);
+    REQUIRE(pricer.chunk_size() == PricingWorkspace::kChunkSize);
+
+    SECTION("Seeded results do not depend on the worker count at any chunk size") {
+        OptionPricer single_pricer(model, 200000, 1);
+        single_pricer.set_chunk_size(8 * PricingWorkspace::kBlockSize);
+        pricer.set_chunk_size(8 * PricingWorkspace::kBlockSize);
+        PricingWorkspace single(1, 5);
+        PricingWorkspace multi(3, 5);
+
+        auto a = single_pricer.price_option(payoff, 1.0, single);
+        auto b = pricer.price_option(payoff, 1.0, multi);
+        REQUIRE(a.price == b.price);
+        REQUIRE(a.standard_error == b.standard_error);
+        REQUIRE(std::abs(a.price - black_scholes_price(100.0, 100.0, 0.05, 0.2, 1.0, true)) < 4.0 * a.standard_error);
+    }
+
+    SECTION("Small jobs below the serial threshold still price correctly") {
+        pricer.set_serial_threshold(1000000);
+        auto result = pricer.price_option(payoff, 1.0);
+        REQUIRE(std::abs(result.price - black_scholes_price(100.0, 100.0, 0.05, 0.2, 1.0, true)) <
+                4.0 * result.standard_error);
+    }
+}
+
+TEST_CASE("OptionPricer deadline-bounded pricing", "[OptionPricer]") {
+    BlackScholesModel model(100.0, 0.05, 0.2);
+    CallPayoff payoff(100.0);
+    const double expected = black_scholes_price(100.0, 100.0, 0.05, 0.2, 1.0, true);
+    using Clock = std::chrono::steady_clock;
+
+    SECTION("Stops at the deadline with the paths completed so far") {
+        // Far more paths than fit in the budget
+        const std::uint64_t num_simulations = 1000000000000ull;
+        OptionPricer pricer(model, num_simulations, 2);
+        pricer.set_deadline(std::chrono::milliseconds(50));
+        PricingWorkspace workspace(2, 9);
+
+        auto start = Clock::now();
+        auto result = pricer.price_option(payoff, 1.0, workspace);
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start);
+
+        REQUIRE(result.deadline_reached);
+        REQUIRE_FALSE(result.cancelled);
+        REQUIRE(result.num_paths > 0);
+        REQUIRE(result.num_paths < num_simulations);
+        REQUIRE(elapsed.count() < 1000);
+        REQUIRE(std::abs(result.price - expected) < 5.0 * result.standard_error);
+    }
+
+    SECTION("Calls that finish in time price every path") {
+        OptionPricer pricer(model, 200000, 2);
+        pricer.set_deadline(std::chrono::seconds(30), 0.5);
+        PricingWorkspace workspace(2, 9);
+        auto result = pricer.price_option(payoff, 1.0, workspace);
+        REQUIRE_FALSE(result.deadline_reached);
+        REQUIRE(result.num_paths == 200000);
+
+        // The same seed without a deadline gives the same price, up to summation order
+        OptionPricer unbounded(model, 200000, 2);
+        PricingWorkspace unbounded_workspace(2, 9);
+        double unbounded_price = unbounded.price_option(payoff, 1.0, unbounded_workspace).price;
+        REQUIRE(std::abs(unbounded_price - result.price) < 1e-12 * result.price);
+    }
+
+    SECTION("An unreachable accuracy floor fails fast") {
+        OptionPricer pricer(model, 1000000000000ull, 2);
+        pricer.set_deadline(std::chrono::seconds(5), 1e-7);
+        PricingWorkspace workspace(2, 9);
+
+        auto start = Clock::now();
+        REQUIRE_THROWS_AS(pricer.price_option(payoff, 1.0, workspace), AccuracyError);
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start);
+        REQUIRE(elapsed.count() < 2500);
+    }
+
+    SECTION("A floor missed after every path also fails") {
+        OptionPricer pricer(model, 10000, 1);
+        pricer.set_deadline(std::chrono::seconds(30), 0.01);
+        REQUIRE_THROWS_AS(pricer.price_option(payoff, 1.0), AccuracyError);
+    }
+
+    SECTION("Traced calls stop at the deadline too") {
+        OptionPricer pricer(model, 1000000000000ull, 2);
+        pricer.set_deadline(std::chrono::milliseconds(50));
+        pricer.enable_convergence_trace();
+        auto result = pricer.price_option(payoff, 1.0);
+        REQUIRE(result.deadline_reached);
+        REQUIRE(pricer.convergence_trace().back().paths == result.num_paths);
+    }
+
+    SECTION("Traced calls apply the floor to the reported standard error") {
+        OptionPricer plain(model, 200000, 2);
+        PricingWorkspace plain_workspace(2, 9);
+        const double standard_error = plain.price_option(payoff, 1.0, plain_workspace).standard_error;
+
+        // Just below the reported standard error
+        OptionPricer pricer(model, 200000, 2);
+        pricer.enable_convergence_trace();
+        pricer.set_deadline(std::chrono::seconds(30), 0.99 * standard_error);
+        PricingWorkspace workspace(2, 9);
+        REQUIRE_THROWS_AS(pricer.price_option(payoff, 1.0, workspace), AccuracyError);
+
+        pricer.set_deadline(std::chrono::seconds(30), 1.01 * standard_error);
+        PricingWorkspace again(2, 9);
+        auto result = pricer.price_option(payoff, 1.0, again);
+        REQUIRE(std::abs(result.standard_error - standard_error) < 1e-9 * standard_error);
+        REQUIRE(pricer.convergence_trace().back().standard_error == result.standard_error);
+
+        // The projection from the traced partial sums fails fast as well
+        OptionPricer unreachable(model, 1000000000000ull, 2);
+        unreachable.enable_convergence_trace();
+        unreachable.set_deadline(std::chrono::seconds(5), 1e-7);
+        auto start = Clock::now();
+        REQUIRE_THROWS_AS(unreachable.price_option(payoff, 1.0), AccuracyError);
+        REQUIRE(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count() < 2500);
+    }
+
+    SECTION("Invalid settings are rejected") {
+        OptionPricer pricer(model, 100000, 1);
+        REQUIRE_THROWS_AS(pricer.set_deadline(std::chrono::milliseconds(-1)), ValidationError);
+        REQUIRE_THROWS_AS(pricer.set_deadline(std::chrono::milliseconds(10), -1.0), ValidationError);
+        pricer.set_deadline(std::chrono::milliseconds(10));
+        pricer.set_stratification(64);
+        REQUIRE_THROWS_AS(pricer.price_option(payoff, 1.0), ValidationError);
+    }
 }
 
-} // namespace montecarlo 
\ No newline at end of file
+} // namespace montecarlo
@@ -0,0 +1,158 @@
+#include "PerfRegression.h"
+#include "Exceptions.h"
+#include "MemoryStats.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+namespace montecarlo {
+
+namespace {
+
+PerfSample make_sample(const std::string& name, double paths_per_second, double noise = 0.0,
+                       std::size_t memory_kb = 1000) {
+    PerfSample sample;
+    sample.name = name;
+    sample.paths = 1000;
+    sample.repeats = 5;
+    sample.paths_per_second = paths_per_second;
+    sample.latency_p50_ms = 1.0;
+    sample.latency_p90_ms = 1.5;
+    sample.latency_p99_ms = 2.0;
+    sample.noise = noise;
+    sample.peak_memory_kb = memory_kb;
+    return sample;
+}
+
+const PerfComparison::Row& row_for(const PerfComparison& comparison, const std::string& name) {
+    for (const auto& row : comparison.rows) {
+        if (row.name == name) return row;
+    }
+    FAIL("No row for " << name);
+    return comparison.rows.front();
+}
+
+} // namespace
+
+TEST_CASE("PerfRegression statistics", "[PerfRegression]") {
+    REQUIRE(percentile({}, 0.5) == 0.0);
+    REQUIRE(percentile({3.0, 1.0, 2.0}, 0.5) == 2.0);
+    REQUIRE(percentile({1.0, 2.0, 3.0, 4.0}, 0.5) == 2.5);
+    REQUIRE(percentile({1.0, 2.0, 3.0, 4.0}, 1.0) == 4.0);
+    REQUIRE(std::abs(percentile({0.0, 10.0}, 0.9) - 9.0) < 1e-12);
+
+    // One outlier does not move the robust noise estimate
+    REQUIRE(std::abs(relative_mad({10.0, 10.0, 11.0, 9.0, 100.0}) - 0.1) < 1e-12);
+    REQUIRE(relative_mad({0.0, 0.0}) == 0.0);
+}
+
+TEST_CASE("PerfRegression flags throughput and memory regressions", "[PerfRegression]") {
+    PerfBaseline baseline;
+    baseline.samples = {make_sample("steady", 100.0),
+                        make_sample("slower", 100.0),
+                        make_sample("noisy", 100.0, 0.08),
+                        make_sample("bloated", 100.0),
+                        make_sample("retired", 100.0)};
+
+    std::vector<PerfSample> current = {make_sample("steady", 95.0),
+                                       make_sample("slower", 85.0),
+                                       make_sample("noisy", 80.0, 0.08),
+                                       make_sample("bloated", 100.0, 0.0, 1300),
+                                       make_sample("added", 50.0)};
+
+    PerfThresholds thresholds;
+    auto comparison = compare(baseline, current, thresholds);
+
+    REQUIRE(comparison.regressed());
+    REQUIRE(row_for(comparison, "steady").status == "ok");
+    REQUIRE(row_for(comparison, "slower").status == "REGRESSED");
+    REQUIRE(std::abs(row_for(comparison, "slower").change + 0.15) < 1e-12);
+
+    // Combined noise sqrt(2) * 0.08 widens the allowed drop to about 34%
+    REQUIRE(row_for(comparison, "noisy").status == "ok");
+    REQUIRE(row_for(comparison, "noisy").allowed > 0.3);
+
+    REQUIRE(row_for(comparison, "bloated").regressed);
+    REQUIRE(std::abs(row_for(comparison, "bloated").memory_change - 0.3) < 1e-12);
+    REQUIRE(row_for(comparison, "added").status == "new");
+    REQUIRE(row_for(comparison, "retired").status == "missing");
+
+    // The readable diff names the regressed workload
+    REQUIRE(comparison.format().find("slower") != std::string::npos);
+    REQUIRE(comparison.format().find("REGRESSED") != std::string::npos);
+
+    SECTION("Different problem sizes are not compared") {
+        current[1].paths = 250;
+        auto resized = compare(baseline, current, thresholds);
+        REQUIRE(row_for(resized, "slower").status == "resized");
+        REQUIRE_FALSE(row_for(resized, "slower").regressed);
+    }
+}
+
+TEST_CASE("PerfRegression baseline round trip", "[PerfRegression]") {
+    const std::string filename = "test_perf_baseline.json";
+
+    PerfBaseline baseline;
+    baseline.hardware_threads = 8;
+    baseline.samples = {make_sample("a", 1234.5, 0.01, 2048), make_sample("b", 99.0)};
+    baseline.save(filename);
+
+    auto loaded = PerfBaseline::load(filename);
+    REQUIRE(loaded.version == PerfBaseline::kVersion);
+    REQUIRE(loaded.hardware_threads == 8);
+    REQUIRE(loaded.samples.size() == 2);
+    REQUIRE(loaded.find("a") != nullptr);
+    REQUIRE(loaded.find("a")->paths_per_second == 1234.5);
+    REQUIRE(loaded.find("a")->latency_p99_ms == 2.0);
+    REQUIRE(loaded.find("a")->peak_memory_kb == 2048);
+    REQUIRE(loaded.find("missing") == nullptr);
+
+    {
+        std::ofstream file(filename);
+        file << R"({"version": 0, "workloads": []})";
+    }
+    REQUIRE_THROWS_AS(PerfBaseline::load(filename), ConfigError);
+    std::remove(filename.c_str());
+
+    REQUIRE_THROWS_AS(PerfBaseline::load("does_not_exist.json"), ConfigError);
+}
+
+TEST_CASE("PerfRegression measures a workload", "[PerfRegression]") {
+    unsigned int calls = 0;
+    PerfWorkload workload{"count", 10, [&calls] { ++calls; }};
+
+    PerfSample sample = measure(workload, 4);
+    REQUIRE(calls == 5);  // One warm-up plus four timed runs
+    REQUIRE(sample.repeats == 4);
+    REQUIRE(sample.name == "count");
+    REQUIRE(sample.latency_p50_ms <= sample.latency_p90_ms);
+    REQUIRE(sample.latency_p90_ms <= sample.latency_p99_ms);
+    REQUIRE(peak_memory_kb() > 0);
+}
+
+TEST_CASE("PerfRegression memory is measured per workload", "[PerfRegression]") {
+    REQUIRE(allocations_counted());
+
+    // 8 MiB, then 64 KiB, allocated and freed inside each run
+    static volatile char sink = 0;
+    PerfWorkload large{"large", 10, [] {
+        std::vector<char> buffer(8u << 20, 1);
+        sink = buffer.back();
+    }};
+    PerfWorkload small{"small", 10, [] {
+        std::vector<char> buffer(64u << 10, 1);
+        sink = buffer.back();
+    }};
+
+    PerfSample large_sample = measure(large, 2);
+    PerfSample small_sample = measure(small, 2);
+    REQUIRE(large_sample.peak_memory_kb >= 8 * 1024);
+    // The later workload does not inherit the earlier peak
+    REQUIRE(small_sample.peak_memory_kb >= 64);
+    REQUIRE(small_sample.peak_memory_kb < 1024);
+    REQUIRE(sink == 1);
+}
+
+} // namespace montecarlo
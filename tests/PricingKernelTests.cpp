@@ -0,0 +1,195 @@
+#include "PricingKernel.h"
+#include "BlackScholesModel.h"
+#include "CallPayoff.h"
+#include "PutPayoff.h"
+#include "OptionPricer.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <memory>
+
+namespace montecarlo {
+
+namespace {
+
+// Call payoff that hides its vanilla terms, forcing the generic kernel
+class OpaqueCall : public Payoff {
+public:
+    explicit OpaqueCall(double K) : K_(K) {}
+    double calculate(double S_T) const override { return std::max(S_T - K_, 0.0); }
+    std::unique_ptr<Payoff> clone() const override { return std::make_unique<OpaqueCall>(K_); }
+
+private:
+    double K_;
+};
+
+// Black-Scholes dynamics that hide their GBM terms, forcing the generic model kernel
+class OpaqueGbm : public IPricingModel {
+public:
+    OpaqueGbm(double S0, double r, double sigma) : model_(S0, r, sigma) {}
+    void simulate_terminal(const double* normals, double* terminal, std::size_t count, double T) const override {
+        model_.simulate_terminal(normals, terminal, count, T);
+    }
+    void simulate_paths(const double* normals, double* paths, std::size_t count, std::size_t num_steps,
+                        double T) const override {
+        model_.simulate_paths(normals, paths, count, num_steps, T);
+    }
+    double discount_factor(double T) const override { return model_.discount_factor(T); }
+
+private:
+    BlackScholesModel model_;
+};
+
+// Driftless Bachelier model S_T = S0 + sigma sqrt(T) Z, with a closed-form call price
+class BachelierModel : public IPricingModel {
+public:
+    BachelierModel(double S0, double sigma) : S0_(S0), sigma_(sigma) {}
+    void simulate_terminal(const double* normals, double* terminal, std::size_t count, double T) const override {
+        for (std::size_t i = 0; i < count; ++i) {
+            terminal[i] = S0_ + sigma_ * std::sqrt(T) * normals[i];
+        }
+    }
+    void simulate_paths(const double* normals, double* paths, std::size_t count, std::size_t num_steps,
+                        double T) const override {
+        double step = sigma_ * std::sqrt(T / num_steps);
+        for (std::size_t k = 0; k < num_steps; ++k) {
+            for (std::size_t i = 0; i < count; ++i) {
+                double previous = k == 0 ? S0_ : paths[(k - 1) * count + i];
+                paths[k * count + i] = previous + step * normals[k * count + i];
+            }
+        }
+    }
+    double discount_factor(double) const override { return 1.0; }
+
+    double call_price(double K, double T) const {
+        double v = sigma_ * std::sqrt(T);
+        double d = (S0_ - K) / v;
+        double pdf = std::exp(-0.5 * d * d) / std::sqrt(2.0 * 3.14159265358979323846);
+        double cdf = 0.5 * std::erfc(-d / std::sqrt(2.0));
+        return (S0_ - K) * cdf + v * pdf;
+    }
+
+private:
+    double S0_;
+    double sigma_;
+};
+
+KernelParams make_params(double strike, const Payoff* payoff) {
+    KernelParams params;
+    params.S0 = 100.0;
+    params.drift = (0.05 - 0.5 * 0.04) * 1.0;
+    params.diffusion = 0.2;
+    params.strike = strike;
+    params.payoff = payoff;
+    return params;
+}
+
+} // namespace
+
+TEST_CASE("PricingKernel payoff classification", "[PricingKernel]") {
+    double strike = 0.0;
+    REQUIRE(classify_payoff(CallPayoff(95.0), strike) == PayoffKind::Call);
+    REQUIRE(strike == 95.0);
+    REQUIRE(classify_payoff(PutPayoff(105.0), strike) == PayoffKind::Put);
+    REQUIRE(strike == 105.0);
+    REQUIRE(classify_payoff(OpaqueCall(100.0), strike) == PayoffKind::Generic);
+}
+
+TEST_CASE("PricingKernel dispatch table covers every configuration", "[PricingKernel]") {
+    const KernelEntry* previous = nullptr;
+    for (ModelKind model : {ModelKind::Gbm, ModelKind::Generic}) {
+        for (PathPrecision precision : {PathPrecision::Double, PathPrecision::Single}) {
+            for (PayoffKind kind : {PayoffKind::Call, PayoffKind::Put, PayoffKind::Generic}) {
+                for (NormalMethod method : {NormalMethod::Ziggurat, NormalMethod::InverseCdf}) {
+                    for (bool weighted : {false, true}) {
+                        const KernelEntry& entry = select_kernel(model, precision, kind, method, weighted);
+                        REQUIRE(entry.simulate != nullptr);
+                        REQUIRE(entry.simulate_strata != nullptr);
+                        if (model == ModelKind::Gbm) {
+                            REQUIRE(&entry != previous);
+                        }
+                        previous = &entry;
+                    }
+                }
+            }
+        }
+    }
+
+    // Generic models always run in double precision
+    REQUIRE(&select_kernel(ModelKind::Generic, PathPrecision::Single, PayoffKind::Call,
+                           NormalMethod::Ziggurat, false)
+            == &select_kernel(ModelKind::Generic, PathPrecision::Double, PayoffKind::Call,
+                              NormalMethod::Ziggurat, false));
+}
+
+TEST_CASE("PricingKernel specialized and generic kernels agree exactly", "[PricingKernel]") {
+    CallPayoff call(100.0);
+    OpaqueCall opaque(100.0);
+
+    for (NormalMethod method : {NormalMethod::Ziggurat, NormalMethod::InverseCdf}) {
+        PricingWorkspace inlined(1, 17);
+        PricingWorkspace generic(1, 17);
+        PathAccumulator a, b;
+
+        select_kernel(ModelKind::Gbm, PathPrecision::Double, PayoffKind::Call, method, false)
+            .simulate(make_params(100.0, &call), 0, 5000, inlined.worker(0), a);
+        select_kernel(ModelKind::Gbm, PathPrecision::Double, PayoffKind::Generic, method, false)
+            .simulate(make_params(0.0, &opaque), 0, 5000, generic.worker(0), b);
+
+        REQUIRE(a.count == 5000);
+        REQUIRE(a.sum.value() == b.sum.value());
+        REQUIRE(a.sum_squared.value() == b.sum_squared.value());
+    }
+}
+
+TEST_CASE("PricingKernel generic payoffs price through OptionPricer", "[PricingKernel]") {
+    BlackScholesModel model(100.0, 0.05, 0.2);
+    OptionPricer pricer(model, 20000, 2);
+
+    PricingWorkspace first(2, 5);
+    PricingWorkspace second(2, 5);
+    PricingResult inlined = pricer.price_option(CallPayoff(100.0), 1.0, first);
+    PricingResult generic = pricer.price_option(OpaqueCall(100.0), 1.0, second);
+
+    REQUIRE(inlined.price == generic.price);
+    REQUIRE(inlined.standard_error == generic.standard_error);
+}
+
+TEST_CASE("PricingKernel generic models price through OptionPricer", "[PricingKernel]") {
+    CallPayoff call(100.0);
+
+    SECTION("Block interface reproduces the inlined GBM kernel") {
+        BlackScholesModel inlined_model(100.0, 0.05, 0.2);
+        OpaqueGbm generic_model(100.0, 0.05, 0.2);
+        OptionPricer inlined(inlined_model, 20000, 2);
+        OptionPricer generic(generic_model, 20000, 2);
+
+        PricingWorkspace first(2, 9);
+        PricingWorkspace second(2, 9);
+        PricingResult a = inlined.price_option(call, 1.0, first);
+        PricingResult b = generic.price_option(call, 1.0, second);
+        REQUIRE(a.price == b.price);
+        REQUIRE(a.standard_error == b.standard_error);
+    }
+
+    SECTION("A new model gets the parallel engine unchanged") {
+        BachelierModel model(100.0, 20.0);
+        double expected = model.call_price(100.0, 1.0);
+
+        OptionPricer plain(model, 400000, 2);
+        PricingWorkspace workspace(2, 3);
+        PricingResult result = plain.price_option(call, 1.0, workspace);
+        REQUIRE(std::abs(result.price - expected) < 5.0 * result.standard_error);
+
+        OptionPricer stratified(model, 400000, 2);
+        stratified.set_stratification(256);
+        PricingResult strata = stratified.price_option(call, 1.0, workspace);
+        REQUIRE(std::abs(strata.price - expected) < 5.0 * strata.standard_error + 1e-3);
+
+        OptionPricer shifted(model, 400000, 2);
+        shifted.enable_automatic_drift_shift();
+        PricingResult weighted = shifted.price_option(CallPayoff(160.0), 1.0, workspace);
+        REQUIRE(std::abs(weighted.price - model.call_price(160.0, 1.0)) < 5.0 * weighted.standard_error);
+    }
+}
+
+} // namespace montecarlo
@@ -0,0 +1,158 @@
+#include "PricingWorkspace.h"
+#include "OptionPricer.h"
+#include "BlackScholesModel.h"
+#include "CallPayoff.h"
+#include "Exceptions.h"
+#include "MemoryStats.h"
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace montecarlo {
+
+TEST_CASE("PricingWorkspace initialization", "[PricingWorkspace]") {
+    PricingWorkspace workspace(4, 42);
+    REQUIRE(workspace.num_workers() == 4);
+
+    for (unsigned int i = 0; i < workspace.num_workers(); ++i) {
+        auto& state = workspace.worker(i);
+        REQUIRE(state.block.size() == PricingWorkspace::kBlockSize);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(state.block.data()) % 64 == 0);
+    }
+
+    REQUIRE_THROWS_AS(PricingWorkspace(0), SimulationError);
+}
+
+TEST_CASE("PricingWorkspace runs every worker", "[PricingWorkspace]") {
+    PricingWorkspace workspace(4, 42);
+    std::atomic<unsigned int> mask{0};
+    auto job = [&](unsigned int worker) { mask |= 1u << worker; };
+
+    for (int i = 0; i < 100; ++i) {
+        mask = 0;
+        workspace.run(job);
+        REQUIRE(mask == 0xFu);
+    }
+}
+
+TEST_CASE("PricingWorkspace seeded pricing is reproducible", "[PricingWorkspace]") {
+    BlackScholesModel model(100.0, 0.05, 0.2);
+    OptionPricer pricer(model, 100000, 4);
+    CallPayoff payoff(100.0);
+
+    PricingWorkspace first(4, 7);
+    PricingWorkspace second(4, 7);
+    auto a = pricer.price_option(payoff, 1.0, first);
+    auto b = pricer.price_option(payoff, 1.0, second);
+    REQUIRE(a.price == b.price);
+    REQUIRE(a.standard_error == b.standard_error);
+
+    // Subsequent calls continue the streams rather than replaying them
+    auto c = pricer.price_option(payoff, 1.0, first);
+    REQUIRE(c.price != a.price);
+}
+
+TEST_CASE("PricingWorkspace chunk plans", "[PricingWorkspace]") {
+    using ChunkPlan = PricingWorkspace::ChunkPlan;
+
+    SECTION("Small runs use minimum-size chunks") {
+        auto plan = ChunkPlan::for_paths(100000);
+        REQUIRE(plan.chunk_size == PricingWorkspace::kChunkSize);
+        REQUIRE(plan.num_chunks == 4);
+        REQUIRE(plan.first(3) == 3 * PricingWorkspace::kChunkSize);
+        REQUIRE(plan.last(3) == 100000);
+    }
+
+    SECTION("Large runs are capped at kMaxChunks") {
+        const std::uint64_t paths = 10000000000ULL;
+        auto plan = ChunkPlan::for_paths(paths);
+        REQUIRE(plan.num_chunks <= PricingWorkspace::kMaxChunks);
+        REQUIRE(plan.chunk_size % PricingWorkspace::kChunkSize == 0);
+        REQUIRE(plan.last(plan.num_chunks - 1) == paths);
+        REQUIRE(plan.first(plan.num_chunks - 1) < paths);
+    }
+
+    SECTION("Empty ranges have no chunks") {
+        REQUIRE(ChunkPlan::for_paths(0).num_chunks == 0);
+    }
+}
+
+TEST_CASE("PricingWorkspace runs every chunk exactly once", "[PricingWorkspace]") {
+    PricingWorkspace workspace(4, 42);
+    auto plan = PricingWorkspace::ChunkPlan::make(100003, 7, 1000);
+    REQUIRE(plan.num_chunks <= 1000);
+
+    std::vector<std::atomic<unsigned int>> visits(plan.num_chunks);
+    std::atomic<std::uint64_t> items{0};
+    auto job = [&](PricingWorkspace::WorkerState&, std::uint64_t chunk,
+                   std::uint64_t first, std::uint64_t last) {
+        ++visits[chunk];
+        items += last - first;
+    };
+    workspace.run_chunks(plan, job);
+
+    REQUIRE(items == 100003);
+    for (auto& count : visits) {
+        REQUIRE(count == 1);
+    }
+}
+
+TEST_CASE("PricingWorkspace seeded results do not depend on the worker count", "[PricingWorkspace]") {
+    BlackScholesModel model(100.0, 0.05, 0.2);
+    CallPayoff payoff(100.0);
+
+    OptionPricer single_pricer(model, 300000, 1);
+    OptionPricer multi_pricer(model, 300000, 3);
+    PricingWorkspace single(1, 11);
+    PricingWorkspace multi(3, 11);
+
+    auto a = single_pricer.price_option(payoff, 1.0, single);
+    auto b = multi_pricer.price_option(payoff, 1.0, multi);
+    REQUIRE(a.price == b.price);
+    REQUIRE(a.standard_error == b.standard_error);
+}
+
+TEST_CASE("PricingWorkspace reuses its per-chunk accumulators", "[PricingWorkspace]") {
+    PricingWorkspace workspace(1, 1);
+    PathAccumulator batch;
+    batch.add(1.0);
+    batch.add(3.0);
+
+    BatchMeansAccumulator* batches = workspace.batch_accumulators(8);
+    batches[3].add_batch(batch);
+    REQUIRE(batches[3].count == 2);
+
+    // A smaller request reuses the storage and starts empty
+    AllocationCounter counter;
+    REQUIRE(workspace.batch_accumulators(4) == batches);
+    REQUIRE(batches[3].count == 0);
+    REQUIRE(counter.allocations() == 0);
+}
+
+TEST_CASE("PricingWorkspace steady state performs no heap allocations", "[PricingWorkspace]") {
+    REQUIRE(allocations_counted());
+
+    BlackScholesModel model(100.0, 0.05, 0.2);
+    CallPayoff payoff(100.0);
+    PricingWorkspace workspace(4, 42);
+
+    for (auto precision : {PathPrecision::Double, PathPrecision::Single}) {
+        OptionPricer pricer(model, 50000, 4, precision);
+
+        // Warm up once so any lazy runtime initialization happens here
+        pricer.price_option(payoff, 1.0, workspace);
+
+        AllocationCounter counter;
+        double checksum = 0.0;
+        for (int i = 0; i < 20; ++i) {
+            checksum += pricer.price_option(payoff, 1.0, workspace).price;
+        }
+
+        REQUIRE(counter.allocations() == 0);
+        REQUIRE(checksum > 0.0);
+    }
+}
+
+} // namespace montecarlo
@@ -0,0 +1,183 @@
+#include "QuantileSketch.h"
+#include "Exceptions.h"
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace montecarlo {
+
+namespace {
+
+// Order statistic the sketch reports for level q: the first value whose
+// cumulative count exceeds q * n
+double exact_quantile(std::vector<double> values, double q) {
+    std::sort(values.begin(), values.end());
+    auto rank = static_cast<std::size_t>(std::floor(q * values.size()));
+    return values[std::min(rank, values.size() - 1)];
+}
+
+std::vector<double> lognormal_sample(std::size_t n, unsigned int seed) {
+    std::mt19937_64 rng(seed);
+    std::lognormal_distribution<double> dist(0.0, 0.5);
+    std::vector<double> values(n);
+    for (auto& v : values) {
+        v = dist(rng);
+    }
+    return values;
+}
+
+} // namespace
+
+TEST_CASE("QuantileSketch relative accuracy", "[QuantileSketch]") {
+    const double alpha = 0.01;
+    auto values = lognormal_sample(100000, 3);
+    QuantileSketch sketch(alpha);
+    for (double v : values) {
+        sketch.add(v);
+    }
+
+    REQUIRE(sketch.total_weight() == 100000.0);
+    REQUIRE(sketch.min() == *std::min_element(values.begin(), values.end()));
+    REQUIRE(sketch.max() == *std::max_element(values.begin(), values.end()));
+    REQUIRE(sketch.quantile(0.0) == sketch.min());
+    REQUIRE(sketch.quantile(1.0) == sketch.max());
+
+    for (double q : {0.001, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999}) {
+        double exact = exact_quantile(values, q);
+        REQUIRE(std::abs(sketch.quantile(q) - exact) <= alpha * exact * (1.0 + 1e-12));
+    }
+
+    SECTION("Upper tail mean") {
+        std::vector<double> sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+        double tail = 0.0;
+        for (std::size_t i = 99000; i < sorted.size(); ++i) {
+            tail += sorted[i];
+        }
+        tail /= 1000.0;
+        REQUIRE(std::abs(sketch.upper_tail_mean(0.99) - tail) <= alpha * tail);
+        REQUIRE(sketch.upper_tail_mean(0.99) >= sketch.quantile(0.99));
+    }
+
+    SECTION("Histogram") {
+        auto bins = sketch.histogram(10);
+        REQUIRE(bins.size() == 10);
+        REQUIRE(bins.front().lower == sketch.min());
+        REQUIRE(bins.back().upper == sketch.max());
+        double total = 0.0;
+        for (const auto& bin : bins) {
+            REQUIRE(bin.probability >= 0.0);
+            total += bin.probability;
+        }
+        REQUIRE(std::abs(total - 1.0) < 1e-12);
+    }
+}
+
+TEST_CASE("QuantileSketch merging", "[QuantileSketch]") {
+    auto values = lognormal_sample(30000, 9);
+    QuantileSketch whole;
+    for (double v : values) {
+        whole.add(v);
+    }
+
+    // Split unevenly across three sketches and merge in a different order
+    QuantileSketch parts[3];
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        parts[(i * 7) % 3 == 0 ? 0 : (i % 5 == 0 ? 1 : 2)].add(values[i]);
+    }
+    QuantileSketch merged;
+    merged.merge(parts[2]);
+    merged.merge(parts[0]);
+    merged.merge(parts[1]);
+
+    REQUIRE(merged.total_weight() == whole.total_weight());
+    REQUIRE(merged.min() == whole.min());
+    REQUIRE(merged.max() == whole.max());
+    for (double q : {0.01, 0.3, 0.5, 0.9, 0.99}) {
+        REQUIRE(merged.quantile(q) == whole.quantile(q));
+    }
+    REQUIRE(merged.upper_tail_mean(0.95) == whole.upper_tail_mean(0.95));
+
+    SECTION("Incompatible sketches are rejected") {
+        QuantileSketch coarse(0.05);
+        REQUIRE_THROWS_AS(merged.merge(coarse), ValidationError);
+    }
+
+    SECTION("Clearing keeps the sketch usable") {
+        merged.clear();
+        REQUIRE(merged.empty());
+        REQUIRE(std::isnan(merged.quantile(0.5)));
+        REQUIRE(merged.histogram(4).empty());
+        merged.add(2.0);
+        REQUIRE(std::abs(merged.quantile(0.5) - 2.0) <= 0.02);
+    }
+}
+
+TEST_CASE("QuantileSketch signed values and zeros", "[QuantileSketch]") {
+    // Half zeros, as for an at-the-money option, plus a negative tail
+    QuantileSketch sketch;
+    std::vector<double> values;
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(0.0);
+        values.push_back(1.0 + i);
+        if (i % 4 == 0) {
+            values.push_back(-0.5 * (i + 1));
+        }
+    }
+    for (double v : values) {
+        sketch.add(v);
+    }
+
+    REQUIRE(sketch.quantile(0.5) == 0.0);
+    for (double q : {0.01, 0.05, 0.2, 0.7, 0.95}) {
+        double exact = exact_quantile(values, q);
+        REQUIRE(std::abs(sketch.quantile(q) - exact) <= 0.01 * std::abs(exact) + 1e-12);
+    }
+}
+
+TEST_CASE("QuantileSketch bounded buckets", "[QuantileSketch]") {
+    // Magnitudes spanning 16 decades need far more than 64 buckets
+    std::vector<double> values;
+    for (int i = 0; i <= 1600; ++i) {
+        values.push_back(std::pow(10.0, -8.0 + i * 0.01));
+    }
+
+    QuantileSketch ascending(0.01, 64);
+    QuantileSketch descending(0.01, 64);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        ascending.add(values[i]);
+        descending.add(values[values.size() - 1 - i]);
+    }
+
+    // Only the smallest magnitudes lose accuracy, whatever the insertion order
+    for (double q : {0.01, 0.5, 0.97, 0.99}) {
+        REQUIRE(ascending.quantile(q) == descending.quantile(q));
+    }
+    for (double q : {0.97, 0.99}) {
+        double exact = exact_quantile(values, q);
+        REQUIRE(std::abs(ascending.quantile(q) - exact) <= 0.01 * exact);
+    }
+    REQUIRE(ascending.quantile(0.01) >= ascending.min());
+}
+
+TEST_CASE("QuantileSketch weighted values", "[QuantileSketch]") {
+    QuantileSketch sketch;
+    sketch.add(1.0, 3.0);
+    sketch.add(10.0, 1.0);
+    sketch.add(5.0, 0.0);
+
+    REQUIRE(sketch.total_weight() == 4.0);
+    REQUIRE(std::abs(sketch.quantile(0.5) - 1.0) <= 0.01);
+    REQUIRE(std::abs(sketch.quantile(0.8) - 10.0) <= 0.1);
+    REQUIRE(sketch.max() == 10.0);
+}
+
+TEST_CASE("QuantileSketch invalid parameters", "[QuantileSketch]") {
+    REQUIRE_THROWS_AS(QuantileSketch(0.0), ValidationError);
+    REQUIRE_THROWS_AS(QuantileSketch(1.0), ValidationError);
+    REQUIRE_THROWS_AS(QuantileSketch(0.01, 1), ValidationError);
+}
+
+} // namespace montecarlo
@@ -0,0 +1,97 @@
+#include "ScenarioEngine.h"
+#include "OptionPricer.h"
+#include "BlackScholesModel.h"
+#include "CallPayoff.h"
+#include "PutPayoff.h"
+#include "Exceptions.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+
+namespace montecarlo {
+
+TEST_CASE("ScenarioEngine grid expansion", "[ScenarioEngine]") {
+    ShockGrid grid;
+    grid.spot_shocks = {-0.1, 0.0, 0.1};
+    grid.vol_shocks = {0.0, 0.05};
+
+    auto scenarios = grid.expand({100.0, 0.2, 0.05});
+    REQUIRE(scenarios.size() == 6);
+
+    // Rate varies fastest, then volatility, then spot
+    REQUIRE(std::abs(scenarios[0].S - 90.0) < 1e-12);
+    REQUIRE(std::abs(scenarios[1].sigma - 0.25) < 1e-12);
+    REQUIRE(std::abs(scenarios[5].S - 110.0) < 1e-12);
+    REQUIRE(scenarios[5].r == 0.05);
+}
+
+TEST_CASE("ScenarioEngine matches independent pricing", "[ScenarioEngine]") {
+    BlackScholesModel model(100.0, 0.05, 0.2);
+    ScenarioEngine engine(model, 200000);
+    PricingWorkspace workspace(4, 11);
+
+    CallPayoff call(100.0);
+    PutPayoff put(100.0);
+    std::vector<MarketScenario> scenarios = {{100.0, 0.2, 0.05}, {110.0, 0.2, 0.05}, {100.0, 0.3, 0.03}};
+    auto result = engine.run(scenarios, {&call, &put}, 1.0, workspace);
+
+    REQUIRE(result.prices.size() == 6);
+    for (std::size_t s = 0; s < scenarios.size(); ++s) {
+        BlackScholesModel shocked(scenarios[s].S, scenarios[s].r, scenarios[s].sigma);
+        OptionPricer pricer(shocked, 200000, 4);
+        auto independent = pricer.price_option(call, 1.0);
+
+        double combined = std::sqrt(independent.standard_error * independent.standard_error +
+                                    result.standard_errors[s * 2] * result.standard_errors[s * 2]);
+        REQUIRE(std::abs(result.price(s, 0) - independent.price) < 4 * combined);
+    }
+
+    // The unshocked scenario has exactly zero P&L
+    REQUIRE(result.pnl[0] == 0.0);
+    REQUIRE(result.pnl_standard_errors[0] == 0.0);
+}
+
+TEST_CASE("ScenarioEngine common random numbers reduce P&L variance", "[ScenarioEngine]") {
+    BlackScholesModel model(100.0, 0.05, 0.2);
+    ScenarioEngine engine(model, 100000);
+    PricingWorkspace workspace(2, 5);
+    CallPayoff call(100.0);
+
+    auto result = engine.run({{101.0, 0.2, 0.05}}, {&call}, 1.0, workspace);
+
+    // A 1% spot bump moves the price by roughly delta; with shared normals the
+    // P&L standard error is far below the standard error of either price
+    REQUIRE(result.pnl[0] > 0.4);
+    REQUIRE(result.pnl[0] < 0.8);
+    REQUIRE(result.pnl_standard_errors[0] < 0.1 * result.standard_errors[0]);
+}
+
+TEST_CASE("ScenarioEngine seeded results do not depend on the thread count", "[ScenarioEngine]") {
+    BlackScholesModel model(100.0, 0.05, 0.2);
+    // Several chunks, so workers fold them into the totals out of step
+    ScenarioEngine engine(model, 5 * PricingWorkspace::kChunkSize + 100);
+    CallPayoff call(100.0);
+    PutPayoff put(95.0);
+    std::vector<MarketScenario> scenarios = {{95.0, 0.2, 0.05}, {105.0, 0.25, 0.04}};
+
+    PricingWorkspace single(1, 23);
+    PricingWorkspace several(3, 23);
+    auto expected = engine.run(scenarios, {&call, &put}, 1.0, single);
+    auto result = engine.run(scenarios, {&call, &put}, 1.0, several);
+    for (std::size_t c = 0; c < expected.prices.size(); ++c) {
+        REQUIRE(result.prices[c] == expected.prices[c]);
+        REQUIRE(result.pnl[c] == expected.pnl[c]);
+        REQUIRE(result.pnl_standard_errors[c] == expected.pnl_standard_errors[c]);
+    }
+}
+
+TEST_CASE("ScenarioEngine rejects invalid scenarios", "[ScenarioEngine]") {
+    BlackScholesModel model(100.0, 0.05, 0.2);
+    ScenarioEngine engine(model, 1000);
+    PricingWorkspace workspace(1, 1);
+    CallPayoff call(100.0);
+
+    REQUIRE_THROWS_AS(engine.run({{100.0, -0.1, 0.05}}, {&call}, 1.0, workspace), ValidationError);
+    REQUIRE_THROWS_AS(engine.run({}, {&call}, 1.0, workspace), ValidationError);
+}
+
+} // namespace montecarlo
@@ -0,0 +1,104 @@
+#include "SpotRepricer.h"
+#include "OptionPricer.h"
+#include "BlackScholesModel.h"
+#include "CallPayoff.h"
+#include "PutPayoff.h"
+#include "Exceptions.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+
+namespace montecarlo {
+
+namespace {
+
+// A call without vanilla terms, evaluated through calculate()
+class OpaqueCall : public Payoff {
+public:
+    explicit OpaqueCall(double strike) : strike_(strike) {}
+    double calculate(double S_T) const override { return S_T > strike_ ? S_T - strike_ : 0.0; }
+    std::unique_ptr<Payoff> clone() const override { return std::make_unique<OpaqueCall>(strike_); }
+
+private:
+    double strike_;
+};
+
+} // namespace
+
+TEST_CASE("SpotRepricer matches full pricing on every spot", "[SpotRepricer]") {
+    const std::uint64_t num_simulations = 100000;
+    const double T = 1.0;
+    CallPayoff call(100.0);
+    PutPayoff put(100.0);
+
+    SpotRepricer repricer(num_simulations, 2);
+    PricingWorkspace workspace(2, 17);
+    BlackScholesModel base(100.0, 0.05, 0.2);
+    repricer.price_option(base, call, T, workspace);
+
+    // Seeded full runs draw the same paths as the cache
+    for (double spot : {80.0, 95.0, 100.0, 112.5, 150.0}) {
+        BlackScholesModel model(spot, 0.05, 0.2);
+        for (const Payoff* payoff : {static_cast<const Payoff*>(&call), static_cast<const Payoff*>(&put)}) {
+            PricingWorkspace full_workspace(2, 17);
+            OptionPricer pricer(model, num_simulations, 2);
+            PricingResult full = pricer.price_option(*payoff, T, full_workspace);
+            PricingResult cached = repricer.price_option(model, *payoff, T);
+
+            REQUIRE(std::abs(cached.price - full.price) < 1e-10 * full.price + 1e-12);
+            REQUIRE(std::abs(cached.standard_error - full.standard_error) < 1e-8 * full.standard_error + 1e-12);
+        }
+    }
+    REQUIRE(repricer.cache_builds() == 1);
+
+    SECTION("Payoffs without vanilla terms are evaluated on the cached samples") {
+        PricingResult vanilla = repricer.reprice(105.0, call);
+        PricingResult generic = repricer.reprice(105.0, OpaqueCall(100.0));
+        REQUIRE(std::abs(generic.price - vanilla.price) < 1e-10 * vanilla.price);
+        REQUIRE(std::abs(generic.standard_error - vanilla.standard_error) < 1e-8 * vanilla.standard_error);
+        REQUIRE(repricer.cache_builds() == 1);
+    }
+
+    SECTION("Strikes beyond every sample price to zero or the forward") {
+        REQUIRE(repricer.reprice(1e-6, call).price == 0.0);
+        REQUIRE(repricer.reprice(1e-6, call).standard_error == 0.0);
+        PricingResult deep = repricer.reprice(1e9, call);
+        REQUIRE(std::abs(deep.price - (1e9 - 100.0 * std::exp(-0.05 * T))) < 4.0 * deep.standard_error);
+    }
+}
+
+TEST_CASE("SpotRepricer invalidates on market changes", "[SpotRepricer]") {
+    SpotRepricer repricer(50000, 2);
+    PricingWorkspace workspace(2, 3);
+    CallPayoff call(100.0);
+
+    REQUIRE_THROWS_AS(repricer.reprice(100.0, call), ValidationError);
+
+    repricer.price_option(BlackScholesModel(100.0, 0.05, 0.2), call, 1.0, workspace);
+    REQUIRE(repricer.is_cached(0.05, 0.2, 1.0));
+    repricer.price_option(BlackScholesModel(101.0, 0.05, 0.2), call, 1.0, workspace);
+    REQUIRE(repricer.cache_builds() == 1);
+
+    repricer.price_option(BlackScholesModel(101.0, 0.05, 0.25), call, 1.0, workspace);
+    REQUIRE(repricer.cache_builds() == 2);
+    repricer.price_option(BlackScholesModel(101.0, 0.04, 0.25), call, 1.0, workspace);
+    REQUIRE(repricer.cache_builds() == 3);
+    PricingResult shorter = repricer.price_option(BlackScholesModel(101.0, 0.04, 0.25), call, 0.5, workspace);
+    REQUIRE(repricer.cache_builds() == 4);
+    REQUIRE_FALSE(repricer.is_cached(0.05, 0.2, 1.0));
+
+    // The cache reflects the new market
+    double d1 = (std::log(101.0 / 100.0) + (0.04 + 0.5 * 0.25 * 0.25) * 0.5) / (0.25 * std::sqrt(0.5));
+    double d2 = d1 - 0.25 * std::sqrt(0.5);
+    auto N = [](double x) { return 0.5 * std::erfc(-x / std::sqrt(2.0)); };
+    double expected = 101.0 * N(d1) - 100.0 * std::exp(-0.04 * 0.5) * N(d2);
+    REQUIRE(std::abs(shorter.price - expected) < 4.0 * shorter.standard_error);
+
+    repricer.set_normal_method(NormalMethod::InverseCdf);
+    REQUIRE_FALSE(repricer.is_cached(0.04, 0.25, 0.5));
+
+    repricer.price_option(BlackScholesModel(101.0, 0.04, 0.25), call, 0.5, workspace);
+    REQUIRE(repricer.cache_builds() == 5);
+    REQUIRE_THROWS_AS(repricer.reprice(-1.0, call), ValidationError);
+}
+
+} // namespace montecarlo
@@ -0,0 +1,179 @@
+#include "TermStructure.h"
+#include "TermStructureModel.h"
+#include "Analytics.h"
+#include "BlackScholesModel.h"
+#include "CallPayoff.h"
+#include "Exceptions.h"
+#include "OptionPricer.h"
+#include "PricingWorkspace.h"
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace montecarlo {
+
+namespace {
+
+// Relative comparison for quantities computed two ways
+bool close(double actual, double expected, double tolerance = 1e-10) {
+    return std::abs(actual - expected) <= tolerance * std::max(1.0, std::abs(expected));
+}
+
+} // namespace
+
+TEST_CASE("TermStructure integrals", "[TermStructure]") {
+    SECTION("Piecewise-constant curves integrate segment by segment") {
+        // 2% to 0.5, 3% to 1, 4% to 2, flat 4% after
+        TermStructure curve({0.5, 1.0, 2.0}, {0.02, 0.03, 0.04});
+        REQUIRE(curve.value(0.25) == 0.02);
+        REQUIRE(curve.value(0.5) == 0.02);
+        REQUIRE(curve.value(0.75) == 0.03);
+        REQUIRE(curve.value(3.0) == 0.04);
+
+        REQUIRE(curve.integral(0.0) == 0.0);
+        REQUIRE(close(curve.integral(0.25), 0.005));
+        REQUIRE(close(curve.integral(1.0), 0.01 + 0.015));
+        REQUIRE(close(curve.integral(1.5), 0.025 + 0.02));
+        REQUIRE(close(curve.integral(3.0), 0.025 + 0.04 + 0.04));
+        REQUIRE(close(curve.integral_of_square(1.0), 0.5 * 0.0004 + 0.5 * 0.0009));
+        REQUIRE_FALSE(curve.is_flat());
+    }
+
+    SECTION("Piecewise-linear curves integrate exactly") {
+        // sigma rises linearly from 0.1 at t = 1 to 0.3 at t = 2
+        TermStructure curve({1.0, 2.0}, {0.1, 0.3}, Interpolation::PiecewiseLinear);
+        REQUIRE(curve.value(0.5) == 0.1);
+        REQUIRE(close(curve.value(1.5), 0.2));
+        REQUIRE(curve.value(2.5) == 0.3);
+
+        REQUIRE(close(curve.integral(1.5), 0.1 + 0.5 * 0.15));
+        REQUIRE(close(curve.integral(2.0), 0.1 + 0.2));
+
+        // Midpoint rule on a fine grid as the reference for the integral of the square
+        double reference = 0.0;
+        const int n = 20000;
+        for (int i = 0; i < n; ++i) {
+            double t = 2.5 * (i + 0.5) / n;
+            reference += curve.value(t) * curve.value(t) * 2.5 / n;
+        }
+        REQUIRE(close(curve.integral_of_square(2.5), reference, 1e-6));
+    }
+
+    SECTION("Flat curves") {
+        TermStructure curve = TermStructure::flat(0.05);
+        REQUIRE(curve.is_flat());
+        REQUIRE(curve.value(7.0) == 0.05);
+        REQUIRE(close(curve.integral(2.0), 0.1));
+        REQUIRE(close(curve.integral_of_square(2.0), 0.005));
+    }
+
+    SECTION("Invalid curves are rejected") {
+        REQUIRE_THROWS_AS(TermStructure({}, {}), ValidationError);
+        REQUIRE_THROWS_AS(TermStructure({1.0, 2.0}, {0.1}), ValidationError);
+        REQUIRE_THROWS_AS(TermStructure({1.0, 1.0}, {0.1, 0.2}), ValidationError);
+        REQUIRE_THROWS_AS(TermStructure({-1.0}, {0.1}), ValidationError);
+        REQUIRE_THROWS_AS(TermStructure::parse_interpolation("cubic"), ConfigError);
+        REQUIRE(TermStructure::parse_interpolation("linear") == Interpolation::PiecewiseLinear);
+    }
+}
+
+TEST_CASE("TermStructureModel dynamics", "[TermStructure]") {
+    TermStructure rates({0.5, 1.0}, {0.01, 0.05});
+    TermStructure vols({0.25, 1.0}, {0.3, 0.15}, Interpolation::PiecewiseLinear);
+    TermStructureModel model(100.0, rates, vols);
+    const double T = 1.0;
+
+    SECTION("Terminal terms are the averages over [0, T]") {
+        auto terms = model.terminal_gbm_terms(T);
+        REQUIRE(terms);
+        REQUIRE(close(terms->risk_free_rate, 0.03));
+        REQUIRE(close(terms->volatility, std::sqrt(vols.integral_of_square(T))));
+        REQUIRE(close(model.discount_factor(T), std::exp(-0.03)));
+        REQUIRE_FALSE(model.gbm_terms());
+
+        // A flat model reports the same terms either way
+        TermStructureModel flat(100.0, TermStructure::flat(0.05), TermStructure::flat(0.2));
+        REQUIRE(flat.gbm_terms());
+        REQUIRE(flat.gbm_terms()->volatility == 0.2);
+    }
+
+    SECTION("Terminal sampling matches a flat model with the average parameters") {
+        auto terms = *model.terminal_gbm_terms(T);
+        BlackScholesModel flat(100.0, terms.risk_free_rate, terms.volatility);
+        std::vector<double> normals = {-2.0, -0.5, 0.0, 0.7, 1.9};
+        std::vector<double> curved(normals.size());
+        std::vector<double> expected(normals.size());
+        model.simulate_terminal(normals.data(), curved.data(), normals.size(), T);
+        flat.simulate_terminal(normals.data(), expected.data(), normals.size(), T);
+        for (std::size_t i = 0; i < normals.size(); ++i) {
+            REQUIRE(close(curved[i], expected[i], 1e-12));
+        }
+    }
+
+    SECTION("Multi-step paths have the exact terminal distribution") {
+        // The discounted price is a martingale and the mean log return is R - V / 2
+        const std::size_t num_steps = 12;
+        const std::size_t count = 200000;
+        std::mt19937 rng(7);
+        std::normal_distribution<double> normal;
+        std::vector<double> paths(num_steps * count);
+        for (double& z : paths) {
+            z = normal(rng);
+        }
+        std::vector<double> normals = paths;
+        model.simulate_paths(paths.data(), paths.data(), count, num_steps, T);
+
+        double sum = 0.0;
+        double sum_log = 0.0;
+        for (std::size_t i = 0; i < count; ++i) {
+            double terminal = paths[(num_steps - 1) * count + i];
+            sum += terminal;
+            sum_log += std::log(terminal / 100.0);
+        }
+        double variance = model.integrated_variance(T);
+        REQUIRE(close(sum / count * model.discount_factor(T), 100.0, 0.005));
+        REQUIRE(std::abs(sum_log / count - (model.integrated_rate(T) - 0.5 * variance)) < 0.003);
+
+        // A precomputed grid evolves the same paths
+        auto grid = model.make_grid(num_steps, T);
+        REQUIRE(close(grid.integrated_rate.back(), model.integrated_rate(T)));
+        REQUIRE(close(grid.integrated_variance.back(), variance));
+        std::vector<double> gridded(num_steps * count);
+        model.simulate_paths(grid, normals.data(), gridded.data(), count);
+        for (std::size_t i = 0; i < num_steps * count; i += 997) {
+            REQUIRE(close(gridded[i], paths[i], 1e-12));
+        }
+    }
+
+    SECTION("Invalid models are rejected") {
+        REQUIRE_THROWS_AS(TermStructureModel(0.0, rates, vols), ValidationError);
+        REQUIRE_THROWS_AS(TermStructureModel(100.0, rates, TermStructure({1.0}, {-0.1})), ValidationError);
+        REQUIRE_THROWS_AS(model.make_grid(0, T), ValidationError);
+    }
+}
+
+TEST_CASE("TermStructureModel prices Europeans through the inlined kernels", "[TermStructure]") {
+    TermStructure rates({0.5, 1.0, 2.0}, {0.01, 0.03, 0.05});
+    TermStructure vols({0.5, 2.0}, {0.35, 0.2}, Interpolation::PiecewiseLinear);
+    TermStructureModel model(100.0, rates, vols);
+    CallPayoff payoff(105.0);
+    const double T = 1.5;
+
+    auto terms = *model.terminal_gbm_terms(T);
+    double expected = analytics::black_scholes_price(100.0, 105.0, terms.risk_free_rate, terms.volatility, T, OptionType::Call);
+
+    OptionPricer pricer(model, 400000, 2);
+    PricingWorkspace workspace(2, 11);
+    auto result = pricer.price_option(payoff, T, workspace);
+    REQUIRE(std::abs(result.price - expected) < 4.0 * result.standard_error);
+
+    // Same seed and flat averages: the same kernel and the same paths
+    BlackScholesModel flat(100.0, terms.risk_free_rate, terms.volatility);
+    OptionPricer flat_pricer(flat, 400000, 2);
+    PricingWorkspace flat_workspace(2, 11);
+    REQUIRE(close(flat_pricer.price_option(payoff, T, flat_workspace).price, result.price, 1e-12));
+}
+
+} // namespace montecarlo